@@ -46,8 +46,15 @@
 
 //------------------------------------------------------------------------------
 
+/* Sample rate of Blip Buffers when polyphase resampler is enabled */
+#define AUDIO_INTERNAL_RATE 48000
+
+//------------------------------------------------------------------------------
+
 int audio_init(int samplerate, f64 framerate);
 void audio_set_rate(int samplerate, f64 framerate);
+void audio_set_output_rate(int samplerate);
+void audio_set_rate_adjustment(f64 adjustment);
 void audio_reset(void);
 void audio_shutdown(void);
 
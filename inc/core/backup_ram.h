@@ -0,0 +1,25 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __CORE_BACKUP_RAM_H__
+#define __CORE_BACKUP_RAM_H__
+
+#include "xee/fnd/data_type.h"
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+// Backup memories.
+#define BACKUP_RAM_SCD  0x01 // Mega-CD internal backup RAM (scd.bram).
+#define BACKUP_RAM_CART 0x02 // Mega-CD backup RAM cartridge (scd.cartridge.area).
+#define BACKUP_RAM_SRAM 0x04 // Cartridge SRAM or EEPROM (sram.sram).
+
+// Backup memories modified by the emulated hardware (set by the write
+// handlers, cleared by the frontend once the memories are saved).
+extern u8 backup_ram_dirty;
+
+#endif // #ifndef __CORE_BACKUP_RAM_H__
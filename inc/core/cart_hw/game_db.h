@@ -0,0 +1,39 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __CORE_CART_HW_GAME_DB_H__
+#define __CORE_CART_HW_GAME_DB_H__
+
+#include "xee/fnd/data_type.h"
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+// Key of a game database entry (e.g. ROM CRC or checksums).
+typedef struct
+{
+  u32 key;   // Key of the entry.
+  u16 entry; // Index of the entry in the database table.
+} game_db_key_t;
+
+// Index of a game database table, built once on first lookup.
+typedef struct
+{
+  game_db_key_t* keys; // Keys sorted by value (then by entry).
+  u16 count;           // Number of entries.
+  u8 ready;            // Keys have been sorted.
+} game_db_t;
+
+//------------------------------------------------------------------------------
+
+// Sort the keys of an index (keys[i].key filled by the caller for each entry).
+void game_db_build(game_db_t* db);
+
+// Returns the first entry (in table order) having a key, or -1 if not found.
+int game_db_find(const game_db_t* db, u32 key);
+
+#endif // #ifndef __CORE_CART_HW_GAME_DB_H__
@@ -50,6 +50,8 @@ extern int cdc_context_save(u8 *state);
 extern int cdc_context_load(u8 *state);
 extern void cdc_dma_init(void);
 extern void cdc_dma_update(unsigned int cycles);
+extern void cdc_dma_copy_words(u8 *dst, u32 dst_index, u32 dst_mask, u16 src_index, unsigned int words);
+extern void cdc_dma_copy_bytes(u8 *dst, u32 dst_index, u32 dst_mask, u16 src_index, unsigned int length);
 extern void cdc_decoder_update(u32 header);
 extern void cdc_reg_w(unsigned char data);
 extern unsigned char cdc_reg_r(void);
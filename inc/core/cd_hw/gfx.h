@@ -90,6 +90,7 @@ extern void cell_ram_1_write8(unsigned int address, unsigned int data);
 /***************************************************************/
 extern void gfx_init(void);
 extern void gfx_reset(void);
+extern void gfx_shutdown(void);
 extern int gfx_context_save(u8 *state);
 extern int gfx_context_load(u8 *state);
 extern void gfx_start(unsigned int base, int cycles);
@@ -83,6 +83,17 @@ struct core_config_t
   u8 ym3438;
 
   u8 cd_latency;
+
+  // CD image file access:
+  // - 0 = stdio file,
+  // - 1 = memory-mapped file,
+  // - 2 = stdio file with background read-ahead
+  u8 cd_stream;
+
+  // Number of cached CD-ROM sectors (0 = no cache, except for compressed
+  // images which are cached by default).
+  u32 cd_cache;
+
   s16 cdda_volume;
   s16 pcm_volume;
 
@@ -104,6 +115,12 @@ struct core_config_t
   // High gain of 3 band equalizer.
   s16 hg;
 
+  // Polyphase resampler:
+  // - 0 = OFF (sound chips are directly resampled to output rate),
+  // - 1 = ON (sound chips are resampled to internal rate, then converted to 
+  //   output rate)
+  u8 resampler;
+
   // Mono output audio mixing:
   // - 0 = OFF,
   // - 1 = ON
@@ -172,6 +189,16 @@ struct core_config_t
   // - 0 = OFF,
   // - 1 = show extended Game Gear screen (256x192)
   u8 gg_extra;
+
+  // Deferred rendering (mode 5):
+  // - 0 = OFF (lines are rendered by the emulation thread),
+  // - N = lines are recorded and rendered by N worker threads
+  u8 render_threads;
+
+  // Rotation / Scaling operation (Mega-CD graphics processor):
+  // - 0 = lines are rendered by the emulation thread,
+  // - N = lines of large operations are fetched by N worker threads
+  u8 gfx_threads;
 };
 
 #endif // #ifndef __CORE_CORE_CONFIG_T_H__
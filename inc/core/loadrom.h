@@ -51,6 +51,7 @@ extern void get_region(char *romheader);
 extern char *get_company(void);
 extern char *get_peripheral(int index);
 extern void getrominfo(char *romheader);
+extern unsigned int getromcrc(void);
 
 #endif /* _LOADROM_H_ */
 
@@ -45,17 +45,32 @@
 #endif
 
 /* Default CD image file access (read-only) functions */
-/* If you need to override default stdio.h functions with custom filesystem API,
-   redefine following macros in platform specific include file (osd.h) or Makefile
+/* Files are opened with the backend selected by core_config.cd_stream (stdio, memory-mapped
+   or background read-ahead, see gpgx/cd/cd_stream.h).
+   If you need to override default functions with custom filesystem API, redefine following
+   macros in platform specific include file (osd.h) or Makefile
 */
 #ifndef cdStream
-#define cdStream            FILE
-#define cdStreamOpen(fname) fopen(fname, "rb")
-#define cdStreamClose       fclose
-#define cdStreamRead        fread
-#define cdStreamSeek        fseek
-#define cdStreamTell        ftell
-#define cdStreamGets        fgets
+#include "gpgx/cd/cd_stream.h"
+#define cdStream                                  gpgx::cd::ICdStream
+#define cdStreamOpen(fname)                       gpgx::cd::OpenCdStream(fname, (gpgx::cd::CdStreamType)core_config.cd_stream)
+#define cdStreamClose(fd)                         gpgx::cd::CloseCdStream(fd)
+#define cdStreamRead(buf, size, count, fd)        (fd)->Read(buf, size, count)
+#define cdStreamSeek(fd, offset, origin)          (fd)->Seek(offset, origin)
+#define cdStreamTell(fd)                          (fd)->Tell()
+#define cdStreamGets(buf, size, fd)               (fd)->Gets(buf, size)
+#define cdStreamReadAt(buf, size, offset, fd)     (fd)->ReadAt(offset, buf, size)
+
+/* CD-DA tracks are read ahead by a worker thread (see gpgx/cd/cdda_decoder.h) */
+#define USE_CDDA_DECODER
+
+/* CD-ROM sectors are cached (see gpgx/cd/sector_cache.h) */
+#define USE_SECTOR_CACHE
+#endif
+
+/* Read bytes at a given position (custom filesystem API without positional read) */
+#ifndef cdStreamReadAt
+#define cdStreamReadAt(buf, size, offset, fd)     (cdStreamSeek(fd, offset, SEEK_SET), cdStreamRead(buf, 1, size, fd))
 #endif
 
 #endif /* _MACROS_H_ */
@@ -60,6 +60,8 @@ struct ROMINFO
   unsigned int romend;          // ROM end address.
   char country[18];             // Country flag.
   u16 peripherals;              // Supported peripherals.
+  unsigned int crc;             // ROM CRC32 (see getromcrc()).
+  u8 crcready;                  // ROM CRC32 has been computed.
 };
 
 //------------------------------------------------------------------------------
@@ -43,6 +43,7 @@
 #define __CORE_SND_H__
 
 #include "gpgx/audio/blip_buffer.h"
+#include "gpgx/audio/polyphase_resampler.h"
 #include "xee/fnd/data_type.h"
 
 //==============================================================================
@@ -51,10 +52,12 @@
 
 typedef struct
 {
-  int sample_rate;      /* Output Sample rate (8000-48000) */
+  int sample_rate;      /* Blip Buffer Sample rate (output sample rate or internal sample rate when resampler is enabled) */
+  int output_rate;      /* Output Sample rate (8000-96000) */
   f64 frame_rate;       /* Output Frame rate (usually 50 or 60 frames per second) */
   int enabled;          /* 1= sound emulation is enabled */
   gpgx::audio::BlipBuffer* blips[3];     /* Blip Buffer resampling (stereo) */
+  gpgx::audio::PolyphaseResampler* resampler; /* Polyphase resampling from internal sample rate to output sample rate (stereo) */
 } t_snd;
 
 //------------------------------------------------------------------------------
@@ -44,9 +44,15 @@
 
 #include "xee/fnd/data_type.h"
 
+/* Background layer state modified during active display (raster effects) */
+#define RASTER_REG    0x01  /* Background layer register */
+#define RASTER_VRAM   0x02  /* VRAM */
+#define RASTER_VSRAM  0x04  /* VSRAM */
+
 /* VDP context */
 extern u8 reg[0x20];
 extern u8 sat[0x400];
+extern u8 sat_dirty;
 extern u8 cram[0x80];
 extern u8 vsram[0x80];
 extern u8 hint_pending;
@@ -62,9 +68,9 @@ extern u16 ntbb;
 extern u16 ntwb;
 extern u16 satb;
 extern u16 hscb;
-extern u8 bg_name_dirty[0x800];
-extern u16 bg_name_list[0x800];
-extern u16 bg_list_index;
+extern u64 bg_dirty_rows[0x100];
+extern u64 bg_dirty_summary[4];
+extern u8 raster_changes;
 extern u8 hscroll_mask;
 extern u8 playfield_shift;
 extern u8 playfield_col_mask;
@@ -48,6 +48,7 @@
 #include "gpgx/ppu/vdp/bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/bg_pattern_cache_updater.h"
 #include "gpgx/ppu/vdp/inv_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/line_change_tracker.h"
 #include "gpgx/ppu/vdp/m0_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m1_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m1x_bg_layer_renderer.h"
@@ -61,10 +62,13 @@
 #include "gpgx/ppu/vdp/m5_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_bg_pattern_cache_updater.h"
 #include "gpgx/ppu/vdp/m5_color_palette_updater.h"
+#include "gpgx/ppu/vdp/m5_deferred_line_renderer.h"
+#include "gpgx/ppu/vdp/m5_frame_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_im2_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_im2_sprite_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_im2_ste_sprite_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_im2_vs_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_line_renderer.h"
 #include "gpgx/ppu/vdp/m5_satb_parser.h"
 #include "gpgx/ppu/vdp/m5_sprite_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_ste_sprite_layer_renderer.h"
@@ -81,6 +85,10 @@ extern u16 spr_col;
 /* Function prototypes */
 extern void render_init(void);
 extern void render_reset(void);
+extern void render_update_mode(void);
+extern void render_flush(void);
+extern void render_end_frame(void);
+extern void render_shutdown(void);
 extern void render_line(int line);
 extern void blank_line(int line, int offset, int width);
 extern void remap_line(int line);
@@ -158,6 +166,27 @@ extern gpgx::ppu::vdp::M5Im2SpriteLayerRenderer* g_sprite_layer_renderer_m5_im2;
 /// Renderer of sprite layer in mode 5 (IM2/STE).
 extern gpgx::ppu::vdp::M5Im2SteSpriteLayerRenderer* g_sprite_layer_renderer_m5_im2_ste;
 
+//------------------------------------------------------------------------------
+// Line rendering.
+
+/// Renderer of background and sprite layers in mode 5 (specialized for the 
+/// current IM2, VS and STE modes by render_update_mode()).
+extern gpgx::ppu::vdp::M5LineRenderer* g_line_renderer_m5;
+
+/// Deferred line renderer in mode 5 (nullptr if lines are rendered by the 
+/// emulation thread).
+extern gpgx::ppu::vdp::M5DeferredLineRenderer* g_deferred_line_renderer_m5;
+
+/// Renderer of background layer in mode 5 by frame (used instead of the line
+/// renderer when the background layer state is not modified during active
+/// display).
+extern gpgx::ppu::vdp::M5FrameBackgroundLayerRenderer* g_frame_bg_layer_renderer_m5;
+
+/// Tracker of the framebuffer lines changed since the previous displayed 
+/// frame (published by render_end_frame(), for presenters and capture 
+/// writers).
+extern gpgx::ppu::vdp::LineChangeTracker* g_line_change_tracker;
+
 //------------------------------------------------------------------------------
 // Sprite attribute table parsing.
 
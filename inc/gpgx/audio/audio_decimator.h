@@ -0,0 +1,58 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_AUDIO_AUDIO_DECIMATOR_H__
+#define __GPGX_AUDIO_AUDIO_DECIMATOR_H__
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::audio {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Stereo sample decimator (fast-forward audio).
+///
+/// Each group of "factor" consecutive input samples is averaged into one
+/// output sample, so that the audio of "factor" emulated frames fits in the
+/// duration of one frame: the audio keeps playing (with a higher pitch)
+/// instead of being muted or overflowing the output buffer. Groups can span
+/// several blocks (the partial sums are kept between calls).
+class AudioDecimator
+{
+public:
+  /// Max. decimation factor.
+  static constexpr s32 kMaxFactor = 16;
+
+public:
+  AudioDecimator();
+
+  /// Set the decimation factor (1 = samples are passed through) and clear the
+  /// partial sums.
+  ///
+  /// @param  factor  The decimation factor (1 to kMaxFactor).
+  void SetFactor(s32 factor);
+
+  /// Get the decimation factor.
+  s32 GetFactor() const;
+
+  /// Decimate interleaved stereo samples in place.
+  ///
+  /// @param  samples The interleaved stereo samples.
+  /// @param  count   The number of input samples (per channel).
+  /// @return The number of output samples (per channel).
+  s32 Process(s16* samples, s32 count);
+
+private:
+  s32 m_factor; /// Decimation factor.
+  s32 m_count; /// Number of samples in the partial sums.
+  s32 m_sum[2]; /// Partial sums of the left (0) and right (1) channels.
+};
+
+} // namespace gpgx::audio
+
+#endif // #ifndef __GPGX_AUDIO_AUDIO_DECIMATOR_H__
@@ -41,6 +41,8 @@
 
 #include "xee/fnd/data_type.h"
 
+#include "core/audio_subsystem.h" // For AUDIO_INTERNAL_RATE.
+
 #include "gpgx/audio/effect/equalizer_3band.h"
 #include "gpgx/audio/effect/fm_synthesizer.h"
 #include "gpgx/ic/ym2413/ym2413.h"
@@ -97,6 +99,9 @@ public:
 
   /**
    * Generate samples to the specified buffer.
+   * 
+   * When the polyphase resampler is enabled, samples are generated at the 
+   * internal rate then converted to the output rate.
    *  
    * @param  output_buffer  The pointer of the buffer to generate samples to.
    * 
@@ -145,6 +150,10 @@ private:
   // (large enough to hold a whole frame at original chips rate)
   int m_fm_buffer[1080 * 2 * 24];
 
+  // The buffer of samples generated at internal rate (when using polyphase resampler).
+  // (large enough to hold the whole blip buffer)
+  s16 m_internal_buffer[(AUDIO_INTERNAL_RATE / 10) * 2];
+
   s16 llp; // Last sample for the left channel (when using low-pass filtering).
   s16 rrp; // Last sample for the right channel (when using low-pass filtering).
 
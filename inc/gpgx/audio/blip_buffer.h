@@ -104,6 +104,13 @@ public:
   // Same as blip_add_delta(), but uses faster, lower-quality synthesis.
   void blip_add_delta_fast(unsigned int clock_time, int delta_l, int delta_r);
 
+  // Adds the deltas of count consecutive stereo samples (one per clock, from
+  // clock_time), relatively to the previous output prev[0] (left) and prev[1]
+  // (right), that are updated with the last sample. Same as calling
+  // blip_add_delta_fast() for each sample.
+  // [Hardware MCD]
+  void blip_add_samples_fast(unsigned int clock_time, const s32* in_l, const s32* in_r, int count, int prev[2]);
+
   // Reads and removes at most 'count' samples and writes them to to every other 
   // element of 'out', allowing easy interleaving of two buffers into a stereo sample 
   // stream. Outputs 16-bit signed samples. Returns number of samples actually read.
@@ -127,6 +134,8 @@ public:
 private:
   void remove_samples(int count);
 
+  void add_delta_fast(u64 time, int delta_l, int delta_r);
+
 private:
   u64 m_factor;
   u64 m_offset;
@@ -50,6 +50,7 @@ namespace gpgx::audio::effect {
 class IFmSynthesizer
 {
 public:
+  virtual ~IFmSynthesizer() = default;
 
   virtual void Reset(int* buffer) = 0;
 
@@ -64,6 +65,10 @@ public:
 
   virtual int SaveContext(unsigned char* state) = 0;
   virtual int LoadContext(unsigned char* state) = 0;
+
+  // Record the registers written since the last reset to the register log
+  // (as register writes), when a log is started while the chip is running.
+  virtual void LogState(unsigned int cycles) = 0;
 };
 
 } // namespace gpgx::audio::effect
@@ -40,7 +40,9 @@
 #ifndef __GPGX_AUDIO_EFFECT_FM_SYNTHESIZER_BASE_H__
 #define __GPGX_AUDIO_EFFECT_FM_SYNTHESIZER_BASE_H__
 
+#include "gpgx/audio/blip_buffer.h"
 #include "gpgx/audio/effect/fm_synthesizer.h"
+#include "gpgx/capture/register_log.h"
 
 namespace gpgx::audio::effect {
 
@@ -55,6 +57,10 @@ public:
 
   void SetClockRatio(int clock_ratio);
 
+  // Set the blip buffer receiving the output (nullptr for the main blip 
+  // buffer of the sound context).
+  void SetBlipBuffer(gpgx::audio::BlipBuffer* blip);
+
   // Implementation of IFmSynthesizer.
 
   void Reset(int* buffer);
@@ -65,12 +71,19 @@ public:
   int SaveContext(unsigned char* state);
   int LoadContext(unsigned char* state);
 
+  void LogState(unsigned int cycles);
+
 protected:
   // Run FM chip until required M-cycles.
   void Update(int cycles);
 
   virtual void UpdateSampleBuffer(int* buffer, int length) = 0;
 
+  // Record a register write (or a reset) to the register log (if any) and to
+  // the copy of the written registers (see LogState()).
+  void LogWrite(gpgx::capture::RegisterLogChip chip, unsigned int cycles, unsigned int address, unsigned int data);
+  void LogReset(unsigned int cycles);
+
   virtual int SaveChipContext(unsigned char* state) = 0;
   virtual int LoadChipContext(unsigned char* state) = 0;
 
@@ -87,6 +100,18 @@ private:
 
   int* m_fm_buffer;
   int* m_fm_ptr; // Buffer current pointer.
+
+  gpgx::audio::BlipBuffer* m_blip; // Output blip buffer (nullptr for snd.blips[0]).
+
+  // Registers written since the last reset (the chips do not keep them in a
+  // raw form). Registers restored from a saved state are not known.
+  gpgx::capture::RegisterLogChip m_log_chip; // Type of the chip.
+  u8 m_log_latch[2];        // Latched register address (per port).
+  u8 m_log_port;            // Port of the last latched register address.
+  u8 m_log_regs[2][256];    // Last value written to each register (per port).
+  u8 m_log_written[2][256]; // The register has been written (per port).
+  u8 m_log_keys[8];         // OPN2 key on/off register ($28) per channel.
+  u8 m_log_keys_written;    // OPN2 channels whose key register has been written (bitmask).
 };
 
 } // namespace gpgx::audio::effect
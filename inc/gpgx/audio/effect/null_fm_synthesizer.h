@@ -65,6 +65,8 @@ public:
 
   int SaveContext(unsigned char* state);
   int LoadContext(unsigned char* state);
+
+  void LogState(unsigned int cycles);
 };
 
 } // namespace gpgx::audio::effect
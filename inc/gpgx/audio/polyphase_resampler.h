@@ -0,0 +1,141 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_AUDIO_POLYPHASE_RESAMPLER_H__
+#define __GPGX_AUDIO_POLYPHASE_RESAMPLER_H__
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::audio {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/**
+ * Stereo polyphase windowed-sinc resampler.
+ *
+ * It converts a 16-bit interleaved stereo stream from an input rate to an
+ * arbitrary output rate. The read position is kept in 32.32 fixed point so
+ * that no error accumulates from one block to the next, and the conversion
+ * ratio can be slightly adjusted at any time (dynamic rate control) without
+ * rebuilding the filter.
+ */
+class PolyphaseResampler
+{
+public:
+  // Number of taps of each phase of the filter (must be a multiple of 4).
+  static constexpr s32 kTapCount = 32;
+
+  // Number of phases of the filter (coefficients between two phases are
+  // linearly interpolated).
+  static constexpr s32 kPhaseBits = 7;
+  static constexpr s32 kPhaseCount = 1 << kPhaseBits;
+
+  // Maximum number of input samples processed at once.
+  static constexpr s32 kMaxBlockSize = 4096;
+
+private:
+  static constexpr s32 kFracBits = 32;
+  static constexpr u64 kFracUnit = (u64)1 << kFracBits;
+
+  // Passband edge (relative to the Nyquist frequency of the lowest rate).
+  static constexpr f64 kPassband = 0.91;
+
+  // Kaiser window beta (about 90 dB of stopband attenuation).
+  static constexpr f64 kKaiserBeta = 8.6;
+
+public:
+  PolyphaseResampler();
+
+  /**
+   * Set the input and output rates.
+   *
+   * The filter is rebuilt (only) when the ratio between both rates changes.
+   * The rate adjustment is reset to 1.0.
+   *
+   * @param  input_rate   The sample rate of the input stream (in Hz).
+   * @param  output_rate  The sample rate of the output stream (in Hz).
+   */
+  void SetRates(f64 input_rate, f64 output_rate);
+
+  /**
+   * Adjust the conversion ratio (dynamic rate control).
+   *
+   * @param  adjustment  The factor applied to the output rate (e.g. 1.005
+   *                     produces 0.5% more output samples). It should stay
+   *                     close to 1.0 since the filter is not rebuilt.
+   */
+  void SetRateAdjustment(f64 adjustment);
+
+  /**
+   * Clear the sample history and the fractional read position.
+   */
+  void Clear();
+
+  /**
+   * Return the maximum number of output samples that can be generated from
+   * the specified number of input samples.
+   */
+  s32 GetMaxOutputSamples(s32 input_count) const;
+
+  /**
+   * Resample stereo samples.
+   *
+   * @param  input          The interleaved stereo input samples.
+   * @param  input_count    The number of input samples (per channel).
+   * @param  output         The buffer receiving interleaved stereo output
+   *                        samples (large enough to hold
+   *                        GetMaxOutputSamples(input_count) samples).
+   *
+   * @return  The number of output samples (per channel).
+   */
+  s32 Process(const s16* input, s32 input_count, s16* output);
+
+private:
+  /**
+   * Build the coefficients of all phases for the current rates.
+   */
+  void BuildFilter();
+
+  /**
+   * Resample the samples currently held in the history buffers.
+   *
+   * @return  The number of output samples (per channel).
+   */
+  s32 ProcessBuffer(s16* output);
+
+  /**
+   * Update the fixed-point step from the rates and the rate adjustment.
+   */
+  void UpdateStep();
+
+private:
+  f64 m_input_rate;
+  f64 m_output_rate;
+  f64 m_adjustment;
+
+  // Ratio used when the filter was last built.
+  f64 m_filter_ratio;
+
+  // Read position and step (32.32 fixed point, in input samples).
+  u64 m_pos;
+  u64 m_step;
+
+  // Number of samples held in the history buffers (per channel).
+  s32 m_count;
+
+  // Filter coefficients (one extra phase for interpolation).
+  alignas(16) f32 m_coeffs[(kPhaseCount + 1) * kTapCount];
+
+  // History buffers for the left channel (index 0) and for the right
+  // channel (index 1).
+  alignas(16) f32 m_history[2][kTapCount + kMaxBlockSize];
+};
+
+} // namespace gpgx::audio
+
+#endif // #ifndef __GPGX_AUDIO_POLYPHASE_RESAMPLER_H__
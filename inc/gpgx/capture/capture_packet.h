@@ -0,0 +1,45 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CAPTURE_CAPTURE_PACKET_H__
+#define __GPGX_CAPTURE_CAPTURE_PACKET_H__
+
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+enum class CapturePacketType : u8
+{
+  kVideo = 0, /// A video frame (packed lines of output pixels).
+  kAudio = 1, /// A block of interleaved stereo 16-bit samples.
+};
+
+//------------------------------------------------------------------------------
+
+/// A block of captured data exchanged between the emulation thread and the 
+/// writer thread.
+/// 
+/// The data buffer is kept allocated when the packet is recycled, so that 
+/// memory is only allocated when a larger block is captured.
+struct CapturePacket
+{
+  CapturePacketType type;
+  s32 width;  /// Width of the video frame (in pixels).
+  s32 height; /// Height of the video frame (in lines).
+  s32 count;  /// Number of audio samples (per channel).
+  std::vector<u8> data;
+  std::vector<u8> lines; /// Changed flags of the video lines (empty if unknown).
+};
+
+} // namespace gpgx::capture
+
+#endif // #ifndef __GPGX_CAPTURE_CAPTURE_PACKET_H__
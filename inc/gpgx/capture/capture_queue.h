@@ -0,0 +1,67 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CAPTURE_CAPTURE_QUEUE_H__
+#define __GPGX_CAPTURE_CAPTURE_QUEUE_H__
+
+#include <atomic>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/capture/capture_packet.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Lock-free single-producer single-consumer queue of capture packets.
+/// 
+/// The producer (emulation thread) acquires a free packet, fills it then 
+/// commits it. The consumer (writer thread) peeks the oldest committed packet,
+/// processes it then releases it. Packets are preallocated and recycled.
+class CaptureQueue
+{
+public:
+  static constexpr u32 kCapacity = 256; /// Number of packets (power of 2).
+
+  CaptureQueue();
+
+  /// Retrieves the next free packet (producer only).
+  /// 
+  /// @return The packet to fill, or nullptr if the queue is full.
+  CapturePacket* Acquire();
+
+  /// Makes the packet retrieved by Acquire() available to the consumer.
+  void Commit();
+
+  /// Retrieves the oldest committed packet (consumer only).
+  /// 
+  /// @return The packet to process, or nullptr if the queue is empty.
+  CapturePacket* Peek();
+
+  /// Recycles the packet retrieved by Peek().
+  void Release();
+
+  /// Indicates whether the queue is empty.
+  bool IsEmpty() const;
+
+private:
+  static constexpr u32 kMask = kCapacity - 1;
+
+  CapturePacket m_packets[kCapacity];
+
+  // Index of the next packet to commit (written by the producer only).
+  alignas(64) std::atomic<u32> m_head;
+
+  // Index of the next packet to release (written by the consumer only).
+  alignas(64) std::atomic<u32> m_tail;
+};
+
+} // namespace gpgx::capture
+
+#endif // #ifndef __GPGX_CAPTURE_CAPTURE_QUEUE_H__
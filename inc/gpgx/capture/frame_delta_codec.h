@@ -0,0 +1,85 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CAPTURE_FRAME_DELTA_CODEC_H__
+#define __GPGX_CAPTURE_FRAME_DELTA_CODEC_H__
+
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "core/vdp/pixel.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Lossless frame-delta codec for output pixels (PIXEL_OUT_T).
+/// 
+/// Each frame is compared with the previous one and encoded as a sequence of
+/// tokens covering all the pixels of the frame (in raster order):
+/// - u16 skip: number of pixels unchanged since the previous frame,
+/// - u16 copy: number of pixels that follow,
+/// - copy pixels.
+/// 
+/// A key frame is encoded against a black frame, it is emitted on the first 
+/// frame, when the frame size changes and every kKeyFrameInterval frames.
+/// 
+/// Frame layout:
+/// - u32 payload size (in bytes),
+/// - u16 width, u16 height,
+/// - u8 flags (kFlagKeyFrame),
+/// - payload (tokens).
+class FrameDeltaCodec
+{
+public:
+  static constexpr u32 kKeyFrameInterval = 300;
+  static constexpr u8 kFlagKeyFrame = 0x01;
+  static constexpr s32 kFrameHeaderSize = 9;
+
+  FrameDeltaCodec();
+
+  /// Resets the reference frame (the next frame is a key frame).
+  void Reset();
+
+  /// Encodes a frame and appends it (header and payload) to the output.
+  /// 
+  /// @param  pixels  The packed pixels of the frame.
+  /// @param  width   The width of the frame.
+  /// @param  height  The height of the frame.
+  /// @param  output  The buffer to append the encoded frame to.
+  /// @param  lines   The changed flags of the lines since the previous frame 
+  ///                 (non-zero when changed), nullptr to compare all lines.
+  ///                 Unchanged lines are skipped without being compared, the
+  ///                 encoded frame is the same.
+  void Encode(const PIXEL_OUT_T* pixels, s32 width, s32 height, std::vector<u8>& output, const u8* lines = nullptr);
+
+  /// Decodes a frame (header and payload) and updates the reference frame.
+  /// 
+  /// @param  data  The encoded frame.
+  /// @param  size  The size of the encoded frame (in bytes).
+  /// @return true if the frame has been decoded, otherwise false (corrupted).
+  bool Decode(const u8* data, s32 size);
+
+  /// Retrieves the packed pixels of the reference frame (last encoded or 
+  /// decoded frame).
+  const PIXEL_OUT_T* GetFrame() const { return m_frame.data(); }
+
+  s32 GetWidth() const { return m_width; }
+  s32 GetHeight() const { return m_height; }
+
+private:
+  std::vector<PIXEL_OUT_T> m_frame; /// The reference frame.
+  s32 m_width;
+  s32 m_height;
+  u32 m_frame_count; /// Number of frames since the last key frame.
+};
+
+} // namespace gpgx::capture
+
+#endif // #ifndef __GPGX_CAPTURE_FRAME_DELTA_CODEC_H__
@@ -0,0 +1,130 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CAPTURE_RECORDER_H__
+#define __GPGX_CAPTURE_RECORDER_H__
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/capture/capture_packet.h"
+#include "gpgx/capture/capture_queue.h"
+#include "gpgx/capture/frame_delta_codec.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+enum class VideoFormat : u8
+{
+  kNone = 0,  /// No video capture.
+  kRaw = 1,   /// Raw RGB24 frames (.rgb).
+  kY4m = 2,   /// YUV4MPEG2 4:4:4 (.y4m).
+  kDelta = 3, /// Lossless frame-delta codec (.vfd).
+};
+
+//------------------------------------------------------------------------------
+
+/// Audio and video recorder.
+/// 
+/// Frames and audio blocks are copied into a lock-free queue by the emulation
+/// thread and written (encoded) to disk by a background writer thread, so 
+/// that no file I/O or encoding happens on the emulation thread.
+/// 
+/// Audio is written to "<path>.wav", video to "<path>.rgb", "<path>.y4m" or 
+/// "<path>.vfd". Raw and Y4M streams keep the size of the first frame (frames 
+/// of a different size are cropped or padded with black).
+class Recorder
+{
+public:
+  Recorder();
+  ~Recorder();
+
+  /// Starts recording.
+  /// 
+  /// @param  path          The path of the files to create (without extension).
+  /// @param  video_format  The format of the video stream.
+  /// @param  audio         true to record the audio stream.
+  /// @param  sample_rate   The sample rate of the audio stream (in Hz).
+  /// @param  frame_rate    The frame rate of the video stream (in frames per second).
+  /// @return true if recording has started, otherwise false.
+  bool Start(const char* path, VideoFormat video_format, bool audio, s32 sample_rate, f64 frame_rate);
+
+  /// Stops recording (pending packets are written before returning).
+  void Stop();
+
+  bool IsRecording() const { return m_recording; }
+
+  /// Queues a video frame (emulation thread).
+  /// 
+  /// @param  data    The pointer of the first pixel of the frame.
+  /// @param  width   The width of the frame (in pixels).
+  /// @param  height  The height of the frame (in lines).
+  /// @param  pitch   The number of bytes between two lines.
+  /// @param  lines   The changed flags of the lines since the previous frame
+  ///                 (non-zero when changed), nullptr if unknown.
+  void PushVideoFrame(const u8* data, s32 width, s32 height, s32 pitch, const u8* lines = nullptr);
+
+  /// Queues a block of audio samples (emulation thread).
+  /// 
+  /// @param  samples The interleaved stereo samples.
+  /// @param  count   The number of samples (per channel).
+  void PushAudioSamples(const s16* samples, s32 count);
+
+  /// Retrieves the number of times the emulation thread had to wait for the 
+  /// writer thread (queue full).
+  u32 GetStallCount() const { return m_stalls.load(std::memory_order_relaxed); }
+
+private:
+  /// Retrieves a free packet, waiting for the writer thread if necessary.
+  CapturePacket* AcquirePacket();
+
+  /// Writer thread main loop.
+  void Run();
+
+  void WriteVideoFrame(const CapturePacket& packet);
+  void WriteAudioBlock(const CapturePacket& packet);
+
+  /// Writes (or rewrites) the header of the WAV file.
+  void WriteWavHeader();
+
+  /// Crops or pads the packet frame to the size of the first frame and 
+  /// converts it to RGB24 (into m_rgb).
+  void ConvertFrame(const CapturePacket& packet);
+
+private:
+  CaptureQueue m_queue;
+  std::thread m_thread;
+  std::atomic<bool> m_stop;
+  std::atomic<u32> m_stalls;
+  bool m_recording;
+
+  VideoFormat m_video_format;
+  FILE* m_video_file;
+  FILE* m_audio_file;
+
+  s32 m_sample_rate;
+  f64 m_frame_rate;
+  u32 m_audio_size;   /// Number of bytes of audio data written.
+
+  s32 m_video_width;  /// Width of the first frame (raw and Y4M).
+  s32 m_video_height; /// Height of the first frame (raw and Y4M).
+
+  FrameDeltaCodec m_codec;
+  std::vector<u8> m_encoded;
+  std::vector<u8> m_rgb;
+  std::vector<u8> m_yuv;
+};
+
+} // namespace gpgx::capture
+
+#endif // #ifndef __GPGX_CAPTURE_RECORDER_H__
@@ -0,0 +1,93 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CAPTURE_REGISTER_LOG_H__
+#define __GPGX_CAPTURE_REGISTER_LOG_H__
+
+#include <cstdio>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Type of a sound chip write stream.
+enum class RegisterLogChip : u8
+{
+  kOpn2 = 0, /// YM2612 / YM3438 (address 0 to 3).
+  kOpll = 1, /// YM2413 (address 0 to 1).
+};
+
+//------------------------------------------------------------------------------
+
+/// Type of an event of a register log.
+/// 
+/// A log starts with a 16-byte header ("VRL1", u32 master clock, u8 PSG type, 
+/// 7 reserved bytes) followed by events. Each event starts with an opcode. 
+/// Except for kEndFrame (followed by the frame length), the opcode is followed
+/// by the difference between the timestamp of the event and the timestamp of 
+/// the previous event of the frame (zigzag encoded variable-length integer), 
+/// then by the written value (one byte).
+enum class RegisterLogEvent : u8
+{
+  kEndFrame = 0x00,  /// End of frame (timestamps restart from 0).
+  kFmReset = 0x01,   /// FM chip reset.
+  kOpn2Write = 0x10, /// OPN2 register write (address in bits 0-1).
+  kOpllWrite = 0x14, /// OPLL register write (address in bit 0).
+  kPsgWrite = 0x20,  /// PSG register write.
+  kPsgConfig = 0x21, /// PSG stereo configuration (panning).
+  kPsgPreamp = 0x22, /// PSG pre-amplification (in %, up to 255), applied by the next kPsgConfig.
+};
+
+//------------------------------------------------------------------------------
+
+/// Records sound chip register writes (with their timestamp in M-cycles) to a 
+/// compact binary log, that can be rendered again offline.
+class RegisterLogWriter
+{
+public:
+  static constexpr u32 kMagic = 0x314C5256; /// "VRL1".
+  static constexpr s32 kHeaderSize = 16;
+
+  RegisterLogWriter();
+  ~RegisterLogWriter();
+
+  /// Creates the log file.
+  /// 
+  /// @param  path      The path of the file.
+  /// @param  clock     The master clock (in Hz).
+  /// @param  psg_type  The type of the PSG (PSG_DISCRETE or PSG_INTEGRATED).
+  /// @return true on success, otherwise false.
+  bool Open(const char* path, u32 clock, u8 psg_type);
+
+  /// Flushes pending events and closes the log file.
+  void Close();
+
+  void LogFmWrite(RegisterLogChip chip, u32 cycles, u32 address, u32 data);
+  void LogFmReset(u32 cycles);
+  void LogPsgWrite(u32 cycles, u32 data);
+  void LogPsgConfig(u32 cycles, u32 preamp, u32 panning);
+  void LogEndFrame(u32 cycles);
+
+private:
+  void LogEvent(u8 opcode, u32 cycles, u32 data);
+  void WriteVarint(u32 value);
+
+private:
+  static constexpr size_t kFlushSize = 64 * 1024;
+
+  FILE* m_file;
+  std::vector<u8> m_buffer; // Pending events.
+  u32 m_last_cycles;        // Timestamp of the previous event of the frame.
+};
+
+} // namespace gpgx::capture
+
+#endif // #ifndef __GPGX_CAPTURE_REGISTER_LOG_H__
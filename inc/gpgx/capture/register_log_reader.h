@@ -0,0 +1,71 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CAPTURE_REGISTER_LOG_READER_H__
+#define __GPGX_CAPTURE_REGISTER_LOG_READER_H__
+
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/capture/register_log.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Event decoded from a register log.
+struct RegisterLogEntry
+{
+  RegisterLogEvent event; /// The type of the event.
+  u32 cycles;             /// The timestamp (or the frame length for kEndFrame).
+  u8 address;             /// The register address (kOpn2Write and kOpllWrite).
+  u8 data;                /// The written value.
+};
+
+//------------------------------------------------------------------------------
+
+/// Reads a register log created by RegisterLogWriter.
+/// 
+/// The whole log is loaded in memory, so that several readers (one per 
+/// rendering thread) can be created from the same file.
+class RegisterLogReader
+{
+public:
+  RegisterLogReader();
+
+  /// Loads a log file.
+  /// 
+  /// @return true on success, otherwise false (file not found, invalid header).
+  bool Open(const char* path);
+
+  u32 GetClock() const { return m_clock; }
+  u8 GetPsgType() const { return m_psg_type; }
+
+  /// Restarts reading from the first event.
+  void Rewind();
+
+  /// Decodes the next event.
+  /// 
+  /// @return false at the end of the log.
+  bool Next(RegisterLogEntry& entry);
+
+private:
+  bool ReadVarint(u32& value);
+
+private:
+  std::vector<u8> m_data;
+  size_t m_pos;
+  u32 m_clock;
+  u8 m_psg_type;
+  u32 m_last_cycles; // Timestamp of the previous event of the frame.
+};
+
+} // namespace gpgx::capture
+
+#endif // #ifndef __GPGX_CAPTURE_REGISTER_LOG_READER_H__
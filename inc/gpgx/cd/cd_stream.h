@@ -0,0 +1,106 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_CD_STREAM_H__
+#define __GPGX_CD_CD_STREAM_H__
+
+#include <cstddef>
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Backend of CD image file access.
+enum class CdStreamType : u8
+{
+  kFile = 0,      /// Buffered stdio file (FILE).
+  kMapped = 1,    /// Memory-mapped file.
+  kReadAhead = 2, /// Buffered file with a background read-ahead thread.
+};
+
+//------------------------------------------------------------------------------
+
+/// Interface for a read-only CD image file stream.
+///
+/// The functions have the semantics of their stdio counterparts (fread(),
+/// fseek(), ftell() and fgets()), so that a stream can replace a FILE in the
+/// CD image file parsers.
+class ICdStream
+{
+public:
+  virtual ~ICdStream() {}
+
+  /// Read items from the current position (see fread()).
+  ///
+  /// @param  dst   The destination buffer.
+  /// @param  size  The size of an item (in bytes).
+  /// @param  count The number of items.
+  /// @return The number of complete items read.
+  virtual size_t Read(void* dst, size_t size, size_t count) = 0;
+
+  /// Set the current position (see fseek()).
+  ///
+  /// @param  offset  The offset (in bytes).
+  /// @param  origin  SEEK_SET, SEEK_CUR or SEEK_END.
+  /// @return 0 on success, otherwise non-zero.
+  virtual s32 Seek(s64 offset, s32 origin) = 0;
+
+  /// Get the current position (see ftell()).
+  virtual s64 Tell() = 0;
+
+  /// Read a line of text (see fgets()).
+  ///
+  /// @param  dst   The destination buffer.
+  /// @param  size  The size of the destination buffer.
+  /// @return dst on success, nullptr at the end of the stream.
+  virtual char* Gets(char* dst, s32 size) = 0;
+
+  /// Read bytes at a given position (the current position is moved after
+  /// the bytes read).
+  ///
+  /// @param  offset  The position (in bytes).
+  /// @param  dst     The destination buffer.
+  /// @param  size    The number of bytes.
+  /// @return The number of bytes read.
+  virtual size_t ReadAt(s64 offset, void* dst, size_t size);
+
+  /// Open another stream on the same file, with its own position (e.g. to be
+  /// read by another thread).
+  ///
+  /// @return The stream, nullptr if it cannot be opened.
+  virtual ICdStream* Clone() = 0;
+
+  /// Check if reading the stream is expensive (e.g. decompression), so that
+  /// sectors read again are worth caching (see SectorCache).
+  virtual bool HasExpensiveReads() const { return false; }
+};
+
+//------------------------------------------------------------------------------
+
+/// Open a CD image file.
+///
+/// The stdio backend is used when the requested backend cannot open the file
+/// (e.g. empty file that cannot be mapped). A compressed disc image is
+/// detected from its header and decompressed by the stream (see
+/// CompressedCdStream).
+///
+/// @param  path  The path of the file.
+/// @param  type  The requested backend.
+/// @return The stream, nullptr if the file cannot be opened.
+ICdStream* OpenCdStream(const char* path, CdStreamType type);
+
+/// Close a CD image file.
+///
+/// @param  stream  The stream.
+void CloseCdStream(ICdStream* stream);
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_CD_STREAM_H__
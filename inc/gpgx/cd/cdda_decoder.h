@@ -0,0 +1,110 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_CDDA_DECODER_H__
+#define __GPGX_CD_CDDA_DECODER_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/cd/cd_stream.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Decoder of CD-DA tracks running on a worker thread.
+///
+/// The worker reads (and decompresses, see CompressedCdStream) the audio
+/// blocks following the current position of the audio track into a ring
+/// buffer, through its own stream on the track file (see ICdStream::Clone()),
+/// so that the emulation thread only copies PCM samples from the buffer and
+/// never waits for the file, except after a seek.
+///
+/// The emulation thread reads the track file itself when it cannot be opened
+/// by the worker.
+class CddaDecoder
+{
+public:
+  /// Size of the ring buffer (75 blocks of 2352 bytes, 1 second).
+  static constexpr s32 kBufferSize = 2352 * 75;
+
+  /// Max. size read from the track file at once (8 blocks).
+  static constexpr s32 kChunkSize = 2352 * 8;
+
+public:
+  CddaDecoder();
+  ~CddaDecoder();
+
+  /// Start the worker thread.
+  void Open();
+
+  /// Stop the worker thread and close the streams of the worker (must be
+  /// called before the track files are closed).
+  void Close();
+
+  /// Set the current position.
+  ///
+  /// @param  stream  The stream of the track file.
+  /// @param  offset  The position in the file (in bytes).
+  void Seek(ICdStream* stream, s64 offset);
+
+  /// Get the current position in the track file (in bytes).
+  s64 Tell();
+
+  /// Read PCM data from the current position.
+  ///
+  /// @param  dst   The destination buffer.
+  /// @param  size  The number of bytes.
+  /// @return The number of bytes read (less than size at the end of the
+  ///         file).
+  size_t Read(void* dst, size_t size);
+
+private:
+  /// Stream of the worker on a track file.
+  struct WorkerStream
+  {
+    ICdStream* source; /// Stream of the emulation thread.
+    ICdStream* stream; /// Stream of the worker (nullptr if not supported).
+  };
+
+private:
+  /// Get the stream of the worker on a track file (opened when not found).
+  ICdStream* GetWorkerStream(ICdStream* source);
+
+  void CloseWorkerStreams();
+
+  void Run();
+
+private:
+  std::vector<u8> m_buffer; /// Ring buffer.
+  s32 m_read_index; /// Position of the next byte to read in the buffer.
+  s32 m_fill; /// Number of bytes available in the buffer.
+
+  ICdStream* m_source; /// Stream of the current track file.
+  s64 m_offset; /// Position of the next byte to read in the file.
+  u32 m_generation; /// Incremented on each seek (discards pending reads).
+  bool m_end; /// The end of the file has been buffered.
+  bool m_failed; /// The worker cannot read the file.
+
+  std::vector<WorkerStream> m_streams; /// Streams of the worker.
+
+  std::thread m_worker;
+  std::mutex m_mutex;
+  std::condition_variable m_worker_cv; /// Signals the worker.
+  std::condition_variable m_reader_cv; /// Signals the emulation thread.
+  bool m_stop;
+};
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_CDDA_DECODER_H__
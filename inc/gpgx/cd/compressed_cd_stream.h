@@ -0,0 +1,112 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_COMPRESSED_CD_STREAM_H__
+#define __GPGX_CD_COMPRESSED_CD_STREAM_H__
+
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/cd/cd_stream.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// CD image file stream on a compressed disc image file (.cdz).
+///
+/// A compressed disc image stores an image file (BIN track, ISO, WAV) as
+/// hunks of kHunkSize bytes compressed independently (see HunkCodec), so that
+/// any position can be read by decompressing a single hunk. The stream
+/// presents the original file: it is transparent for the CD image parsers.
+///
+/// File layout (little-endian):
+/// - header (kHeaderSize bytes): "VCDZ", u16 version, u16 reserved, u32 hunk
+///   size, u32 hunk count, u64 size of the original file,
+/// - index (kIndexEntrySize bytes per hunk): u64 offset, u32 size of the
+///   stored hunk (a hunk stored with its original size is not compressed),
+/// - hunks.
+///
+/// The last decompressed hunks are kept in a LRU cache (kCacheSize hunks),
+/// sequential reads decompress each hunk once.
+class CompressedCdStream final : public ICdStream
+{
+public:
+  static constexpr u32 kMagic = 0x5A444356; // "VCDZ".
+  static constexpr u16 kVersion = 1;
+  static constexpr s32 kHeaderSize = 24;
+  static constexpr s32 kIndexEntrySize = 12;
+
+  /// Default hunk size (8 sectors of 2352 bytes).
+  static constexpr u32 kHunkSize = 2352 * 8;
+
+  /// Max. hunk size.
+  static constexpr u32 kMaxHunkSize = 1024 * 1024;
+
+  /// Number of cached hunks.
+  static constexpr s32 kCacheSize = 8;
+
+public:
+  CompressedCdStream();
+  ~CompressedCdStream();
+
+  /// Check if a stream is a compressed disc image (the current position is
+  /// reset to the start of the stream).
+  ///
+  /// @param  source  The stream.
+  static bool IsCompressed(ICdStream* source);
+
+  /// Open a compressed disc image.
+  ///
+  /// @param  source  The stream of the compressed disc image (closed with
+  ///                 this stream).
+  /// @return true if the image has been opened, otherwise false.
+  bool Open(ICdStream* source);
+
+  size_t Read(void* dst, size_t size, size_t count) override;
+  s32 Seek(s64 offset, s32 origin) override;
+  s64 Tell() override;
+  char* Gets(char* dst, s32 size) override;
+  ICdStream* Clone() override;
+  bool HasExpensiveReads() const override { return true; }
+
+private:
+  struct CachedHunk
+  {
+    s64 index; /// Index of the hunk (-1 if empty).
+    u32 stamp; /// Last access.
+    std::vector<u8> data;
+  };
+
+private:
+  /// Get the decompressed data of a hunk.
+  ///
+  /// @param  index The index of the hunk.
+  /// @return The data, nullptr if the hunk cannot be read (corrupted).
+  const u8* GetHunk(u32 index);
+
+private:
+  ICdStream* m_source; /// Compressed disc image.
+
+  u32 m_hunk_size; /// Size of a hunk (in bytes).
+  u32 m_hunk_count; /// Number of hunks.
+  s64 m_size; /// Size of the original file (in bytes).
+  s64 m_position; /// Current position in the original file.
+
+  std::vector<u64> m_offsets; /// Offset of each hunk in the image.
+  std::vector<u32> m_sizes; /// Stored size of each hunk.
+  std::vector<u8> m_buffer; /// Stored hunk.
+
+  CachedHunk m_cache[kCacheSize]; /// Decompressed hunks.
+  u32 m_stamp; /// Access counter.
+};
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_COMPRESSED_CD_STREAM_H__
@@ -0,0 +1,51 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_COMPRESSED_CD_WRITER_H__
+#define __GPGX_CD_COMPRESSED_CD_WRITER_H__
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Writer of compressed disc image files (see CompressedCdStream).
+class CompressedCdWriter
+{
+public:
+  CompressedCdWriter();
+
+  /// Set the hunk size.
+  ///
+  /// @param  hunk_size The hunk size (in bytes, up to
+  ///                   CompressedCdStream::kMaxHunkSize).
+  void SetHunkSize(u32 hunk_size);
+
+  /// Compress an image file.
+  ///
+  /// @param  src_path  The path of the image file.
+  /// @param  dst_path  The path of the compressed disc image file.
+  /// @return true if the file has been written, otherwise false.
+  bool Write(const char* src_path, const char* dst_path);
+
+  /// Get the size of the last compressed file (in bytes).
+  s64 GetInputSize() const { return m_input_size; }
+
+  /// Get the size of the last compressed disc image file (in bytes).
+  s64 GetOutputSize() const { return m_output_size; }
+
+private:
+  u32 m_hunk_size;
+  s64 m_input_size;
+  s64 m_output_size;
+};
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_COMPRESSED_CD_WRITER_H__
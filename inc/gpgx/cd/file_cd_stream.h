@@ -0,0 +1,49 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_FILE_CD_STREAM_H__
+#define __GPGX_CD_FILE_CD_STREAM_H__
+
+#include <cstdio>
+#include <string>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/cd/cd_stream.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// CD image file stream on a buffered stdio file (FILE).
+class FileCdStream final : public ICdStream
+{
+public:
+  FileCdStream();
+  ~FileCdStream();
+
+  /// Open a file.
+  ///
+  /// @param  path  The path of the file.
+  /// @return true if the file has been opened, otherwise false.
+  bool Open(const char* path);
+
+  size_t Read(void* dst, size_t size, size_t count) override;
+  s32 Seek(s64 offset, s32 origin) override;
+  s64 Tell() override;
+  char* Gets(char* dst, s32 size) override;
+  ICdStream* Clone() override;
+
+private:
+  FILE* m_file;
+  std::string m_path; /// Path of the file (see Clone()).
+};
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_FILE_CD_STREAM_H__
@@ -0,0 +1,66 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_HUNK_CODEC_H__
+#define __GPGX_CD_HUNK_CODEC_H__
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Lossless LZ77 codec for the hunks of a compressed disc image.
+///
+/// A compressed hunk is a sequence of:
+/// - u8 token: number of literals (high nibble) and match length minus
+///   kMinMatch (low nibble), a nibble of 15 is followed by extension bytes
+///   (added until a byte is not 255),
+/// - literals,
+/// - u16 match offset (little-endian, 1 to 65535), absent after the literals
+///   of the last sequence.
+///
+/// Matches are searched with a single-entry hash table (greedy parsing): the
+/// compression is fast and the decompression is a loop of copies.
+class HunkCodec
+{
+public:
+  /// Min. match length.
+  static constexpr s32 kMinMatch = 4;
+
+  /// Max. match offset.
+  static constexpr s32 kMaxOffset = 0xFFFF;
+
+public:
+  /// Get the max. size of the compressed data (incompressible data).
+  ///
+  /// @param  size  The size of the data.
+  static s32 GetMaxCompressedSize(s32 size) { return size + (size / 255) + 16; }
+
+  /// Compress data.
+  ///
+  /// @param  src       The data.
+  /// @param  size      The size of the data (in bytes).
+  /// @param  dst       The compressed data (GetMaxCompressedSize() bytes).
+  /// @return The size of the compressed data.
+  static s32 Compress(const u8* src, s32 size, u8* dst);
+
+  /// Decompress data.
+  ///
+  /// @param  src       The compressed data.
+  /// @param  size      The size of the compressed data (in bytes).
+  /// @param  dst       The data.
+  /// @param  dst_size  The size of the data (in bytes).
+  /// @return true if the data has been decompressed, otherwise false
+  ///         (corrupted data).
+  static bool Decompress(const u8* src, s32 size, u8* dst, s32 dst_size);
+};
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_HUNK_CODEC_H__
@@ -0,0 +1,63 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_MAPPED_CD_STREAM_H__
+#define __GPGX_CD_MAPPED_CD_STREAM_H__
+
+#include <string>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/cd/cd_stream.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// CD image file stream on a memory-mapped file.
+///
+/// The whole file is mapped read-only: a read is a copy from the mapping
+/// (no system call, no intermediate stdio buffer) and the pages are loaded
+/// and cached by the operating system.
+class MappedCdStream final : public ICdStream
+{
+public:
+  MappedCdStream();
+  ~MappedCdStream();
+
+  /// Map a file.
+  ///
+  /// @param  path  The path of the file.
+  /// @return true if the file has been mapped, otherwise false.
+  bool Open(const char* path);
+
+  size_t Read(void* dst, size_t size, size_t count) override;
+  s32 Seek(s64 offset, s32 origin) override;
+  s64 Tell() override;
+  char* Gets(char* dst, s32 size) override;
+  size_t ReadAt(s64 offset, void* dst, size_t size) override;
+  ICdStream* Clone() override;
+
+private:
+  void Close();
+
+private:
+  const u8* m_data; /// Mapped file.
+  s64 m_size; /// Size of the file (in bytes).
+  s64 m_position; /// Current position.
+  std::string m_path; /// Path of the file (see Clone()).
+
+#if defined(_WIN32)
+  void* m_file; /// File handle.
+  void* m_mapping; /// File mapping handle.
+#endif // #if defined(_WIN32)
+};
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_MAPPED_CD_STREAM_H__
@@ -0,0 +1,109 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_READ_AHEAD_CD_STREAM_H__
+#define __GPGX_CD_READ_AHEAD_CD_STREAM_H__
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/cd/cd_stream.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// CD image file stream with a background read-ahead thread.
+///
+/// The file is divided into blocks of kBlockSize bytes. After each read, the
+/// blocks following the current position (kBlockCount - 1 blocks ahead) are
+/// requested and loaded by a worker thread with its own file handle, so that
+/// the sequential reads of the emulation thread (data track sectors, CD-DA
+/// samples) are copies from memory. A read outside the loaded blocks falls
+/// back to a synchronous read (seek, new track) and moves the read-ahead
+/// window.
+class ReadAheadCdStream final : public ICdStream
+{
+public:
+  /// Size of a block (in bytes, multiple of the 2352-byte sector size).
+  static constexpr s32 kBlockSize = 2352 * 32;
+
+  /// Number of blocks (current block and blocks read ahead).
+  static constexpr s32 kBlockCount = 8;
+
+public:
+  ReadAheadCdStream();
+  ~ReadAheadCdStream();
+
+  /// Open a file and start the worker thread.
+  ///
+  /// @param  path  The path of the file.
+  /// @return true if the file has been opened, otherwise false.
+  bool Open(const char* path);
+
+  size_t Read(void* dst, size_t size, size_t count) override;
+  s32 Seek(s64 offset, s32 origin) override;
+  s64 Tell() override;
+  char* Gets(char* dst, s32 size) override;
+  ICdStream* Clone() override;
+
+private:
+  enum class BlockState : u8
+  {
+    kEmpty = 0,   /// No data.
+    kQueued = 1,  /// Requested, waiting for the worker.
+    kLoading = 2, /// Being read by the worker.
+    kReady = 3,   /// Data available.
+  };
+
+  struct Block
+  {
+    s64 offset; /// Position of the first byte in the file.
+    s32 size; /// Number of bytes (less than kBlockSize at the end of the file).
+    BlockState state;
+    std::vector<u8> data;
+  };
+
+private:
+  void Close();
+
+  /// Copy bytes from the loaded blocks.
+  ///
+  /// @return The number of bytes copied (from the current position, stops at
+  /// the first byte that is not loaded).
+  size_t CopyFromBlocks(u8* dst, size_t size);
+
+  /// Request the blocks of the read-ahead window of the current position.
+  void RequestBlocks();
+
+  void Run();
+
+private:
+  FILE* m_file; /// File handle of the emulation thread (synchronous reads).
+  FILE* m_worker_file; /// File handle of the worker thread.
+  s64 m_size; /// Size of the file (in bytes).
+  s64 m_position; /// Current position.
+  std::string m_path; /// Path of the file (see Clone()).
+
+  Block m_blocks[kBlockCount];
+
+  std::thread m_worker;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop;
+};
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_READ_AHEAD_CD_STREAM_H__
@@ -0,0 +1,95 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_CD_SECTOR_CACHE_H__
+#define __GPGX_CD_SECTOR_CACHE_H__
+
+#include <unordered_map>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/cd/cd_stream.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// LRU cache of the sectors of a CD image file, keyed by LBA.
+///
+/// Plain image files are already cached by the operating system, the cache
+/// mostly helps streams with an expensive read (e.g. compressed images, see
+/// CompressedCdStream) on sectors read again. A cache is not thread-safe.
+class SectorCache
+{
+public:
+  /// Max. size of a sector (in bytes).
+  static constexpr s32 kMaxSectorSize = 2352;
+
+  /// Counters.
+  struct Stats
+  {
+    u64 hits; /// Number of sectors read from the cache.
+    u64 misses; /// Number of sectors read from the file.
+    u64 bytes_read; /// Number of bytes read from the file.
+  };
+
+public:
+  /// @param  sector_size   The size of a sector in the file (2048 or 2352).
+  /// @param  capacity      The number of cached sectors.
+  SectorCache(s32 sector_size, u32 capacity);
+
+  /// Read a sector.
+  ///
+  /// @param  stream  The stream of the file (read on cache miss).
+  /// @param  lba     The logical block address of the sector in the file.
+  /// @param  dst     The destination buffer (sector size bytes, cleared
+  ///                 after the end of the file).
+  void Read(ICdStream* stream, s32 lba, u8* dst);
+
+  /// Get the size of a sector (in bytes).
+  s32 GetSectorSize() const { return m_sector_size; }
+
+  /// Get the counters.
+  Stats GetStats() const { return m_stats; }
+
+  /// Reset the counters.
+  void ResetStats();
+
+private:
+  static constexpr u32 kNone = 0xFFFFFFFF;
+
+  /// Cached sector (entry of the LRU list).
+  struct Entry
+  {
+    s32 lba;
+    u32 prev; /// Previous entry (most recently used), kNone if first.
+    u32 next; /// Next entry (least recently used), kNone if last.
+  };
+
+private:
+  void Unlink(u32 index);
+  void PushFront(u32 index);
+
+private:
+  s32 m_sector_size; /// Size of a sector (in bytes).
+  u32 m_capacity; /// Number of cached sectors.
+  u32 m_count; /// Number of used entries.
+
+  std::vector<u8> m_data; /// Sectors data.
+  std::vector<Entry> m_entries;
+  std::unordered_map<s32, u32> m_index; /// Entry of each cached LBA.
+  u32 m_first; /// Most recently used entry.
+  u32 m_last; /// Least recently used entry.
+
+  Stats m_stats;
+};
+
+} // namespace gpgx::cd
+
+#endif // #ifndef __GPGX_CD_SECTOR_CACHE_H__
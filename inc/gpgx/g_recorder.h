@@ -0,0 +1,23 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_G_RECORDER_H__
+#define __GPGX_G_RECORDER_H__
+
+#include "gpgx/capture/recorder.h"
+
+namespace gpgx {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+// The active recorder (nullptr when not recording).
+extern gpgx::capture::Recorder* g_recorder;
+
+} // namespace gpgx
+
+#endif // #ifndef __GPGX_G_RECORDER_H__
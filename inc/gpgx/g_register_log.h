@@ -0,0 +1,23 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_G_REGISTER_LOG_H__
+#define __GPGX_G_REGISTER_LOG_H__
+
+#include "gpgx/capture/register_log.h"
+
+namespace gpgx {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+// The active register log (nullptr when not logging).
+extern gpgx::capture::RegisterLogWriter* g_register_log;
+
+} // namespace gpgx
+
+#endif // #ifndef __GPGX_G_REGISTER_LOG_H__
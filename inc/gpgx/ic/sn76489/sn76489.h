@@ -44,6 +44,7 @@
 
 #include "xee/fnd/data_type.h"
 
+#include "gpgx/audio/blip_buffer.h"
 #include "gpgx/ic/sn76489/sn76489_type.h"
 
 namespace gpgx::ic::sn76489 {
@@ -64,6 +65,14 @@ private:
   // with 1.5x amplification of PSG output).
   static constexpr s32 kMaxVolume = 2800;
 
+  // Number of internal clock ticks averaged into one sample when the high 
+  // quality PSG is OFF (internal clock : 4 = ~56 kHz).
+  static constexpr s32 kSampleTicks = 4;
+
+  // Size of the sample buffer (large enough to hold a whole PAL frame at 
+  // internal clock rate).
+  static constexpr s32 kSampleBufferSize = 4608;
+
   static const u8 noiseShiftWidth[2];
   static const u8 noiseBitMask[2];
   static const u8 noiseFeedback[10];
@@ -81,9 +90,27 @@ public:
   void psg_config(unsigned int clocks, unsigned int preamp, unsigned int panning);
   void psg_end_frame(unsigned int clocks);
 
+  // Record the current configuration and registers to the register log (as 
+  // register writes), when a log is started while the chip is running.
+  void psg_log_state(unsigned int clocks);
+
+  // Set the blip buffer receiving the output (nullptr for the main blip 
+  // buffer of the sound context).
+  void psg_set_blip_buffer(gpgx::audio::BlipBuffer* blip) { m_blip = blip; }
+
 private:
   void psg_update(unsigned int clocks);
 
+  // Add a variation of the mixed channels output at the specified timestamp,
+  // either to the blip buffer (high quality PSG ON) or to the sample buffer.
+  void psg_add_delta(int timestamp, int delta_l, int delta_r);
+
+  // Render the sample buffer until the specified timestamp to the blip buffer.
+  void psg_flush_samples(unsigned int clocks);
+
+  // Return the blip buffer receiving the output.
+  gpgx::audio::BlipBuffer* psg_blip_buffer() const;
+
 private:
   int m_clocks;
   int m_latch;
@@ -98,6 +125,16 @@ private:
   int m_chanDelta[4][2];
   int m_chanOut[4][2];
   int m_chanAmp[4][2];
+  unsigned int m_preamp;  // Pre-amplification (see psg_config()).
+  unsigned int m_panning; // Stereo panning (see psg_config()).
+
+  // Sample buffer (used when high quality PSG is OFF).
+  int m_tickOrigin;     // Timestamp of the first internal clock tick of the frame.
+  int m_sampleLevel[2]; // Mixed channels output at the start of the frame.
+  int m_sampleLast[2];  // Last sample rendered to the blip buffer.
+  int m_sampleDelta[2][kSampleBufferSize]; // Mixed channels output variations (per internal clock tick).
+
+  gpgx::audio::BlipBuffer* m_blip; // Output blip buffer (nullptr for snd.blips[0]).
 };
 
 } // namespace gpgx::ic::sn76489
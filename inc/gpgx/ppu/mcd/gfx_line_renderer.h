@@ -0,0 +1,140 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_MCD_GFX_LINE_RENDERER_H__
+#define __GPGX_PPU_MCD_GFX_LINE_RENDERER_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::ppu::mcd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Parameters of a graphics operation (rotation/scaling, see gfx_start()).
+struct GfxOperation
+{
+  const u16* map; /// Stamp map table base address.
+  u32 dot_mask; /// Stamp map size mask.
+  u16 buffer_offset; /// Image buffer column offset.
+  u8 stamp_shift; /// Stamp pixel shift value.
+  u8 map_shift; /// Stamp map table shift value.
+  u8 stamp_size; /// 1 if stamps are 32x32 pixels, 0 if 16x16 pixels.
+  u8 repeat; /// 1 if the stamp map is repeated.
+  u8 priority_mode; /// Priority mode of the writes (0-3).
+};
+
+//------------------------------------------------------------------------------
+
+/// Renderer of the image buffer lines of a graphics operation.
+///
+/// The lines of a batch are rendered in two passes: the dots of each line
+/// are first fetched from the stamp map by blocks (positions of a whole block
+/// computed at once, then stamp data gathered), then written to the image
+/// buffer by pixel pairs (one read-modify-write per byte instead of one per
+/// pixel). The fetch pass only reads Word-RAM, so the lines of a large batch
+/// can be fetched concurrently by worker threads (see Start()); the write
+/// pass stays on the emulation thread, in line order.
+///
+/// The result is the same as rendering the dots one by one: when a trace
+/// vector, a stamp map entry or a stamp pixel read by the batch is inside the
+/// image buffer area written by the batch, the batch is rendered again dot by
+/// dot.
+class GfxLineRenderer
+{
+public:
+  /// Number of dots whose positions are computed at once.
+  static constexpr s32 kBlockSize = 16;
+
+  /// Max. number of dots fetched before they are written.
+  static constexpr s32 kMaxBatchDots = 0x10000;
+
+  /// Min. number of dots of a batch fetched by the worker threads.
+  static constexpr s32 kMinParallelDots = 0x1000;
+
+public:
+  GfxLineRenderer(u8* word_ram, const u8* lut_cell, const u8* lut_pixel,
+    const u8 (*lut_prio)[0x100][0x100]);
+  ~GfxLineRenderer();
+
+  /// Start the worker threads.
+  ///
+  /// @param  thread_count  The number of worker threads.
+  void Start(s32 thread_count);
+
+  /// Stop the worker threads.
+  void Stop();
+
+  /// Indicates whether the worker threads are running.
+  bool IsRunning() const { return !m_workers.empty(); }
+
+  /// Render lines to the image buffer.
+  ///
+  /// @param  op            The graphics operation.
+  /// @param  trace         The trace vectors of the first line (4 words per
+  ///                       line).
+  /// @param  buffer_start  The image buffer index of the first line (in dot
+  ///                       units).
+  /// @param  lines         The number of lines.
+  /// @param  width         The number of dots per line.
+  void Render(const GfxOperation& op, const u16* trace, u32 buffer_start, s32 lines, s32 width);
+
+private:
+  /// Render a batch of lines (at most kMaxBatchDots dots).
+  void RenderBatch(const GfxOperation& op, const u16* trace, u32 buffer_start, s32 lines, s32 width);
+
+  /// Fetch the lines assigned to a thread (line modulo number of threads).
+  void FetchLines(s32 first, s32 step);
+
+  /// Fetch the dots of a line.
+  ///
+  /// @return true if Word-RAM is read inside the image buffer area written by
+  ///         the batch.
+  bool FetchLine(const u16* trace, u8* pixels);
+
+  /// Write the fetched dots of a line to the image buffer.
+  void WriteLine(const u8* pixels, u32 buffer_index);
+
+  /// Render a line dot by dot.
+  void RenderLine(const u16* trace, u32 buffer_index);
+
+  void Run(s32 index, s32 step);
+
+private:
+  u8* m_word_ram; /// Word-RAM (2M mode).
+  const u8* m_lut_cell; /// Stamp offset lookup table.
+  const u8* m_lut_pixel; /// Dot offset lookup table.
+  const u8 (*m_lut_prio)[0x100][0x100]; /// Priority lookup tables.
+
+  // Current batch.
+  GfxOperation m_op;
+  const u16* m_trace; /// Trace vectors of the first line.
+  s32 m_lines; /// Number of lines.
+  s32 m_width; /// Number of dots per line.
+  u32 m_area_start; /// First byte of the written image buffer area.
+  u32 m_area_size; /// Size of the written image buffer area (minus 1).
+
+  std::vector<u8> m_pixels; /// Fetched dots (m_width per line).
+  std::vector<u8> m_conflicts; /// Conflicting reads (per line).
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv; /// Signals the workers.
+  std::condition_variable m_done_cv; /// Signals the emulation thread.
+  u32 m_generation; /// Incremented on each batch fetched by the workers.
+  s32 m_pending; /// Number of workers fetching the current batch.
+  bool m_stop;
+};
+
+} // namespace gpgx::ppu::mcd
+
+#endif // #ifndef __GPGX_PPU_MCD_GFX_LINE_RENDERER_H__
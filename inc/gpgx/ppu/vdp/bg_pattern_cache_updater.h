@@ -53,8 +53,20 @@ namespace gpgx::ppu::vdp {
 class IBackgroundPatternCacheUpdater
 {
 public:
+  virtual ~IBackgroundPatternCacheUpdater() = default;
 
-  virtual void UpdateBackgroundPatternCache(s32 index) = 0;
+  /// Update the cached rows of the modified patterns and clear the modified
+  /// pattern rows.
+  virtual void UpdateBackgroundPatternCache() = 0;
+
+  /// Number of patterns updated since the counters have been reset.
+  virtual u32 GetUpdatedPatternCount() const = 0;
+
+  /// Number of pattern rows updated since the counters have been reset.
+  virtual u32 GetUpdatedRowCount() const = 0;
+
+  /// Reset the counters of updated patterns and rows (e.g. once per frame).
+  virtual void ResetUpdateCounters() = 0;
 };
 
 } // namespace gpgx::ppu::vdp
@@ -0,0 +1,171 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_BG_PATTERN_DIRTY_H__
+#define __GPGX_PPU_VDP_BG_PATTERN_DIRTY_H__
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif // #if defined(_MSC_VER)
+
+#include "xee/fnd/compiler.h"
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Modified background pattern rows (2048 patterns x 8 rows, one bit per row).
+///
+/// For a VRAM address A:
+///   rows[A >> 8], bit (A >> 2) & 0x3F      (the 8 rows of a pattern are a byte)
+///   summary[A >> 14], bit (A >> 8) & 0x3F  (set if rows[A >> 8] is not 0)
+constexpr s32 kPatternDirtyRowsSize = 0x100;
+constexpr s32 kPatternDirtySummarySize = 4;
+
+//------------------------------------------------------------------------------
+
+/// Index of the lowest set bit (data must not be 0).
+XEE_INLINE s32 FindLowestSetBit(u64 data)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, data);
+  return (s32)index;
+#else
+  return __builtin_ctzll(data);
+#endif // #if defined(_MSC_VER)
+}
+
+//------------------------------------------------------------------------------
+
+/// Number of set bits.
+XEE_INLINE s32 CountSetBits(u64 data)
+{
+#if defined(_MSC_VER)
+  return (s32)__popcnt64(data);
+#else
+  return __builtin_popcountll(data);
+#endif // #if defined(_MSC_VER)
+}
+
+//------------------------------------------------------------------------------
+
+/// Mark the pattern row of a VRAM address as modified.
+XEE_INLINE void MarkPatternRowDirty(u64* rows, u64* summary, u32 address)
+{
+  rows[(address >> 8) & 0xFF] |= (u64)1 << ((address >> 2) & 0x3F);
+  summary[(address >> 14) & 0x03] |= (u64)1 << ((address >> 8) & 0x3F);
+}
+
+//------------------------------------------------------------------------------
+
+/// Mark the specified rows of a pattern as modified.
+XEE_INLINE void MarkPatternDirty(u64* rows, u64* summary, u32 name, u8 dirty)
+{
+  if (dirty) {
+    rows[(name >> 3) & 0xFF] |= (u64)dirty << ((name & 7) << 3);
+    summary[(name >> 9) & 0x03] |= (u64)1 << ((name >> 3) & 0x3F);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+/// Mark all rows of the first patterns as modified (count is a multiple of 8).
+XEE_INLINE void MarkPatternsDirty(u64* rows, u64* summary, s32 count)
+{
+  for (s32 i = 0; i < (count >> 3); i++) {
+    rows[i] = ~(u64)0;
+    summary[i >> 6] |= (u64)1 << (i & 0x3F);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+/// Clear all modified pattern rows.
+XEE_INLINE void ClearPatternsDirty(u64* rows, u64* summary)
+{
+  for (s32 i = 0; i < kPatternDirtyRowsSize; i++) {
+    rows[i] = 0;
+  }
+
+  for (s32 i = 0; i < kPatternDirtySummarySize; i++) {
+    summary[i] = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+/// Check if a pattern row has been modified.
+XEE_INLINE bool IsAnyPatternDirty(const u64* summary)
+{
+  return (summary[0] | summary[1] | summary[2] | summary[3]) != 0;
+}
+
+//------------------------------------------------------------------------------
+
+/// Number of modified patterns.
+XEE_INLINE s32 CountDirtyPatterns(const u64* rows, const u64* summary)
+{
+  s32 count = 0;
+
+  for (s32 i = 0; i < kPatternDirtySummarySize; i++) {
+    u64 words = summary[i];
+
+    while (words) {
+      u64 data = rows[(i << 6) | FindLowestSetBit(words)];
+
+      // One bit per non-zero byte (pattern).
+      data |= data >> 4;
+      data |= data >> 2;
+      data |= data >> 1;
+
+      count += CountSetBits(data & 0x0101010101010101ULL);
+
+      words &= words - 1;
+    }
+  }
+
+  return count;
+}
+
+//------------------------------------------------------------------------------
+
+/// Call func(name, dirty) for each modified pattern, in ascending order, then
+/// clear all modified pattern rows.
+template<typename Func>
+XEE_INLINE void TakeDirtyPatterns(u64* rows, u64* summary, Func func)
+{
+  for (s32 i = 0; i < kPatternDirtySummarySize; i++) {
+    u64 words = summary[i];
+
+    summary[i] = 0;
+
+    while (words) {
+      s32 index = (i << 6) | FindLowestSetBit(words);
+      u64 data = rows[index];
+
+      rows[index] = 0;
+
+      while (data) {
+        // Byte of the lowest modified pattern.
+        s32 shift = FindLowestSetBit(data) & 0x38;
+
+        func((u16)((index << 3) | (shift >> 3)), (u8)(data >> shift));
+
+        data &= ~((u64)0xFF << shift);
+      }
+
+      words &= words - 1;
+    }
+  }
+}
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_BG_PATTERN_DIRTY_H__
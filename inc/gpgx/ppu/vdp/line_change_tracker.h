@@ -0,0 +1,96 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_LINE_CHANGE_TRACKER_H__
+#define __GPGX_PPU_VDP_LINE_CHANGE_TRACKER_H__
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Tracker of the framebuffer lines changed since the previous frame.
+///
+/// Each converted line is identified by a hash of its pixel data (line buffer)
+/// seeded with a hash of the color palette used for the conversion, so that
+/// the output pixels of two lines with the same hash are identical. A line is
+/// changed when its hash differs from the hash of the previous conversion of
+/// the same framebuffer line.
+///
+/// The changes are accumulated until the end of a displayed frame, then they
+/// are published for the presenters and capture writers (which only have to
+/// upload or encode the changed lines).
+///
+/// Lines are updated from the worker threads in deferred rendering: each line
+/// has its own flag and hash, and the changes are published once the workers
+/// are idle.
+class LineChangeTracker
+{
+public:
+  /// Max. number of framebuffer lines.
+  static constexpr s32 kMaxLines = 576;
+
+public:
+  LineChangeTracker();
+
+  /// Compute the hash of a block of data.
+  ///
+  /// @param  data  The data.
+  /// @param  size  The size of the data (in bytes).
+  /// @param  seed  The initial value of the hash.
+  /// @return The hash.
+  static u64 Hash(const void* data, s32 size, u64 seed);
+
+  /// Forget the hashes of all the lines (all lines are changed in the next
+  /// published frame).
+  void Invalidate();
+
+  /// Record the conversion of a line to the framebuffer.
+  ///
+  /// @param  line          The framebuffer line.
+  /// @param  src           The pixel data of the line (line buffer).
+  /// @param  width         The number of pixels.
+  /// @param  palette_hash  The hash of the color palette.
+  void UpdateLine(s32 line, const u8* src, s32 width, u64 palette_hash);
+
+  /// Publish the lines changed since the previous published frame.
+  void EndFrame();
+
+  /// Check if a line has changed in the published frame.
+  bool IsLineChanged(s32 line) const
+  {
+    return (line >= 0) && (line < kMaxLines) && m_frame_changed[line];
+  }
+
+  /// Get the number of changed lines in the published frame.
+  s32 GetChangedLineCount() const { return m_frame_changed_count; }
+
+  /// Get the changed flags of the lines in the published frame (kMaxLines
+  /// entries, non-zero when changed).
+  const u8* GetChangedLines() const { return m_frame_changed; }
+
+  /// Find the next run of changed lines in the published frame.
+  ///
+  /// @param  first The first searched line.
+  /// @param  end   The line following the last searched line.
+  /// @param  count Receives the number of consecutive changed lines.
+  /// @return The first changed line of the run (end if there is none).
+  s32 FindChangedLines(s32 first, s32 end, s32* count) const;
+
+private:
+  u64 m_hash[kMaxLines]; /// Hash of the last conversion of each line.
+  u8 m_changed[kMaxLines]; /// Lines changed since the previous published frame.
+
+  u8 m_frame_changed[kMaxLines]; /// Lines changed in the published frame.
+  s32 m_frame_changed_count; /// Number of changed lines in the published frame.
+};
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_LINE_CHANGE_TRACKER_H__
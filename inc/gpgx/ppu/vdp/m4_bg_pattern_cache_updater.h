@@ -55,20 +55,30 @@ namespace gpgx::ppu::vdp {
 class M4BackgroundPatternCacheUpdater : public IBackgroundPatternCacheUpdater
 {
 public:
-  M4BackgroundPatternCacheUpdater(u8* pattern_cache, u16* name_list, u8* name_dirty, u8* ram, u32* bp_lut);
+  M4BackgroundPatternCacheUpdater(u8* pattern_cache, u64* dirty_rows, u64* dirty_summary, u8* ram, u32* bp_lut);
 
   // Implementation of IBackgroundPatternCacheUpdater.
 
-  void UpdateBackgroundPatternCache(s32 index);
+  void UpdateBackgroundPatternCache();
+  u32 GetUpdatedPatternCount() const;
+  u32 GetUpdatedRowCount() const;
+  void ResetUpdateCounters();
+
+private:
+  /// Update the modified rows (dirty) of a pattern.
+  void UpdatePattern(u16 name, u8 dirty);
 
 private:
 
   u8* m_pattern_cache; /// Cached and flipped patterns.
-  u16* m_name_list; /// List of modified pattern indices.
-  u8* m_name_dirty; /// 1 = This pattern is dirty.
+  u64* m_dirty_rows; /// Modified pattern rows (see bg_pattern_dirty.h).
+  u64* m_dirty_summary; /// Non-zero words of modified pattern rows.
   u8* m_ram; /// Video RAM (64K x 8-bit).
 
   u32* m_bp_lut; /// Bitplane to packed pixel look-up table (Mode 4).
+
+  u32 m_updated_pattern_count; /// Number of updated patterns.
+  u32 m_updated_row_count; /// Number of updated pattern rows.
 };
 
 } // namespace gpgx::ppu::vdp
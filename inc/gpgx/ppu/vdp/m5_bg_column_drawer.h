@@ -41,8 +41,11 @@
 #ifndef __GPGX_PPU_VDP_M5_BG_COLUMN_DRAWER_H__
 #define __GPGX_PPU_VDP_M5_BG_COLUMN_DRAWER_H__
 
+#include "xee/fnd/compiler.h"
 #include "xee/fnd/data_type.h"
 
+#include "gpgx/ppu/vdp/m5_pattern_cache.h"
+
 namespace gpgx::ppu::vdp {
 
 //==============================================================================
@@ -108,9 +111,63 @@ private:
   ///   N = Pattern Number (0-2047) from pattern attribute
   ///   H = Horizontal Flip bit from pattern attribute
   ///   V = Vertical Flip bit from pattern attribute
+  /// 
+  /// (see m5_pattern_cache.h for the compact layout)
   u8* m_pattern_cache;
 };
 
+//==============================================================================
+// Inline implementation
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void M5BackgroundColumnDrawer::DrawColumn(u32** dest, u32 attr, u32 line)
+{
+#ifdef LSB_FIRST
+  DrawLSBTile(dest, attr, line);
+  DrawMSBTile(dest, attr, line);
+#else
+  DrawMSBTile(dest, attr, line);
+  DrawLSBTile(dest, attr, line);
+#endif // #ifdef LSB_FIRST
+}
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void M5BackgroundColumnDrawer::DrawLSBTile(u32** dest, u32 attr, u32 line)
+{
+  u32 atex = m_atex_table[(attr >> 13) & 7];
+#ifdef USE_COMPACT_PATTERN_CACHE
+  u32 src[2];
+  ReadPatternRow(&m_pattern_cache[(attr & 0x000007FF) << 6 | (line ^ (GetFlipMask(attr, 12) & 0x38))], GetFlipMask(attr, 11), src);
+#else
+  u32* src = (u32*)&m_pattern_cache[(attr & 0x00001FFF) << 6 | line];
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
+
+  **dest = (src[0] | atex);
+  (*dest)++;
+  **dest = (src[1] | atex);
+  (*dest)++;
+}
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void M5BackgroundColumnDrawer::DrawMSBTile(u32** dest, u32 attr, u32 line)
+{
+  u32 atex = m_atex_table[(attr >> 29) & 7];
+#ifdef USE_COMPACT_PATTERN_CACHE
+  u32 src[2];
+  ReadPatternRow(&m_pattern_cache[(attr & 0x07FF0000) >> 10 | (line ^ (GetFlipMask(attr, 28) & 0x38))], GetFlipMask(attr, 27), src);
+#else
+  u32* src = (u32*)&m_pattern_cache[(attr & 0x1FFF0000) >> 10 | line];
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
+
+  **dest = (src[0] | atex);
+  (*dest)++;
+  **dest = (src[1] | atex);
+  (*dest)++;
+}
+
 } // namespace gpgx::ppu::vdp
 
 #endif // #ifndef __GPGX_PPU_VDP_M5_BG_COLUMN_DRAWER_H__
@@ -0,0 +1,230 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_M5_DEFERRED_LINE_RENDERER_H__
+#define __GPGX_PPU_VDP_M5_DEFERRED_LINE_RENDERER_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "core/framebuffer_t.h"
+#include "core/vdp/clip_t.h"
+#include "core/vdp/object_info_t.h"
+#include "core/vdp/pixel.h"
+#include "core/viewport_t.h"
+
+#include "gpgx/ppu/vdp/line_change_tracker.h"
+#include "gpgx/ppu/vdp/lut.h"
+#include "gpgx/ppu/vdp/m5_line_record.h"
+#include "gpgx/ppu/vdp/m5_line_render_context.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Deferred line renderer in mode 5.
+///
+/// Instead of rendering a line, the emulation thread appends a record to a log:
+/// the patterns modified since the previous line (taken from the pattern
+/// cache dirty list), the parsed sprites of the line and, only when they have
+/// changed, snapshots of the registers, VSRAM and color palette. Worker
+/// threads replay the log into their own copy of the VDP state and render the
+/// lines assigned to them (line modulo number of workers), so that mid-frame
+/// raster effects are rendered exactly as with immediate rendering.
+///
+/// Sprites are still parsed by the emulation thread (the sprite overflow flag
+/// is visible to the CPU). The log is rewound by Flush(), which must be called
+/// before the framebuffer is read (the sprite collision flag is only reported
+/// at that time).
+class M5DeferredLineRenderer
+{
+public:
+  static constexpr u32 kMaxRecords = 1024; /// Capacity of the log (records).
+  static constexpr u32 kMaxVramBlocks = 0x1000; /// Capacity of the log (patterns).
+  static constexpr u32 kMaxStates = 256; /// Capacity of the log (states).
+  static constexpr u32 kMaxVsrams = 512; /// Capacity of the log (VSRAM).
+  static constexpr u32 kMaxPalettes = 512; /// Capacity of the log (palettes).
+
+  M5DeferredLineRenderer(
+    u8* reg,
+    u8* vram,
+    u8* vsram,
+    PIXEL_OUT_T* pixel,
+
+    u16* ntab,
+    u16* ntbb,
+    u16* ntwb,
+    u16* hscb,
+
+    u8* playfield_shift,
+    u8* playfield_col_mask,
+    u16* playfield_row_mask,
+    u8* hscroll_mask,
+
+    u8* odd_frame,
+    u8* im2_flag,
+    u16* max_sprite_pixels,
+    u16* lines_per_frame,
+
+    clip_t* clip,
+    viewport_t* viewport,
+
+    object_info_t(&obj_info)[2][20],
+    u8* object_count,
+    u16* status,
+    u8* spr_ovr,
+
+    u64* dirty_rows,
+    u64* dirty_summary,
+
+    u8 (*lut)[kLayerPriorityLutSize],
+    u8* name_lut,
+    const u32* atex_table,
+    LineChangeTracker* line_changes,
+    framebuffer_t* framebuffer
+  );
+
+  ~M5DeferredLineRenderer();
+
+  /// Start the worker threads.
+  ///
+  /// @param  thread_count  The number of worker threads.
+  void Start(s32 thread_count);
+
+  /// Stop the worker threads (pending lines are rendered before returning).
+  void Stop();
+
+  bool IsRunning() const { return !m_workers.empty(); }
+
+  /// Record a rendered line (see render_line()).
+  ///
+  /// The patterns of the dirty list are moved to the log and, if display is
+  /// enabled, the sprite masking state is updated for the next line.
+  ///
+  /// @param  line  The line.
+  void PushRenderLine(s32 line);
+
+  /// Record a partially blanked line (see blank_line()).
+  ///
+  /// @param  line    The line.
+  /// @param  offset  The offset of the first blanked pixel.
+  /// @param  width   The number of blanked pixels.
+  void PushBlankLine(s32 line, s32 offset, s32 width);
+
+  /// Record a line converted again (see remap_line()).
+  ///
+  /// @param  line  The line.
+  void PushRemapLine(s32 line);
+
+  /// Wait until every recorded line has been rendered, then rewind the log.
+  ///
+  /// The sprite collision flag set by the workers is reported in the VDP
+  /// status.
+  void Flush();
+
+  /// Flush and clear the VRAM and pattern cache of the workers (VDP reset).
+  void Reset();
+
+  /// Force snapshots of the state, VSRAM and color palette in the next record.
+  void Invalidate();
+
+private:
+  struct Worker
+  {
+    M5LineRenderContext* context;
+    std::thread thread;
+    s32 index; /// Index of the worker (lines modulo number of workers).
+    u32 done; /// Number of processed records.
+  };
+
+  /// Retrieve the next record (the log is flushed if it is full).
+  M5LineRecord* AcquireRecord(s32 line, M5LineCommand command);
+
+  /// Make the record retrieved by AcquireRecord() available to the workers.
+  void Commit();
+
+  void CaptureVramBlocks(M5LineRecord* record);
+  void CaptureState(M5LineRecord* record);
+  void CaptureVsram(M5LineRecord* record);
+  void CapturePalette(M5LineRecord* record);
+
+  /// Retrieve the sprite masking state after the sprites of a line (same as
+  /// the sprite layer renderers).
+  u8 GetNextSpriteMasking(s32 list) const;
+
+  /// Worker thread main loop.
+  void Run(Worker* worker);
+
+private:
+  u8* m_reg; /// Internal VDP registers (23 x 8-bit).
+  u8* m_vram; /// Video RAM (64K x 8-bit).
+  u8* m_vsram; /// On-chip vertical scroll RAM (40 x 11-bit).
+  PIXEL_OUT_T* m_pixel; /// Output pixel data look-up table.
+
+  u16* m_ntab; /// Name table A base address.
+  u16* m_ntbb; /// Name table B base address.
+  u16* m_ntwb; /// Name table W base address.
+  u16* m_hscb; /// Horizontal scroll table base address.
+
+  u8* m_playfield_shift; /// Width of planes A, B (in bits).
+  u8* m_playfield_col_mask; /// Playfield column mask.
+  u16* m_playfield_row_mask; /// Playfield row mask.
+  u8* m_hscroll_mask; /// Horizontal Scrolling line mask.
+
+  u8* m_odd_frame; /// 1: odd field, 0: even field.
+  u8* m_im2_flag; /// 1: Interlace mode 2 is being used.
+  u16* m_max_sprite_pixels; /// Max. sprites pixels per line.
+  u16* m_lines_per_frame; /// Number of lines per frame.
+
+  clip_t* m_clip; /// Plane A and Window clipping.
+  viewport_t* m_viewport; /// Viewport.
+
+  object_info_t(&m_obj_info)[2][20]; /// Sprite parsing lists.
+  u8* m_object_count; /// Number of sprites in the lists.
+  u16* m_status; /// VDP status flags.
+  u8* m_spr_ovr; /// Sprite masking state.
+
+  u64* m_dirty_rows; /// Modified pattern rows (see bg_pattern_dirty.h).
+  u64* m_dirty_summary; /// Non-zero words of modified pattern rows.
+
+  u8 (*m_lut)[kLayerPriorityLutSize];
+  u8* m_name_lut;
+  const u32* m_atex_table;
+  LineChangeTracker* m_line_changes;
+  framebuffer_t* m_framebuffer;
+
+  // Log (written by the emulation thread, read by the workers).
+  std::vector<M5LineRecord> m_records;
+  std::vector<M5VramBlock> m_vram_blocks;
+  std::vector<M5LineRenderState> m_states;
+  std::vector<u8> m_vsrams;
+  std::vector<PIXEL_OUT_T> m_palettes;
+
+  u32 m_vram_block_count; /// Number of patterns in the log.
+  u32 m_state_count; /// Number of state snapshots in the log.
+  u32 m_vsram_count; /// Number of VSRAM snapshots in the log.
+  u32 m_palette_count; /// Number of color palette snapshots in the log.
+  bool m_invalidated; /// true to force snapshots in the next record.
+
+  // Synchronization.
+  std::vector<Worker*> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv; /// Signaled when records are committed.
+  std::condition_variable m_done_cv; /// Signaled when records are processed.
+  u32 m_record_count; /// Number of committed records (guarded by m_mutex).
+  u32 m_generation; /// Incremented when the log is rewound (guarded by m_mutex).
+  bool m_stop; /// true to stop the workers (guarded by m_mutex).
+};
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_M5_DEFERRED_LINE_RENDERER_H__
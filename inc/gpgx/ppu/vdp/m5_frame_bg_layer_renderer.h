@@ -0,0 +1,146 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_M5_FRAME_BG_LAYER_RENDERER_H__
+#define __GPGX_PPU_VDP_M5_FRAME_BG_LAYER_RENDERER_H__
+
+#include "xee/fnd/data_type.h"
+
+#include "core/vdp/clip_t.h"
+#include "core/viewport_t.h"
+
+#include "gpgx/ppu/vdp/bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_bg_column_drawer.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Renderer of background layer in mode 5, for a whole frame at once.
+///
+/// When the VDP state does not change during the active display, planes A, B
+/// and the window of all the lines of the frame are drawn by RenderFrame() in
+/// tile order: the name table entry of a 2-cell column is read once for the
+/// consecutive lines of the same pattern row with the same horizontal scroll
+/// value (up to 8 lines). RenderBackground() then only merges the planes of a
+/// line.
+///
+/// 16 pixel column vertical scrolling and interlace mode 2 are not supported
+/// (see CanRenderFrame()). The result is the same as M5BackgroundLayerRenderer.
+class M5FrameBackgroundLayerRenderer final : public IBackgroundLayerRenderer
+{
+public:
+  /// Max. number of lines of a frame.
+  static constexpr s32 kMaxLineCount = 240;
+
+public:
+  M5FrameBackgroundLayerRenderer(
+    u8* reg,
+    u8* vram,
+    u8* vsram,
+
+    u8* playfield_shift,
+    u8* playfield_col_mask,
+    u16* playfield_row_mask,
+
+    u16* hscb,
+    u8* hscroll_mask,
+
+    u16* ntab,
+    u16* ntbb,
+    u16* ntwb,
+
+    u8* b_line_buffer,
+
+    u8* bg_lut,
+    u8* bg_ste_lut,
+
+    clip_t* a_clip,
+    clip_t* w_clip,
+
+    viewport_t* viewport,
+    M5BackgroundColumnDrawer* bg_column_drawer
+  );
+
+  /// Check if the current VDP state can be rendered by frame.
+  ///
+  /// @param  im2_flag  The interlace mode 2 flag.
+  bool CanRenderFrame(u8 im2_flag) const;
+
+  /// Draw planes A, B and the window of all the lines of the frame.
+  void RenderFrame();
+
+  // Implementation of IBackgroundLayerRenderer.
+
+  /// Merge the planes of a line drawn by RenderFrame().
+  void RenderBackground(s32 line);
+
+private:
+  /// Draw a plane (A or B) on a range of lines, by 2-cell columns.
+  ///
+  /// @param  layer       The plane layer.
+  /// @param  nt_base     The name table base address.
+  /// @param  plane_shift The shift of the plane scroll values in the 32-bit
+  ///                     scroll words (0 or 16).
+  /// @param  start       The first column.
+  /// @param  end         The column after the last one.
+  /// @param  first_line  The first line.
+  /// @param  last_line   The line after the last one.
+  void DrawPlane(u8 (*layer)[0x200], u16 nt_base, u32 plane_shift, s32 start, s32 end, s32 first_line, s32 last_line);
+
+  /// Horizontal scroll value of a plane for a line.
+  u32 GetXScroll(s32 line, u32 plane_shift) const;
+
+  /// Draw the window on a range of lines, by 2-cell columns.
+  ///
+  /// @param  start       The first column.
+  /// @param  end         The column after the last one.
+  /// @param  first_line  The first line.
+  /// @param  last_line   The line after the last one.
+  void DrawWindow(s32 start, s32 end, s32 first_line, s32 last_line);
+
+  /// Draw plane A and the window on a range of lines where they share the
+  /// line in the same way.
+  void DrawPlaneAndWindow(s32 first_line, s32 last_line, bool full_window);
+
+  void Merge(u8* srca, u8* srcb, u8* dst, s32 width);
+
+private:
+  u8* m_reg; /// Internal VDP registers (23 x 8-bit).
+  u8* m_vram; /// Video RAM (64K x 8-bit).
+  u8* m_vsram; /// On-chip vertical scroll RAM (40 x 11-bit).
+
+  u8* m_playfield_shift; /// Width of planes A, B (in bits).
+  u8* m_playfield_col_mask; /// Playfield column mask.
+  u16* m_playfield_row_mask; /// Playfield row mask.
+
+  u16* m_hscb; /// Horizontal scroll table base address.
+  u8* m_hscroll_mask; /// Horizontal scrolling line mask.
+
+  u16* m_ntab; /// Name table A base address.
+  u16* m_ntbb; /// Name table B base address.
+  u16* m_ntwb; /// Name table W base address.
+
+  u8* m_b_line_buffer; /// Plane B line buffer (merged background).
+
+  u8* m_bg_lut;
+  u8* m_bg_ste_lut;
+
+  clip_t* m_a_clip; /// Plane A clip.
+  clip_t* m_w_clip; /// Window clip.
+
+  viewport_t* m_viewport;
+  M5BackgroundColumnDrawer* m_bg_column_drawer;
+
+  alignas(4) u8 m_a_layer[kMaxLineCount][0x200]; /// Plane A (and window) lines of the frame.
+  alignas(4) u8 m_b_layer[kMaxLineCount][0x200]; /// Plane B lines of the frame.
+};
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_M5_FRAME_BG_LAYER_RENDERER_H__
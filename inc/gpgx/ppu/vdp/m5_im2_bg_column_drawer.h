@@ -41,8 +41,11 @@
 #ifndef __GPGX_PPU_VDP_M5_IM2_BG_COLUMN_DRAWER_H__
 #define __GPGX_PPU_VDP_M5_IM2_BG_COLUMN_DRAWER_H__
 
+#include "xee/fnd/compiler.h"
 #include "xee/fnd/data_type.h"
 
+#include "gpgx/ppu/vdp/m5_pattern_cache.h"
+
 namespace gpgx::ppu::vdp {
 
 //==============================================================================
@@ -110,9 +113,63 @@ private:
   ///   N = Pattern Number (0-1023)
   ///   H = Horizontal Flip bit
   ///   V = Vertical Flip bit
+  /// 
+  /// (see m5_pattern_cache.h for the compact layout)
   u8* m_pattern_cache;
 };
 
+//==============================================================================
+// Inline implementation
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void M5Im2BackgroundColumnDrawer::DrawColumn(u32** dest, u32 attr, u32 line)
+{
+#ifdef LSB_FIRST
+  DrawLSBTile(dest, attr, line);
+  DrawMSBTile(dest, attr, line);
+#else
+  DrawMSBTile(dest, attr, line);
+  DrawLSBTile(dest, attr, line);
+#endif // #ifdef LSB_FIRST
+}
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void M5Im2BackgroundColumnDrawer::DrawLSBTile(u32** dest, u32 attr, u32 line)
+{
+  u32 atex = m_atex_table[(attr >> 13) & 7];
+#ifdef USE_COMPACT_PATTERN_CACHE
+  u32 src[2];
+  ReadPatternRow(&m_pattern_cache[(attr & 0x000003FF) << 7 | (line ^ (GetFlipMask(attr, 12) & 0x78))], GetFlipMask(attr, 11), src);
+#else
+  u32* src = (u32*)&m_pattern_cache[((attr & 0x000003FF) << 7 | (attr & 0x00001800) << 6 | line) ^ ((attr & 0x00001000) >> 6)];
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
+
+  **dest = (src[0] | atex);
+  (*dest)++;
+  **dest = (src[1] | atex);
+  (*dest)++;
+}
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void M5Im2BackgroundColumnDrawer::DrawMSBTile(u32** dest, u32 attr, u32 line)
+{
+  u32 atex = m_atex_table[(attr >> 29) & 7];
+#ifdef USE_COMPACT_PATTERN_CACHE
+  u32 src[2];
+  ReadPatternRow(&m_pattern_cache[(attr & 0x03FF0000) >> 9 | (line ^ (GetFlipMask(attr, 28) & 0x78))], GetFlipMask(attr, 27), src);
+#else
+  u32* src = (u32*)&m_pattern_cache[((attr & 0x03FF0000) >> 9 | (attr & 0x18000000) >> 10 | line) ^ ((attr & 0x10000000) >> 22)];
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
+
+  **dest = (src[0] | atex);
+  (*dest)++;
+  **dest = (src[1] | atex);
+  (*dest)++;
+}
+
 } // namespace gpgx::ppu::vdp
 
 #endif // #ifndef __GPGX_PPU_VDP_M5_IM2_BG_COLUMN_DRAWER_H__
@@ -57,7 +57,7 @@ namespace gpgx::ppu::vdp {
 
 /// Renderer of background layer in mode 5 with interlace double resolution 
 /// (IM2) enabled.
-class M5Im2BackgroundLayerRenderer : public IBackgroundLayerRenderer
+class M5Im2BackgroundLayerRenderer final : public IBackgroundLayerRenderer
 {
 public:
   M5Im2BackgroundLayerRenderer(
@@ -96,7 +96,7 @@ public:
   void RenderBackground(s32 line);
 
 private:
-  void Merge(u8* srca, u8* srcb, u8* dst, u8* table, s32 width);
+  void Merge(u8* srca, u8* srcb, u8* dst, s32 width);
 
 private:
   u8* m_reg; /// Internal VDP registers (23 x 8-bit).
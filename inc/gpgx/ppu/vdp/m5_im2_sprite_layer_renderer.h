@@ -57,7 +57,7 @@ namespace gpgx::ppu::vdp {
 
 /// Renderer of sprite layer in mode 5 with interlace double resoultion (IM2) 
 /// enabled.
-class M5Im2SpriteLayerRenderer : public ISpriteLayerRenderer
+class M5Im2SpriteLayerRenderer final : public ISpriteLayerRenderer
 {
 public:
   M5Im2SpriteLayerRenderer(
@@ -46,7 +46,7 @@
 #include "core/vdp/object_info_t.h"
 #include "core/viewport_t.h"
 
-#include "gpgx/ppu/vdp/m5_sprite_tile_drawer.h"
+#include "gpgx/ppu/vdp/m5_ste_sprite_tile_drawer.h"
 #include "gpgx/ppu/vdp/sprite_layer_renderer.h"
 
 namespace gpgx::ppu::vdp {
@@ -57,7 +57,7 @@ namespace gpgx::ppu::vdp {
 
 /// Renderer of sprite layer in mode 5 with interlace double resoultion (IM2) 
 /// enabled and shadow/highlight mode (STE) enabled.
-class M5Im2SteSpriteLayerRenderer : public ISpriteLayerRenderer
+class M5Im2SteSpriteLayerRenderer final : public ISpriteLayerRenderer
 {
 public:
   M5Im2SteSpriteLayerRenderer(
@@ -81,7 +81,7 @@ public:
   void RenderSprites(s32 line);
 
 private:
-  void Merge(u8* srca, u8* srcb, u8* dst, u8* table, s32 width);
+  void Merge(u8* srca, u8* srcb, u8* dst, s32 width);
 
 private:
   object_info_t (&m_obj_info)[2][20];
@@ -101,7 +101,7 @@ private:
 
   viewport_t* m_viewport;
 
-  M5SpriteTileDrawer* m_sprite_tile_drawer;
+  M5SteSpriteTileDrawer* m_sprite_tile_drawer;
 };
 
 } // namespace gpgx::ppu::vdp
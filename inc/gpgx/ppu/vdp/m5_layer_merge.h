@@ -0,0 +1,326 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_M5_LAYER_MERGE_H__
+#define __GPGX_PPU_VDP_M5_LAYER_MERGE_H__
+
+#include "xee/fnd/compiler.h"
+#include "xee/fnd/data_type.h"
+
+// SSE2 is always available on x86-64 (MSVC does not define __SSE2__).
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define GPGX_PPU_VDP_SSE2
+#include <emmintrin.h>
+#endif // #if defined(__SSE2__) || ...
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Layer priority merge in mode 5.
+///
+/// The pixels are combined arithmetically, 16 pixels (merge) or 8 pixels
+/// (sprite tile) at a time, with the same result as the layer priority pixel
+/// look-up tables built by MakeLayerPriorityLuts() (the look-up table is only
+/// used for the remaining pixels and when SSE2 is not available).
+///
+/// Line buffer pixel: (msb) SPppcccc (lsb)
+/// with:
+///   S = sprite pixel marker / intensity select (d7)
+///   P = priority bit (d6)
+///   p = color palette (d5-d4)
+///   c = color data (d3-d0)
+
+/// Merge plane A (srca) with plane B (srcb), same as lut[0] (bg).
+void MergeBackgroundLayers(const u8* srca, const u8* srcb, u8* dst, const u8* lut, s32 width);
+
+/// Merge plane A (srca) with plane B (srcb), same as lut[2] (bg_ste).
+void MergeSteBackgroundLayers(const u8* srca, const u8* srcb, u8* dst, const u8* lut, s32 width);
+
+/// Merge the sprite layer (srca) with the background (srcb), same as lut[4]
+/// (bgobj_ste).
+void MergeSteSpriteLayer(const u8* srca, const u8* srcb, u8* dst, const u8* lut, s32 width);
+
+/// Draw 8 sprite pixels over the background, same as lut[1] (bgobj).
+///
+/// @param  src         The sprite pattern pixels (color data).
+/// @param  attr        The sprite attribute (priority + palette bits).
+/// @param  line_buffer The line buffer.
+/// @param  lut         The layer priority pixel look-up table.
+/// @return 0x20 if an opaque pixel is drawn over a sprite pixel (sprite
+///         collision), otherwise 0.
+u16 DrawSpritePixels(const u8* src, u32 attr, u8* line_buffer, const u8* lut);
+
+/// Draw 8 sprite pixels in the sprite layer, same as lut[3] (obj).
+///
+/// @param  src         The sprite pattern pixels (color data).
+/// @param  attr        The sprite attribute (priority + palette bits).
+/// @param  line_buffer The sprite line buffer.
+/// @param  lut         The layer priority pixel look-up table.
+/// @return 0x20 if an opaque pixel is drawn over a sprite pixel (sprite
+///         collision), otherwise 0.
+u16 DrawSteSpritePixels(const u8* src, u32 attr, u8* line_buffer, const u8* lut);
+
+//==============================================================================
+// Inline implementation
+
+#ifdef GPGX_PPU_VDP_SSE2
+
+//------------------------------------------------------------------------------
+
+/// All bits set in the pixels where (v & mask) == value.
+XEE_INLINE __m128i M5MaskEqual(__m128i v, u8 mask, u8 value)
+{
+  return _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)mask)), _mm_set1_epi8((char)value));
+}
+
+//------------------------------------------------------------------------------
+
+/// Pixels of a where mask is set, pixels of b elsewhere.
+XEE_INLINE __m128i M5Select(__m128i mask, __m128i a, __m128i b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+//------------------------------------------------------------------------------
+
+/// Plane priority (make_lut_bg): the color of plane A or plane B (d6-d0),
+/// before stripping transparent pixels.
+XEE_INLINE __m128i M5SelectPlane(__m128i a, __m128i b)
+{
+  __m128i a_transparent = M5MaskEqual(a, 0x0F, 0x00);
+  __m128i a_priority = M5MaskEqual(a, 0x40, 0x40);
+  __m128i b_opaque_priority = _mm_andnot_si128(M5MaskEqual(b, 0x0F, 0x00), M5MaskEqual(b, 0x40, 0x40));
+
+  // Plane A wins if opaque, unless plane B is opaque with priority (and A without).
+  __m128i select_a = _mm_andnot_si128(a_transparent, _mm_or_si128(a_priority, _mm_xor_si128(b_opaque_priority, _mm_set1_epi8(-1))));
+
+  __m128i mask = _mm_set1_epi8(0x7F);
+
+  return M5Select(select_a, _mm_and_si128(a, mask), _mm_and_si128(b, mask));
+}
+
+//------------------------------------------------------------------------------
+
+/// Merge 16 pixels (lut[0]).
+XEE_INLINE __m128i M5MergeBackground16(__m128i a, __m128i b)
+{
+  __m128i c = M5SelectPlane(a, b);
+
+  // Strip palette & priority bits from transparent pixels.
+  return _mm_andnot_si128(M5MaskEqual(c, 0x0F, 0x00), c);
+}
+
+//------------------------------------------------------------------------------
+
+/// Merge 16 pixels (lut[2]).
+XEE_INLINE __m128i M5MergeSteBackground16(__m128i a, __m128i b)
+{
+  __m128i c = M5SelectPlane(a, b);
+
+  // Half intensity when both pixels are low priority.
+  __m128i normal = _mm_and_si128(M5MaskEqual(_mm_or_si128(a, b), 0x40, 0x40), _mm_set1_epi8((char)0x80));
+
+  // Strip palette & priority bits from transparent pixels.
+  return _mm_or_si128(_mm_andnot_si128(M5MaskEqual(c, 0x0F, 0x00), c), normal);
+}
+
+//------------------------------------------------------------------------------
+
+/// Merge 16 pixels (lut[4]): sx = sprite layer, bx = background.
+XEE_INLINE __m128i M5MergeSteSprite16(__m128i sx, __m128i bx)
+{
+  __m128i zero = _mm_setzero_si128();
+  __m128i all = _mm_set1_epi8(-1);
+
+  __m128i bf = _mm_and_si128(bx, _mm_set1_epi8(0x3F));
+  __m128i sf = _mm_and_si128(sx, _mm_set1_epi8(0x3F));
+
+  // Background intensity (d7 moved to d6).
+  __m128i b_normal = _mm_cmplt_epi8(bx, zero);
+  __m128i bi = _mm_and_si128(b_normal, _mm_set1_epi8(0x40));
+
+  __m128i s_opaque = _mm_xor_si128(M5MaskEqual(sx, 0x0F, 0x00), all);
+  __m128i s_priority = M5MaskEqual(sx, 0x40, 0x40);
+  __m128i b_opaque_priority = _mm_andnot_si128(M5MaskEqual(bx, 0x0F, 0x00), M5MaskEqual(bx, 0x40, 0x40));
+
+  // The sprite pixel is used unless transparent or behind a high priority
+  // background pixel.
+  __m128i use_sprite = _mm_andnot_si128(_mm_andnot_si128(s_priority, b_opaque_priority), s_opaque);
+
+  // Shadow (color 0x3F) & highlight (color 0x3E) operators.
+  __m128i operator_pixel = M5MaskEqual(sx, 0x3E, 0x3E);
+  __m128i shadow = _mm_and_si128(operator_pixel, M5MaskEqual(sx, 0x01, 0x01));
+  __m128i highlight = M5Select(b_normal, _mm_set1_epi8((char)0x80), _mm_set1_epi8(0x40));
+
+  // Colors 0x0E, 0x1E & 0x2E are always displayed at normal intensity.
+  __m128i color_e = _mm_andnot_si128(operator_pixel, M5MaskEqual(sx, 0x0F, 0x0E));
+
+  __m128i s_intensity = _mm_or_si128(_mm_and_si128(sx, _mm_set1_epi8(0x40)), bi);
+  s_intensity = M5Select(color_e, _mm_set1_epi8(0x40), s_intensity);
+
+  __m128i sprite = _mm_or_si128(sf, s_intensity);
+  sprite = M5Select(operator_pixel, _mm_or_si128(bf, _mm_andnot_si128(shadow, highlight)), sprite);
+
+  __m128i c = M5Select(use_sprite, sprite, _mm_or_si128(bf, bi));
+
+  // Strip palette bits from transparent pixels.
+  return M5Select(M5MaskEqual(c, 0x0F, 0x00), _mm_and_si128(c, _mm_set1_epi8((char)0xC0)), c);
+}
+
+#endif // #ifdef GPGX_PPU_VDP_SSE2
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void MergeBackgroundLayers(const u8* srca, const u8* srcb, u8* dst, const u8* lut, s32 width)
+{
+#ifdef GPGX_PPU_VDP_SSE2
+  for (; width >= 16; width -= 16, srca += 16, srcb += 16, dst += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i*)srca);
+    __m128i b = _mm_loadu_si128((const __m128i*)srcb);
+    _mm_storeu_si128((__m128i*)dst, M5MergeBackground16(a, b));
+  }
+#endif // #ifdef GPGX_PPU_VDP_SSE2
+
+  for (; width > 0; width--) {
+    *dst++ = lut[(*srcb++ << 8) | (*srca++)];
+  }
+}
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void MergeSteBackgroundLayers(const u8* srca, const u8* srcb, u8* dst, const u8* lut, s32 width)
+{
+#ifdef GPGX_PPU_VDP_SSE2
+  for (; width >= 16; width -= 16, srca += 16, srcb += 16, dst += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i*)srca);
+    __m128i b = _mm_loadu_si128((const __m128i*)srcb);
+    _mm_storeu_si128((__m128i*)dst, M5MergeSteBackground16(a, b));
+  }
+#endif // #ifdef GPGX_PPU_VDP_SSE2
+
+  for (; width > 0; width--) {
+    *dst++ = lut[(*srcb++ << 8) | (*srca++)];
+  }
+}
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE void MergeSteSpriteLayer(const u8* srca, const u8* srcb, u8* dst, const u8* lut, s32 width)
+{
+#ifdef GPGX_PPU_VDP_SSE2
+  for (; width >= 16; width -= 16, srca += 16, srcb += 16, dst += 16) {
+    __m128i s = _mm_loadu_si128((const __m128i*)srca);
+    __m128i b = _mm_loadu_si128((const __m128i*)srcb);
+    _mm_storeu_si128((__m128i*)dst, M5MergeSteSprite16(s, b));
+  }
+#endif // #ifdef GPGX_PPU_VDP_SSE2
+
+  for (; width > 0; width--) {
+    *dst++ = lut[(*srcb++ << 8) | (*srca++)];
+  }
+}
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE u16 DrawSpritePixels(const u8* src, u32 attr, u8* line_buffer, const u8* lut)
+{
+#ifdef GPGX_PPU_VDP_SSE2
+  (void)lut; // Scalar path only.
+
+  __m128i zero = _mm_setzero_si128();
+
+  __m128i bx = _mm_loadl_epi64((const __m128i*)line_buffer);
+  __m128i sx = _mm_or_si128(_mm_loadl_epi64((const __m128i*)src), _mm_set1_epi8((char)attr));
+
+  __m128i s_opaque = _mm_xor_si128(M5MaskEqual(sx, 0x0F, 0x00), _mm_set1_epi8(-1));
+  __m128i b_sprite = _mm_cmplt_epi8(bx, zero);
+
+  // Previous sprite has higher priority.
+  __m128i draw = _mm_andnot_si128(b_sprite, s_opaque);
+
+  // High priority background pixel over low priority sprite pixel.
+  __m128i keep_background = _mm_andnot_si128(M5MaskEqual(sx, 0x40, 0x40),
+    _mm_andnot_si128(M5MaskEqual(bx, 0x0F, 0x00), M5MaskEqual(bx, 0x40, 0x40)));
+
+  __m128i mask = _mm_set1_epi8(0x3F);
+  __m128i c = M5Select(keep_background, _mm_and_si128(bx, mask), _mm_and_si128(sx, mask));
+  c = _mm_or_si128(c, _mm_set1_epi8((char)0x80));
+
+  _mm_storel_epi64((__m128i*)line_buffer, M5Select(draw, c, bx));
+
+  // Sprite collision.
+  return (_mm_movemask_epi8(_mm_and_si128(s_opaque, b_sprite)) & 0xFF) ? 0x20 : 0;
+#else
+  u16 status = 0;
+  u32 temp;
+
+  for (s32 i = 0; i < 8; i++) {
+    temp = src[i];
+
+    if (temp & 0x0F) {
+      temp |= (line_buffer[i] << 8);
+      line_buffer[i] = lut[temp | attr];
+
+      status |= ((temp & 0x8000) >> 10);
+    }
+  }
+
+  return status;
+#endif // #ifdef GPGX_PPU_VDP_SSE2
+}
+
+//------------------------------------------------------------------------------
+
+XEE_INLINE u16 DrawSteSpritePixels(const u8* src, u32 attr, u8* line_buffer, const u8* lut)
+{
+#ifdef GPGX_PPU_VDP_SSE2
+  (void)lut; // Scalar path only.
+
+  __m128i zero = _mm_setzero_si128();
+
+  __m128i bx = _mm_loadl_epi64((const __m128i*)line_buffer);
+  __m128i sx = _mm_or_si128(_mm_loadl_epi64((const __m128i*)src), _mm_set1_epi8((char)attr));
+
+  __m128i s_opaque = _mm_xor_si128(M5MaskEqual(sx, 0x0F, 0x00), _mm_set1_epi8(-1));
+  __m128i b_sprite = _mm_cmplt_epi8(bx, zero);
+
+  // Previous sprite has higher priority.
+  __m128i mask = _mm_set1_epi8(0x7F);
+  __m128i c = M5Select(b_sprite, _mm_and_si128(bx, mask), _mm_and_si128(sx, mask));
+
+  // Strip palette bits from transparent pixels.
+  c = M5Select(M5MaskEqual(c, 0x0F, 0x00), _mm_and_si128(c, _mm_set1_epi8((char)0xC0)), c);
+  c = _mm_or_si128(c, _mm_set1_epi8((char)0x80));
+
+  _mm_storel_epi64((__m128i*)line_buffer, M5Select(s_opaque, c, bx));
+
+  // Sprite collision.
+  return (_mm_movemask_epi8(_mm_and_si128(s_opaque, b_sprite)) & 0xFF) ? 0x20 : 0;
+#else
+  u16 status = 0;
+  u32 temp;
+
+  for (s32 i = 0; i < 8; i++) {
+    temp = src[i];
+
+    if (temp & 0x0F) {
+      temp |= (line_buffer[i] << 8);
+      line_buffer[i] = lut[temp | attr];
+
+      status |= ((temp & 0x8000) >> 10);
+    }
+  }
+
+  return status;
+#endif // #ifdef GPGX_PPU_VDP_SSE2
+}
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_M5_LAYER_MERGE_H__
@@ -0,0 +1,100 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_M5_LINE_RECORD_H__
+#define __GPGX_PPU_VDP_M5_LINE_RECORD_H__
+
+#include "xee/fnd/data_type.h"
+
+#include "core/vdp/clip_t.h"
+#include "core/vdp/object_info_t.h"
+#include "core/viewport_t.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// State of the VDP read by the line renderers in mode 5 (VRAM, VSRAM and the
+/// color palette are recorded separately).
+///
+/// Snapshots are compared byte per byte: they must be cleared before being
+/// filled so that the padding bytes are deterministic.
+struct M5LineRenderState
+{
+  u8 reg[0x20]; /// Internal VDP registers.
+
+  u16 ntab; /// Name table A base address.
+  u16 ntbb; /// Name table B base address.
+  u16 ntwb; /// Name table W base address.
+  u16 hscb; /// Horizontal scroll table base address.
+
+  u16 playfield_row_mask; /// Playfield row mask.
+  u8 playfield_shift; /// Width of planes A, B (in bits).
+  u8 playfield_col_mask; /// Playfield column mask.
+  u8 hscroll_mask; /// Horizontal Scrolling line mask.
+
+  u8 odd_frame; /// 1: odd field, 0: even field.
+  u8 im2_flag; /// 1: Interlace mode 2 is being used.
+  u16 max_sprite_pixels; /// Max. sprites pixels per line.
+  u16 lines_per_frame; /// Number of lines per frame.
+
+  clip_t clip[2]; /// Plane A and Window clipping.
+
+  viewport_t viewport; /// Viewport (only x, y, w and h are recorded).
+};
+
+//------------------------------------------------------------------------------
+
+/// Pattern (32 bytes of VRAM) modified since the previous line.
+struct M5VramBlock
+{
+  u16 name; /// Pattern name index.
+  u8 dirty; /// Modified pattern lines (1 bit per line).
+  u8 data[32]; /// Pattern data.
+};
+
+//------------------------------------------------------------------------------
+
+/// Command of a line record.
+enum class M5LineCommand : u8
+{
+  kRender = 0, /// Render the line (render_line()).
+  kBlank = 1, /// Blank part of the line (blank_line()).
+  kRemap = 2, /// Convert the line again (remap_line()).
+};
+
+//------------------------------------------------------------------------------
+
+/// Record of a line in the log of the deferred line renderer.
+///
+/// The snapshots are referenced by index: a record references the same
+/// snapshot as the previous one unless the state has changed in between.
+struct M5LineRecord
+{
+  s32 line; /// Line number.
+  M5LineCommand command; /// Command.
+
+  u8 spr_ovr; /// Sprite masking state at the start of the line.
+  u8 object_count; /// Number of sprites on the line.
+
+  s16 blank_offset; /// Offset of the blanked pixels (kBlank).
+  s16 blank_width; /// Number of blanked pixels (kBlank).
+
+  u32 vram_index; /// Index of the first modified pattern.
+  u32 vram_count; /// Number of modified patterns.
+
+  u16 state_index; /// Index of the state snapshot.
+  u16 vsram_index; /// Index of the VSRAM snapshot.
+  u16 palette_index; /// Index of the color palette snapshot.
+
+  object_info_t obj_info[20]; /// Sprites of the line (kRender).
+};
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_M5_LINE_RECORD_H__
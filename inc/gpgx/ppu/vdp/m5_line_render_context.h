@@ -0,0 +1,165 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_M5_LINE_RENDER_CONTEXT_H__
+#define __GPGX_PPU_VDP_M5_LINE_RENDER_CONTEXT_H__
+
+#include "xee/fnd/data_type.h"
+
+#include "core/framebuffer_t.h"
+#include "core/vdp/clip_t.h"
+#include "core/vdp/object_info_t.h"
+#include "core/vdp/pixel.h"
+#include "core/viewport_t.h"
+
+#include "gpgx/ppu/vdp/bg_pattern_dirty.h"
+#include "gpgx/ppu/vdp/line_change_tracker.h"
+#include "gpgx/ppu/vdp/lut.h"
+#include "gpgx/ppu/vdp/m5_bg_column_drawer.h"
+#include "gpgx/ppu/vdp/m5_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_bg_pattern_cache_updater.h"
+#include "gpgx/ppu/vdp/m5_im2_bg_column_drawer.h"
+#include "gpgx/ppu/vdp/m5_im2_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_ste_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_vs_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_line_record.h"
+#include "gpgx/ppu/vdp/m5_line_renderer.h"
+#include "gpgx/ppu/vdp/m5_pattern_cache.h"
+#include "gpgx/ppu/vdp/m5_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_ste_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_vs_bg_layer_renderer.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Private copy of the VDP state with its own line renderers in mode 5.
+///
+/// A context is updated from the records of the deferred line renderer and
+/// renders lines into the framebuffer exactly as render_line(), blank_line()
+/// and remap_line() do with the state of the VDP.
+class M5LineRenderContext
+{
+public:
+  M5LineRenderContext(
+    u8 (*lut)[kLayerPriorityLutSize],
+    u8* name_lut,
+    const u32* atex_table,
+    LineChangeTracker* line_changes,
+    framebuffer_t* framebuffer
+  );
+
+  ~M5LineRenderContext();
+
+  /// Clear VRAM, pattern cache and line buffers (VDP reset).
+  void Reset();
+
+  /// Write modified patterns to VRAM (the pattern cache is updated before
+  /// the next displayed line).
+  ///
+  /// @param  blocks  The modified patterns.
+  /// @param  count   The number of modified patterns.
+  void ApplyVramBlocks(const M5VramBlock* blocks, u32 count);
+
+  /// Update registers and derived state.
+  ///
+  /// @param  state The state snapshot.
+  void ApplyState(const M5LineRenderState& state);
+
+  /// Update VSRAM.
+  ///
+  /// @param  vsram The VSRAM snapshot (0x80 bytes).
+  void ApplyVsram(const u8* vsram);
+
+  /// Update color palette.
+  ///
+  /// @param  palette The color palette snapshot (0x100 entries).
+  void ApplyPalette(const PIXEL_OUT_T* palette);
+
+  /// Render a line (see render_line()).
+  ///
+  /// @param  record  The record of the line.
+  void RenderLine(const M5LineRecord& record);
+
+  /// Blank part of a line (see blank_line()).
+  ///
+  /// @param  line    The line.
+  /// @param  offset  The offset of the first blanked pixel.
+  /// @param  width   The number of blanked pixels.
+  void BlankLine(s32 line, s32 offset, s32 width);
+
+  /// Retrieve and clear the VDP status flags set by the sprite layer renderers
+  /// (sprite collision).
+  u16 TakeStatus();
+
+  /// Convert the line buffer to the framebuffer (see remap_line()).
+  ///
+  /// @param  line  The line.
+  void RemapLine(s32 line);
+
+private:
+  u8 m_reg[0x20]; /// Internal VDP registers (23 x 8-bit).
+  alignas(4) u8 m_vram[0x10000]; /// Video RAM (64K x 8-bit).
+  alignas(4) u8 m_vsram[0x80]; /// On-chip vertical scroll RAM (40 x 11-bit).
+
+  u16 m_ntab; /// Name table A base address.
+  u16 m_ntbb; /// Name table B base address.
+  u16 m_ntwb; /// Name table W base address.
+  u16 m_hscb; /// Horizontal scroll table base address.
+
+  u8 m_playfield_shift; /// Width of planes A, B (in bits).
+  u8 m_playfield_col_mask; /// Playfield column mask.
+  u16 m_playfield_row_mask; /// Playfield row mask.
+  u8 m_hscroll_mask; /// Horizontal Scrolling line mask.
+
+  u8 m_odd_frame; /// 1: odd field, 0: even field.
+  u8 m_im2_flag; /// 1: Interlace mode 2 is being used.
+  u16 m_max_sprite_pixels; /// Max. sprites pixels per line.
+  u16 m_lines_per_frame; /// Number of lines per frame.
+  u16 m_status; /// VDP status flags (sprite collision).
+
+  clip_t m_clip[2]; /// Plane A and Window clipping.
+  viewport_t m_viewport; /// Viewport.
+
+  u64 m_dirty_rows[kPatternDirtyRowsSize]; /// Modified pattern rows (see bg_pattern_dirty.h).
+  u64 m_dirty_summary[kPatternDirtySummarySize]; /// Non-zero words of modified pattern rows.
+
+  alignas(4) u8 m_pattern_cache[kPatternCacheSize]; /// Background pattern cache.
+  alignas(4) u8 m_line_buffer[2][0x200]; /// Line buffers.
+
+  u8 m_spr_ovr; /// Sprite masking state.
+  object_info_t m_obj_info[2][20]; /// Sprites of the current line.
+  u8 m_object_count[2]; /// Number of sprites of the current line.
+
+  PIXEL_OUT_T m_pixel[0x100]; /// Output pixel data look-up table.
+  u64 m_palette_hash; /// Hash of the output pixel data look-up table.
+
+  LineChangeTracker* m_line_changes; /// Tracker of changed lines (optional).
+  framebuffer_t* m_framebuffer; /// Output framebuffer.
+
+  M5BackgroundColumnDrawer* m_bg_column_drawer;
+  M5Im2BackgroundColumnDrawer* m_bg_column_drawer_im2;
+
+  M5BackgroundLayerRenderer* m_bg_layer_renderer;
+  M5VsBackgroundLayerRenderer* m_bg_layer_renderer_vs;
+  M5Im2BackgroundLayerRenderer* m_bg_layer_renderer_im2;
+  M5Im2VsBackgroundLayerRenderer* m_bg_layer_renderer_im2_vs;
+
+  M5SpriteLayerRenderer* m_sprite_layer_renderer;
+  M5SteSpriteLayerRenderer* m_sprite_layer_renderer_ste;
+  M5Im2SpriteLayerRenderer* m_sprite_layer_renderer_im2;
+  M5Im2SteSpriteLayerRenderer* m_sprite_layer_renderer_im2_ste;
+
+  M5BackgroundPatternCacheUpdater* m_bg_pattern_cache_updater;
+  M5LineRenderer* m_line_renderer;
+};
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_M5_LINE_RENDER_CONTEXT_H__
@@ -0,0 +1,89 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_M5_LINE_RENDERER_H__
+#define __GPGX_PPU_VDP_M5_LINE_RENDERER_H__
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/ppu/vdp/m5_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_ste_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_vs_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_ste_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_vs_bg_layer_renderer.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Renderer of the background and sprite layers of a line in mode 5.
+///
+/// The layer renderers are resolved at compile time from the interlace double
+/// resolution (IM2), the 16 pixel column vertical scrolling (VS) and the
+/// shadow/highlight (STE) modes: there is one specialization per combination,
+/// selected through a function table when one of these modes changes, so that
+/// rendering a line does not involve any virtual call.
+class M5LineRenderer
+{
+public:
+  M5LineRenderer(
+    M5BackgroundLayerRenderer* bg_layer_renderer,
+    M5VsBackgroundLayerRenderer* bg_layer_renderer_vs,
+    M5Im2BackgroundLayerRenderer* bg_layer_renderer_im2,
+    M5Im2VsBackgroundLayerRenderer* bg_layer_renderer_im2_vs,
+
+    M5SpriteLayerRenderer* sprite_layer_renderer,
+    M5SteSpriteLayerRenderer* sprite_layer_renderer_ste,
+    M5Im2SpriteLayerRenderer* sprite_layer_renderer_im2,
+    M5Im2SteSpriteLayerRenderer* sprite_layer_renderer_im2_ste
+  );
+
+  /// Select the specialization matching the specified modes.
+  ///
+  /// @param  im2     true if interlace double resolution is enabled.
+  /// @param  vscroll true if 16 pixel column vertical scrolling is enabled.
+  /// @param  ste     true if shadow/highlight is enabled.
+  void SetMode(bool im2, bool vscroll, bool ste);
+
+  /// Render the background and sprite layers of the specified line.
+  ///
+  /// @param  line  The line to render.
+  void RenderLayers(s32 line)
+  {
+    (this->*m_render_layers)(line);
+  }
+
+private:
+  using RenderLayersFunction = void (M5LineRenderer::*)(s32 line);
+
+  template <bool kIm2, bool kVScroll, bool kSte>
+  void RenderLayersT(s32 line);
+
+private:
+  /// Specializations (index = IM2 VS STE).
+  static const RenderLayersFunction kRenderLayersFunctions[8];
+
+  M5BackgroundLayerRenderer* m_bg_layer_renderer;
+  M5VsBackgroundLayerRenderer* m_bg_layer_renderer_vs;
+  M5Im2BackgroundLayerRenderer* m_bg_layer_renderer_im2;
+  M5Im2VsBackgroundLayerRenderer* m_bg_layer_renderer_im2_vs;
+
+  M5SpriteLayerRenderer* m_sprite_layer_renderer;
+  M5SteSpriteLayerRenderer* m_sprite_layer_renderer_ste;
+  M5Im2SpriteLayerRenderer* m_sprite_layer_renderer_im2;
+  M5Im2SteSpriteLayerRenderer* m_sprite_layer_renderer_im2_ste;
+
+  RenderLayersFunction m_render_layers; /// Current specialization.
+};
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_M5_LINE_RENDERER_H__
@@ -0,0 +1,82 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_PPU_VDP_M5_PATTERN_CACHE_H__
+#define __GPGX_PPU_VDP_M5_PATTERN_CACHE_H__
+
+#include "xee/fnd/compiler.h"
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Background pattern cache (one pixel per byte, 8 bytes per pattern row).
+///
+/// Default layout, shared by mode 4 (0x20000 bytes) and mode 5:
+///   VHN NNNNNNNN NNYYYxxx (one copy per horizontal/vertical flip)
+///
+/// Compact layout (USE_COMPACT_PATTERN_CACHE), mode 5:
+///   NNNNNNNN NNNYYYxxx (unflipped pattern only, flips are done when drawing)
+///
+/// with:
+///   x = Pattern Pixel (0-7)
+///   Y = Pattern Row (0-7)
+///   N = Pattern Number (0-2047)
+///   H = Horizontal Flip bit
+///   V = Vertical Flip bit
+#ifdef USE_COMPACT_PATTERN_CACHE
+constexpr s32 kPatternCacheSize = 0x20000;
+#else
+constexpr s32 kPatternCacheSize = 0x80000;
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
+
+#ifdef USE_COMPACT_PATTERN_CACHE
+
+//------------------------------------------------------------------------------
+
+/// Reverse the bytes of a 32-bit word (compiled to a byte swap instruction).
+XEE_INLINE u32 ReversePatternBytes(u32 data)
+{
+  return (data >> 24) | ((data >> 8) & 0x0000FF00) | ((data << 8) & 0x00FF0000) | (data << 24);
+}
+
+//------------------------------------------------------------------------------
+
+/// Read a pattern row (8 pixels) from the compact pattern cache.
+///
+/// @param  src   The pattern row.
+/// @param  hflip Non-zero to flip the row horizontally.
+/// @param  row   The 8 pixels (2 x 32-bit words, in memory order).
+XEE_INLINE void ReadPatternRow(const u8* src, u32 hflip, u32* row)
+{
+  u32 a = ((const u32*)src)[0];
+  u32 b = ((const u32*)src)[1];
+
+  if (hflip) {
+    row[0] = ReversePatternBytes(b);
+    row[1] = ReversePatternBytes(a);
+  } else {
+    row[0] = a;
+    row[1] = b;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+/// Mask of all bits set if the specified bit is set, otherwise 0.
+XEE_INLINE u32 GetFlipMask(u32 attr, s32 bit)
+{
+  return 0 - ((attr >> bit) & 1);
+}
+
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
+
+} // namespace gpgx::ppu::vdp
+
+#endif // #ifndef __GPGX_PPU_VDP_M5_PATTERN_CACHE_H__
@@ -55,7 +55,12 @@ namespace gpgx::ppu::vdp {
 //------------------------------------------------------------------------------
 
 /// Parser of sprite attribute table in mode 5.
-class M5SpriteAttributeTableParser : public ISpriteAttributeTableParser
+/// 
+/// The linked sprite list of the internal SAT cache is walked once into a
+/// sprite index (sprites of each line, in link order), which is rebuilt only
+/// when the internal SAT cache is modified (sat_dirty) or when the display
+/// width, interlace mode or sprite limit change.
+class M5SpriteAttributeTableParser final : public ISpriteAttributeTableParser
 {
 public:
   M5SpriteAttributeTableParser(
@@ -64,6 +69,7 @@ public:
     object_info_t(&obj_info)[2][20], 
     u8* object_count, 
     u8* sat, 
+    u8* sat_dirty, 
     u16* satb, 
     u8* im2_flag, 
     u16* max_sprite_pixels, 
@@ -75,6 +81,16 @@ public:
   s32 GetMaxSpritesPerLine() const;
   void ParseSpriteAttributeTable(s32 line);
 
+private:
+  /// Number of lines of the sprite index (9-bit Y position + 32 pixels high).
+  static constexpr s32 kIndexLineCount = 0x220;
+
+  /// Max. number of sprites per line in the index (20 sprites + overflow).
+  static constexpr s32 kIndexSpriteCount = 21;
+
+  /// Walk the linked sprite list and rebuild the sprite index.
+  void UpdateSpriteIndex();
+
 private:
   viewport_t* m_viewport; /// 
   u8* m_vram; /// Video RAM (64K x 8-bit).
@@ -82,10 +98,21 @@ private:
   u8* m_object_count; /// Sprite counter.
 
   u8* m_sat; /// Internal copy of sprite attribute table.
+  u8* m_sat_dirty; /// 1 = Internal copy of sprite attribute table has been modified.
   u16* m_satb; /// Sprite attribute table base address.
   u8* m_im2_flag; /// 1 = Interlace mode 2 is being used.
   u16* m_max_sprite_pixels; /// Max. sprites pixels per line (parsing & rendering).
   u16* m_status; /// VDP status flags.
+
+  // Sprite index.
+  u8 m_line_sprite_count[kIndexLineCount]; /// Number of sprites per line.
+  u8 m_line_sprites[kIndexLineCount][kIndexSpriteCount]; /// Sprites per line (entry indices, in link order).
+  u16 m_sprite_ypos[0x80]; /// Y position per entry.
+  u8 m_sprite_size[0x80]; /// Sprite size per entry.
+
+  u16 m_index_width; /// Display width of the sprite index.
+  u16 m_index_max_sprite_pixels; /// Sprite limit of the sprite index.
+  u8 m_index_im2_flag; /// Interlace mode of the sprite index.
 };
 
 } // namespace gpgx::ppu::vdp
@@ -56,7 +56,7 @@ namespace gpgx::ppu::vdp {
 //------------------------------------------------------------------------------
 
 /// Renderer of sprite layer in mode 5.
-class M5SpriteLayerRenderer : public ISpriteLayerRenderer
+class M5SpriteLayerRenderer final : public ISpriteLayerRenderer
 {
 public:
   M5SpriteLayerRenderer(
@@ -49,12 +49,18 @@ namespace gpgx::ppu::vdp {
 
 //------------------------------------------------------------------------------
 
-/// Drawer of normal sprite tile in mode 5, 5 (IM2), 5 (STE) and 5 (IM2/STE).
+/// Drawer of normal sprite tile in mode 5 and 5 (IM2).
 class M5SpriteTileDrawer
 {
 public:
   M5SpriteTileDrawer(u16* status, u8* lut);
   
+  /// Draw sprite tile over the background.
+  /// 
+  /// @param  width       The number of pixels (multiple of 8).
+  /// @param  attr        The sprite attribute (priority + palette bits).
+  /// @param  src         The sprite pattern pixels.
+  /// @param  line_buffer The line buffer.
   void DrawSpriteTile(s32 width, s32 attr, u8* src, u8* line_buffer);
 
 private:
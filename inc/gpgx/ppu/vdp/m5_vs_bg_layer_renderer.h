@@ -56,7 +56,7 @@ namespace gpgx::ppu::vdp {
 //------------------------------------------------------------------------------
 
 /// Renderer of background layer in mode 5 with 16 pixel column vertical scrolling.
-class M5VsBackgroundLayerRenderer : public IBackgroundLayerRenderer
+class M5VsBackgroundLayerRenderer final : public IBackgroundLayerRenderer
 {
 public:
   M5VsBackgroundLayerRenderer(
@@ -93,7 +93,7 @@ public:
   void RenderBackground(s32 line);
 
 private:
-  void Merge(u8* srca, u8* srcb, u8* dst, u8* table, s32 width);
+  void Merge(u8* srca, u8* srcb, u8* dst, s32 width);
 
 private:
   u8* m_reg; /// Internal VDP registers (23 x 8-bit).
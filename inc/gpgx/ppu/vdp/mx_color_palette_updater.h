@@ -97,10 +97,15 @@ public:
 
   void UpdateColor(s32 index, u32 data);
 
+  /// Get the number of color updates (changes each time the output pixel
+  /// data look-up table is modified).
+  u32 GetVersion() const { return m_version; }
+
 private:
   u8* m_reg; /// Internal VDP registers (23 x 8-bit).
 
   PIXEL_OUT_T* m_pixel; /// Output pixel data look-up table.
+  u32 m_version; /// Number of color updates.
 
   u8* m_system_hw;
 
@@ -0,0 +1,96 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_VGS_BACKUP_FLUSHER_H__
+#define __GPGX_VGS_BACKUP_FLUSHER_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::vgs {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Writer of backup memories (backup RAM, SRAM) to files on a worker thread.
+///
+/// The emulation thread takes a snapshot of a memory when its content differs
+/// from the last saved one (see Save()), at a frame boundary. The worker
+/// writes the snapshot to a temporary file then renames it over the
+/// destination file, so that the file is never left partially written and the
+/// emulation thread never waits for the file system.
+class BackupFlusher
+{
+public:
+  BackupFlusher();
+  ~BackupFlusher();
+
+  /// Start the worker thread.
+  void Start();
+
+  /// Write the pending snapshots, then stop the worker thread.
+  void Stop();
+
+  /// Indicates whether the worker thread is running.
+  bool IsRunning() const { return m_worker.joinable(); }
+
+  /// Set the content of a file (e.g. after it has been loaded): the memory is
+  /// not saved while its content is the same.
+  ///
+  /// @param  path  The path of the file.
+  /// @param  data  The memory.
+  /// @param  size  The size of the memory (in bytes).
+  void SetSaved(const char* path, const u8* data, u32 size);
+
+  /// Save a memory if its content differs from the last saved one (written
+  /// immediately when the worker thread is not running).
+  ///
+  /// @param  path  The path of the file.
+  /// @param  data  The memory.
+  /// @param  size  The size of the memory (in bytes).
+  void Save(const char* path, const u8* data, u32 size);
+
+  /// Write a file atomically (temporary file renamed over the file).
+  ///
+  /// @param  path  The path of the file.
+  /// @param  data  The data.
+  /// @param  size  The size of the data (in bytes).
+  /// @return true on success.
+  static bool WriteFile(const std::string& path, const u8* data, u32 size);
+
+private:
+  /// Saved content of a file.
+  struct File
+  {
+    std::string path;
+    std::vector<u8> data; /// Last saved (or loaded) content.
+    std::vector<u8> pending; /// Snapshot not written yet (worker side).
+    bool queued; /// The snapshot is waiting for the worker.
+  };
+
+private:
+  File* GetFile(const char* path);
+
+  void Run();
+
+private:
+  std::vector<File*> m_files;
+
+  std::thread m_worker;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop;
+};
+
+} // namespace gpgx::vgs
+
+#endif // #ifndef __GPGX_VGS_BACKUP_FLUSHER_H__
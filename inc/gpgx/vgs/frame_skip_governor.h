@@ -0,0 +1,84 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#ifndef __GPGX_VGS_FRAME_SKIP_GOVERNOR_H__
+#define __GPGX_VGS_FRAME_SKIP_GOVERNOR_H__
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::vgs {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Automatic frame skipping.
+///
+/// The governor compares the host time with the time at which each emulated
+/// frame is due (one frame period after the previous one). When the host is
+/// late by more than one frame period, the rendering of the next frames is
+/// skipped (they are still emulated, so audio and timing are unaffected)
+/// until it catches up, with at most kMaxSkippedFrames consecutive skipped
+/// frames so that the display is still updated on a host that is too slow.
+///
+/// The host time is provided by the caller (in microseconds), the governor
+/// does not depend on any clock.
+class FrameSkipGovernor
+{
+public:
+  /// Max. number of consecutive skipped frames.
+  static constexpr s32 kMaxSkippedFrames = 4;
+
+  /// Max. delay (in frame periods) caught up by skipping frames: beyond, the
+  /// delay is dropped (e.g. after the emulation has been paused).
+  static constexpr s32 kMaxLateFrames = 8;
+
+public:
+  FrameSkipGovernor();
+
+  /// Enable or disable frame skipping (frames are never skipped when
+  /// disabled, but the delay is still measured).
+  void SetEnabled(bool enabled);
+
+  /// Check if frame skipping is enabled.
+  bool IsEnabled() const;
+
+  /// Restart the measure.
+  ///
+  /// @param  time          The host time (in microseconds).
+  /// @param  frame_period  The host duration of an emulated frame (in
+  ///                       microseconds, divided by the speed factor in
+  ///                       fast-forward).
+  void Reset(u64 time, u32 frame_period);
+
+  /// Start an emulated frame.
+  ///
+  /// @param  time  The host time (in microseconds).
+  /// @return true if the rendering of the frame must be skipped.
+  bool BeginFrame(u64 time);
+
+  /// Get the number of emulated frames since the last call.
+  u32 TakeFrameCount();
+
+  /// Get the number of skipped frames since the last call.
+  u32 TakeSkippedFrameCount();
+
+private:
+  bool m_enabled; /// Frame skipping is enabled.
+
+  u64 m_start_time; /// Host time of the first frame (in microseconds).
+  u64 m_frame_index; /// Index of the next frame since m_start_time.
+  u32 m_frame_period; /// Host duration of a frame (in microseconds).
+
+  s32 m_skipped; /// Number of consecutive skipped frames.
+
+  u32 m_frame_count; /// Number of emulated frames (statistics).
+  u32 m_skipped_frame_count; /// Number of skipped frames (statistics).
+};
+
+} // namespace gpgx::vgs
+
+#endif // #ifndef __GPGX_VGS_FRAME_SKIP_GOVERNOR_H__
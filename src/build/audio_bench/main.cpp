@@ -0,0 +1,797 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+// Benchmark of the sound chips (and of the audio processing blocks).
+//
+// Each case drives a chip with a canned (deterministic) register sequence,
+// reports the rendering speed and compares the hash of the output with the
+// golden file, so that any optimization can be proven bit-exact.
+//
+// usage: audio_bench [options] [case ...]
+//   -f <frames>   number of emulated frames per case (default: 600)
+//   -i <count>    number of iterations, the fastest is reported (default: 3)
+//   -g <file>     golden file (default: AUDIO_BENCH_GOLDEN_FILE)
+//   -u            update the golden file instead of checking it
+//
+// The exit code is 0 when all hashes match the golden file.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "core/core_config.h"
+
+#include "gpgx/audio/blip_buffer.h"
+#include "gpgx/audio/effect/equalizer_3band.h"
+#include "gpgx/audio/effect/fm_synthesizer_base.h"
+#include "gpgx/ic/sn76489/sn76489.h"
+#include "gpgx/ic/sn76489/sn76489_type.h"
+#include "gpgx/ic/ym2413/ym2413.h"
+#include "gpgx/ic/ym2612/ym2612.h"
+#include "gpgx/ic/ym2612/ym2612_type.h"
+#include "gpgx/ic/ym3438/ym3438.h"
+
+#ifndef AUDIO_BENCH_GOLDEN_FILE
+#define AUDIO_BENCH_GOLDEN_FILE "golden.txt"
+#endif
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+// NTSC master clock and frame length (in M-cycles).
+static constexpr u32 kMasterClock = 53693175;
+static constexpr u32 kFrameCycles = 262 * 3420;
+
+// Output sample rate.
+static constexpr s32 kSampleRate = 44100;
+
+// Size of the FM buffer (one frame at the highest chip rate).
+static constexpr s32 kFmBufferSize = 1080 * 2 * 24;
+
+//------------------------------------------------------------------------------
+
+// Deterministic pseudo-random generator (the sequences must never change).
+class Random
+{
+public:
+  explicit Random(u32 seed) : m_state(seed) {}
+
+  u32 Next()
+  {
+    m_state = (m_state * 1664525) + 1013904223;
+    return m_state >> 8;
+  }
+
+  u32 Next(u32 range) { return Next() % range; }
+
+private:
+  u32 m_state;
+};
+
+//------------------------------------------------------------------------------
+
+// 64-bit FNV-1a hash of the output.
+class Hash
+{
+public:
+  void Add(s32 value)
+  {
+    // Hashed as a little-endian 16-bit sample.
+    Add((u8)(value & 0xff));
+    Add((u8)((value >> 8) & 0xff));
+  }
+
+  u64 Get() const { return m_hash; }
+
+private:
+  void Add(u8 byte)
+  {
+    m_hash ^= byte;
+    m_hash *= 0x100000001b3ULL;
+  }
+
+private:
+  u64 m_hash = 0xcbf29ce484222325ULL;
+};
+
+//------------------------------------------------------------------------------
+
+// Result of one iteration of a case.
+struct CaseResult
+{
+  u64 samples; // Number of output samples (per channel).
+  u64 hash;
+};
+
+typedef CaseResult (*CaseFunction)(s32 frames);
+
+struct BenchCase
+{
+  const char* name;
+  CaseFunction function;
+};
+
+//------------------------------------------------------------------------------
+
+// Read the samples rendered during the last frame.
+static u64 ReadSamples(gpgx::audio::BlipBuffer* blip, Hash& hash)
+{
+  static s16 samples[kSampleRate / 10 * 2];
+
+  s32 count = blip->blip_samples_avail();
+  blip->blip_read_samples(samples, count);
+
+  for (s32 i = 0; i < (count * 2); i++) {
+    hash.Add(samples[i]);
+  }
+
+  return count;
+}
+
+//------------------------------------------------------------------------------
+
+// OPN2 register write (address and data ports).
+static void WriteOpn2(gpgx::audio::effect::FmSynthesizerBase* fm, u32 cycles, u32 port, u32 reg, u32 data)
+{
+  fm->Write(cycles, port << 1, reg);
+  fm->Write(cycles + 17 * 7, (port << 1) | 1, data);
+}
+
+//------------------------------------------------------------------------------
+
+// Canned OPN2 sequence: 5 FM channels playing notes with various algorithms
+// and LFO settings, and a DAC stream on channel 6.
+static CaseResult RunOpn2(gpgx::audio::effect::FmSynthesizerBase* fm, s32 frames)
+{
+  Random random(0x2612);
+  Hash hash;
+  CaseResult result = { 0, 0 };
+
+  std::vector<int> fm_buffer(kFmBufferSize);
+
+  gpgx::audio::BlipBuffer* blip = gpgx::audio::BlipBuffer::blip_new(kSampleRate / 10);
+  blip->blip_set_rates(kMasterClock, kSampleRate);
+
+  fm->SetBlipBuffer(blip);
+  fm->Reset(fm_buffer.data());
+
+  // Voices.
+  u32 cycles = 0;
+
+  WriteOpn2(fm, cycles, 0, 0x22, 0x0b); // LFO ON.
+  cycles += 1000;
+
+  for (u32 ch = 0; ch < 6; ch++) {
+    u32 port = ch / 3;
+    u32 offset = ch % 3;
+
+    WriteOpn2(fm, cycles, port, 0xb0 + offset, (ch & 7) | ((ch & 3) << 3));
+    WriteOpn2(fm, cycles + 300, port, 0xb4 + offset, 0xc0 | (ch & 0x37));
+    cycles += 600;
+
+    for (u32 op = 0; op < 4; op++) {
+      u32 reg = (op << 2) + offset;
+
+      WriteOpn2(fm, cycles, port, 0x30 + reg, 0x01 + ((ch + op) & 0x7f));
+      WriteOpn2(fm, cycles + 300, port, 0x40 + reg, (op == 3) ? 0x04 : (0x18 + (op << 3)));
+      WriteOpn2(fm, cycles + 600, port, 0x50 + reg, 0x1f - op);
+      WriteOpn2(fm, cycles + 900, port, 0x60 + reg, 0x80 | (0x05 + op));
+      WriteOpn2(fm, cycles + 1200, port, 0x70 + reg, 0x02 + op);
+      WriteOpn2(fm, cycles + 1500, port, 0x80 + reg, 0x14 + op);
+      WriteOpn2(fm, cycles + 1800, port, 0x90 + reg, (ch == 1) ? 0x08 + op : 0);
+      cycles += 2100;
+    }
+  }
+
+  // DAC ON.
+  WriteOpn2(fm, cycles, 0, 0x2b, 0x80);
+
+  for (s32 frame = 0; frame < frames; frame++) {
+    // DAC stream (~8 kHz).
+    u32 dac_step = kFrameCycles / 133;
+    u32 next_dac = (frame == 0) ? (cycles + 500) : 500;
+
+    // Note events.
+    u32 next_note = 2000 + random.Next(20000);
+
+    for (u32 time = 0; time < kFrameCycles - 4000; ) {
+      if (next_dac <= next_note) {
+        time = next_dac;
+        WriteOpn2(fm, time, 0, 0x2a, 0x80 + (s32)(random.Next(64)) - 32 + (((frame * 133 + time / dac_step) & 16) ? 40 : -40));
+        next_dac += dac_step;
+      } else {
+        time = next_note;
+
+        u32 ch = random.Next(5);
+        u32 port = (ch >= 3) ? 1 : 0;
+        u32 offset = ch % 3;
+        u32 slot = (port << 2) | offset;
+
+        switch (random.Next(4)) {
+          case 0:
+          case 1:
+          {
+            // Key on (with a new pitch).
+            WriteOpn2(fm, time, port, 0xa4 + offset, (random.Next(8) << 3) | random.Next(3));
+            WriteOpn2(fm, time + 400, port, 0xa0 + offset, random.Next(256));
+            WriteOpn2(fm, time + 800, 0, 0x28, 0xf0 | slot);
+            break;
+          }
+          case 2:
+          {
+            // Key off.
+            WriteOpn2(fm, time, 0, 0x28, slot);
+            break;
+          }
+          default:
+          {
+            // Volume change.
+            WriteOpn2(fm, time, port, 0x4c + offset, random.Next(32));
+            break;
+          }
+        }
+
+        next_note += 1200 + random.Next(30000);
+      }
+    }
+
+    fm->EndFrame(kFrameCycles);
+    blip->blip_end_frame(kFrameCycles);
+    result.samples += ReadSamples(blip, hash);
+  }
+
+  blip->blip_delete();
+
+  result.hash = hash.Get();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunYm2612(s32 frames, s32 type)
+{
+  gpgx::ic::ym2612::Ym2612* ym2612 = new gpgx::ic::ym2612::Ym2612();
+
+  ym2612->YM2612Init();
+  ym2612->YM2612Config(type);
+
+  // chip is running at sample clock.
+  ym2612->SetClockRatio(gpgx::ic::ym2612::Ym2612::kYm2612ClockRatio * 24);
+
+  CaseResult result = RunOpn2(ym2612, frames);
+
+  delete ym2612;
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunYm2612Discrete(s32 frames)
+{
+  return RunYm2612(frames, gpgx::ic::ym2612::YM2612_DISCRETE);
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunYm2612Integrated(s32 frames)
+{
+  return RunYm2612(frames, gpgx::ic::ym2612::YM2612_INTEGRATED);
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunYm2612Enhanced(s32 frames)
+{
+  return RunYm2612(frames, gpgx::ic::ym2612::YM2612_ENHANCED);
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunYm3438(s32 frames)
+{
+  gpgx::ic::ym3438::Ym3438* ym3438 = new gpgx::ic::ym3438::Ym3438();
+
+  ym3438->Init();
+
+  // chip is running at internal clock.
+  ym3438->SetClockRatio(gpgx::ic::ym2612::Ym2612::kYm2612ClockRatio);
+
+  CaseResult result = RunOpn2(ym3438, frames);
+
+  delete ym3438;
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+// Canned OPLL sequence: melodic channels using built-in and user instruments,
+// then rhythm mode.
+static CaseResult RunYm2413(s32 frames)
+{
+  Random random(0x2413);
+  Hash hash;
+  CaseResult result = { 0, 0 };
+
+  std::vector<int> fm_buffer(kFmBufferSize);
+
+  gpgx::audio::BlipBuffer* blip = gpgx::audio::BlipBuffer::blip_new(kSampleRate / 10);
+  blip->blip_set_rates(kMasterClock, kSampleRate);
+
+  gpgx::ic::ym2413::Ym2413* ym2413 = new gpgx::ic::ym2413::Ym2413();
+
+  ym2413->YM2413Init();
+
+  // chip is running at ZCLK / 72 = MCLK / 15 / 72.
+  ym2413->SetClockRatio(72 * 15);
+  ym2413->SetBlipBuffer(blip);
+  ym2413->Reset(fm_buffer.data());
+
+  auto write = [ym2413](u32 cycles, u32 reg, u32 data) {
+    ym2413->Write(cycles, 0, reg);
+    ym2413->Write(cycles + 12 * 15, 1, data);
+  };
+
+  // User instrument.
+  static const u8 kUserInstrument[8] = { 0x61, 0x61, 0x1e, 0x17, 0xf0, 0x7f, 0x00, 0x17 };
+
+  for (u32 reg = 0; reg < 8; reg++) {
+    write(reg * 400, reg, kUserInstrument[reg]);
+  }
+
+  for (s32 frame = 0; frame < frames; frame++) {
+    // Rhythm mode during the second half.
+    bool rhythm = (frame >= (frames / 2));
+
+    if (frame == (frames / 2)) {
+      write(1000, 0x16, 0x20);
+      write(1400, 0x17, 0x50);
+      write(1800, 0x18, 0xc0);
+      write(2200, 0x26, 0x05);
+      write(2600, 0x27, 0x05);
+      write(3000, 0x28, 0x01);
+      write(3400, 0x36, 0x04);
+      write(3800, 0x37, 0x22);
+      write(4200, 0x38, 0x33);
+    }
+
+    for (u32 time = 6000 + random.Next(10000); time < (kFrameCycles - 4000); time += 4000 + random.Next(60000)) {
+      u32 ch = random.Next(rhythm ? 6 : 9);
+
+      switch (random.Next(5)) {
+        case 0:
+        case 1:
+        {
+          // Key on (with a new pitch and instrument).
+          write(time, 0x30 + ch, (random.Next(16) << 4) | random.Next(8));
+          write(time + 400, 0x10 + ch, random.Next(256));
+          write(time + 800, 0x20 + ch, 0x30 | (random.Next(8) << 1) | random.Next(2));
+          break;
+        }
+        case 2:
+        {
+          // Key off.
+          write(time, 0x20 + ch, random.Next(16) & 0x0f);
+          break;
+        }
+        case 3:
+        {
+          // Rhythm instruments (or user instrument change).
+          if (rhythm) {
+            write(time, 0x0e, 0x20 | random.Next(32));
+          } else {
+            write(time, 0x03, random.Next(32));
+          }
+          break;
+        }
+        default:
+        {
+          // Volume change.
+          write(time, 0x30 + ch, (random.Next(16) << 4) | random.Next(16));
+          break;
+        }
+      }
+    }
+
+    ym2413->EndFrame(kFrameCycles);
+    blip->blip_end_frame(kFrameCycles);
+    result.samples += ReadSamples(blip, hash);
+  }
+
+  delete ym2413;
+
+  blip->blip_delete();
+
+  result.hash = hash.Get();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+// Canned PSG sequence: tone channels with frequency sweeps and volume
+// envelopes, and both noise modes.
+static CaseResult RunSn76489(s32 frames)
+{
+  Random random(0x76489);
+  Hash hash;
+  CaseResult result = { 0, 0 };
+
+  gpgx::audio::BlipBuffer* blip = gpgx::audio::BlipBuffer::blip_new(kSampleRate / 10);
+  blip->blip_set_rates(kMasterClock, kSampleRate);
+
+  gpgx::ic::sn76489::Sn76489* psg = new gpgx::ic::sn76489::Sn76489();
+
+  psg->psg_init(gpgx::ic::sn76489::PSG_INTEGRATED);
+  psg->psg_set_blip_buffer(blip);
+  psg->psg_reset();
+  psg->psg_config(0, core_config.psg_preamp, 0xff);
+
+  u32 tone[3] = { 0x0fe, 0x17c, 0x3f8 };
+
+  for (s32 frame = 0; frame < frames; frame++) {
+    // Stereo configuration change (Game Gear).
+    if ((frame % 120) == 60) {
+      psg->psg_config(500, core_config.psg_preamp, random.Next(256));
+    }
+
+    for (u32 time = 1000 + random.Next(8000); time < (kFrameCycles - 4000); time += 3000 + random.Next(40000)) {
+      u32 ch = random.Next(4);
+
+      if (ch < 3) {
+        // Tone sweep (1 to 1023, 0 is also tested).
+        tone[ch] = (tone[ch] + random.Next(64) - 32) & 0x3ff;
+
+        psg->psg_write(time, 0x80 | (ch << 5) | (tone[ch] & 0x0f));
+        psg->psg_write(time + 300, tone[ch] >> 4);
+      } else {
+        // Noise mode (periodic, white, channel 2 frequency).
+        psg->psg_write(time, 0xe0 | random.Next(8));
+      }
+
+      // Volume envelope.
+      psg->psg_write(time + 600, 0x90 | (ch << 5) | random.Next(16));
+    }
+
+    psg->psg_end_frame(kFrameCycles);
+    blip->blip_end_frame(kFrameCycles);
+    result.samples += ReadSamples(blip, hash);
+  }
+
+  delete psg;
+
+  blip->blip_delete();
+
+  result.hash = hash.Get();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunSn76489Hq(s32 frames)
+{
+  core_config.hq_psg = 1;
+
+  return RunSn76489(frames);
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunSn76489Lq(s32 frames)
+{
+  core_config.hq_psg = 0;
+
+  CaseResult result = RunSn76489(frames);
+
+  core_config.hq_psg = 1;
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+// Band-limited synthesis of random steps (one every 32 M-cycles on average).
+static CaseResult RunBlipBuffer(s32 frames, bool fast)
+{
+  Random random(fast ? 0xb11f : 0xb11b);
+  Hash hash;
+  CaseResult result = { 0, 0 };
+
+  gpgx::audio::BlipBuffer* blip = gpgx::audio::BlipBuffer::blip_new(kSampleRate / 10);
+  blip->blip_set_rates(kMasterClock, kSampleRate);
+
+  for (s32 frame = 0; frame < frames; frame++) {
+    for (u32 time = random.Next(64); time < kFrameCycles; time += random.Next(64)) {
+      s32 delta_l = (s32)random.Next(2048) - 1024;
+      s32 delta_r = (s32)random.Next(2048) - 1024;
+
+      if (fast) {
+        blip->blip_add_delta_fast(time, delta_l, delta_r);
+      } else {
+        blip->blip_add_delta(time, delta_l, delta_r);
+      }
+    }
+
+    blip->blip_end_frame(kFrameCycles);
+    result.samples += ReadSamples(blip, hash);
+  }
+
+  blip->blip_delete();
+
+  result.hash = hash.Get();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunBlipBufferHq(s32 frames)
+{
+  return RunBlipBuffer(frames, false);
+}
+
+//------------------------------------------------------------------------------
+
+static CaseResult RunBlipBufferFast(s32 frames)
+{
+  return RunBlipBuffer(frames, true);
+}
+
+//------------------------------------------------------------------------------
+
+// 3-band equalizer applied to a stereo signal (two sines and noise).
+static CaseResult RunEqualizer3band(s32 frames)
+{
+  Random random(0xe03b);
+  Hash hash;
+  CaseResult result = { 0, 0 };
+
+  gpgx::audio::effect::Equalizer3band eq[2];
+
+  for (s32 i = 0; i < 2; i++) {
+    eq[i].init_3band_state(200, 8000, kSampleRate);
+    eq[i].SetLowGainControl(1.5);
+    eq[i].SetMiddleGainControl(0.75);
+    eq[i].SetHighGainControl(1.25);
+  }
+
+  // Same number of samples as the chips cases.
+  s32 count = (s32)(((u64)frames * kFrameCycles * kSampleRate) / kMasterClock);
+
+  // Square waves (bass and treble) mixed with noise.
+  for (s32 i = 0; i < count; i++) {
+    s32 in_l = ((i / 100) & 1) ? 8000 : -8000;
+    s32 in_r = ((i / 7) & 1) ? 6000 : -6000;
+
+    in_l += (s32)random.Next(4096) - 2048;
+    in_r += (s32)random.Next(4096) - 2048;
+
+    s32 l = (s32)eq[0].do_3band(in_l);
+    s32 r = (s32)eq[1].do_3band(in_r);
+
+    // clipping (16-bit samples).
+    if (l > 32767) l = 32767;
+    else if (l < -32768) l = -32768;
+    if (r > 32767) r = 32767;
+    else if (r < -32768) r = -32768;
+
+    hash.Add(l);
+    hash.Add(r);
+  }
+
+  result.samples = count;
+  result.hash = hash.Get();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+static const BenchCase kCases[] = {
+  { "ym2612",          RunYm2612Discrete },
+  { "ym2612_asic",     RunYm2612Integrated },
+  { "ym2612_enhanced", RunYm2612Enhanced },
+  { "ym3438",          RunYm3438 },
+  { "ym2413",          RunYm2413 },
+  { "sn76489",         RunSn76489Hq },
+  { "sn76489_lq",      RunSn76489Lq },
+  { "blip",            RunBlipBufferHq },
+  { "blip_fast",       RunBlipBufferFast },
+  { "eq3band",         RunEqualizer3band },
+};
+
+//------------------------------------------------------------------------------
+
+// Golden file: one "<case> <frames> <hash>" line per case.
+static bool FindGoldenHash(const std::vector<std::string>& lines, const char* name, s32 frames, u64& hash)
+{
+  for (const std::string& line : lines) {
+    char line_name[64];
+    s32 line_frames = 0;
+    unsigned long long line_hash = 0;
+
+    if (sscanf(line.c_str(), "%63s %d %llx", line_name, &line_frames, &line_hash) != 3) {
+      continue;
+    }
+
+    if (!strcmp(line_name, name) && (line_frames == frames)) {
+      hash = line_hash;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+  s32 frames = 600;
+  s32 iterations = 3;
+  const char* golden_path = AUDIO_BENCH_GOLDEN_FILE;
+  bool update = false;
+  std::vector<std::string> selected;
+
+  for (s32 i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-f") && ((i + 1) < argc)) {
+      frames = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-i") && ((i + 1) < argc)) {
+      iterations = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-g") && ((i + 1) < argc)) {
+      golden_path = argv[++i];
+    } else if (!strcmp(argv[i], "-u")) {
+      update = true;
+    } else {
+      selected.push_back(argv[i]);
+    }
+  }
+
+  if ((frames < 1) || (iterations < 1)) {
+    printf("usage: %s [-f frames] [-i iterations] [-g golden] [-u] [case ...]\n", argv[0]);
+    return 1;
+  }
+
+  // Sound settings used by the chips.
+  core_config.psg_preamp = 150;
+  core_config.fm_preamp = 100;
+  core_config.hq_fm = 1;
+  core_config.hq_psg = 1;
+
+  // Load the golden file.
+  std::vector<std::string> golden;
+  FILE* file = fopen(golden_path, "r");
+
+  if (file) {
+    char line[256];
+
+    while (fgets(line, sizeof(line), file)) {
+      golden.push_back(line);
+    }
+
+    fclose(file);
+  } else if (!update) {
+    fprintf(stderr, "cannot open golden file %s\n", golden_path);
+  }
+
+  printf("%-16s %10s %10s %12s %10s  %-16s %s\n", "case", "samples", "time (ms)", "samples/s", "ns/sample", "hash", "golden");
+
+  s32 failures = 0;
+  std::vector<std::string> updated;
+
+  for (const BenchCase& bench_case : kCases) {
+    bool run = selected.empty();
+
+    for (const std::string& name : selected) {
+      run |= (name == bench_case.name);
+    }
+
+    if (!run) {
+      continue;
+    }
+
+    CaseResult result = { 0, 0 };
+    f64 best = 0.0;
+    bool stable = true;
+
+    for (s32 i = 0; i < iterations; i++) {
+      auto start = std::chrono::steady_clock::now();
+      CaseResult current = bench_case.function(frames);
+      f64 seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+
+      // The output must not depend on the iteration.
+      if (i && (current.hash != result.hash)) {
+        stable = false;
+      }
+
+      if (!i || (seconds < best)) {
+        best = seconds;
+      }
+
+      result = current;
+    }
+
+    const char* status = "-";
+    u64 expected = 0;
+
+    if (!stable) {
+      status = "UNSTABLE";
+      failures++;
+    } else if (update) {
+      status = "UPDATED";
+    } else if (FindGoldenHash(golden, bench_case.name, frames, expected)) {
+      if (expected == result.hash) {
+        status = "OK";
+      } else {
+        status = "MISMATCH";
+        failures++;
+      }
+    } else {
+      status = "MISSING";
+    }
+
+    char line[128];
+    snprintf(line, sizeof(line), "%s %d %016llx\n", bench_case.name, frames, (unsigned long long)result.hash);
+    updated.push_back(line);
+
+    printf("%-16s %10llu %10.2f %12.0f %10.1f  %016llx %s\n", bench_case.name, (unsigned long long)result.samples,
+      best * 1000.0, result.samples / best, (best * 1e9) / result.samples, (unsigned long long)result.hash, status);
+  }
+
+  // Update the golden file (hashes of other cases or frame counts are kept).
+  if (update) {
+    std::vector<std::string> lines;
+
+    for (const std::string& line : golden) {
+      char name[64];
+      s32 line_frames = 0;
+
+      if (sscanf(line.c_str(), "%63s %d", name, &line_frames) != 2) {
+        continue;
+      }
+
+      bool replaced = false;
+
+      for (const std::string& updated_line : updated) {
+        char updated_name[64];
+        s32 updated_frames = 0;
+
+        sscanf(updated_line.c_str(), "%63s %d", updated_name, &updated_frames);
+        replaced |= (!strcmp(name, updated_name) && (line_frames == updated_frames));
+      }
+
+      if (!replaced) {
+        lines.push_back(line);
+      }
+    }
+
+    lines.insert(lines.end(), updated.begin(), updated.end());
+
+    file = fopen(golden_path, "w");
+
+    if (!file) {
+      fprintf(stderr, "cannot write golden file %s\n", golden_path);
+      return 1;
+    }
+
+    for (const std::string& line : lines) {
+      fputs(line.c_str(), file);
+    }
+
+    fclose(file);
+  }
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,226 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+// Converter of CD images to compressed disc images (see
+// gpgx::cd::CompressedCdStream).
+//
+// A CUE sheet is converted by compressing each file it references to
+// "<file>.cdz" in the output directory, then by writing the CUE sheet with the
+// file names replaced. Any other file (BIN, ISO) is compressed to
+// "<file>.cdz".
+//
+// usage: cdz_pack [options] image.cue|image.bin|image.iso output_dir
+//   -s <count>    number of 2352-byte sectors per hunk (default: 8)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/cd/compressed_cd_stream.h"
+#include "gpgx/cd/compressed_cd_writer.h"
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+static void PrintUsage()
+{
+  fprintf(stderr,
+    "usage: cdz_pack [options] image.cue|image.bin|image.iso output_dir\n"
+    "  -s <count>    number of 2352-byte sectors per hunk (default: 8)\n");
+}
+
+//------------------------------------------------------------------------------
+
+/// Get the position after the directory part of a path.
+static size_t GetNameStart(const std::string& path)
+{
+  size_t pos = path.find_last_of("/\\");
+
+  return (pos == std::string::npos) ? 0 : pos + 1;
+}
+
+//------------------------------------------------------------------------------
+
+/// Replace the extension of a file name by ".cdz".
+static std::string GetCompressedName(const std::string& name)
+{
+  size_t pos = name.find_last_of('.');
+
+  if ((pos == std::string::npos) || (pos < GetNameStart(name))) {
+    return name + ".cdz";
+  }
+
+  return name.substr(0, pos) + ".cdz";
+}
+
+//------------------------------------------------------------------------------
+
+static bool IsCueSheet(const std::string& path)
+{
+  if (path.size() < 4) {
+    return false;
+  }
+
+  std::string ext = path.substr(path.size() - 4);
+
+  return (ext == ".cue") || (ext == ".CUE");
+}
+
+//------------------------------------------------------------------------------
+
+static bool Compress(gpgx::cd::CompressedCdWriter& writer, const std::string& src,
+  const std::string& dst)
+{
+  if (!writer.Write(src.c_str(), dst.c_str())) {
+    fprintf(stderr, "error: cannot compress \"%s\" to \"%s\"\n", src.c_str(), dst.c_str());
+    return false;
+  }
+
+  s64 input_size = writer.GetInputSize();
+  s64 output_size = writer.GetOutputSize();
+
+  printf("%s: %lld -> %lld bytes (%.1f%%)\n",
+    dst.c_str(),
+    (long long)input_size,
+    (long long)output_size,
+    input_size ? (100.0 * (f64)output_size / (f64)input_size) : 100.0
+  );
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+/// Convert a CUE sheet and the files it references.
+static bool ConvertCueSheet(gpgx::cd::CompressedCdWriter& writer, const std::string& cue_path,
+  const std::string& output_dir)
+{
+  FILE* src = fopen(cue_path.c_str(), "r");
+
+  if (!src) {
+    fprintf(stderr, "error: cannot open \"%s\"\n", cue_path.c_str());
+    return false;
+  }
+
+  std::string cue_dir = cue_path.substr(0, GetNameStart(cue_path));
+  std::vector<std::string> lines;
+  char line[1024];
+  bool ok = true;
+
+  while (ok && fgets(line, sizeof(line), src)) {
+    std::string text = line;
+    size_t start = text.find_first_not_of(' ');
+
+    if ((start == std::string::npos) || text.compare(start, 4, "FILE")) {
+      lines.push_back(text);
+      continue;
+    }
+
+    // FILE "name" TYPE (the name can also be unquoted).
+    size_t name_start = text.find_first_not_of(' ', start + 4);
+    size_t name_end = std::string::npos;
+
+    if ((name_start != std::string::npos) && (text[name_start] == '\"')) {
+      name_start++;
+      name_end = text.find('\"', name_start);
+    } else if (name_start != std::string::npos) {
+      name_end = text.find(' ', name_start);
+    }
+
+    if ((name_start == std::string::npos) || (name_end == std::string::npos)) {
+      fprintf(stderr, "error: invalid FILE command in \"%s\"\n", cue_path.c_str());
+      ok = false;
+      break;
+    }
+
+    std::string name = text.substr(name_start, name_end - name_start);
+    std::string compressed_name = GetCompressedName(name);
+
+    // The name of the output file has no directory part.
+    compressed_name = compressed_name.substr(GetNameStart(compressed_name));
+
+    ok = Compress(writer, cue_dir + name, output_dir + "/" + compressed_name);
+
+    lines.push_back(text.substr(0, name_start) + compressed_name + text.substr(name_end));
+  }
+
+  fclose(src);
+
+  if (!ok) {
+    return false;
+  }
+
+  std::string dst_path = output_dir + "/" + cue_path.substr(GetNameStart(cue_path));
+  FILE* dst = fopen(dst_path.c_str(), "w");
+
+  if (!dst) {
+    fprintf(stderr, "error: cannot create \"%s\"\n", dst_path.c_str());
+    return false;
+  }
+
+  for (const std::string& text : lines) {
+    fputs(text.c_str(), dst);
+  }
+
+  if (fclose(dst)) {
+    fprintf(stderr, "error: cannot write \"%s\"\n", dst_path.c_str());
+    return false;
+  }
+
+  printf("%s\n", dst_path.c_str());
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+  u32 hunk_sectors = gpgx::cd::CompressedCdStream::kHunkSize / 2352;
+  std::vector<std::string> paths;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-s") && ((i + 1) < argc)) {
+      hunk_sectors = (u32)atoi(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      PrintUsage();
+      return EXIT_FAILURE;
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+
+  u32 max_sectors = gpgx::cd::CompressedCdStream::kMaxHunkSize / 2352;
+
+  if ((paths.size() != 2) || !hunk_sectors || (hunk_sectors > max_sectors)) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  const std::string& input_path = paths[0];
+  const std::string& output_dir = paths[1];
+
+  gpgx::cd::CompressedCdWriter writer;
+
+  writer.SetHunkSize(hunk_sectors * 2352);
+
+  bool ok;
+
+  if (IsCueSheet(input_path)) {
+    ok = ConvertCueSheet(writer, input_path, output_dir);
+  } else {
+    std::string name = GetCompressedName(input_path.substr(GetNameStart(input_path)));
+
+    ok = Compress(writer, input_path, output_dir + "/" + name);
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -67,6 +67,7 @@ void set_config_defaults(void)
   core_config.ym2413         = 2; /* = AUTO (0 = always OFF, 1 = always ON) */
   core_config.ym3438         = 0;
   core_config.mono           = 0;
+  core_config.resampler      = 1; /* = ON (output rate can be changed without reinitializing sound chips) */
 
   /* system options */
   core_config.system         = 0; /* = AUTO (or SYSTEM_SG, SYSTEM_SGII, SYSTEM_SGII_RAM_EXT, SYSTEM_MARKIII, SYSTEM_SMS, SYSTEM_SMS2, SYSTEM_GG, SYSTEM_MD) */
@@ -79,10 +80,14 @@ void set_config_defaults(void)
   core_config.lock_on        = 0; /* = OFF (or TYPE_SK, TYPE_GG & TYPE_AR) */
   core_config.add_on         = 0; /* = HW_ADDON_AUTO (or HW_ADDON_MEGACD, HW_ADDON_MEGASD & HW_ADDON_ONE) */
   core_config.cd_latency     = 1;
+  core_config.cd_stream      = 0; /* = stdio (1 = memory-mapped, 2 = background read-ahead) */
+  core_config.cd_cache       = 0; /* = no sector cache, except for compressed images (number of cached sectors) */
 
   /* display options */
   core_config.overscan = 0;  /* 3 = all borders (0 = no borders , 1 = vertical borders only, 2 = horizontal borders only) */
   core_config.gg_extra = 0;  /* 1 = show extended Game Gear screen (256x192) */
+  core_config.render_threads = 0; /* 0 = OFF (N = deferred rendering with N worker threads) */
+  core_config.gfx_threads = 0; /* 0 = OFF (N = Mega-CD graphics operations fetched by N worker threads) */
 
   /* controllers options */
   gpgx::g_hid_system->ConnectDevice(0, gpgx::hid::DeviceType::kGamepad);
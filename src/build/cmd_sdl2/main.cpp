@@ -48,6 +48,7 @@
 #include "core/vdp/pixel.h"
 #include "core/loadrom.h"
 #include "core/audio_subsystem.h"
+#include "core/backup_ram.h"
 #include "core/boot_rom.h"
 #include "core/core_config.h"
 #include "core/framebuffer.h"
@@ -58,36 +59,61 @@
 #include "core/snd.h"
 #include "core/system.h"
 #include "core/system_bios.h"
+#include "core/system_clock.h"
 #include "core/system_hw.h"
 #include "core/system_model.h"
+#include "core/system_timing.h"
 #include "core/viewport.h"
 #include "core/ext.h" // For scd.
 #include "core/genesis.h" // For gen_reset().
 #include "core/vdp_ctrl.h"
+#include "core/vdp_render.h" // For render_shutdown().
 #include "core/input_hw/input.h"
 #include "core/cart_hw/sram.h"
+#include "core/cd_hw/gfx.h" // For gfx_shutdown().
 #include "core/state.h"
 
+#include "gpgx/audio/audio_decimator.h"
+#include "gpgx/audio/polyphase_resampler.h"
 #include "gpgx/cpu/z80/z80.h"
 
 #include "gpgx/hid/controller_type.h"
 #include "gpgx/hid/hid_system.h"
 #include "gpgx/hid/input.h"
 #include "gpgx/g_audio_renderer.h"
+#include "gpgx/g_fm_synthesizer.h"
 #include "gpgx/g_hid_system.h"
+#include "gpgx/g_psg.h"
+#include "gpgx/g_recorder.h"
+#include "gpgx/g_register_log.h"
+#include "gpgx/ic/sn76489/sn76489_type.h"
 #include "gpgx/g_z80.h"
+#include "gpgx/vgs/backup_flusher.h"
+#include "gpgx/vgs/frame_skip_governor.h"
 
-#define SOUND_FREQUENCY 48000
 #define SOUND_SAMPLES_SIZE  2048
 
+/* max. output rate deviation of dynamic rate control (polyphase resampler only) */
+#define SOUND_RATE_CONTROL 0.005
+
 #define VIDEO_WIDTH  320
 #define VIDEO_HEIGHT 240
 
+/* max. number of window areas updated per frame (changed lines) */
+#define VIDEO_UPDATE_RECTS 16
+
+/* fast-forward speed (with sound) */
+#define TURBO_SPEED 4
+
+/* number of frames between checks of backup memories written without handler (directly mapped) */
+#define BACKUP_CHECK_FRAMES 60
+
 int joynum = 0;
 
 int log_error   = 0;
 int debug_on    = 0;
 int turbo_mode  = 0;
+int frame_skip  = 1; /* automatic frame skipping */
 int use_sound   = 1;
 int fullscreen  = 0; /* SDL_WINDOW_FULLSCREEN */
 
@@ -98,6 +124,7 @@ struct {
   SDL_Rect srect;
   SDL_Rect drect;
   Uint32 frames_rendered;
+  int full_update; /* 1 = whole bitmap is blitted (otherwise changed lines only) */
 } sdl_video;
 
 /* sound */
@@ -108,6 +135,10 @@ struct {
   int current_emulated_samples;
 } sdl_sound;
 
+/* output sample rates (cycled with Page Up) */
+static const int sound_rates[4] = { 32000, 44100, 48000, 96000 };
+static int sound_rate_index = 2;
+
 
 static u8 brm_format[0x40] =
 {
@@ -118,7 +149,12 @@ static u8 brm_format[0x40] =
 };
 
 
-static short soundframe[SOUND_SAMPLES_SIZE];
+/* samples rendered for one frame (sized from current output rate) */
+static short* soundframe = NULL;
+static int soundframe_size = 0;
+
+/* fast-forward audio (samples of TURBO_SPEED frames are played in one frame) */
+static gpgx::audio::AudioDecimator sound_decimator;
 
 static void sdl_sound_callback(void *userdata, Uint8 *stream, int len)
 {
@@ -138,7 +174,7 @@ static void sdl_sound_callback(void *userdata, Uint8 *stream, int len)
   }
 }
 
-static int sdl_sound_init()
+static int sdl_sound_init(int samplerate)
 {
   int n;
   SDL_AudioSpec as_desired;
@@ -148,7 +184,7 @@ static int sdl_sound_init()
     return 0;
   }
 
-  as_desired.freq     = SOUND_FREQUENCY;
+  as_desired.freq     = samplerate;
   as_desired.format   = AUDIO_S16SYS;
   as_desired.channels = 2;
   as_desired.samples  = SOUND_SAMPLES_SIZE;
@@ -173,12 +209,36 @@ static int sdl_sound_init()
 
 static void sdl_sound_update(int enabled)
 {
-  int size = gpgx::g_audio_renderer->Update(soundframe) * 2;
+  int size;
+
+  /* Blip Buffers hold up to 100 ms of samples, which may be converted to a higher output rate */
+  int max = (snd.sample_rate / 10) * 2;
+  if (snd.resampler)
+  {
+    max = snd.resampler->GetMaxOutputSamples(snd.sample_rate / 10) * 2;
+  }
+
+  if (max > soundframe_size)
+  {
+    short *frame = (short*)realloc(soundframe, max * sizeof(short));
+    if (!frame)
+    {
+      return;
+    }
+    soundframe = frame;
+    soundframe_size = max;
+  }
+
+  size = gpgx::g_audio_renderer->Update(soundframe) * 2;
 
   if (enabled)
   {
     int i;
     short *out;
+    f64 fill;
+
+    /* fast-forward: keep the output rate */
+    size = sound_decimator.Process(soundframe, size / 2) * 2;
 
     SDL_LockAudio();
     out = (short*)sdl_sound.current_pos;
@@ -188,7 +248,13 @@ static void sdl_sound_update(int enabled)
     }
     sdl_sound.current_pos = (char*)out;
     sdl_sound.current_emulated_samples += size * sizeof(short);
+    fill = (f64)sdl_sound.current_emulated_samples / (SOUND_SAMPLES_SIZE * 2 * sizeof(short) * 2);
     SDL_UnlockAudio();
+
+    /* dynamic rate control: keep about one SDL buffer of samples queued, so that the */
+    /* callback does not have to drop or repeat samples when timings slightly differ  */
+    if (fill > 1.0) fill = 1.0;
+    audio_set_rate_adjustment(1.0 + SOUND_RATE_CONTROL * (1.0 - 2.0 * fill));
   }
 }
 
@@ -198,6 +264,7 @@ static void sdl_sound_close()
   SDL_CloseAudio();
   if (sdl_sound.buffer)
     free(sdl_sound.buffer);
+  sdl_sound.buffer = NULL;
 }
 
 /* video */
@@ -222,23 +289,30 @@ static int sdl_video_init()
   sdl_video.surf_screen  = SDL_GetWindowSurface(sdl_video.window);
   sdl_video.surf_bitmap = SDL_CreateRGBSurfaceWithFormat(0, 720, 576, SDL_BITSPERPIXEL(surface_format), surface_format);
   sdl_video.frames_rendered = 0;
+  sdl_video.full_update = 1;
   SDL_ShowCursor(0);
   return 1;
 }
 
-static void sdl_video_update()
+static void sdl_video_update(int do_skip)
 {
   if (system_hw == SYSTEM_MCD)
   {
-    system_frame_scd(0);
+    system_frame_scd(do_skip);
   }
   else if ((system_hw & SYSTEM_PBC) == SYSTEM_MD)
   {
-    system_frame_gen(0);
+    system_frame_gen(do_skip);
   }
   else	
   {
-    system_frame_sms(0);
+    system_frame_sms(do_skip);
+  }
+
+  /* frame is emulated but not rendered */
+  if (do_skip)
+  {
+    return;
   }
 
   /* viewport size changed */
@@ -270,10 +344,45 @@ static void sdl_video_update()
 
     /* clear destination surface */
     SDL_FillRect(sdl_video.surf_screen, 0, 0);
+    sdl_video.full_update = 1;
   }
 
-  SDL_BlitSurface(sdl_video.surf_bitmap, &sdl_video.srect, sdl_video.surf_screen, &sdl_video.drect);
-  SDL_UpdateWindowSurface(sdl_video.window);
+  if (sdl_video.full_update)
+  {
+    sdl_video.full_update = 0;
+    SDL_BlitSurface(sdl_video.surf_bitmap, &sdl_video.srect, sdl_video.surf_screen, &sdl_video.drect);
+    SDL_UpdateWindowSurface(sdl_video.window);
+  }
+  else
+  {
+    /* only blit & update the lines changed since the previous rendered frame */
+    SDL_Rect rects[VIDEO_UPDATE_RECTS];
+    int count = 0;
+    int line = sdl_video.srect.y;
+    int end = sdl_video.srect.y + sdl_video.srect.h;
+
+    while (line < end)
+    {
+      int height;
+      line = g_line_change_tracker->FindChangedLines(line, end, &height);
+      if (line >= end) break;
+
+      /* last area covers all remaining lines */
+      if (count == (VIDEO_UPDATE_RECTS - 1)) height = end - line;
+
+      SDL_Rect src = { sdl_video.srect.x, line, sdl_video.srect.w, height };
+      SDL_Rect dst = { sdl_video.drect.x, sdl_video.drect.y + (line - sdl_video.srect.y), sdl_video.drect.w, height };
+      rects[count++] = dst;
+      SDL_BlitSurface(sdl_video.surf_bitmap, &src, sdl_video.surf_screen, &dst);
+
+      line += height;
+    }
+
+    if (count)
+    {
+      SDL_UpdateWindowSurfaceRects(sdl_video.window, rects, count);
+    }
+  }
 
   ++sdl_video.frames_rendered;
 }
@@ -289,8 +398,12 @@ static void sdl_video_close()
 struct {
   SDL_sem* sem_sync;
   unsigned ticks;
+  Uint32 frames_emulated;
+  u32 frame_period;
 } sdl_sync;
 
+static gpgx::vgs::FrameSkipGovernor frame_skip_governor;
+
 static Uint32 sdl_sync_timer_callback(Uint32 interval, void *param)
 {
   SDL_SemPost(sdl_sync.sem_sync);
@@ -324,6 +437,8 @@ static int sdl_sync_init()
 
   sdl_sync.sem_sync = SDL_CreateSemaphore(0);
   sdl_sync.ticks = 0;
+  sdl_sync.frames_emulated = 0;
+  sdl_sync.frame_period = 0;
   return 1;
 }
 
@@ -333,6 +448,46 @@ static void sdl_sync_close()
     SDL_DestroySemaphore(sdl_sync.sem_sync);
 }
 
+/* host time (in microseconds) */
+static u64 sdl_sync_time()
+{
+  return (u64)((f64)SDL_GetPerformanceCounter() * 1000000.0 / (f64)SDL_GetPerformanceFrequency());
+}
+
+/* emulation speed (fast-forward is throttled when sound is enabled) */
+static int sdl_sync_speed()
+{
+  return (turbo_mode && use_sound) ? TURBO_SPEED : 1;
+}
+
+/* check if the next frame should be emulated without being rendered */
+static int sdl_sync_skip()
+{
+  u64 time = sdl_sync_time();
+
+  /* host duration of an emulated frame */
+  u32 period = (u32)((1000000.0 * lines_per_frame * MCYCLES_PER_LINE) / system_clock / sdl_sync_speed());
+
+  if (period != sdl_sync.frame_period)
+  {
+    sdl_sync.frame_period = period;
+    frame_skip_governor.Reset(time, period);
+  }
+
+  /* captured frames are never skipped */
+  frame_skip_governor.SetEnabled(frame_skip && !gpgx::g_recorder);
+
+  int skip = frame_skip_governor.BeginFrame(time);
+
+  /* fast-forward: only one frame out of TURBO_SPEED is rendered */
+  if (turbo_mode && !gpgx::g_recorder && (sdl_sync.frames_emulated % TURBO_SPEED))
+  {
+    skip = 1;
+  }
+
+  return skip;
+}
+
 static const u16 vc_table[4][2] =
 {
   /* NTSC, PAL */
@@ -342,6 +497,39 @@ static const u16 vc_table[4][2] =
   {0x106, 0x10A}  /* Mode 5 (240 lines) */
 };
 
+/* backup memories */
+
+static gpgx::vgs::BackupFlusher backup_flusher;
+
+static void sdl_backup_update(int check)
+{
+  if (system_hw == SYSTEM_MCD)
+  {
+    /* save internal backup RAM (if modified and formatted) */
+    if ((check || (backup_ram_dirty & BACKUP_RAM_SCD)) && !xee::mem::Memcmp(scd.bram + 0x2000 - 0x20, brm_format + 0x20, 0x20))
+    {
+      backup_flusher.Save("./scd.brm", scd.bram, 0x2000);
+    }
+
+    /* save cartridge backup RAM (if modified and formatted) */
+    if (scd.cartridge.id && (check || (backup_ram_dirty & BACKUP_RAM_CART)))
+    {
+      if (!xee::mem::Memcmp(scd.cartridge.area + scd.cartridge.mask + 1 - 0x20, brm_format + 0x20, 0x20))
+      {
+        backup_flusher.Save("./cart.brm", scd.cartridge.area, scd.cartridge.mask + 1);
+      }
+    }
+  }
+
+  /* save SRAM (if modified) */
+  if (sram.on && (check || (backup_ram_dirty & BACKUP_RAM_SRAM)))
+  {
+    backup_flusher.Save("./game.srm", sram.sram, 0x10000);
+  }
+
+  backup_ram_dirty = 0;
+}
+
 static u8 state_load_buf[STATE_SIZE];
 static u8 state_save_buf[STATE_SIZE];
 
@@ -380,7 +568,7 @@ static int sdl_control_update(SDL_Keycode keystate)
 
       case SDLK_F4:
       {
-        if (!turbo_mode) use_sound ^= 1;
+        use_sound ^= 1;
         break;
       }
 
@@ -392,11 +580,32 @@ static int sdl_control_update(SDL_Keycode keystate)
 
       case SDLK_F6:
       {
-        if (!use_sound)
+        /* fast-forward (audio is decimated to keep playing) */
+        turbo_mode ^=1;
+        sdl_sync.ticks = 0;
+        sound_decimator.SetFactor(turbo_mode ? TURBO_SPEED : 1);
+        break;
+      }
+
+      case SDLK_PAGEDOWN:
+      {
+        frame_skip ^= 1;
+        break;
+      }
+
+      case SDLK_PAGEUP:
+      {
+        /* cycle output sample rate (only the polyphase resampler is reconfigured) */
+        sound_rate_index = (sound_rate_index + 1) % 4;
+        if (sdl_sound.buffer)
         {
-          turbo_mode ^=1;
-          sdl_sync.ticks = 0;
+          sdl_sound_close();
+          if (sdl_sound_init(sound_rates[sound_rate_index]))
+          {
+            SDL_PauseAudio(0);
+          }
         }
+        audio_set_output_rate(sound_rates[sound_rate_index]);
         break;
       }
 
@@ -430,7 +639,7 @@ static int sdl_control_update(SDL_Keycode keystate)
         get_region(0);
 
         /* framerate has changed, reinitialize audio timings */
-        audio_init(snd.sample_rate, 0);
+        audio_init(snd.output_rate, 0);
 
         /* system with region BIOS should be reinitialized */
         if ((system_hw == SYSTEM_MCD) || ((system_hw & SYSTEM_SMS) && (core_config.bios & 1)))
@@ -510,6 +719,55 @@ static int sdl_control_update(SDL_Keycode keystate)
         break;
       }
 
+      case SDLK_PRINTSCREEN:
+      {
+        /* toggle audio/video capture */
+        if (gpgx::g_recorder)
+        {
+          gpgx::g_recorder->Stop();
+          delete gpgx::g_recorder;
+          gpgx::g_recorder = nullptr;
+        }
+        else
+        {
+          gpgx::g_recorder = new gpgx::capture::Recorder();
+          f64 frame_rate = (f64)system_clock / (f64)(lines_per_frame * MCYCLES_PER_LINE);
+          if (!gpgx::g_recorder->Start("./capture", gpgx::capture::VideoFormat::kY4m, true, snd.output_rate, frame_rate))
+          {
+            delete gpgx::g_recorder;
+            gpgx::g_recorder = nullptr;
+          }
+        }
+        break;
+      }
+
+      case SDLK_SCROLLLOCK:
+      {
+        /* toggle sound chips register log */
+        if (gpgx::g_register_log)
+        {
+          gpgx::g_register_log->Close();
+          delete gpgx::g_register_log;
+          gpgx::g_register_log = nullptr;
+        }
+        else
+        {
+          gpgx::g_register_log = new gpgx::capture::RegisterLogWriter();
+          if (gpgx::g_register_log->Open("./capture.vrl", system_clock, (system_hw == SYSTEM_SG) ? gpgx::ic::sn76489::PSG_DISCRETE : gpgx::ic::sn76489::PSG_INTEGRATED))
+          {
+            /* log starts with current chips state */
+            gpgx::g_fm_synthesizer->LogState(0);
+            gpgx::g_psg->psg_log_state(0);
+          }
+          else
+          {
+            delete gpgx::g_register_log;
+            gpgx::g_register_log = nullptr;
+          }
+        }
+        break;
+      }
+
       case SDLK_ESCAPE:
       {
         return 0;
@@ -808,7 +1066,7 @@ int main (int argc, char **argv)
     return 1;
   }
   sdl_video_init();
-  if (use_sound) sdl_sound_init();
+  if (use_sound) sdl_sound_init(sound_rates[sound_rate_index]);
   sdl_sync_init();
 
   /* initialize Genesis virtual system */
@@ -831,7 +1089,7 @@ int main (int argc, char **argv)
   }
 
   /* initialize system hardware */
-  audio_init(SOUND_FREQUENCY, 0);
+  audio_init(sound_rates[sound_rate_index], 0);
   system_init();
 
   /* Mega CD specific */
@@ -841,7 +1099,10 @@ int main (int argc, char **argv)
     fp = fopen("./scd.brm", "rb");
     if (fp!=NULL)
     {
-      fread(scd.bram, 0x2000, 1, fp);
+      if (fread(scd.bram, 0x2000, 1, fp))
+      {
+        backup_flusher.SetSaved("./scd.brm", scd.bram, 0x2000);
+      }
       fclose(fp);
     }
 
@@ -865,7 +1126,10 @@ int main (int argc, char **argv)
       fp = fopen("./cart.brm", "rb");
       if (fp!=NULL)
       {
-        fread(scd.cartridge.area, scd.cartridge.mask + 1, 1, fp);
+        if (fread(scd.cartridge.area, scd.cartridge.mask + 1, 1, fp))
+        {
+          backup_flusher.SetSaved("./cart.brm", scd.cartridge.area, scd.cartridge.mask + 1);
+        }
         fclose(fp);
       }
 
@@ -891,11 +1155,18 @@ int main (int argc, char **argv)
     fp = fopen("./game.srm", "rb");
     if (fp!=NULL)
     {
-      fread(sram.sram,0x10000,1, fp);
+      if (fread(sram.sram,0x10000,1, fp))
+      {
+        backup_flusher.SetSaved("./game.srm", sram.sram, 0x10000);
+      }
       fclose(fp);
     }
   }
 
+  /* backup memories are saved in background */
+  backup_ram_dirty = 0;
+  backup_flusher.Start();
+
   /* reset system hardware */
   system_reset();
 
@@ -915,8 +1186,10 @@ int main (int argc, char **argv)
       {
         case SDL_USEREVENT:
         {
-          char caption[100];
-          sprintf(caption,"Genesis Plus GX - %d fps - %s", event.user.code, (rominfo.international[0] != 0x20) ? rominfo.international : rominfo.domestic);
+          char caption[128];
+          int skipped = frame_skip_governor.TakeSkippedFrameCount();
+          if (vdp_pal) skipped /= 3;
+          sprintf(caption,"Genesis Plus GX - %d fps (%d skipped) - %s", event.user.code, skipped, (rominfo.international[0] != 0x20) ? rominfo.international : rominfo.domestic);
           SDL_SetWindowTitle(sdl_video.window, caption);
           break;
         }
@@ -927,6 +1200,16 @@ int main (int argc, char **argv)
           break;
         }
 
+        case SDL_WINDOWEVENT:
+        {
+          /* window content must be redrawn */
+          if ((event.window.event == SDL_WINDOWEVENT_EXPOSED) || (event.window.event == SDL_WINDOWEVENT_RESTORED))
+          {
+            sdl_video.full_update = 1;
+          }
+          break;
+        }
+
         case SDL_KEYDOWN:
         {
           running = sdl_control_update(event.key.keysym.sym);
@@ -935,54 +1218,43 @@ int main (int argc, char **argv)
       }
     }
 
-    sdl_video_update();
+    sdl_video_update(sdl_sync_skip());
     sdl_sound_update(use_sound);
 
-    if(!turbo_mode && sdl_sync.sem_sync && sdl_video.frames_rendered % 3 == 0)
+    /* 3 frames (3 x TURBO_SPEED frames in fast-forward with sound) per timer tick */
+    ++sdl_sync.frames_emulated;
+
+    /* save modified backup memories */
+    sdl_backup_update((sdl_sync.frames_emulated % BACKUP_CHECK_FRAMES) == 0);
+
+    if((!turbo_mode || use_sound) && sdl_sync.sem_sync && (sdl_sync.frames_emulated % (3 * sdl_sync_speed())) == 0)
     {
       SDL_SemWait(sdl_sync.sem_sync);
     }
   }
 
-  if (system_hw == SYSTEM_MCD)
-  {
-    /* save internal backup RAM (if formatted) */
-    if (!xee::mem::Memcmp(scd.bram + 0x2000 - 0x20, brm_format + 0x20, 0x20))
-    {
-      fp = fopen("./scd.brm", "wb");
-      if (fp!=NULL)
-      {
-        fwrite(scd.bram, 0x2000, 1, fp);
-        fclose(fp);
-      }
-    }
+  /* save backup memories (pending writes are completed) */
+  sdl_backup_update(1);
+  backup_flusher.Stop();
 
-    /* save cartridge backup RAM (if formatted) */
-    if (scd.cartridge.id)
-    {
-      if (!xee::mem::Memcmp(scd.cartridge.area + scd.cartridge.mask + 1 - 0x20, brm_format + 0x20, 0x20))
-      {
-        fp = fopen("./cart.brm", "wb");
-        if (fp!=NULL)
-        {
-          fwrite(scd.cartridge.area, scd.cartridge.mask + 1, 1, fp);
-          fclose(fp);
-        }
-      }
-    }
+  /* stop sound chips register log */
+  if (gpgx::g_register_log)
+  {
+    gpgx::g_register_log->Close();
+    delete gpgx::g_register_log;
+    gpgx::g_register_log = nullptr;
   }
 
-  if (sram.on)
+  /* stop audio/video capture */
+  if (gpgx::g_recorder)
   {
-    /* save SRAM */
-    fp = fopen("./game.srm", "wb");
-    if (fp!=NULL)
-    {
-      fwrite(sram.sram,0x10000,1, fp);
-      fclose(fp);
-    }
+    gpgx::g_recorder->Stop();
+    delete gpgx::g_recorder;
+    gpgx::g_recorder = nullptr;
   }
 
+  render_shutdown();
+  gfx_shutdown();
   audio_shutdown();
   error_shutdown();
 
@@ -991,6 +1263,8 @@ int main (int argc, char **argv)
   sdl_sync_close();
   SDL_Quit();
 
+  free(soundframe);
+
   // 
   if (gpgx::g_z80) {
     delete gpgx::g_z80;
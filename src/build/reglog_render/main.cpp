@@ -0,0 +1,472 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+// Offline renderer of register logs (see gpgx::capture::RegisterLogWriter).
+//
+// Each chip stream (FM and PSG) of each log is rendered by its own thread,
+// then both streams of a log are mixed to "<log>.wav".
+//
+// usage: reglog_render [options] log1.vrl [log2.vrl ...]
+//   -r <rate>     output sample rate (default: 44100)
+//   -c <core>     core rendering OPN2 writes: ym2612, ym2612i (integrated),
+//                 ym2612e (enhanced) or ym3438 (default: ym2612)
+//   -lq           use linear interpolation instead of band-limited synthesis
+//   -j <count>    number of threads (default: number of CPU cores)
+//   -s            also write each chip stream ("<log>_fm.wav", "<log>_psg.wav")
+//   -n            do not write any file (benchmark)
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+
+#include "core/core_config.h"
+
+#include "gpgx/audio/blip_buffer.h"
+#include "gpgx/audio/effect/fm_synthesizer_base.h"
+#include "gpgx/capture/register_log.h"
+#include "gpgx/capture/register_log_reader.h"
+#include "gpgx/ic/sn76489/sn76489.h"
+#include "gpgx/ic/sn76489/sn76489_type.h"
+#include "gpgx/ic/ym2413/ym2413.h"
+#include "gpgx/ic/ym2612/ym2612.h"
+#include "gpgx/ic/ym2612/ym2612_type.h"
+#include "gpgx/ic/ym3438/ym3438.h"
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+enum class StreamType : u8
+{
+  kFm = 0,
+  kPsg = 1,
+};
+
+//------------------------------------------------------------------------------
+
+struct RenderJob
+{
+  std::string log_path;
+  StreamType stream;
+  bool ok;
+  std::vector<s16> samples; // Interleaved stereo samples.
+  f64 seconds;              // Rendering time.
+};
+
+//------------------------------------------------------------------------------
+
+static s32 s_sample_rate = 44100;
+static bool s_ym3438 = false;
+static bool s_split = false;
+static bool s_no_output = false;
+
+// Size of the FM buffer (one frame at the highest chip rate).
+static constexpr s32 kFmBufferSize = 1080 * 2 * 24;
+
+//------------------------------------------------------------------------------
+
+static gpgx::audio::effect::FmSynthesizerBase* CreateFmSynthesizer(gpgx::capture::RegisterLogEvent event)
+{
+  if (event == gpgx::capture::RegisterLogEvent::kOpllWrite) {
+    gpgx::ic::ym2413::Ym2413* ym2413 = new gpgx::ic::ym2413::Ym2413();
+
+    ym2413->YM2413Init();
+
+    // chip is running at ZCLK / 72 = MCLK / 15 / 72.
+    ym2413->SetClockRatio(72 * 15);
+
+    return ym2413;
+  }
+
+  if (s_ym3438) {
+    gpgx::ic::ym3438::Ym3438* ym3438 = new gpgx::ic::ym3438::Ym3438();
+
+    ym3438->Init();
+
+    // chip is running at internal clock.
+    ym3438->SetClockRatio(gpgx::ic::ym2612::Ym2612::kYm2612ClockRatio);
+
+    return ym3438;
+  }
+
+  gpgx::ic::ym2612::Ym2612* ym2612 = new gpgx::ic::ym2612::Ym2612();
+
+  ym2612->YM2612Init();
+  ym2612->YM2612Config(core_config.ym2612);
+
+  // chip is running at sample clock.
+  ym2612->SetClockRatio(gpgx::ic::ym2612::Ym2612::kYm2612ClockRatio * 24);
+
+  return ym2612;
+}
+
+//------------------------------------------------------------------------------
+
+// Read the samples rendered during the last frame.
+static void ReadSamples(gpgx::audio::BlipBuffer* blip, std::vector<s16>& samples)
+{
+  s32 count = blip->blip_samples_avail();
+  size_t offset = samples.size();
+
+  samples.resize(offset + (count * 2));
+  blip->blip_read_samples(&samples[offset], count);
+}
+
+//------------------------------------------------------------------------------
+
+static bool RenderFm(gpgx::capture::RegisterLogReader& reader, gpgx::audio::BlipBuffer* blip, std::vector<s16>& samples)
+{
+  std::vector<int> fm_buffer(kFmBufferSize);
+  gpgx::audio::effect::FmSynthesizerBase* fm = nullptr;
+  gpgx::capture::RegisterLogEntry entry;
+
+  while (reader.Next(entry)) {
+    switch (entry.event) {
+      case gpgx::capture::RegisterLogEvent::kOpn2Write:
+      case gpgx::capture::RegisterLogEvent::kOpllWrite:
+      {
+        // The chip is created on the first write.
+        if (!fm) {
+          fm = CreateFmSynthesizer(entry.event);
+          fm->SetBlipBuffer(blip);
+          fm->Reset(fm_buffer.data());
+        }
+
+        fm->Write(entry.cycles, entry.address, entry.data);
+
+        break;
+      }
+      case gpgx::capture::RegisterLogEvent::kFmReset:
+      {
+        if (fm) {
+          fm->SyncAndReset(entry.cycles);
+        }
+
+        break;
+      }
+      case gpgx::capture::RegisterLogEvent::kEndFrame:
+      {
+        if (fm) {
+          fm->EndFrame(entry.cycles);
+        }
+
+        blip->blip_end_frame(entry.cycles);
+        ReadSamples(blip, samples);
+
+        break;
+      }
+      default:
+      {
+        break;
+      }
+    }
+  }
+
+  delete fm;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+static bool RenderPsg(gpgx::capture::RegisterLogReader& reader, gpgx::audio::BlipBuffer* blip, std::vector<s16>& samples)
+{
+  gpgx::ic::sn76489::Sn76489* psg = new gpgx::ic::sn76489::Sn76489();
+  gpgx::capture::RegisterLogEntry entry;
+  u32 preamp = core_config.psg_preamp;
+
+  psg->psg_init((gpgx::ic::sn76489::PSG_TYPE)reader.GetPsgType());
+  psg->psg_set_blip_buffer(blip);
+  psg->psg_reset();
+  psg->psg_config(0, preamp, 0xff);
+
+  while (reader.Next(entry)) {
+    switch (entry.event) {
+      case gpgx::capture::RegisterLogEvent::kPsgWrite:
+      {
+        psg->psg_write(entry.cycles, entry.data);
+
+        break;
+      }
+      case gpgx::capture::RegisterLogEvent::kPsgPreamp:
+      {
+        preamp = entry.data;
+
+        break;
+      }
+      case gpgx::capture::RegisterLogEvent::kPsgConfig:
+      {
+        psg->psg_config(entry.cycles, preamp, entry.data);
+
+        break;
+      }
+      case gpgx::capture::RegisterLogEvent::kEndFrame:
+      {
+        psg->psg_end_frame(entry.cycles);
+
+        blip->blip_end_frame(entry.cycles);
+        ReadSamples(blip, samples);
+
+        break;
+      }
+      default:
+      {
+        break;
+      }
+    }
+  }
+
+  delete psg;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+static void RunJob(RenderJob& job)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  job.ok = false;
+
+  gpgx::capture::RegisterLogReader reader;
+
+  if (!reader.Open(job.log_path.c_str())) {
+    return;
+  }
+
+  // Each job renders to its own blip buffer.
+  gpgx::audio::BlipBuffer* blip = gpgx::audio::BlipBuffer::blip_new(s_sample_rate / 10);
+
+  if (!blip) {
+    return;
+  }
+
+  blip->blip_set_rates(reader.GetClock(), s_sample_rate);
+
+  if (job.stream == StreamType::kFm) {
+    job.ok = RenderFm(reader, blip, job.samples);
+  } else {
+    job.ok = RenderPsg(reader, blip, job.samples);
+  }
+
+  blip->blip_delete();
+
+  job.seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------
+
+static void WriteU16(FILE* file, u32 value)
+{
+  u8 data[2] = { (u8)(value & 0xff), (u8)((value >> 8) & 0xff) };
+  fwrite(data, 1, 2, file);
+}
+
+//------------------------------------------------------------------------------
+
+static void WriteU32(FILE* file, u32 value)
+{
+  u8 data[4] = { (u8)(value & 0xff), (u8)((value >> 8) & 0xff), (u8)((value >> 16) & 0xff), (u8)((value >> 24) & 0xff) };
+  fwrite(data, 1, 4, file);
+}
+
+//------------------------------------------------------------------------------
+
+// Write 16-bit stereo samples to a WAV file.
+static bool WriteWav(const std::string& path, const std::vector<s16>& samples)
+{
+  FILE* file = fopen(path.c_str(), "wb");
+
+  if (!file) {
+    fprintf(stderr, "cannot create %s\n", path.c_str());
+    return false;
+  }
+
+  u32 size = (u32)(samples.size() * sizeof(s16));
+
+  fwrite("RIFF", 1, 4, file);
+  WriteU32(file, 36 + size);
+  fwrite("WAVE", 1, 4, file);
+  fwrite("fmt ", 1, 4, file);
+  WriteU32(file, 16);
+  WriteU16(file, 1);
+  WriteU16(file, 2);
+  WriteU32(file, s_sample_rate);
+  WriteU32(file, s_sample_rate * 2 * sizeof(s16));
+  WriteU16(file, 2 * sizeof(s16));
+  WriteU16(file, 16);
+  fwrite("data", 1, 4, file);
+  WriteU32(file, size);
+
+  for (size_t i = 0; i < samples.size(); i++) {
+    WriteU16(file, (u16)samples[i]);
+  }
+
+  fclose(file);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Return the path of the log without extension.
+static std::string GetBasePath(const std::string& path)
+{
+  size_t dot = path.find_last_of('.');
+  size_t sep = path.find_last_of("/\\");
+
+  if ((dot == std::string::npos) || ((sep != std::string::npos) && (dot < sep))) {
+    return path;
+  }
+
+  return path.substr(0, dot);
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> logs;
+  s32 thread_count = (s32)std::thread::hardware_concurrency();
+
+  core_config.psg_preamp = 150;
+  core_config.fm_preamp = 100;
+  core_config.hq_fm = 1;
+  core_config.hq_psg = 1;
+  core_config.ym2612 = gpgx::ic::ym2612::YM2612_DISCRETE;
+
+  for (s32 i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-r") && ((i + 1) < argc)) {
+      s_sample_rate = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-c") && ((i + 1) < argc)) {
+      const char* core = argv[++i];
+
+      if (!strcmp(core, "ym3438")) {
+        s_ym3438 = true;
+      } else if (!strcmp(core, "ym2612i")) {
+        core_config.ym2612 = gpgx::ic::ym2612::YM2612_INTEGRATED;
+      } else if (!strcmp(core, "ym2612e")) {
+        core_config.ym2612 = gpgx::ic::ym2612::YM2612_ENHANCED;
+      }
+    } else if (!strcmp(argv[i], "-lq")) {
+      core_config.hq_fm = 0;
+      core_config.hq_psg = 0;
+    } else if (!strcmp(argv[i], "-j") && ((i + 1) < argc)) {
+      thread_count = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-s")) {
+      s_split = true;
+    } else if (!strcmp(argv[i], "-n")) {
+      s_no_output = true;
+    } else {
+      logs.push_back(argv[i]);
+    }
+  }
+
+  if (logs.empty() || (s_sample_rate < 8000)) {
+    printf("usage: %s [-r rate] [-c ym2612|ym2612i|ym2612e|ym3438] [-lq] [-j threads] [-s] [-n] log1.vrl [log2.vrl ...]\n", argv[0]);
+    return 1;
+  }
+
+  // One job per chip stream.
+  std::vector<RenderJob> jobs(logs.size() * 2);
+
+  for (size_t i = 0; i < logs.size(); i++) {
+    jobs[i * 2].log_path = logs[i];
+    jobs[i * 2].stream = StreamType::kFm;
+    jobs[i * 2 + 1].log_path = logs[i];
+    jobs[i * 2 + 1].stream = StreamType::kPsg;
+  }
+
+  if (thread_count < 1) {
+    thread_count = 1;
+  }
+
+  if ((size_t)thread_count > jobs.size()) {
+    thread_count = (s32)jobs.size();
+  }
+
+  // Render all jobs.
+  auto start = std::chrono::steady_clock::now();
+
+  std::atomic<size_t> next_job(0);
+  std::vector<std::thread> threads;
+
+  for (s32 i = 0; i < thread_count; i++) {
+    threads.emplace_back([&jobs, &next_job]() {
+      for (size_t index = next_job++; index < jobs.size(); index = next_job++) {
+        RunJob(jobs[index]);
+      }
+    });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  f64 elapsed = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+
+  // Mix and write the streams of each log.
+  int result = 0;
+  f64 total_audio = 0.0;
+
+  for (size_t i = 0; i < logs.size(); i++) {
+    RenderJob& fm = jobs[i * 2];
+    RenderJob& psg = jobs[i * 2 + 1];
+
+    if (!fm.ok || !psg.ok) {
+      fprintf(stderr, "cannot render %s\n", logs[i].c_str());
+      result = 1;
+      continue;
+    }
+
+    f64 duration = (f64)(fm.samples.size() / 2) / s_sample_rate;
+    total_audio += duration;
+
+    printf("%s: %.2f s of audio, FM %.3f s (%.1fx), PSG %.3f s (%.1fx)\n", logs[i].c_str(), duration,
+      fm.seconds, fm.seconds ? (duration / fm.seconds) : 0.0, psg.seconds, psg.seconds ? (duration / psg.seconds) : 0.0);
+
+    if (s_no_output) {
+      continue;
+    }
+
+    std::string base = GetBasePath(logs[i]);
+
+    if (s_split) {
+      WriteWav(base + "_fm.wav", fm.samples);
+      WriteWav(base + "_psg.wav", psg.samples);
+    }
+
+    // Both streams have the same number of frames, hence of samples.
+    std::vector<s16> mix(fm.samples.size());
+
+    for (size_t n = 0; n < mix.size(); n++) {
+      s32 sample = fm.samples[n] + ((n < psg.samples.size()) ? psg.samples[n] : 0);
+
+      // clipping (16-bit samples).
+      if (sample > 32767) sample = 32767;
+      else if (sample < -32768) sample = -32768;
+
+      mix[n] = (s16)sample;
+    }
+
+    if (!WriteWav(base + ".wav", mix)) {
+      result = 1;
+    }
+  }
+
+  printf("%zu log(s), %.2f s of audio rendered in %.3f s with %d thread(s) (%.1fx real time)\n", logs.size(), total_audio,
+    elapsed, thread_count, elapsed ? (total_audio / elapsed) : 0.0);
+
+  return result;
+}
@@ -0,0 +1,934 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+// Benchmark of the mode 5 line renderers.
+//
+// Each case renders a canned (deterministic) scene with one of the mode 5
+// specializations (IM2, VS and STE modes, line or full screen horizontal
+// scrolling), reports the rendering speed and
+// compares the hash of the rendered lines with the golden file, so that any
+// optimization of the renderers can be proven bit-exact.
+//
+// usage: render_bench [options] [case ...]
+//   -f <frames>   number of rendered frames per case (default: 600)
+//   -i <count>    number of iterations, the fastest is reported (default: 3)
+//   -g <file>     golden file (default: RENDER_BENCH_GOLDEN_FILE)
+//   -u            update the golden file instead of checking it
+//   -v            render through the layer renderer interfaces (virtual
+//                 calls) instead of the specialized line renderer
+//   -d <threads>  record the lines for the deferred line renderer, rendered
+//                 by the specified number of worker threads (the hashes are
+//                 computed from the framebuffer, with an identity palette)
+//   -t            render the background layers by frame with the frame
+//                 background layer renderer (cases without IM2 and VS, the
+//                 other cases are rendered by line)
+//
+// The pattern cache layout is selected at build time (the golden hashes are
+// the same with USE_COMPACT_PATTERN_CACHE).
+//
+// The pat/frm and rows/frm columns are the average number of patterns and
+// pattern rows updated in the pattern cache per frame (0 with -d, the worker
+// threads update their own pattern caches).
+//
+// The exit code is 0 when all hashes match the golden file.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "xee/fnd/data_type.h"
+#include "xee/mem/memory.h"
+
+#include "core/framebuffer_t.h"
+#include "core/vdp/clip_t.h"
+#include "core/vdp/object_info_t.h"
+#include "core/vdp/pixel.h"
+#include "core/viewport_t.h"
+
+#include "gpgx/ppu/vdp/bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/bg_pattern_dirty.h"
+#include "gpgx/ppu/vdp/lut.h"
+#include "gpgx/ppu/vdp/m5_bg_column_drawer.h"
+#include "gpgx/ppu/vdp/m5_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_bg_pattern_cache_updater.h"
+#include "gpgx/ppu/vdp/m5_deferred_line_renderer.h"
+#include "gpgx/ppu/vdp/m5_frame_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_bg_column_drawer.h"
+#include "gpgx/ppu/vdp/m5_im2_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_ste_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_im2_vs_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_line_renderer.h"
+#include "gpgx/ppu/vdp/m5_pattern_cache.h"
+#include "gpgx/ppu/vdp/m5_satb_parser.h"
+#include "gpgx/ppu/vdp/m5_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_ste_sprite_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_vs_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/sprite_layer_renderer.h"
+
+#ifndef RENDER_BENCH_GOLDEN_FILE
+#define RENDER_BENCH_GOLDEN_FILE "golden.txt"
+#endif
+
+using namespace gpgx::ppu::vdp;
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+// Display size (H40, NTSC).
+static constexpr s32 kWidth = 320;
+static constexpr s32 kHeight = 224;
+
+// VRAM layout.
+static constexpr u16 kNtab = 0xC000;
+static constexpr u16 kNtwb = 0xD000;
+static constexpr u16 kNtbb = 0xE000;
+static constexpr u16 kSatb = 0xF800;
+static constexpr u16 kHscb = 0xFC00;
+
+// Number of sprites (linked list of the whole H40 table).
+static constexpr s32 kSpriteCount = 80;
+
+//------------------------------------------------------------------------------
+
+// Deterministic pseudo-random generator (the sequences must never change).
+class Random
+{
+public:
+  explicit Random(u32 seed) : m_state(seed) {}
+
+  u32 Next()
+  {
+    m_state = (m_state * 1664525) + 1013904223;
+    return m_state >> 8;
+  }
+
+  u32 Next(u32 range) { return Next() % range; }
+
+private:
+  u32 m_state;
+};
+
+//------------------------------------------------------------------------------
+
+// 64-bit FNV-1a hash of the rendered lines.
+class Hash
+{
+public:
+  void Add(const u8* data, s32 size)
+  {
+    for (s32 i = 0; i < size; i++) {
+      m_hash ^= data[i];
+      m_hash *= 0x100000001b3ULL;
+    }
+  }
+
+  u64 Get() const { return m_hash; }
+
+private:
+  u64 m_hash = 0xcbf29ce484222325ULL;
+};
+
+//------------------------------------------------------------------------------
+
+// VDP state shared by the renderers (same layout as in vdp_ctrl.cpp and
+// vdp_render.cpp).
+struct Vdp
+{
+  u8 reg[0x20];
+  alignas(4) u8 vram[0x10000];
+  alignas(4) u8 vsram[0x80];
+  alignas(4) u8 sat[0x400];
+  u8 sat_dirty;
+
+  u16 status;
+  u8 odd_frame;
+  u8 im2_flag;
+  u16 max_sprite_pixels;
+  u16 lines_per_frame;
+
+  u8 playfield_shift;
+  u8 playfield_col_mask;
+  u16 playfield_row_mask;
+
+  u16 hscb;
+  u8 hscroll_mask;
+
+  u16 ntab;
+  u16 ntbb;
+  u16 ntwb;
+  u16 satb;
+
+  u64 bg_dirty_rows[kPatternDirtyRowsSize];
+  u64 bg_dirty_summary[kPatternDirtySummarySize];
+
+  alignas(4) u8 bg_pattern_cache[kPatternCacheSize];
+  u8 name_lut[0x400];
+  u8 lut[kLayerPriorityLutCount][kLayerPriorityLutSize];
+  alignas(4) u8 linebuf[2][0x200];
+
+  u8 spr_ovr;
+  object_info_t obj_info[2][20];
+  u8 object_count[2];
+
+  clip_t clip[2];
+  viewport_t viewport;
+
+  PIXEL_OUT_T pixel[0x100];
+  alignas(4) u8 framebuffer_data[kHeight * kWidth * sizeof(PIXEL_OUT_T)];
+  framebuffer_t framebuffer;
+};
+
+//------------------------------------------------------------------------------
+
+// Renderers bound to the VDP state.
+struct Renderers
+{
+  explicit Renderers(Vdp* vdp);
+  ~Renderers();
+
+  M5BackgroundColumnDrawer* bg_column_drawer;
+  M5Im2BackgroundColumnDrawer* bg_column_drawer_im2;
+
+  M5BackgroundLayerRenderer* bg;
+  M5VsBackgroundLayerRenderer* bg_vs;
+  M5Im2BackgroundLayerRenderer* bg_im2;
+  M5Im2VsBackgroundLayerRenderer* bg_im2_vs;
+
+  M5SpriteLayerRenderer* sprite;
+  M5SteSpriteLayerRenderer* sprite_ste;
+  M5Im2SpriteLayerRenderer* sprite_im2;
+  M5Im2SteSpriteLayerRenderer* sprite_im2_ste;
+
+  M5SpriteAttributeTableParser* satb_parser;
+  M5BackgroundPatternCacheUpdater* bg_pattern_cache_updater;
+
+  M5LineRenderer* line_renderer;
+  M5DeferredLineRenderer* deferred_line_renderer;
+  M5FrameBackgroundLayerRenderer* frame_bg;
+};
+
+//------------------------------------------------------------------------------
+
+// Pattern attribute (priority + palette bits) expansion table.
+static const u32 atex_table[] =
+{
+  0x00000000,
+  0x10101010,
+  0x20202020,
+  0x30303030,
+  0x40404040,
+  0x50505050,
+  0x60606060,
+  0x70707070
+};
+
+//------------------------------------------------------------------------------
+
+Renderers::Renderers(Vdp* vdp)
+{
+  bg_column_drawer = new M5BackgroundColumnDrawer(atex_table, vdp->bg_pattern_cache);
+  bg_column_drawer_im2 = new M5Im2BackgroundColumnDrawer(atex_table, vdp->bg_pattern_cache);
+
+  bg = new M5BackgroundLayerRenderer(
+    vdp->reg, vdp->vram, vdp->vsram,
+    &vdp->playfield_shift, &vdp->playfield_col_mask, &vdp->playfield_row_mask,
+    &vdp->hscb, &vdp->hscroll_mask,
+    &vdp->ntab, &vdp->ntbb, &vdp->ntwb,
+    vdp->linebuf[1], vdp->linebuf[0],
+    vdp->lut[0], vdp->lut[2],
+    &vdp->clip[0], &vdp->clip[1],
+    &vdp->viewport, bg_column_drawer
+  );
+
+  bg_vs = new M5VsBackgroundLayerRenderer(
+    vdp->reg, vdp->vram, vdp->vsram,
+    &vdp->playfield_shift, &vdp->playfield_col_mask, &vdp->playfield_row_mask,
+    &vdp->hscb, &vdp->hscroll_mask,
+    &vdp->ntab, &vdp->ntbb, &vdp->ntwb,
+    vdp->linebuf[1], vdp->linebuf[0],
+    vdp->lut[0], vdp->lut[2],
+    &vdp->clip[0], &vdp->clip[1],
+    &vdp->viewport, bg_column_drawer
+  );
+
+  bg_im2 = new M5Im2BackgroundLayerRenderer(
+    vdp->reg, vdp->vram, vdp->vsram,
+    &vdp->odd_frame,
+    &vdp->playfield_shift, &vdp->playfield_col_mask, &vdp->playfield_row_mask,
+    &vdp->hscb, &vdp->hscroll_mask,
+    &vdp->ntab, &vdp->ntbb, &vdp->ntwb,
+    vdp->linebuf[1], vdp->linebuf[0],
+    vdp->lut[0], vdp->lut[2],
+    &vdp->clip[0], &vdp->clip[1],
+    &vdp->viewport, bg_column_drawer_im2
+  );
+
+  bg_im2_vs = new M5Im2VsBackgroundLayerRenderer(
+    vdp->reg, vdp->vram, vdp->vsram,
+    &vdp->odd_frame,
+    &vdp->playfield_shift, &vdp->playfield_col_mask, &vdp->playfield_row_mask,
+    &vdp->hscb, &vdp->hscroll_mask,
+    &vdp->ntab, &vdp->ntbb, &vdp->ntwb,
+    vdp->linebuf[1], vdp->linebuf[0],
+    vdp->lut[0], vdp->lut[2],
+    &vdp->clip[0], &vdp->clip[1],
+    &vdp->viewport, bg_column_drawer_im2
+  );
+
+  sprite = new M5SpriteLayerRenderer(
+    vdp->obj_info, vdp->object_count, &vdp->status, &vdp->spr_ovr,
+    vdp->bg_pattern_cache, vdp->linebuf[0], vdp->lut[1], vdp->name_lut,
+    &vdp->max_sprite_pixels, &vdp->viewport
+  );
+
+  sprite_ste = new M5SteSpriteLayerRenderer(
+    vdp->obj_info, vdp->object_count, &vdp->status, &vdp->spr_ovr,
+    vdp->bg_pattern_cache, vdp->linebuf[1], vdp->lut[3], vdp->linebuf[0], vdp->lut[4],
+    vdp->name_lut, &vdp->max_sprite_pixels, &vdp->viewport
+  );
+
+  sprite_im2 = new M5Im2SpriteLayerRenderer(
+    vdp->obj_info, vdp->object_count, &vdp->status, &vdp->odd_frame, &vdp->spr_ovr,
+    vdp->bg_pattern_cache, vdp->linebuf[0], vdp->lut[1], vdp->name_lut,
+    &vdp->max_sprite_pixels, &vdp->viewport
+  );
+
+  sprite_im2_ste = new M5Im2SteSpriteLayerRenderer(
+    vdp->obj_info, vdp->object_count, &vdp->status, &vdp->odd_frame, &vdp->spr_ovr,
+    vdp->bg_pattern_cache, vdp->linebuf[1], vdp->lut[3], vdp->linebuf[0], vdp->lut[4],
+    vdp->name_lut, &vdp->max_sprite_pixels, &vdp->viewport
+  );
+
+  satb_parser = new M5SpriteAttributeTableParser(
+    &vdp->viewport, vdp->vram, vdp->obj_info, vdp->object_count, vdp->sat,
+    &vdp->sat_dirty, &vdp->satb, &vdp->im2_flag, &vdp->max_sprite_pixels, &vdp->status
+  );
+
+  bg_pattern_cache_updater = new M5BackgroundPatternCacheUpdater(
+    vdp->bg_pattern_cache, vdp->bg_dirty_rows, vdp->bg_dirty_summary, vdp->vram
+  );
+
+  line_renderer = new M5LineRenderer(
+    bg, bg_vs, bg_im2, bg_im2_vs,
+    sprite, sprite_ste, sprite_im2, sprite_im2_ste
+  );
+
+  deferred_line_renderer = new M5DeferredLineRenderer(
+    vdp->reg, vdp->vram, vdp->vsram, vdp->pixel,
+    &vdp->ntab, &vdp->ntbb, &vdp->ntwb, &vdp->hscb,
+    &vdp->playfield_shift, &vdp->playfield_col_mask, &vdp->playfield_row_mask, &vdp->hscroll_mask,
+    &vdp->odd_frame, &vdp->im2_flag, &vdp->max_sprite_pixels, &vdp->lines_per_frame,
+    vdp->clip, &vdp->viewport,
+    vdp->obj_info, vdp->object_count, &vdp->status, &vdp->spr_ovr,
+    vdp->bg_dirty_rows, vdp->bg_dirty_summary,
+    vdp->lut, vdp->name_lut, atex_table, nullptr, &vdp->framebuffer
+  );
+
+  frame_bg = new M5FrameBackgroundLayerRenderer(
+    vdp->reg, vdp->vram, vdp->vsram,
+    &vdp->playfield_shift, &vdp->playfield_col_mask, &vdp->playfield_row_mask,
+    &vdp->hscb, &vdp->hscroll_mask,
+    &vdp->ntab, &vdp->ntbb, &vdp->ntwb,
+    vdp->linebuf[0],
+    vdp->lut[0], vdp->lut[2],
+    &vdp->clip[0], &vdp->clip[1],
+    &vdp->viewport, bg_column_drawer
+  );
+}
+
+//------------------------------------------------------------------------------
+
+Renderers::~Renderers()
+{
+  delete frame_bg;
+  delete deferred_line_renderer;
+  delete line_renderer;
+  delete bg_pattern_cache_updater;
+  delete satb_parser;
+  delete sprite_im2_ste;
+  delete sprite_im2;
+  delete sprite_ste;
+  delete sprite;
+  delete bg_im2_vs;
+  delete bg_im2;
+  delete bg_vs;
+  delete bg;
+  delete bg_column_drawer_im2;
+  delete bg_column_drawer;
+}
+
+//------------------------------------------------------------------------------
+
+// Mode 5 specialization of a case.
+struct Mode
+{
+  bool im2;
+  bool vscroll;
+  bool ste;
+  bool fscroll; // Full screen horizontal scrolling (instead of line scrolling).
+};
+
+// Result of one iteration of a case.
+struct CaseResult
+{
+  u64 lines; // Number of rendered lines.
+  u64 hash;
+  u64 patterns; // Number of patterns updated in the pattern cache.
+  u64 rows; // Number of pattern rows updated in the pattern cache.
+};
+
+struct BenchCase
+{
+  const char* name;
+  Mode mode;
+};
+
+//------------------------------------------------------------------------------
+
+// Mark patterns as modified (as done by the VDP data port).
+static void MarkPattern(Vdp* vdp, u16 name, u8 dirty = 0xFF)
+{
+  MarkPatternDirty(vdp->bg_dirty_rows, vdp->bg_dirty_summary, name, dirty);
+}
+
+//------------------------------------------------------------------------------
+
+// Write a 16-bit word in VRAM (as written by the VDP data port).
+static void WriteVram16(Vdp* vdp, u32 address, u16 data)
+{
+  address &= 0xFFFE;
+
+  *(u16*)&vdp->vram[address] = data;
+
+  // Same as MARK_BG_DIRTY (the deferred line renderer takes the modified
+  // VRAM from the modified pattern rows).
+  MarkPatternRowDirty(vdp->bg_dirty_rows, vdp->bg_dirty_summary, address);
+}
+
+//------------------------------------------------------------------------------
+
+// Update the pattern cache (as done before rendering a line). The deferred
+// line renderer moves the modified patterns to its log instead.
+static void UpdatePatternCache(Renderers* renderers)
+{
+  if (renderers->deferred_line_renderer->IsRunning()) {
+    return;
+  }
+
+  renderers->bg_pattern_cache_updater->UpdateBackgroundPatternCache();
+}
+
+//------------------------------------------------------------------------------
+
+// Hash the lines of the framebuffer (the identity palette gives back the
+// pixels of the line buffer).
+static void HashFramebuffer(const Vdp* vdp, Hash& hash)
+{
+  u8 pixels[kWidth];
+
+  for (s32 line = 0; line < kHeight; line++) {
+    const PIXEL_OUT_T* src = (const PIXEL_OUT_T*)&vdp->framebuffer_data[line * vdp->framebuffer.pitch];
+
+    for (s32 x = 0; x < kWidth; x++) {
+      pixels[x] = (u8)src[x];
+    }
+
+    hash.Add(pixels, kWidth);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+// Build the canned scene: random patterns, planes made of runs of tiles with
+// random flips, priorities and palettes, a window on the top lines and a
+// linked list of sprites of every size.
+static void SetupScene(Vdp* vdp, Renderers* renderers, const Mode& mode, Random& random)
+{
+  xee::mem::Memset(vdp->reg, 0, sizeof(vdp->reg));
+  xee::mem::Memset(vdp->vram, 0, sizeof(vdp->vram));
+  xee::mem::Memset(vdp->vsram, 0, sizeof(vdp->vsram));
+  xee::mem::Memset(vdp->linebuf, 0, sizeof(vdp->linebuf));
+  xee::mem::Memset(vdp->obj_info, 0, sizeof(vdp->obj_info));
+  xee::mem::Memset(vdp->framebuffer_data, 0, sizeof(vdp->framebuffer_data));
+
+  ClearPatternsDirty(vdp->bg_dirty_rows, vdp->bg_dirty_summary);
+
+  vdp->reg[1] = 0x44; // Display enabled, mode 5.
+  vdp->reg[11] = (mode.vscroll ? 0x04 : 0x00) | (mode.fscroll ? 0x00 : 0x03); // Line scrolling.
+  vdp->reg[12] = 0x81 | (mode.im2 ? 0x06 : 0x00) | (mode.ste ? 0x08 : 0x00); // H40.
+  vdp->reg[16] = 0x01; // 64x32 cells.
+  vdp->reg[17] = 0x00;
+  vdp->reg[18] = 0x03; // Window on the top 24 lines.
+
+  vdp->status = 0;
+  vdp->odd_frame = 0;
+  vdp->im2_flag = mode.im2 ? 1 : 0;
+  vdp->max_sprite_pixels = kWidth;
+  vdp->lines_per_frame = 262;
+
+  vdp->playfield_shift = 7;
+  vdp->playfield_col_mask = 0x1F;
+  vdp->playfield_row_mask = 0x0FF;
+
+  vdp->hscb = kHscb;
+  vdp->hscroll_mask = mode.fscroll ? 0x00 : 0xFF;
+
+  vdp->ntab = kNtab;
+  vdp->ntbb = kNtbb;
+  vdp->ntwb = kNtwb;
+  vdp->satb = kSatb;
+
+  vdp->spr_ovr = 0;
+  vdp->object_count[0] = vdp->object_count[1] = 0;
+
+  // Plane A takes up the entire line.
+  vdp->clip[0].left = 0;
+  vdp->clip[0].right = kWidth >> 4;
+  vdp->clip[0].enable = 1;
+  vdp->clip[1].left = 0;
+  vdp->clip[1].right = kWidth >> 4;
+  vdp->clip[1].enable = 0;
+
+  vdp->viewport.x = 0;
+  vdp->viewport.y = 0;
+  vdp->viewport.w = kWidth;
+  vdp->viewport.h = kHeight;
+  vdp->viewport.ow = kWidth;
+  vdp->viewport.oh = kHeight;
+  vdp->viewport.changed = 0;
+
+  // Patterns (with some transparent pixels).
+  for (u32 address = 0; address < kNtab; address += 2) {
+    u16 data = (u16)random.Next(0x10000);
+
+    if (random.Next(4) == 0) {
+      data &= 0xF0F0;
+    }
+
+    WriteVram16(vdp, address, data);
+  }
+
+  for (u16 name = 0; name < 0x800; name++) {
+    MarkPattern(vdp, name);
+  }
+
+  UpdatePatternCache(renderers);
+
+  // Name tables (runs of consecutive tiles, as found in actual games).
+  u16 tiles = mode.im2 ? 0x2FF : 0x5FF;
+
+  for (u32 address = kNtab; address < kSatb; address += 2) {
+    u16 attr = (u16)(random.Next(tiles) | (random.Next(0x20) << 11));
+
+    for (s32 run = 1 + random.Next(8); run && (address < kSatb); run--, address += 2) {
+      WriteVram16(vdp, address, attr);
+      attr = (attr & 0xF800) | ((attr + 1) & 0x07FF);
+    }
+
+    address -= 2;
+  }
+
+  // Sprites (all linked, the last one links back to the first one).
+  u16* sat = (u16*)&vdp->sat[0];
+
+  for (s32 i = 0; i < kSpriteCount; i++) {
+    u16 ypos = (u16)(0x80 - 16 + random.Next(kHeight + 16));
+    u16 size = (u16)random.Next(16);
+    u16 link = (u16)((i + 1) % kSpriteCount);
+    u16 attr = (u16)(random.Next(tiles - 16) | (random.Next(0x20) << 11));
+    u16 xpos = (u16)(0x80 - 16 + random.Next(kWidth + 16));
+
+    if (mode.im2) {
+      ypos = (u16)((ypos << 1) - 0x80);
+    }
+
+    // Y position and size/link are cached in the internal SAT.
+    sat[(i << 2) + 0] = ypos;
+    sat[(i << 2) + 1] = (u16)((size << 8) | link);
+
+    WriteVram16(vdp, kSatb + (i << 3) + 0, ypos);
+    WriteVram16(vdp, kSatb + (i << 3) + 2, (u16)((size << 8) | link));
+    WriteVram16(vdp, kSatb + (i << 3) + 4, attr);
+    WriteVram16(vdp, kSatb + (i << 3) + 6, xpos);
+  }
+
+  vdp->sat_dirty = 1;
+}
+
+//------------------------------------------------------------------------------
+
+// Update the scroll tables and some patterns for the next frame.
+static void UpdateScene(Vdp* vdp, Renderers* renderers, s32 frame, Random& random)
+{
+  // Horizontal scrolling (per line, with a wave on plane B).
+  u16 scroll_a = (u16)(frame * 3);
+
+  for (s32 line = 0; line < kHeight; line++) {
+    u16 scroll_b = (u16)(frame + ((line * 7) & 0x1F));
+
+    WriteVram16(vdp, kHscb + (line << 2) + 0, (u16)(-scroll_a & 0x3FF));
+    WriteVram16(vdp, kHscb + (line << 2) + 2, (u16)(-scroll_b & 0x3FF));
+  }
+
+  // Moving sprites (the SAT is written every frame, as done by DMA in games).
+  u16* sat = (u16*)&vdp->sat[0];
+
+  for (s32 i = 0; i < kSpriteCount; i++) {
+    u16 ypos = (u16)((sat[i << 2] + (i & 3) - 1) & 0x3FF);
+
+    sat[i << 2] = ypos;
+    WriteVram16(vdp, kSatb + (i << 3), ypos);
+  }
+
+  vdp->sat_dirty = 1;
+
+  // Vertical scrolling (per 2-cell column).
+  for (s32 i = 0; i < 40; i++) {
+    u16 data = (u16)((frame + (random.Next(8) * i)) & 0x3FF);
+    *(u16*)&vdp->vsram[i << 1] = data;
+  }
+
+  // Modified patterns (e.g. animated tiles).
+  for (s32 i = 0; i < 16; i++) {
+    u16 name = (u16)random.Next(0x600);
+
+    WriteVram16(vdp, (name << 5) + (random.Next(16) << 1), (u16)random.Next(0x10000));
+    MarkPattern(vdp, name);
+  }
+
+  UpdatePatternCache(renderers);
+
+  // Interlaced field.
+  vdp->odd_frame ^= vdp->im2_flag;
+}
+
+//------------------------------------------------------------------------------
+
+// Render the frames of a case.
+static CaseResult RunCase(Vdp* vdp, Renderers& renderers, const Mode& mode, s32 frames, bool virtual_calls, bool by_frame)
+{
+  Random random(0x5D5);
+  Hash hash;
+  CaseResult result = { 0, 0, 0, 0 };
+
+  M5DeferredLineRenderer* deferred_line_renderer = renderers.deferred_line_renderer;
+  bool deferred = deferred_line_renderer->IsRunning();
+
+  // Clear the state of the worker threads.
+  deferred_line_renderer->Reset();
+
+  SetupScene(vdp, &renderers, mode, random);
+
+  // Only count the updates of the animated scene.
+  renderers.bg_pattern_cache_updater->ResetUpdateCounters();
+
+  renderers.line_renderer->SetMode(mode.im2, mode.vscroll, mode.ste);
+
+  // Layer renderers (virtual calls).
+  IBackgroundLayerRenderer* bg_layer_renderer = nullptr;
+  ISpriteLayerRenderer* sprite_layer_renderer = nullptr;
+
+  if (mode.im2) {
+    bg_layer_renderer = mode.vscroll ? (IBackgroundLayerRenderer*)renderers.bg_im2_vs : renderers.bg_im2;
+    sprite_layer_renderer = mode.ste ? (ISpriteLayerRenderer*)renderers.sprite_im2_ste : renderers.sprite_im2;
+  } else {
+    bg_layer_renderer = mode.vscroll ? (IBackgroundLayerRenderer*)renderers.bg_vs : renderers.bg;
+    sprite_layer_renderer = mode.ste ? (ISpriteLayerRenderer*)renderers.sprite_ste : renderers.sprite;
+  }
+
+  // Background layers rendered by frame (the scene is not modified during the
+  // active display).
+  by_frame = by_frame && !deferred && renderers.frame_bg->CanRenderFrame(vdp->im2_flag);
+
+  for (s32 frame = 0; frame < frames; frame++) {
+    UpdateScene(vdp, &renderers, frame, random);
+
+    // Sprites of the first line are parsed during the last line of VBLANK.
+    renderers.satb_parser->ParseSpriteAttributeTable(-1);
+
+    if (by_frame) {
+      renderers.frame_bg->RenderFrame();
+    }
+
+    for (s32 line = 0; line < kHeight; line++) {
+      if (deferred) {
+        deferred_line_renderer->PushRenderLine(line);
+      } else if (by_frame) {
+        renderers.frame_bg->RenderBackground(line);
+        sprite_layer_renderer->RenderSprites(line & 1);
+      } else if (virtual_calls) {
+        bg_layer_renderer->RenderBackground(line);
+        sprite_layer_renderer->RenderSprites(line & 1);
+      } else {
+        renderers.line_renderer->RenderLayers(line);
+      }
+
+      if (line < (kHeight - 1)) {
+        renderers.satb_parser->ParseSpriteAttributeTable(line);
+      }
+
+      if (!deferred) {
+        hash.Add(&vdp->linebuf[0][0x20], kWidth);
+      }
+    }
+
+    if (deferred) {
+      // Wait for the worker threads.
+      deferred_line_renderer->Flush();
+      HashFramebuffer(vdp, hash);
+    }
+
+    result.lines += kHeight;
+  }
+
+  result.hash = hash.Get();
+  result.patterns = renderers.bg_pattern_cache_updater->GetUpdatedPatternCount();
+  result.rows = renderers.bg_pattern_cache_updater->GetUpdatedRowCount();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+
+static const BenchCase kCases[] = {
+  { "m5",            { false, false, false, false } },
+  { "m5_ste",        { false, false, true, false } },
+  { "m5_vs",         { false, true, false, false } },
+  { "m5_vs_ste",     { false, true, true, false } },
+  { "m5_im2",        { true, false, false, false } },
+  { "m5_im2_ste",    { true, false, true, false } },
+  { "m5_im2_vs",     { true, true, false, false } },
+  { "m5_im2_vs_ste", { true, true, true, false } },
+  { "m5_fs",         { false, false, false, true } },
+  { "m5_fs_ste",     { false, false, true, true } },
+};
+
+//------------------------------------------------------------------------------
+
+// Golden file: one "<case> <frames> <hash>" line per case.
+static bool FindGoldenHash(const std::vector<std::string>& lines, const char* name, s32 frames, u64& hash)
+{
+  for (const std::string& line : lines) {
+    char line_name[64];
+    s32 line_frames = 0;
+    unsigned long long line_hash = 0;
+
+    if (sscanf(line.c_str(), "%63s %d %llx", line_name, &line_frames, &line_hash) != 3) {
+      continue;
+    }
+
+    if (!strcmp(line_name, name) && (line_frames == frames)) {
+      hash = line_hash;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+  s32 frames = 600;
+  s32 iterations = 3;
+  const char* golden_path = RENDER_BENCH_GOLDEN_FILE;
+  bool update = false;
+  bool virtual_calls = false;
+  bool by_frame = false;
+  s32 threads = 0;
+  std::vector<std::string> selected;
+
+  for (s32 i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-f") && ((i + 1) < argc)) {
+      frames = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-i") && ((i + 1) < argc)) {
+      iterations = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-g") && ((i + 1) < argc)) {
+      golden_path = argv[++i];
+    } else if (!strcmp(argv[i], "-u")) {
+      update = true;
+    } else if (!strcmp(argv[i], "-v")) {
+      virtual_calls = true;
+    } else if (!strcmp(argv[i], "-d") && ((i + 1) < argc)) {
+      threads = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-t")) {
+      by_frame = true;
+    } else {
+      selected.push_back(argv[i]);
+    }
+  }
+
+  if ((frames < 1) || (iterations < 1) || (threads < 0)) {
+    printf("usage: %s [-f frames] [-i iterations] [-g golden] [-u] [-v] [-d threads] [-t] [case ...]\n", argv[0]);
+    return 1;
+  }
+
+  // The VDP state is too large for the stack.
+  Vdp* vdp = new Vdp();
+
+  MakeLayerPriorityLuts(vdp->lut);
+  MakeSpriteNameLut(vdp->name_lut);
+
+  // Identity palette (the framebuffer holds the pixels of the line buffer).
+  for (s32 i = 0; i < 0x100; i++) {
+    vdp->pixel[i] = (PIXEL_OUT_T)i;
+  }
+
+  vdp->framebuffer.data = vdp->framebuffer_data;
+  vdp->framebuffer.width = kWidth;
+  vdp->framebuffer.height = kHeight;
+  vdp->framebuffer.pitch = kWidth * sizeof(PIXEL_OUT_T);
+
+  Renderers* renderers = new Renderers(vdp);
+
+  if (threads) {
+    renderers->deferred_line_renderer->Start(threads);
+  }
+
+  // Load the golden file.
+  std::vector<std::string> golden;
+  FILE* file = fopen(golden_path, "r");
+
+  if (file) {
+    char line[256];
+
+    while (fgets(line, sizeof(line), file)) {
+      golden.push_back(line);
+    }
+
+    fclose(file);
+  } else if (!update) {
+    fprintf(stderr, "cannot open golden file %s\n", golden_path);
+  }
+
+  printf("pattern cache: %s (%d KB)\n",
+#ifdef USE_COMPACT_PATTERN_CACHE
+    "compact",
+#else
+    "flipped",
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
+    kPatternCacheSize >> 10);
+
+  printf("%-16s %10s %10s %12s %10s %9s %9s  %-16s %s\n", "case", "lines", "time (ms)", "lines/s", "ns/line",
+    "pat/frm", "rows/frm", "hash", "golden");
+
+  s32 failures = 0;
+  std::vector<std::string> updated;
+
+  for (const BenchCase& bench_case : kCases) {
+    bool run = selected.empty();
+
+    for (const std::string& name : selected) {
+      run |= (name == bench_case.name);
+    }
+
+    if (!run) {
+      continue;
+    }
+
+    CaseResult result = { 0, 0, 0, 0 };
+    f64 best = 0.0;
+    bool stable = true;
+
+    for (s32 i = 0; i < iterations; i++) {
+      auto start = std::chrono::steady_clock::now();
+      CaseResult current = RunCase(vdp, *renderers, bench_case.mode, frames, virtual_calls, by_frame);
+      f64 seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+
+      // The output must not depend on the iteration.
+      if (i && (current.hash != result.hash)) {
+        stable = false;
+      }
+
+      if (!i || (seconds < best)) {
+        best = seconds;
+      }
+
+      result = current;
+    }
+
+    const char* status = "-";
+    u64 expected = 0;
+
+    if (!stable) {
+      status = "UNSTABLE";
+      failures++;
+    } else if (update) {
+      status = "UPDATED";
+    } else if (FindGoldenHash(golden, bench_case.name, frames, expected)) {
+      if (expected == result.hash) {
+        status = "OK";
+      } else {
+        status = "MISMATCH";
+        failures++;
+      }
+    } else {
+      status = "MISSING";
+    }
+
+    char line[128];
+    snprintf(line, sizeof(line), "%s %d %016llx\n", bench_case.name, frames, (unsigned long long)result.hash);
+    updated.push_back(line);
+
+    printf("%-16s %10llu %10.2f %12.0f %10.1f %9.1f %9.1f  %016llx %s\n", bench_case.name, (unsigned long long)result.lines,
+      best * 1000.0, result.lines / best, (best * 1e9) / result.lines,
+      (f64)result.patterns / frames, (f64)result.rows / frames, (unsigned long long)result.hash, status);
+  }
+
+  delete renderers;
+  delete vdp;
+
+  // Update the golden file (hashes of other cases or frame counts are kept).
+  if (update) {
+    std::vector<std::string> lines;
+
+    for (const std::string& line : golden) {
+      char name[64];
+      s32 line_frames = 0;
+
+      if (sscanf(line.c_str(), "%63s %d", name, &line_frames) != 2) {
+        continue;
+      }
+
+      bool replaced = false;
+
+      for (const std::string& updated_line : updated) {
+        char updated_name[64];
+        s32 updated_frames = 0;
+
+        sscanf(updated_line.c_str(), "%63s %d", updated_name, &updated_frames);
+        replaced |= (!strcmp(name, updated_name) && (line_frames == updated_frames));
+      }
+
+      if (!replaced) {
+        lines.push_back(line);
+      }
+    }
+
+    lines.insert(lines.end(), updated.begin(), updated.end());
+
+    file = fopen(golden_path, "w");
+
+    if (!file) {
+      fprintf(stderr, "cannot write golden file %s\n", golden_path);
+      return 1;
+    }
+
+    for (const std::string& line : lines) {
+      fputs(line.c_str(), file);
+    }
+
+    fclose(file);
+  }
+
+  return failures ? 1 : 0;
+}
@@ -47,6 +47,7 @@
 #include "xee/mem/memory.h"
 
 #include "osd.h"
+#include "core/core_config.h"
 #include "core/snd.h"
 #include "core/system_clock.h"
 #include "core/system_cycle.h"
@@ -62,6 +63,7 @@
 #include "gpgx/g_audio_renderer.h"
 #include "gpgx/audio/audio_renderer.h"
 #include "gpgx/audio/blip_buffer.h"
+#include "gpgx/audio/polyphase_resampler.h"
 
 //==============================================================================
 
@@ -75,17 +77,30 @@ int audio_init(int samplerate, f64 framerate)
   /* Clear the sound data context */
   xee::mem::Memset(&snd, 0, sizeof(snd));
 
+  /* Blip Buffers run at a fixed internal rate when polyphase resampler is enabled */
+  int bliprate = samplerate;
+
+  if (core_config.resampler) {
+    snd.resampler = new (std::nothrow) gpgx::audio::PolyphaseResampler();
+    if (!snd.resampler) {
+      return -1;
+    }
+
+    bliprate = AUDIO_INTERNAL_RATE;
+  }
+
   /* Initialize Blip Buffers */
-  snd.blips[0] = gpgx::audio::BlipBuffer::blip_new(samplerate / 10);
+  snd.blips[0] = gpgx::audio::BlipBuffer::blip_new(bliprate / 10);
   if (!snd.blips[0]) {
+    audio_shutdown();
     return -1;
   }
 
   /* Mega CD sound hardware */
   if (system_hw == SYSTEM_MCD) {
     /* allocate blip buffers */
-    snd.blips[1] = gpgx::audio::BlipBuffer::blip_new(samplerate / 10);
-    snd.blips[2] = gpgx::audio::BlipBuffer::blip_new(samplerate / 10);
+    snd.blips[1] = gpgx::audio::BlipBuffer::blip_new(bliprate / 10);
+    snd.blips[2] = gpgx::audio::BlipBuffer::blip_new(bliprate / 10);
     if (!snd.blips[1] || !snd.blips[2]) {
       audio_shutdown();
       return -1;
@@ -142,11 +157,16 @@ void audio_set_rate(int samplerate, f64 framerate)
   /*                                                                                      */
   f64 mclk = framerate ? (MCYCLES_PER_LINE * (vdp_pal ? 313 : 262) * framerate) : system_clock;
 
+  /* When polyphase resampler is enabled, sound chips are resampled to a fixed internal */
+  /* rate, which is then converted to output rate, so that output rate can be changed  */
+  /* without reinitializing Blip Buffers.                                               */
+  int bliprate = snd.resampler ? AUDIO_INTERNAL_RATE : samplerate;
+
   /* For maximal accuracy, sound chips are running at their original rate using common */
   /* master clock timebase so they remain perfectly synchronized together, while still */
   /* being synchronized with 68K and Z80 CPUs as well. Mixed sound chip output is then */
   /* resampled to desired rate at the end of each frame, using Blip Buffer.            */
-  snd.blips[0]->blip_set_rates(mclk, samplerate);
+  snd.blips[0]->blip_set_rates(mclk, bliprate);
 
   /* Mega CD sound hardware enabled ? */
   if (snd.blips[1] && snd.blips[2]) {
@@ -154,19 +174,49 @@ void audio_set_rate(int samplerate, f64 framerate)
     mclk = (mclk / system_clock) * SCD_CLOCK;
 
     /* PCM core */
-    pcm_init(mclk, samplerate);
+    pcm_init(mclk, bliprate);
 
     /* CDD core */
-    cdd_init(samplerate);
+    cdd_init(bliprate);
+  }
+
+  /* Polyphase resampler */
+  if (snd.resampler) {
+    snd.resampler->SetRates(bliprate, samplerate);
   }
 
   /* Reinitialize internal rates */
-  snd.sample_rate = samplerate;
+  snd.sample_rate = bliprate;
+  snd.output_rate = samplerate;
   snd.frame_rate = framerate;
 }
 
 //------------------------------------------------------------------------------
 
+void audio_set_output_rate(int samplerate)
+{
+  if (snd.resampler) {
+    /* only the polyphase resampler needs to be reconfigured */
+    snd.resampler->SetRates(snd.sample_rate, samplerate);
+    snd.output_rate = samplerate;
+  } else {
+    /* Blip Buffers are directly resampling to output rate and need to be reallocated */
+    audio_init(samplerate, snd.frame_rate);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void audio_set_rate_adjustment(f64 adjustment)
+{
+  /* only available with polyphase resampler (dynamic rate control) */
+  if (snd.resampler) {
+    snd.resampler->SetRateAdjustment(adjustment);
+  }
+}
+
+//------------------------------------------------------------------------------
+
 void audio_reset(void)
 {
   int i;
@@ -178,6 +228,11 @@ void audio_reset(void)
     }
   }
 
+  /* Polyphase resampler */
+  if (snd.resampler) {
+    snd.resampler->Clear();
+  }
+
   /* Low-Pass filter */
   gpgx::g_audio_renderer->ResetLowPassFilter();
 
@@ -206,5 +261,11 @@ void audio_shutdown(void)
       snd.blips[i] = nullptr;
     }
   }
+
+  /* Delete polyphase resampler */
+  if (snd.resampler) {
+    delete snd.resampler;
+    snd.resampler = nullptr;
+  }
 }
 
@@ -0,0 +1,13 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "core/backup_ram.h"
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+u8 backup_ram_dirty;
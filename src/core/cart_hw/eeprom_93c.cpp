@@ -41,6 +41,7 @@
 #include "xee/mem/memory.h"
 
 #include "core/cart_hw/sram.h"
+#include "core/backup_ram.h"
 
 /* fixed board implementation */
 #define BIT_DATA (0)
@@ -120,6 +121,7 @@ void eeprom_93c_write(unsigned char data)
                 if (eeprom_93c.we)
                 {
                   *(u16 *)(sram.sram + ((eeprom_93c.opcode & 0x3F) << 1)) = 0xFFFF;
+                  backup_ram_dirty |= BACKUP_RAM_SRAM;
                 }
 
                 /* wait for next command */
@@ -147,6 +149,7 @@ void eeprom_93c_write(unsigned char data)
                     if (eeprom_93c.we)
                     {
                       xee::mem::Memset(sram.sram, 0xFF, 128);
+                      backup_ram_dirty |= BACKUP_RAM_SRAM;
                     }
 
                     /* wait for next command */
@@ -186,6 +189,7 @@ void eeprom_93c_write(unsigned char data)
               {
                 /* write one word */
                 *(u16 *)(sram.sram + ((eeprom_93c.opcode & 0x3F) << 1)) = eeprom_93c.buffer;
+                backup_ram_dirty |= BACKUP_RAM_SRAM;
               }
               else
               {
@@ -196,6 +200,7 @@ void eeprom_93c_write(unsigned char data)
                   *(u16 *)(sram.sram + (i << 1)) = eeprom_93c.buffer;
 
                 }
+                backup_ram_dirty |= BACKUP_RAM_SRAM;
               }
             }
 
@@ -51,6 +51,7 @@
 #include "core/mem68k.h"
 #include "core/rominfo.h"
 #include "core/cart_hw/sram.h"
+#include "core/backup_ram.h"
 
 #include "core/input_hw/gamepad.h"
 
@@ -591,6 +592,7 @@ static void eeprom_i2c_update(void)
         {
           /* write back to memory array (max 64kB) */
           sram.sram[(eeprom_i2c.device_address | eeprom_i2c.word_address) & 0xffff] = eeprom_i2c.buffer;
+          backup_ram_dirty |= BACKUP_RAM_SRAM;
           
           /* clear write buffer */
           eeprom_i2c.buffer = 0;
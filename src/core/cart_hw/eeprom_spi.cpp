@@ -42,6 +42,7 @@
 #include "xee/mem/memory.h"
 
 #include "core/cart_hw/sram.h"
+#include "core/backup_ram.h"
 
 /* max supported size 64KB (25x512/95x512) */
 #define SIZE_MASK 0xffff
@@ -270,6 +271,7 @@ void eeprom_spi_write(unsigned char data)
                       if (spi_eeprom.addr < 0xC000)
                       {
                         sram.sram[spi_eeprom.addr] = spi_eeprom.buffer;
+                        backup_ram_dirty |= BACKUP_RAM_SRAM;
                       }
                       break;
                     }
@@ -280,6 +282,7 @@ void eeprom_spi_write(unsigned char data)
                       if (spi_eeprom.addr < 0x8000)
                       {
                         sram.sram[spi_eeprom.addr] = spi_eeprom.buffer;
+                        backup_ram_dirty |= BACKUP_RAM_SRAM;
                       }
                       break;
                     }
@@ -294,6 +297,7 @@ void eeprom_spi_write(unsigned char data)
                     {
                       /* no sectors protected */
                       sram.sram[spi_eeprom.addr] = spi_eeprom.buffer;
+                      backup_ram_dirty |= BACKUP_RAM_SRAM;
                       break;
                     }
                   }
@@ -0,0 +1,35 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "core/cart_hw/game_db.h"
+
+#include <algorithm>
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+void game_db_build(game_db_t* db)
+{
+  std::sort(db->keys, db->keys + db->count, [](const game_db_key_t& a, const game_db_key_t& b) {
+    return (a.key < b.key) || ((a.key == b.key) && (a.entry < b.entry));
+  });
+
+  db->ready = 1;
+}
+
+//------------------------------------------------------------------------------
+
+int game_db_find(const game_db_t* db, u32 key)
+{
+  const game_db_key_t* begin = db->keys;
+  const game_db_key_t* end = begin + db->count;
+  const game_db_key_t* it = std::lower_bound(begin, end, key, [](const game_db_key_t& a, u32 k) {
+    return a.key < k;
+  });
+
+  return ((it != end) && (it->key == key)) ? it->entry : -1;
+}
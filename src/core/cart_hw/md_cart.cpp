@@ -69,6 +69,8 @@
 #include "core/cart_hw/lock_on_type.h"
 #include "core/cart_hw/special_hw_md.h"
 #include "core/cart_hw/sram.h"
+#include "core/cart_hw/game_db.h"
+#include "core/backup_ram.h"
 #include "core/cart_hw/ggenie.h"
 #include "core/cart_hw/areplay.h"
 #include "core/cart_hw/svp/svp.h"
@@ -304,11 +306,33 @@ static const md_entry_t rom_database[] =
   {0xffff,0x3632,0x20,0x20,{{0x00,0x00,0x00,0x00},{0xffffff,0xffffff,0xffffff,0xffffff},{0x000000,0x000000,0x000000,0x000000},0,0,NULL,m68k_unused_8_w,topshooter_r,topshooter_w}}
 };
 
+/* database index (by header & real checksums) */
+static game_db_key_t rom_keys[sizeof(rom_database) / sizeof(md_entry_t)];
+static game_db_t rom_db = {rom_keys, sizeof(rom_database) / sizeof(md_entry_t), 0};
+
 
 /************************************************************
           Cart Hardware initialization 
 *************************************************************/
 
+static int md_cart_find(u16 checksum, u16 realchecksum)
+{
+  /* index database on first lookup */
+  if (!rom_db.ready)
+  {
+    int i;
+    for (i = 0; i < rom_db.count; i++)
+    {
+      rom_keys[i].key = ((u32)rom_database[i].chk_1 << 16) | rom_database[i].chk_2;
+      rom_keys[i].entry = i;
+    }
+
+    game_db_build(&rom_db);
+  }
+
+  return game_db_find(&rom_db, ((u32)checksum << 16) | realchecksum);
+}
+
 void md_cart_init(void)
 {
   int i;
@@ -504,37 +528,31 @@ void md_cart_init(void)
   cart.hw.regs[0] = (0x200000 & cart.mask) >> 16;
 
   /* search for game into database */
-  for (i=0; i<(sizeof(rom_database)/sizeof(md_entry_t)); i++)
+  i = md_cart_find(rominfo.checksum, rominfo.realchecksum);
+  if (i >= 0)
   {
     /* known cart found ! */
-    if ((rominfo.checksum == rom_database[i].chk_1) &&
-        (rominfo.realchecksum == rom_database[i].chk_2))
-    {
-      int j = rom_database[i].bank_start;
+    int j = rom_database[i].bank_start;
 
-      /* retrieve hardware information */
-      xee::mem::Memcpy(&cart.hw, &(rom_database[i].cart_hw), sizeof(cart.hw));
+    /* retrieve hardware information */
+    xee::mem::Memcpy(&cart.hw, &(rom_database[i].cart_hw), sizeof(cart.hw));
 
-      /* initialize memory handlers for $400000-$7FFFFF region */
-      while (j <= rom_database[i].bank_end)
+    /* initialize memory handlers for $400000-$7FFFFF region */
+    while (j <= rom_database[i].bank_end)
+    {
+      if (cart.hw.regs_r)
       {
-        if (cart.hw.regs_r)
-        {
-          m68k.memory_map[j].read8    = cart.hw.regs_r;
-          m68k.memory_map[j].read16   = cart.hw.regs_r;
-          zbank_memory_map[j].read    = cart.hw.regs_r;
-        }
-        if (cart.hw.regs_w)
-        {
-          m68k.memory_map[j].write8   = cart.hw.regs_w;
-          m68k.memory_map[j].write16  = cart.hw.regs_w;
-          zbank_memory_map[j].write   = cart.hw.regs_w;
-        }
-        j++;
+        m68k.memory_map[j].read8    = cart.hw.regs_r;
+        m68k.memory_map[j].read16   = cart.hw.regs_r;
+        zbank_memory_map[j].read    = cart.hw.regs_r;
       }
-
-      /* leave loop */
-      break;
+      if (cart.hw.regs_w)
+      {
+        m68k.memory_map[j].write8   = cart.hw.regs_w;
+        m68k.memory_map[j].write16  = cart.hw.regs_w;
+        zbank_memory_map[j].write   = cart.hw.regs_w;
+      }
+      j++;
     }
   }
 
@@ -841,7 +859,7 @@ void md_cart_init(void)
     snd.blips[2] = gpgx::audio::BlipBuffer::blip_new(snd.sample_rate / 10);
 
     /* initialize PCM and CD-DA audio */
-    audio_set_rate(snd.sample_rate, snd.frame_rate);
+    audio_set_rate(snd.output_rate, snd.frame_rate);
   }
 }
 
@@ -2349,6 +2367,7 @@ static void topshooter_w(u32 address, u32 data)
   if (address >= 0x202000)
   {
     WRITE_BYTE(sram.sram , address & 0xffff, data);
+    backup_ram_dirty |= BACKUP_RAM_SRAM;
     return;
   }
 
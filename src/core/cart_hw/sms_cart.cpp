@@ -45,7 +45,7 @@
 #include "xee/mem/memory.h"
 
 #include "core/core_config.h"
-#include "core/loadrom.h" // For load_bios().
+#include "core/loadrom.h" // For load_bios() and getromcrc().
 #include "core/io_reg.h"
 #include "core/region_code.h"
 #include "core/rominfo.h"
@@ -57,7 +57,7 @@
 #include "core/input_hw/input.h"
 #include "core/cart_hw/special_hw_sms.h"
 #include "core/cart_hw/sram.h"
-#include "core/crypto/crypto_crc32.h"
+#include "core/cart_hw/game_db.h"
 #include "core/state.h"
 
 #include "core/cart_hw/eeprom_93c.h"
@@ -465,6 +465,10 @@ static const rominfo_t game_list[] =
   {0x07301F83, 0, 1, gpgx::hid::DeviceType::kNone, MAPPER_SEGA, SYSTEM_PBC, REGION_JAPAN_NTSC}  /* Phantasy Star [Megadrive] (J) */
 };
 
+/* game database index (by CRC) */
+static game_db_key_t game_keys[sizeof(game_list) / sizeof(rominfo_t)];
+static game_db_t game_db = {game_keys, sizeof(game_list) / sizeof(rominfo_t), 0};
+
 /* Cartridge & BIOS ROM hardware */
 static romhw_t cart_rom;
 static romhw_t bios_rom;
@@ -510,12 +514,31 @@ static unsigned char read_mapper_korea_8k(unsigned int address);
 static unsigned char read_mapper_default(unsigned int address);
 static unsigned char read_mapper_none(unsigned int address);
 
+static int sms_cart_find(u32 crc)
+{
+  /* index game database on first lookup (CRC are unique in the database) */
+  if (!game_db.ready)
+  {
+    int i;
+    for (i = 0; i < game_db.count; i++)
+    {
+      game_keys[i].key = game_list[i].crc;
+      game_keys[i].entry = i;
+    }
+
+    game_db_build(&game_db);
+  }
+
+  return game_db_find(&game_db, crc);
+}
+
 void sms_cart_init(void)
 {
-  int i = sizeof(game_list) / sizeof(rominfo_t) - 1;
+  /* game CRC (computed once per loaded ROM) */
+  u32 crc = getromcrc();
 
-  /* game CRC */
-  u32 crc = crc32(0, cart.rom, cart.romsize);
+  /* search for game into database */
+  int i = sms_cart_find(crc);
 
   /* unmapped memory return $FF on read (mapped to unused cartridge areas $510000-$5103FF & $510400-$5107FF) */
   xee::mem::Memset(cart.rom + 0x510000, 0xFF, 0x800);
@@ -542,39 +565,32 @@ void sms_cart_init(void)
   }
 
   /* auto-detect game settings */
-  do
+  if (i >= 0)
   {
-    if (crc == game_list[i].crc)
-    {
-      /* auto-detect cartridge mapper */
-      cart_rom.mapper = game_list[i].mapper;
-
-      /* auto-detect required peripherals */
-      if (game_list[i].peripheral != gpgx::hid::DeviceType::kNone)
-      {
-        gpgx::g_hid_system->ConnectDevice(0, game_list[i].peripheral);
-      }
+    /* auto-detect cartridge mapper */
+    cart_rom.mapper = game_list[i].mapper;
 
-      /* auto-detect 3D glasses support */
-      cart.special = game_list[i].g_3d;
+    /* auto-detect required peripherals */
+    if (game_list[i].peripheral != gpgx::hid::DeviceType::kNone)
+    {
+      gpgx::g_hid_system->ConnectDevice(0, game_list[i].peripheral);
+    }
 
-      /* auto-detect system hardware */
-      if (!core_config.system || ((core_config.system == SYSTEM_GG) && (game_list[i].system == SYSTEM_GGMS)))
-      {
-        system_hw = game_list[i].system;
-      }
+    /* auto-detect 3D glasses support */
+    cart.special = game_list[i].g_3d;
 
-      /* auto-detect YM2413 chip support in AUTO mode */
-      if (core_config.ym2413 & 2)
-      {
-        core_config.ym2413 |= game_list[i].fm;
-      }
+    /* auto-detect system hardware */
+    if (!core_config.system || ((core_config.system == SYSTEM_GG) && (game_list[i].system == SYSTEM_GGMS)))
+    {
+      system_hw = game_list[i].system;
+    }
 
-      /* game found, leave loop */
-      break;
+    /* auto-detect YM2413 chip support in AUTO mode */
+    if (core_config.ym2413 & 2)
+    {
+      core_config.ym2413 |= game_list[i].fm;
     }
   }
-  while (i--);
 
   /* ROM paging */
   if (cart_rom.mapper < MAPPER_SEGA)
@@ -839,10 +855,9 @@ int sms_cart_ram_size(void)
 
 int sms_cart_region_detect(void)
 {
-  int i = sizeof(game_list) / sizeof(rominfo_t) - 1;
-
-  /* compute CRC */
-  u32 crc = crc32(0, cart.rom, cart.romsize);
+  /* ROM CRC (computed once per loaded ROM) */
+  u32 crc = getromcrc();
+  int i;
 
   /* Turma da Mnica em: O Resgate & Wonder Boy III enable FM support on japanese hardware only */
   if (core_config.ym2413 && ((crc == 0x22CCA9BB) || (crc == 0x679E1676)))
@@ -851,14 +866,11 @@ int sms_cart_region_detect(void)
   }
 
   /* game database */
-  do
+  i = sms_cart_find(crc);
+  if (i >= 0)
   {
-    if (crc == game_list[i].crc)
-    {
-      return game_list[i].region;
-    }
+    return game_list[i].region;
   }
-  while(i--);
 
   /* Mark-III hardware */
   if (core_config.system == SYSTEM_MARKIII)
@@ -42,6 +42,7 @@
 
 #include "xee/mem/memory.h"
 
+#include "core/backup_ram.h"
 #include "core/macros.h"
 #include "core/ext.h" // For cart.
 #include "core/rominfo.h"
@@ -242,9 +243,11 @@ unsigned int sram_read_word(unsigned int address)
 void sram_write_byte(unsigned int address, unsigned int data)
 {
   sram.sram[address & 0xffff] = data;
+  backup_ram_dirty |= BACKUP_RAM_SRAM;
 }
 
 void sram_write_word(unsigned int address, unsigned int data)
 {
   WRITE_WORD(sram.sram, address & 0xfffe, data);
+  backup_ram_dirty |= BACKUP_RAM_SRAM;
 }
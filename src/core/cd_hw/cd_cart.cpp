@@ -40,6 +40,7 @@
 
 #include "xee/mem/memory.h"
 
+#include "core/backup_ram.h"
 #include "core/m68k/m68k.h"
 #include "core/ext.h" // For scd.
 #include "core/zbank_memory_map.h"
@@ -73,12 +74,14 @@ static void cart_ram_write_byte(unsigned int address, unsigned int data)
   if (address & 1)
   {
     scd.cartridge.area[(address >> 1) & scd.cartridge.mask] = data;
+    backup_ram_dirty |= BACKUP_RAM_CART;
   }
 }
 
 static void cart_ram_write_word(unsigned int address, unsigned int data)
 {
   scd.cartridge.area[(address >> 1) & scd.cartridge.mask] = data & 0xff;
+  backup_ram_dirty |= BACKUP_RAM_CART;
 }
 
 
@@ -38,6 +38,7 @@
 
 #include "core/cd_hw/cdc.h"
 
+#include "xee/fnd/compiler.h"
 #include "xee/fnd/data_type.h"
 #include "xee/mem/memory.h"
 
@@ -401,6 +402,82 @@ void cdc_dma_init(void)
   }
 }
 
+/* Copy 16-bit words from big-endian format (CDC RAM buffer) to native format */
+static XEE_INLINE void cdc_copy_words(u8 *dst, const u8 *src, unsigned int words)
+{
+#ifdef LSB_FIRST
+  unsigned int i;
+  u16 *dst16 = (u16 *)dst;
+  const u16 *src16 = (const u16 *)src;
+
+  /* byte swapping (vectorized by the compiler) */
+  for (i = 0; i < words; i++)
+  {
+    dst16[i] = (u16)((src16[i] << 8) | (src16[i] >> 8));
+  }
+#else
+  xee::mem::Memcpy(dst, src, words << 1);
+#endif
+}
+
+void cdc_dma_copy_words(u8 *dst, u32 dst_index, u32 dst_mask, u16 src_index, unsigned int words)
+{
+  unsigned int count, left;
+
+  while (words)
+  {
+    /* copy contiguous words until source or destination address wraps */
+    count = words;
+
+    left = (0x4000 - src_index) >> 1;
+    if (count > left)
+    {
+      count = left;
+    }
+
+    left = (dst_mask + 2 - dst_index) >> 1;
+    if (count > left)
+    {
+      count = left;
+    }
+
+    cdc_copy_words(dst + dst_index, cdc.ram + src_index, count);
+
+    src_index = (src_index + (count << 1)) & 0x3ffe;
+    dst_index = (dst_index + (count << 1)) & dst_mask;
+    words -= count;
+  }
+}
+
+void cdc_dma_copy_bytes(u8 *dst, u32 dst_index, u32 dst_mask, u16 src_index, unsigned int length)
+{
+  unsigned int count, left;
+
+  while (length)
+  {
+    /* copy contiguous bytes until source or destination address wraps */
+    count = length;
+
+    left = 0x4000 - src_index;
+    if (count > left)
+    {
+      count = left;
+    }
+
+    left = dst_mask + 1 - dst_index;
+    if (count > left)
+    {
+      count = left;
+    }
+
+    xee::mem::Memcpy(dst + dst_index, cdc.ram + src_index, count);
+
+    src_index = (src_index + count) & 0x3fff;
+    dst_index = (dst_index + count) & dst_mask;
+    length -= count;
+  }
+}
+
 void cdc_dma_update(unsigned int cycles)
 {
   /* max number of bytes that can be transfered */
@@ -60,6 +60,14 @@
 
 #include "core/cart_hw/megasd.h"
 
+#ifdef USE_CDDA_DECODER
+#include "gpgx/cd/cdda_decoder.h"
+#endif
+
+#ifdef USE_SECTOR_CACHE
+#include "gpgx/cd/sector_cache.h"
+#endif
+
 #define SUPPORTED_EXT 10
 
 /* CD blocks scanning speed */
@@ -159,6 +167,49 @@ static const char extensions[SUPPORTED_EXT][16] =
   " - %d.wav"
 };
 
+#ifdef USE_CDDA_DECODER
+/* CD-DA tracks reader (audio blocks are read and decompressed ahead of playback) */
+static gpgx::cd::CddaDecoder cdda_decoder;
+#endif
+
+#ifdef USE_SECTOR_CACHE
+/* CD-ROM sectors cache (disabled if NULL) */
+static gpgx::cd::SectorCache *sector_cache = NULL;
+
+/* default number of cached sectors for compressed images (2.3 MB) */
+#define SECTOR_CACHE_DEFAULT 1024
+#endif
+
+/* TOC index: first track not ended at the start of each second of the disc (up to 100 minutes) */
+#define TOC_INDEX_SIZE (100*60)
+static u8 toc_index[TOC_INDEX_SIZE];
+
+static void cdd_build_toc_index(void)
+{
+  int i, index = 0;
+
+  for (i=0; i<TOC_INDEX_SIZE; i++)
+  {
+    while ((cdd.toc.tracks[index].end <= (i * 75)) && (index < cdd.toc.last)) index++;
+    toc_index[i] = index;
+  }
+}
+
+static int cdd_find_track(int lba)
+{
+  int index = 0;
+
+  /* start from first track not ended at the start of current second */
+  if (lba >= 0)
+  {
+    index = toc_index[(lba < (TOC_INDEX_SIZE * 75)) ? (lba / 75) : (TOC_INDEX_SIZE - 1)];
+  }
+
+  while ((cdd.toc.tracks[index].end <= lba) && (index < cdd.toc.last)) index++;
+
+  return index;
+}
+
 void cdd_init(int samplerate)
 {
   /* CD-DA is running by default at 44100 Hz */
@@ -207,7 +258,11 @@ int cdd_context_save(u8 *state)
     if (cdd.toc.tracks[cdd.index].fd)
     {
       /* PCM file offset */
+#ifdef USE_CDDA_DECODER
+      offset = cdda_decoder.Tell();
+#else
       offset = cdStreamTell(cdd.toc.tracks[cdd.index].fd);
+#endif
     }
   }
 
@@ -261,7 +316,11 @@ int cdd_context_load(u8 *state, const char *version)
       if (cdd.toc.tracks[index].fd)
       {
         /* PCM file offset */
+#ifdef USE_CDDA_DECODER
+        cdda_decoder.Seek(cdd.toc.tracks[index].fd, offset);
+#else
         cdStreamSeek(cdd.toc.tracks[index].fd, offset, SEEK_SET);
+#endif
       }
     }
   }
@@ -895,6 +954,32 @@ int cdd_load(char *filename, char *header)
     /* CD mounted */
     cdd.loaded = isMSDfile ? HW_ADDON_MEGASD : HW_ADDON_MEGACD;
 
+#ifdef USE_CDDA_DECODER
+    /* start CD-DA tracks reader */
+    cdda_decoder.Open();
+#endif
+
+    /* track lookup from LBA */
+    cdd_build_toc_index();
+
+#ifdef USE_SECTOR_CACHE
+    /* CD-ROM sectors cache (enabled by default for compressed images, which are expensive to read) */
+    if (cdd.sectorSize && cdd.toc.tracks[0].type)
+    {
+      u32 capacity = core_config.cd_cache;
+
+      if (!capacity && cdd.toc.tracks[0].fd->HasExpensiveReads())
+      {
+        capacity = SECTOR_CACHE_DEFAULT;
+      }
+
+      if (capacity)
+      {
+        sector_cache = new gpgx::cd::SectorCache(cdd.sectorSize, capacity);
+      }
+    }
+#endif
+
     /* Automatically try to open associated subcode data file */
     xee::mem::Memcpy(&fname[strlen(fname) - 4], ".sub", 4);
     cdd.toc.sub = cdStreamOpen(fname);
@@ -913,6 +998,25 @@ void cdd_unload(void)
   {
     int i;
 
+#ifdef USE_CDDA_DECODER
+    /* stop CD-DA tracks reader (before its streams on track files are closed) */
+    cdda_decoder.Close();
+#endif
+
+#ifdef USE_SECTOR_CACHE
+    if (sector_cache)
+    {
+#ifdef LOG_CDD
+      gpgx::cd::SectorCache::Stats stats = sector_cache->GetStats();
+      error("sector cache: %llu hits, %llu misses, %llu bytes read\n", (unsigned long long)stats.hits, (unsigned long long)stats.misses, (unsigned long long)stats.bytes_read);
+#endif
+
+      /* release CD-ROM sectors cache */
+      delete sector_cache;
+      sector_cache = NULL;
+    }
+#endif
+
     /* close CD tracks */
     for (i=0; i<cdd.toc.last; i++)
     {
@@ -942,6 +1046,7 @@ void cdd_unload(void)
 
   /* reset TOC */
   xee::mem::Memset(&cdd.toc, 0x00, sizeof(cdd.toc));
+  xee::mem::Memset(toc_index, 0x00, sizeof(toc_index));
 
   /* no CD-ROM track */
   cdd.sectorSize = 0;
@@ -952,12 +1057,41 @@ void cdd_read_data(u8 *dst, u8 *subheader)
   /* only allow reading (first) CD-ROM track sectors */
   if (cdd.toc.tracks[cdd.index].type && (cdd.lba >= 0))
   {
+#ifdef USE_SECTOR_CACHE
+    if (sector_cache)
+    {
+      /* read full sector from cache */
+      u8 sector[gpgx::cd::SectorCache::kMaxSectorSize];
+      sector_cache->Read(cdd.toc.tracks[0].fd, cdd.lba, sector);
+
+      if (cdd.sectorSize == 2048)
+      {
+        /* Mode 1 user data (2048 bytes) */
+        xee::mem::Memcpy(dst, sector, 2048);
+      }
+      else if (!subheader)
+      {
+        /* skip block sync pattern (12 bytes) + block header (4 bytes) then copy Mode 1 user data (2048 bytes) */
+        xee::mem::Memcpy(dst, sector + 12 + 4, 2048);
+      }
+      else
+      {
+        /* skip block sync pattern (12 bytes) + block header (4 bytes) + Mode 2 sub-header (first 4 bytes) then copy Mode 2 sub-header (last 4 bytes) */
+        xee::mem::Memcpy(subheader, sector + 12 + 4 + 4, 4);
+
+        /* copy Mode 2 user data (max 2328 bytes) */
+        xee::mem::Memcpy(dst, sector + 12 + 4 + 8, 2328);
+      }
+
+      return;
+    }
+#endif
+
     /* check sector size */
     if (cdd.sectorSize == 2048)
     {
       /* read Mode 1 user data (2048 bytes) */
-      cdStreamSeek(cdd.toc.tracks[0].fd, cdd.lba * 2048, SEEK_SET);
-      cdStreamRead(dst, 2048, 1, cdd.toc.tracks[0].fd);
+      cdStreamReadAt(dst, 2048, cdd.lba * 2048, cdd.toc.tracks[0].fd);
     }
     else
     {
@@ -965,14 +1099,12 @@ void cdd_read_data(u8 *dst, u8 *subheader)
       if (!subheader)
       {
         /* skip block sync pattern (12 bytes) + block header (4 bytes) then read Mode 1 user data (2048 bytes) */
-        cdStreamSeek(cdd.toc.tracks[0].fd, (cdd.lba * 2352) + 12 + 4, SEEK_SET);
-        cdStreamRead(dst, 2048, 1, cdd.toc.tracks[0].fd);
+        cdStreamReadAt(dst, 2048, (cdd.lba * 2352) + 12 + 4, cdd.toc.tracks[0].fd);
       }
       else
       {
         /* skip block sync pattern (12 bytes) + block header (4 bytes) + Mode 2 sub-header (first 4 bytes) then read Mode 2 sub-header (last 4 bytes) */
-        cdStreamSeek(cdd.toc.tracks[0].fd, (cdd.lba * 2352) + 12 + 4 + 4, SEEK_SET);
-        cdStreamRead(subheader, 4, 1, cdd.toc.tracks[0].fd);
+        cdStreamReadAt(subheader, 4, (cdd.lba * 2352) + 12 + 4 + 4, cdd.toc.tracks[0].fd);
 
         /* read Mode 2 user data (max 2328 bytes) */
         cdStreamRead(dst, 2328, 1, cdd.toc.tracks[0].fd);
@@ -987,7 +1119,11 @@ void cdd_seek_audio(int index, int lba)
   if (cdd.toc.tracks[index].fd)
   {
     /* PCM AUDIO track */
+#ifdef USE_CDDA_DECODER
+    cdda_decoder.Seek(cdd.toc.tracks[index].fd, (lba * 2352) - cdd.toc.tracks[index].offset);
+#else
     cdStreamSeek(cdd.toc.tracks[index].fd, (lba * 2352) - cdd.toc.tracks[index].offset, SEEK_SET);
+#endif
   }
 }
 
@@ -1015,7 +1151,11 @@ void cdd_read_audio(unsigned int samples)
 #else
       u8 *ptr = cdc.ram;
 #endif
+#ifdef USE_CDDA_DECODER
+      cdda_decoder.Read(cdc.ram, samples * 4);
+#else
       cdStreamRead(cdc.ram, 1, samples * 4, cdd.toc.tracks[cdd.index].fd);
+#endif
 
       /* process 16-bit (little-endian) stereo samples */
       for (i=0; i<samples; i++)
@@ -1477,8 +1617,8 @@ void cdd_process(void)
 
     case 0x03:  /* Play */
     {
-      /* reset track index */
-      int index = 0;
+      /* track index */
+      int index;
 
       /* new LBA position */
       int lba = ((scd.regs[0x44>>1].byte.h * 10 + scd.regs[0x44>>1].byte.l) * 60 + 
@@ -1513,7 +1653,7 @@ void cdd_process(void)
       cdd.lba = lba;
 
       /* get track index */
-      while ((cdd.toc.tracks[index].end <= lba) && (index < cdd.toc.last)) index++;
+      index = cdd_find_track(lba);
 
       /* audio track ? */
       if (cdd.toc.tracks[index].type == TYPE_AUDIO)
@@ -1555,8 +1695,8 @@ void cdd_process(void)
 
     case 0x04:  /* Seek */
     {
-      /* reset track index */
-      int index = 0;
+      /* track index */
+      int index;
 
       /* new LBA position */
       int lba = ((scd.regs[0x44>>1].byte.h * 10 + scd.regs[0x44>>1].byte.l) * 60 + 
@@ -1580,7 +1720,7 @@ void cdd_process(void)
       cdd.lba = lba;
 
       /* get current track index */
-      while ((cdd.toc.tracks[index].end <= lba) && (index < cdd.toc.last)) index++;
+      index = cdd_find_track(lba);
 
       /* audio track ? */
       if (cdd.toc.tracks[index].type == TYPE_AUDIO)
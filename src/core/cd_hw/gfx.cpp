@@ -46,9 +46,16 @@
 #include "osd.h" // For error().
 #endif
 
+#include "core/core_config.h"
 #include "core/m68k/m68k.h"
 #include "core/ext.h" // For cdc, scd and gfx.
 #include "core/state.h"
+#include "core/cd_hw/cdc.h" // For cdc_dma_copy_words().
+
+#include "gpgx/ppu/mcd/gfx_line_renderer.h"
+
+/* Rotation / Scaling operation renderer */
+static gpgx::ppu::mcd::GfxLineRenderer* gfx_line_renderer = nullptr;
 
 /***************************************************************/
 /*          WORD-RAM DMA interfaces (1M & 2M modes)            */
@@ -56,8 +63,6 @@
 
 void word_ram_0_dma_w(unsigned int length)
 {
-  u16 data;
-
   /* 16-bit DMA only */
   unsigned int words = length >> 1;
 
@@ -73,27 +78,12 @@ void word_ram_0_dma_w(unsigned int length)
   /* update DMA source address */
   cdc.dac.w += (words << 1);
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC RAM buffer (big-endian format) */
-    data = READ_WORD(cdc.ram, src_index);
-
-    /* write 16-bit word to WORD-RAM */
-    *(u16 *)(scd.word_ram[0] + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment WORD-RAM destination address */
-    dst_index = (dst_index + 2) & 0x1fffe;
-  }
+  /* DMA transfer (16-bit words from CDC RAM buffer in big-endian format) */
+  cdc_dma_copy_words(scd.word_ram[0], dst_index, 0x1fffe, src_index, words);
 }
 
 void word_ram_1_dma_w(unsigned int length)
 {
-  u16 data;
-
   /* 16-bit DMA only */
   unsigned int words = length >> 1;
 
@@ -109,27 +99,12 @@ void word_ram_1_dma_w(unsigned int length)
   /* update DMA source address */
   cdc.dac.w += (words << 1);
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC RAM buffer (big-endian format) */
-    data = READ_WORD(cdc.ram, src_index);
-
-    /* write 16-bit word to WORD-RAM */
-    *(u16 *)(scd.word_ram[1] + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment WORD-RAM destination address */
-    dst_index = (dst_index + 2) & 0x1fffe;
-  }
+  /* DMA transfer (16-bit words from CDC RAM buffer in big-endian format) */
+  cdc_dma_copy_words(scd.word_ram[1], dst_index, 0x1fffe, src_index, words);
 }
 
 void word_ram_2M_dma_w(unsigned int length)
 {
-  u16 data;
-
   /* 16-bit DMA only */
   unsigned int words = length >> 1;
 
@@ -145,21 +120,8 @@ void word_ram_2M_dma_w(unsigned int length)
   /* update DMA source address */
   cdc.dac.w += (words << 1);
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC RAM buffer (big-endian format) */
-    data = READ_WORD(cdc.ram, src_index);
-
-    /* write 16-bit word to WORD-RAM */
-    *(u16 *)(scd.word_ram_2M + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment WORD-RAM destination address */
-    dst_index = (dst_index + 2) & 0x3fffe;
-  }
+  /* DMA transfer (16-bit words from CDC RAM buffer in big-endian format) */
+  cdc_dma_copy_words(scd.word_ram_2M, dst_index, 0x3fffe, src_index, words);
 }
 
 
@@ -424,6 +386,17 @@ void gfx_init(void)
     /* pixel offset (0-63) */
     gfx.lut_pixel[i] = col + row * 8;
   }
+
+  /* Initialize renderer (dots fetched by worker threads if enabled) */
+  if (!gfx_line_renderer)
+  {
+    gfx_line_renderer = new gpgx::ppu::mcd::GfxLineRenderer(scd.word_ram_2M, gfx.lut_cell, gfx.lut_pixel, gfx.lut_prio);
+  }
+
+  if (core_config.gfx_threads)
+  {
+    gfx_line_renderer->Start(core_config.gfx_threads);
+  }
 }
 
 void gfx_reset(void)
@@ -432,6 +405,16 @@ void gfx_reset(void)
   gfx.cycles = 0;
 }
 
+void gfx_shutdown(void)
+{
+  /* Stop worker threads */
+  if (gfx_line_renderer)
+  {
+    delete gfx_line_renderer;
+    gfx_line_renderer = nullptr;
+  }
+}
+
 int gfx_context_save(u8 *state)
 {
   u32 tmp32;
@@ -476,136 +459,6 @@ int gfx_context_load(u8 *state)
   return bufferptr;
 }
 
-static XEE_INLINE void gfx_render(u32 bufferIndex, u32 width)
-{
-  u8 pixel_in, pixel_out;
-  u16 stamp_data;
-  u32 stamp_index;
-
-  /* bits [1:0] of 32x32 pixels stamp index are masked (see Chuck Rock II - Son of Chuck) */
-  u32 stamp_mask = (scd.regs[0x58>>1].byte.l & 0x02) ? 0x7fc : 0x7ff;
-
-  /* pixel map start position for current line (13.3 format converted to 13.11) */
-  u32 xpos = *gfx.tracePtr++ << 8;
-  u32 ypos = *gfx.tracePtr++ << 8;
-
-  /* pixel map offset values for current line (5.11 format) */
-  u32 xoffset = (s16) *gfx.tracePtr++;
-  u32 yoffset = (s16) *gfx.tracePtr++;
-
-  /* process all dots */
-  while (width--)
-  {
-    /* check if stamp map is repeated */
-    if (scd.regs[0x58>>1].byte.l & 0x01)
-    {
-      /* stamp map range */
-      xpos &= gfx.dotMask;
-      ypos &= gfx.dotMask;
-    }
-    else
-    {
-      /* 24-bit range */
-      xpos &= 0xffffff;
-      ypos &= 0xffffff;
-    }
-
-    /* check if pixel is outside stamp map */
-    if ((xpos | ypos) & ~gfx.dotMask)
-    {
-      /* force pixel output to 0 */
-      pixel_out = 0x00;
-    }
-    else
-    {
-      /* read stamp map table data */
-      stamp_data = gfx.mapPtr[(xpos >> gfx.stampShift) | ((ypos >> gfx.stampShift) << gfx.mapShift)];
-
-      /* stamp generator base index                                     */
-      /* sss ssssssss ccyyyxxx (16x16) or sss sssssscc ccyyyxxx (32x32) */
-      /* with:  s = stamp number (1 stamp = 16x16 or 32x32 pixels)      */
-      /*        c = cell offset  (0-3 for 16x16, 0-15 for 32x32)        */
-      /*      yyy = line offset  (0-7)                                  */
-      /*      xxx = pixel offset (0-7)                                  */
-      stamp_index = (stamp_data & stamp_mask) << 8;
-
-      if (stamp_index)
-      {
-        /* extract HFLIP & ROTATION bits */
-        stamp_data = (stamp_data >> 13) & 7;
-
-        /* cell offset (0-3 or 0-15)                             */
-        /* table entry = yyxxshrr (8 bits)                       */
-        /* with: yy = cell row  (0-3) = (ypos >> (11 + 3)) & 3   */
-        /*       xx = cell column (0-3) = (xpos >> (11 + 3)) & 3 */
-        /*        s = stamp size (0=16x16, 1=32x32)              */
-        /*      hrr = HFLIP & ROTATION bits                      */
-        stamp_index |= gfx.lut_cell[stamp_data | ((scd.regs[0x58>>1].byte.l & 0x02) << 2 ) | ((ypos >> 8) & 0xc0) | ((xpos >> 10) & 0x30)] << 6;
-            
-        /* pixel  offset (0-63)                              */
-        /* table entry = yyyxxxhrr (9 bits)                  */
-        /* with: yyy = pixel row  (0-7) = (ypos >> 11) & 7   */
-        /*       xxx = pixel column (0-7) = (xpos >> 11) & 7 */
-        /*       hrr = HFLIP & ROTATION bits                 */
-        stamp_index |= gfx.lut_pixel[stamp_data | ((xpos >> 8) & 0x38) | ((ypos >> 5) & 0x1c0)];
-
-        /* read pixel pair (2 pixels/byte) */
-        pixel_out = READ_BYTE(scd.word_ram_2M, stamp_index >> 1);
-
-        /* extract left or rigth pixel */
-        if (stamp_index & 1)
-        {
-           pixel_out &= 0x0f;
-        }
-        else
-        {
-           pixel_out >>= 4;
-        }
-      }
-      else
-      {
-        /* stamp 0 is not used: force pixel output to 0 */
-        pixel_out = 0x00;
-      }
-    }
-
-    /* read out paired pixel data */
-    pixel_in = READ_BYTE(scd.word_ram_2M, bufferIndex >> 1);
-
-    /* update left or rigth pixel */
-    if (bufferIndex & 1)
-    {
-      pixel_out |= (pixel_in & 0xf0);
-    }
-    else
-    {
-      pixel_out = (pixel_out << 4) | (pixel_in & 0x0f);
-    }
-
-    /* priority mode write */
-    pixel_out = gfx.lut_prio[(scd.regs[0x02>>1].w >> 3) & 0x03][pixel_in][pixel_out];
-
-    /* write data to image buffer */
-    WRITE_BYTE(scd.word_ram_2M, bufferIndex >> 1, pixel_out);
-
-    /* check current pixel position  */
-    if ((bufferIndex & 7) != 7)
-    {
-      /* next pixel */
-      bufferIndex++;
-    }
-    else
-    {
-      /* next cell: increment image buffer offset by one column (minus 7 pixels) */
-      bufferIndex += gfx.bufferOffset;
-    }
-
-    /* increment pixel position */
-    xpos += xoffset;
-    ypos += yoffset;
-  }
-}
-
 void gfx_start(unsigned int base, int cycles)
 {
   u32 mask;
@@ -741,13 +594,27 @@ void gfx_update(int cycles)
       }
 
       /* render lines */
-      while (lines--)
+      if (lines)
       {
+        gpgx::ppu::mcd::GfxOperation op;
+
+        op.map = gfx.mapPtr;
+        op.dot_mask = gfx.dotMask;
+        op.buffer_offset = gfx.bufferOffset;
+        op.stamp_shift = gfx.stampShift;
+        op.map_shift = gfx.mapShift;
+        op.stamp_size = (scd.regs[0x58>>1].byte.l >> 1) & 0x01;
+        op.repeat = scd.regs[0x58>>1].byte.l & 0x01;
+        op.priority_mode = (scd.regs[0x02>>1].w >> 3) & 0x03;
+
         /* process dots to image buffer */
-        gfx_render(gfx.bufferStart, scd.regs[0x62>>1].w);
+        gfx_line_renderer->Render(op, gfx.tracePtr, gfx.bufferStart, lines, scd.regs[0x62>>1].w);
+
+        /* 4 trace vectors per line */
+        gfx.tracePtr += lines * 4;
 
-        /* increment image buffer start index for next line (8 pixels/line) */
-        gfx.bufferStart += 8;
+        /* increment image buffer start index for next lines (8 pixels/line) */
+        gfx.bufferStart += lines * 8;
       }
     }
   }
@@ -38,9 +38,12 @@
 
 #include "core/cd_hw/pcm.h"
 
+#include <cstring> // For memchr().
+
 #include "core/core_config.h"
 #include "core/snd.h"
 #include "core/ext.h" // For cdc and pcm.
+#include "core/cd_hw/cdc.h" // For cdc_dma_copy_bytes().
 #include "xee/mem/memory.h"
 
 #ifdef LOG_PCM
@@ -55,8 +58,22 @@
 
 #define pcm scd.pcm_hw
 
+/* PCM samples mixed at once */
+#define PCM_BLOCK_SIZE 256
+
+/* sign-magnitude PCM data decoding table (bit 7 = sign, 1 = positive) */
+static s8 pcm_data_lut[256];
+
 void pcm_init(f64 clock, int samplerate)
 {
+  int i;
+
+  /* initialize PCM data decoding table */
+  for (i=0; i<256; i++)
+  {
+    pcm_data_lut[i] = (i & 0x80) ? (i & 0x7f) : -(i & 0x7f);
+  }
+
   /* PCM chip is running at original rate and is synchronized with SUB-CPU  */
   /* Chip output is resampled to desired rate using Blip Buffer. */
   snd.blips[1]->blip_set_rates(clock / PCM_SCYCLES_RATIO, samplerate);
@@ -124,99 +141,169 @@ int pcm_context_load(u8 *state)
   return bufferptr;
 }
 
-void pcm_run(unsigned int length)
+/* check if a loop marker (0xff) is read from WAVE RAM within the next samples of a channel */
+static int pcm_find_loop_marker(u32 addr, u32 step, int length)
 {
-#ifdef LOG_PCM
-  error("[%d][%d]run %d PCM samples (from %d)\n", v_counter, s68k.cycles, length, pcm.cycles);
-#endif
+  /* first and last read WAVE RAM addresses */
+  u32 first = (addr >> 11) & 0xffff;
+  u32 count = (u32)((((u64)addr + ((u64)(length - 1) * step)) >> 11) - (addr >> 11)) + 1;
 
-  /* previous audio outputs */
-  int prev_l = pcm.out[0];
-  int prev_r = pcm.out[1];
+  if (count >= 0x10000)
+  {
+    /* whole WAVE RAM is read */
+    return memchr(pcm.ram, 0xff, 0x10000) != NULL;
+  }
 
-  /* check if PCM chip is running */
-  if (pcm.enabled)
+  if ((first + count) > 0x10000)
   {
-    int i, j, l, r;
-  
-    /* generate PCM samples */
-    for (i=0; i<length; i++)
+    /* WAVE RAM address wraps around */
+    return (memchr(&pcm.ram[first], 0xff, 0x10000 - first) != NULL) ||
+           (memchr(pcm.ram, 0xff, first + count - 0x10000) != NULL);
+  }
+
+  return memchr(&pcm.ram[first], 0xff, count) != NULL;
+}
+
+/* mix PCM channels outputs (channel by channel) */
+static void pcm_mix_block(s32 *out_l, s32 *out_r, int length)
+{
+  int i, j, mul_l, mul_r;
+  u32 addr, step;
+
+  xee::mem::Memset(out_l, 0, length * sizeof(s32));
+  xee::mem::Memset(out_r, 0, length * sizeof(s32));
+
+  /* run eight PCM channels */
+  for (j=0; j<8; j++)
+  {
+    chan_t *chan = &pcm.chan[j];
+
+    /* check if channel is enabled */
+    if (!(pcm.status & (1 << j)))
     {
-      /* clear output */
-      l = r = 0;
+      continue;
+    }
+
+    /* ENV & stereo PAN multipliers */
+    mul_l = chan->env * (chan->pan & 0x0F);
+    mul_r = chan->env * (chan->pan >> 4);
 
-      /* run eight PCM channels */
-      for (j=0; j<8; j++)
+    addr = chan->addr;
+    step = chan->fd.w;
+
+    if (!pcm_find_loop_marker(addr, step, length))
+    {
+      /* no loop data within block */
+      if (mul_l | mul_r)
       {
-        /* check if channel is enabled */
-        if (pcm.status & (1 << j))
+        for (i=0; i<length; i++)
         {
-          /* read from current WAVE RAM address */
-          short data = pcm.ram[(pcm.chan[j].addr >> 11) & 0xffff];
+          int data = pcm_data_lut[pcm.ram[(addr >> 11) & 0xffff]];
+          addr += step;
 
-          /* loop data ? */
-          if (data == 0xff)
-          {
-            /* reset WAVE RAM address */
-            pcm.chan[j].addr = pcm.chan[j].ls.w << 11;
+          /* multiply PCM data with ENV & stereo PAN data then add to L/R outputs (14.5 fixed point) */
+          out_l[i] += ((data * mul_l) >> 5);
+          out_r[i] += ((data * mul_r) >> 5);
+        }
+      }
+      else
+      {
+        /* muted channel */
+        addr += step * length;
+      }
+    }
+    else
+    {
+      for (i=0; i<length; i++)
+      {
+        /* read from current WAVE RAM address */
+        int data = pcm.ram[(addr >> 11) & 0xffff];
 
-            /* read again from WAVE RAM address */
-            data = pcm.ram[pcm.chan[j].ls.w];
-          }
-          else
-          {
-            /* increment WAVE RAM address */
-            pcm.chan[j].addr += pcm.chan[j].fd.w;
-          }
+        /* loop data ? */
+        if (data == 0xff)
+        {
+          /* reset WAVE RAM address */
+          addr = chan->ls.w << 11;
+
+          /* read again from WAVE RAM address */
+          data = pcm.ram[chan->ls.w];
 
           /* infinite loop should not output any data */
-          if (data != 0xff)
+          if (data == 0xff)
           {
-            /* check sign bit (output centered around 0) */
-            if (data & 0x80)
-            {
-              /* PCM data is positive */
-              data = data & 0x7f;
-            }
-            else
-            {
-              /* PCM data is negative */
-              data = -(data & 0x7f);
-            }
-
-            /* multiply PCM data with ENV & stereo PAN data then add to L/R outputs (14.5 fixed point) */
-            l += ((data * pcm.chan[j].env * (pcm.chan[j].pan & 0x0F)) >> 5);
-            r += ((data * pcm.chan[j].env * (pcm.chan[j].pan >> 4)) >> 5);
+            continue;
           }
         }
+        else
+        {
+          /* increment WAVE RAM address */
+          addr += step;
+        }
+
+        /* multiply PCM data with ENV & stereo PAN data then add to L/R outputs (14.5 fixed point) */
+        data = pcm_data_lut[data];
+        out_l[i] += ((data * mul_l) >> 5);
+        out_r[i] += ((data * mul_r) >> 5);
       }
+    }
 
-      /* limiter */
-      if (l < -32768) l = -32768;
-      else if (l > 32767) l = 32767;
-      if (r < -32768) r = -32768;
-      else if (r > 32767) r = 32767;
+    chan->addr = addr;
+  }
 
-      /* PCM output mixing level (0-100%) */
-      l = (l * core_config.pcm_volume) / 100;
-      r = (r * core_config.pcm_volume) / 100;
+  for (i=0; i<length; i++)
+  {
+    int l = out_l[i];
+    int r = out_r[i];
+
+    /* limiter */
+    if (l < -32768) l = -32768;
+    else if (l > 32767) l = 32767;
+    if (r < -32768) r = -32768;
+    else if (r > 32767) r = 32767;
+
+    /* PCM output mixing level (0-100%) */
+    out_l[i] = (l * core_config.pcm_volume) / 100;
+    out_r[i] = (r * core_config.pcm_volume) / 100;
+  }
+}
+
+void pcm_run(unsigned int length)
+{
+#ifdef LOG_PCM
+  error("[%d][%d]run %d PCM samples (from %d)\n", v_counter, s68k.cycles, length, pcm.cycles);
+#endif
+
+  /* previous audio outputs */
+  int prev[2] = { pcm.out[0], pcm.out[1] };
+
+  /* check if PCM chip is running */
+  if (pcm.enabled)
+  {
+    s32 out_l[PCM_BLOCK_SIZE];
+    s32 out_r[PCM_BLOCK_SIZE];
+    unsigned int i;
+
+    /* generate PCM samples by blocks */
+    for (i=0; i<length; i+=PCM_BLOCK_SIZE)
+    {
+      int count = ((length - i) < PCM_BLOCK_SIZE) ? (length - i) : PCM_BLOCK_SIZE;
+
+      pcm_mix_block(out_l, out_r, count);
 
       /* update blip buffer */
-      snd.blips[1]->blip_add_delta_fast(i, l - prev_l, r - prev_r);
-      prev_l = l;
-      prev_r = r;
+      snd.blips[1]->blip_add_samples_fast(i, out_l, out_r, count, prev);
     }
 
     /* save last audio outputs */
-    pcm.out[0] = prev_l;
-    pcm.out[1] = prev_r;
+    pcm.out[0] = prev[0];
+    pcm.out[1] = prev[1];
   }
   else
   {
     /* check if PCM output was not muted */
-    if (prev_l | prev_r)
+    if (prev[0] | prev[1])
     {
-      snd.blips[1]->blip_add_delta_fast(0, -prev_l, -prev_r);
+      snd.blips[1]->blip_add_delta_fast(0, -prev[0], -prev[1]);
       pcm.out[0] = 0;
       pcm.out[1] = 0;
     }
@@ -424,16 +511,6 @@ void pcm_ram_dma_w(unsigned int length)
   cdc.dac.w += length;
 
   /* DMA transfer */
-  while (length--)
-  {
-    /* copy byte from CDC buffer to PCM RAM bank */
-    pcm.bank[dst_index] = cdc.ram[src_index];
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 1) & 0x3fff;
-
-    /* increment PCM-RAM destination address */
-    dst_index = (dst_index + 1) & 0xfff;
-  }
+  cdc_dma_copy_bytes(pcm.bank, dst_index, 0xfff, src_index, length);
 }
 
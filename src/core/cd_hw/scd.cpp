@@ -46,6 +46,7 @@
 #include "osd.h"
 #endif
 
+#include "core/backup_ram.h"
 #include "core/m68k/m68k.h"
 #include "core/system_clock.h"
 #include "core/system_cycle.h"
@@ -145,8 +146,6 @@ static unsigned int s68k_lockup_r_16 (unsigned int address)
 /*--------------------------------------------------------------------------*/
 void prg_ram_dma_w(unsigned int length)
 {
-  u16 data;
-
   /* 16-bit DMA only */
   unsigned int words = length >> 1;
 
@@ -162,21 +161,8 @@ void prg_ram_dma_w(unsigned int length)
   /* update DMA source address */
   cdc.dac.w += (words << 1);
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC RAM buffer (big-endian format) */
-    data = READ_WORD(cdc.ram, src_index);
-
-    /* write 16-bit word to PRG-RAM */
-    *(u16 *)(scd.prg_ram + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment PRG-RAM destination address */
-    dst_index = (dst_index + 2) & 0x7fffe;
-  }
+  /* DMA transfer (16-bit words from CDC RAM buffer in big-endian format) */
+  cdc_dma_copy_words(scd.prg_ram, dst_index, 0x7fffe, src_index, words);
 }
 
 /*--------------------------------------------------------------------------*/
@@ -447,12 +433,14 @@ static void bram_write_byte(unsigned int address, unsigned int data)
   if (address & 0x01)
   {
     scd.bram[(address >> 1) & 0x1fff] = data;
+    backup_ram_dirty |= BACKUP_RAM_SCD;
   }
 }
 
 static void bram_write_word(unsigned int address, unsigned int data)
 {
   scd.bram[(address >> 1) & 0x1fff] = data & 0xff;
+  backup_ram_dirty |= BACKUP_RAM_SCD;
 }
 
 /*--------------------------------------------------------------------------*/
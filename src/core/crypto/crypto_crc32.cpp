@@ -97,28 +97,59 @@ static const unsigned int crc_table[256] = {
   0x2d02ef8d
 };
 
+/* Slicing-by-8 tables: crc_slices[k][n] is the CRC of byte n followed by k null bytes */
+static unsigned int crc_slices[8][256];
+static int crc_slices_ready = 0;
+
 //==============================================================================
 
 //------------------------------------------------------------------------------
 
+static void crc_init_slices(void)
+{
+  int i, k;
+
+  for (i = 0; i < 256; i++) {
+    crc_slices[0][i] = crc_table[i];
+  }
+
+  for (k = 1; k < 8; k++) {
+    for (i = 0; i < 256; i++) {
+      unsigned int crc = crc_slices[k - 1][i];
+      crc_slices[k][i] = crc_table[crc & 0xff] ^ (crc >> 8);
+    }
+  }
+
+  crc_slices_ready = 1;
+}
+
+//------------------------------------------------------------------------------
+
 unsigned int crc32(unsigned int crc, const unsigned char* buffer, unsigned int len)
 {
   if (!buffer) {
     return 0;
   }
 
+  if (!crc_slices_ready) {
+    crc_init_slices();
+  }
+
   crc = crc ^ 0xffffffff;
 
+  /* 8 bytes per iteration, with one table lookup per byte */
   while (len >= 8) {
-    crc = crc_table[((int)crc ^ (*buffer++)) & 0xff] ^ (crc >> 8);
-    crc = crc_table[((int)crc ^ (*buffer++)) & 0xff] ^ (crc >> 8);
-    crc = crc_table[((int)crc ^ (*buffer++)) & 0xff] ^ (crc >> 8);
-    crc = crc_table[((int)crc ^ (*buffer++)) & 0xff] ^ (crc >> 8);
-    crc = crc_table[((int)crc ^ (*buffer++)) & 0xff] ^ (crc >> 8);
-    crc = crc_table[((int)crc ^ (*buffer++)) & 0xff] ^ (crc >> 8);
-    crc = crc_table[((int)crc ^ (*buffer++)) & 0xff] ^ (crc >> 8);
-    crc = crc_table[((int)crc ^ (*buffer++)) & 0xff] ^ (crc >> 8);
+    unsigned int lo = crc ^ ((unsigned int)buffer[0] | ((unsigned int)buffer[1] << 8) |
+                             ((unsigned int)buffer[2] << 16) | ((unsigned int)buffer[3] << 24));
+    unsigned int hi = (unsigned int)buffer[4] | ((unsigned int)buffer[5] << 8) |
+                      ((unsigned int)buffer[6] << 16) | ((unsigned int)buffer[7] << 24);
+
+    crc = crc_slices[7][lo & 0xff] ^ crc_slices[6][(lo >> 8) & 0xff] ^
+          crc_slices[5][(lo >> 16) & 0xff] ^ crc_slices[4][lo >> 24] ^
+          crc_slices[3][hi & 0xff] ^ crc_slices[2][(hi >> 8) & 0xff] ^
+          crc_slices[1][(hi >> 16) & 0xff] ^ crc_slices[0][hi >> 24];
 
+    buffer += 8;
     len -= 8;
   }
 
@@ -127,4 +158,4 @@ unsigned int crc32(unsigned int crc, const unsigned char* buffer, unsigned int l
   } while (--len);
 
   return crc ^ 0xffffffff;
-}
\ No newline at end of file
+}
@@ -62,6 +62,7 @@
 
 #include "core/cart_hw/hw_addon.h"
 #include "core/cart_hw/sms_cart.h" // For sms_cart_region_detect().
+#include "core/crypto/crypto_crc32.h"
 #include "core/cd_hw/scd.h" // For CD_TYPE_WONDERMEGA, CD_TYPE_WONDERMEGA_M2, CD_TYPE_CDX and CD_TYPE_DEFAULT.
 #include "core/cd_hw/cdd.h" // For cdd_load() and cdd_unload().
 
@@ -226,14 +227,17 @@ static const PERIPHERALINFO peripheralinfo[MAXPERIPHERALS] =
 static u16 getchecksum(u8 *rom, int length)
 {
   int i;
-  u16 checksum = 0;
+  u32 high = 0;
+  u32 low = 0;
 
+  /* high and low bytes of the 16-bit words are summed separately (vectorizable) */
   for (i = 0; i < length; i += 2)
   {
-    checksum += ((rom[i] << 8) + rom[i + 1]);
+    high += rom[i];
+    low += rom[i + 1];
   }
 
-  return checksum;
+  return (u16)((high << 8) + low);
 }
 
 
@@ -407,6 +411,23 @@ void getrominfo(char *romheader)
   }
 }
 
+/***************************************************************************
+ * getromcrc
+ *
+ * Return CRC32 of loaded ROM (computed once per loaded ROM).
+ *
+ ***************************************************************************/
+unsigned int getromcrc(void)
+{
+  if (!rominfo.crcready)
+  {
+    rominfo.crc = crc32(0, cart.rom, cart.romsize);
+    rominfo.crcready = 1;
+  }
+
+  return rominfo.crc;
+}
+
 /***************************************************************************
  * load_bios
  *
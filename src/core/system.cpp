@@ -46,6 +46,7 @@
 #include "osd.h" // For osd_input_update();
 #include "core/m68k/m68k.h"
 #include "core/audio_subsystem.h"
+#include "core/framebuffer.h"
 #include "core/core_config.h"
 #include "core/system_cycle.h"
 #include "core/system_hw.h"
@@ -69,6 +70,7 @@
 #include "gpgx/cpu/z80/z80_line_state.h"
 #include "gpgx/hid/input.h"
 #include "gpgx/g_audio_renderer.h"
+#include "gpgx/g_recorder.h"
 #include "gpgx/g_hid_system.h"
 #include "gpgx/g_z80.h"
 
@@ -96,6 +98,15 @@ void system_reset(void)
   audio_reset();
 }
 
+/* send rendered frame to the recorder (if any) */
+static void system_capture_frame(void)
+{
+  if (gpgx::g_recorder)
+  {
+    gpgx::g_recorder->PushVideoFrame(framebuffer.data, viewport.w + 2*viewport.x, viewport.h + 2*viewport.y, framebuffer.pitch, g_line_change_tracker->GetChangedLines());
+  }
+}
+
 void system_frame_gen(int do_skip)
 {
   /* line counters */
@@ -159,6 +170,9 @@ void system_frame_gen(int do_skip)
             g_sprite_layer_renderer = g_sprite_layer_renderer_m5;
           }
         }
+
+        /* update line renderer */
+        render_update_mode();
       }
     }
     else
@@ -454,6 +468,16 @@ void system_frame_gen(int do_skip)
   m68k.cycles -= mcycles_vdp;
   gpgx::g_z80->SubCycles(mcycles_vdp);
   dma_endCycles = 0;
+
+  /* wait for deferred line rendering */
+  render_flush();
+
+  /* publish changed lines & capture frame */
+  if (!do_skip)
+  {
+    render_end_frame();
+    system_capture_frame();
+  }
 }
 
 void system_frame_scd(int do_skip)
@@ -520,6 +544,9 @@ void system_frame_scd(int do_skip)
             g_sprite_layer_renderer = g_sprite_layer_renderer_m5;
           }
         }
+
+        /* update line renderer */
+        render_update_mode();
       }
     }
     else
@@ -800,6 +827,16 @@ void system_frame_scd(int do_skip)
   m68k.cycles -= mcycles_vdp;
   gpgx::g_z80->SubCycles(mcycles_vdp);
   dma_endCycles = 0;
+
+  /* wait for deferred line rendering */
+  render_flush();
+
+  /* publish changed lines & capture frame */
+  if (!do_skip)
+  {
+    render_end_frame();
+    system_capture_frame();
+  }
 }
 
 void system_frame_sms(int do_skip)
@@ -869,6 +906,9 @@ void system_frame_sms(int do_skip)
               g_sprite_layer_renderer = g_sprite_layer_renderer_m5;
             }
           }
+
+          /* update line renderer */
+          render_update_mode();
         }
       }
 
@@ -1224,4 +1264,14 @@ void system_frame_sms(int do_skip)
   /* adjust timings for next frame */
   input_end_frame(mcycles_vdp);
   gpgx::g_z80->SubCycles(mcycles_vdp);
+
+  /* wait for deferred line rendering */
+  render_flush();
+
+  /* publish changed lines & capture frame */
+  if (!do_skip)
+  {
+    render_end_frame();
+    system_capture_frame();
+  }
 }
@@ -71,18 +71,23 @@
 #include "core/hvc.h"
 
 #include "gpgx/g_z80.h"
+#include "gpgx/ppu/vdp/bg_pattern_dirty.h"
 #include "gpgx/vgs/vdp_irq_handler_z80.h"
 
-/* Mark a pattern as modified */
-#define MARK_BG_DIRTY(addr)                         \
-{                                                   \
-  name = (addr >> 5) & 0x7FF;                       \
-  if (bg_name_dirty[name] == 0)                     \
-  {                                                 \
-    bg_name_list[bg_list_index++] = name;           \
-  }                                                 \
-  bg_name_dirty[name] |= (1 << ((addr >> 2) & 7));  \
-}
+/* SSE2 is always available on x86-64 (MSVC does not define __SSE2__) */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define VDP_DMA_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Mark a pattern row as modified */
+#define MARK_BG_DIRTY(addr) gpgx::ppu::vdp::MarkPatternRowDirty(bg_dirty_rows, bg_dirty_summary, addr)
+
+/* Record a background layer state change during active display */
+#define MARK_RASTER_CHANGE(flags) (raster_changes |= ((v_counter < viewport.h) ? (flags) : 0))
+
+/* Registers used by background layer rendering (Mode 5): #1-#4, #11-#13, #16-#18 */
+#define RASTER_REG_MASK 0x0007381E
 
 /* VINT timings */
 #define VINT_H32_MCYCLE (770)
@@ -96,6 +101,7 @@
 
 /* VDP context */
 u8 ALIGNED_(4) sat[0x400];     /* Internal copy of sprite attribute table */
+u8 sat_dirty;                  /* 1= Internal SAT has been modified (sprite index) */
 u8 ALIGNED_(4) cram[0x80];     /* On-chip color RAM (64 x 9-bit) */
 u8 ALIGNED_(4) vsram[0x80];    /* On-chip vertical scroll RAM (40 x 11-bit) */
 u8 reg[0x20];                  /* Internal VDP registers (23 x 8-bit) */
@@ -112,9 +118,9 @@ u16 ntbb;                      /* Name table B base address */
 u16 ntwb;                      /* Name table W base address */
 u16 satb;                      /* Sprite attribute table base address */
 u16 hscb;                      /* Horizontal scroll table base address */
-u8 bg_name_dirty[0x800];       /* 1= This pattern is dirty */
-u16 bg_name_list[0x800];       /* List of modified pattern indices */
-u16 bg_list_index;             /* # of modified patterns in list */
+u64 bg_dirty_rows[0x100];      /* Modified pattern rows (1 bit per row, 8 rows per pattern) */
+u64 bg_dirty_summary[4];       /* Non-zero words of modified pattern rows */
+u8 raster_changes;             /* Background layer state modified during active display (RASTER_xxx flags) */
 u8 hscroll_mask;               /* Horizontal Scrolling line mask */
 u8 playfield_shift;            /* Width of planes A, B (in bits) */
 u8 playfield_col_mask;         /* Playfield column mask */
@@ -159,6 +165,11 @@ static void vdp_dma_68k_ram(unsigned int length);
 static void vdp_dma_68k_io(unsigned int length);
 static void vdp_dma_copy(unsigned int length);
 static void vdp_dma_fill(unsigned int length);
+static int vdp_dma_bulk(void);
+static void vdp_dma_vram_w(const u16 *src, unsigned int length);
+static void vdp_dma_vram_w_byte(unsigned int index, u8 data);
+static void vdp_dma_vram_dirty(unsigned int start, unsigned int end);
+static void vdp_dma_sat_update(unsigned int start, unsigned int end);
 
 /* Tables that define the playfield layout */
 static const u8 hscroll_mask_table[] = { 0x00, 0x07, 0xF8, 0xFF };
@@ -267,6 +278,7 @@ void vdp_reset(void)
   int i;
 
   xee::mem::Memset ((char *) sat, 0, sizeof (sat));
+  sat_dirty = 1;
   xee::mem::Memset ((char *) vram, 0, sizeof (vram));
   xee::mem::Memset ((char *) cram, 0, sizeof (cram));
   xee::mem::Memset ((char *) vsram, 0, sizeof (vsram));
@@ -307,9 +319,10 @@ void vdp_reset(void)
   sat_addr_mask       = 0x01FF;
 
   /* reset pattern cache changes */
-  bg_list_index = 0;
-  xee::mem::Memset ((char *) bg_name_dirty, 0, sizeof (bg_name_dirty));
-  xee::mem::Memset ((char *) bg_name_list, 0, sizeof (bg_name_list));
+  gpgx::ppu::vdp::ClearPatternsDirty(bg_dirty_rows, bg_dirty_summary);
+
+  /* reset raster effects */
+  raster_changes = 0;
 
   /* default Window clipping */
   window_clip(0,0);
@@ -462,6 +475,9 @@ void vdp_reset(void)
     g_color_palette_updater_mx->UpdateColor(i, 0x00);
   }
   g_color_palette_updater_mx->UpdateColor(0x40, 0x00);
+
+  /* update rendering mode */
+  render_update_mode();
 }
 
 int vdp_context_save(u8 *state)
@@ -497,6 +513,7 @@ int vdp_context_load(u8 *state)
   u8 temp_reg[0x20];
 
   load_param(sat, sizeof(sat));
+  sat_dirty = 1;
   load_param(vram, sizeof(vram));
   load_param(cram, sizeof(cram));
   load_param(vsram, sizeof(vsram));
@@ -562,7 +579,7 @@ int vdp_context_load(u8 *state)
   if (reg[1] & 0x04)
   {
     /* Mode 5 */
-    bg_list_index = 0x800;
+    gpgx::ppu::vdp::MarkPatternsDirty(bg_dirty_rows, bg_dirty_summary, 0x800);
 
     /* reinitialize palette */
     g_color_palette_updater_m5->UpdateColor(0, *(u16 *)&cram[border << 1]);
@@ -574,7 +591,7 @@ int vdp_context_load(u8 *state)
   else
   {
     /* Modes 0,1,2,3,4 */
-    bg_list_index = 0x200;
+    gpgx::ppu::vdp::MarkPatternsDirty(bg_dirty_rows, bg_dirty_summary, 0x200);
 
     /* reinitialize palette */
     for(i = 0; i < 0x20; i ++)
@@ -584,13 +601,6 @@ int vdp_context_load(u8 *state)
     g_color_palette_updater_mx->UpdateColor(0x40, *(u16 *)&cram[(0x10 | (border & 0x0F)) << 1]);
   }
 
-  /* invalidate tile cache */
-  for (i=0;i<bg_list_index;i++) 
-  {
-    bg_name_list[i]=i;
-    bg_name_dirty[i]=0xFF;
-  }
-
   return bufferptr;
 }
 
@@ -1107,7 +1117,7 @@ void vdp_sms_ctrl_w(unsigned int data)
             g_sprite_layer_renderer = g_sprite_layer_renderer_m4;
 
             /* force BG cache update*/
-            bg_list_index = 0x200;
+            gpgx::ppu::vdp::MarkPatternsDirty(bg_dirty_rows, bg_dirty_summary, 0x200);
           }
           else
           {
@@ -1116,7 +1126,7 @@ void vdp_sms_ctrl_w(unsigned int data)
             g_sprite_layer_renderer = g_sprite_layer_renderer_tms;
 
             /* BG cache is not used */
-            bg_list_index = 0;
+            gpgx::ppu::vdp::ClearPatternsDirty(bg_dirty_rows, bg_dirty_summary);
           }
 
           /* reinitialize palette */
@@ -1520,6 +1530,12 @@ static void vdp_reg_w(unsigned int r, unsigned int d, unsigned int cycles)
     return;
   }
 
+  /* Background layer register modified during active display */
+  if ((r < 0x20) && ((RASTER_REG_MASK >> r) & 1) && (d != reg[r]))
+  {
+    MARK_RASTER_CHANGE(RASTER_REG);
+  }
+
   switch(r)
   {
     case 0: /* CTRL #1 */
@@ -1794,8 +1810,8 @@ static void vdp_reg_w(unsigned int r, unsigned int d, unsigned int cycles)
               hvc_latch = vdp_hvc_r(cycles) | 0x10000;
             }
 
-            /* max tiles to invalidate */
-            bg_list_index = 0x800;
+            /* Invalidate pattern cache */
+            gpgx::ppu::vdp::MarkPatternsDirty(bg_dirty_rows, bg_dirty_summary, 0x800);
           }
           else
           {
@@ -1821,16 +1837,12 @@ static void vdp_reg_w(unsigned int r, unsigned int d, unsigned int cycles)
             /* Latch current HVC */
             hvc_latch = vdp_hvc_r(cycles) | 0x10000;
 
-            /* max tiles to invalidate */
-            bg_list_index = 0x200;
+            /* Invalidate pattern cache */
+            gpgx::ppu::vdp::MarkPatternsDirty(bg_dirty_rows, bg_dirty_summary, 0x200);
           }
 
-          /* Invalidate pattern cache */
-          for (i=0;i<bg_list_index;i++) 
-          {
-            bg_name_list[i] = i;
-            bg_name_dirty[i] = 0xFF;
-          }
+          /* Update rendering mode */
+          render_update_mode();
 
           /* Update vertical counter max value */
           vc_max = vc_table[(d >> 2) & 3][vdp_pal];
@@ -1992,6 +2004,9 @@ static void vdp_reg_w(unsigned int r, unsigned int d, unsigned int cycles)
           g_bg_layer_renderer = g_bg_layer_renderer_m5;
         }
       }
+
+      /* Update rendering mode */
+      render_update_mode();
       break;
     }
 
@@ -2029,6 +2044,9 @@ static void vdp_reg_w(unsigned int r, unsigned int d, unsigned int cycles)
             g_sprite_layer_renderer = g_sprite_layer_renderer_m5;
           }
         }
+
+        /* Update rendering mode */
+        render_update_mode();
       }
 
       /* Interlaced modes */
@@ -2190,18 +2208,18 @@ static void vdp_bus_w(unsigned int data)
       {
         /* Update internal SAT */
         *(u16 *) &sat[index & sat_addr_mask] = data;
+        sat_dirty = 1;
       }
 
       /* Only write unique data to VRAM */
       if (data != *p)
       {
-        int name;
-
         /* Write data to VRAM */
         *p = data;
 
         /* Update pattern cache */
         MARK_BG_DIRTY (index);
+        MARK_RASTER_CHANGE(RASTER_VRAM);
       }
 
 #ifdef HOOK_CPU
@@ -2267,6 +2285,7 @@ static void vdp_bus_w(unsigned int data)
     case 0x05:  /* VSRAM */
     {
       *(u16 *)&vsram[addr & 0x7E] = data;
+      MARK_RASTER_CHANGE(RASTER_VSRAM);
 
       /* 2-cell Vscroll mode */
       if (reg[11] & 0x04)
@@ -2388,8 +2407,6 @@ static void vdp_68k_data_w_m4(unsigned int data)
     /* Only write unique data to VRAM */
     if (data != *p)
     {
-      int name;
-
       /* Write data to VRAM */
       *p = data;
 
@@ -2631,8 +2648,6 @@ static void vdp_z80_data_w_m4(unsigned int data)
     /* Only write unique data to VRAM */
     if (data != vram[index])
     {
-      int name;
-
       /* Write data */
       vram[index] = data;
 
@@ -2667,18 +2682,18 @@ static void vdp_z80_data_w_m5(unsigned int data)
       {
         /* Update internal SAT */
         WRITE_BYTE(sat, index & sat_addr_mask, data);
+        sat_dirty = 1;
       }
 
       /* Only write unique data to VRAM */
       if (data != READ_BYTE(vram, index))
       {
-        int name;
-
         /* Write data */
         WRITE_BYTE(vram, index, data);
 
         /* Update pattern cache */
         MARK_BG_DIRTY (index);
+        MARK_RASTER_CHANGE(RASTER_VRAM);
       }
       break;
     }
@@ -2729,6 +2744,7 @@ static void vdp_z80_data_w_m5(unsigned int data)
     {
       /* Write low byte to even address & high byte to odd address */
       WRITE_BYTE(vsram, (addr & 0x7F) ^ 1, data);
+      MARK_RASTER_CHANGE(RASTER_VSRAM);
       break;
     }
   }
@@ -2861,7 +2877,6 @@ static void vdp_z80_data_w_ms(unsigned int data)
     /* VRAM write */
     if (data != vram[index])
     {
-      int name;
       vram[index] = data;
       MARK_BG_DIRTY(index);
     }
@@ -2937,7 +2952,6 @@ static void vdp_z80_data_w_gg(unsigned int data)
     /* VRAM write */
     if (data != vram[index])
     {
-      int name;
       vram[index] = data;
       MARK_BG_DIRTY(index);
     }
@@ -3010,6 +3024,208 @@ static void vdp_z80_data_w_sg(unsigned int data)
 #endif
 }
 
+/*--------------------------------------------------------------------------*/
+/* Bulk DMA to VRAM (Mega Drive VDP only)                                   */
+/*--------------------------------------------------------------------------*/
+
+/* Check if DMA can be processed by blocks instead of single accesses */
+static int vdp_dma_bulk(void)
+{
+#ifdef LOGVDP
+  return 0;
+#else
+#ifdef HOOK_CPU
+  /* VRAM accesses are reported one by one */
+  if (cpu_hook)
+  {
+    return 0;
+  }
+#endif
+
+  return 1;
+#endif
+}
+
+/* Write a block of words to VRAM (address register is even, incremented by 2 and does not wrap) */
+static void vdp_dma_vram_w(const u16 *src, unsigned int length)
+{
+  unsigned int i;
+
+  /* VRAM destination range */
+  unsigned int start = addr;
+  unsigned int end = start + (length << 1);
+  unsigned int index = start;
+
+  /* Words until next pattern boundary */
+  while ((index & 0x1F) && (index < end))
+  {
+    u16 *p = (u16 *)&vram[index];
+
+    /* Only write unique data to VRAM */
+    if (*src != *p)
+    {
+      *p = *src;
+      MARK_BG_DIRTY(index);
+      MARK_RASTER_CHANGE(RASTER_VRAM);
+    }
+
+    src++;
+    index += 2;
+  }
+
+  /* Whole patterns (8 rows of 4 bytes) */
+  while ((index + 32) <= end)
+  {
+    u8 *p = &vram[index];
+
+    /* Modified pattern rows */
+    int rows;
+
+#ifdef VDP_DMA_SSE2
+    __m128i a0 = _mm_loadu_si128((const __m128i *)src);
+    __m128i a1 = _mm_loadu_si128((const __m128i *)(src + 8));
+    __m128i b0 = _mm_loadu_si128((const __m128i *)p);
+    __m128i b1 = _mm_loadu_si128((const __m128i *)(p + 16));
+
+    rows = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a0, b0)));
+    rows |= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a1, b1))) << 4;
+    rows ^= 0xFF;
+
+    if (rows)
+    {
+      _mm_storeu_si128((__m128i *)p, a0);
+      _mm_storeu_si128((__m128i *)(p + 16), a1);
+    }
+#else
+    rows = 0;
+
+    for (i = 0; i < 8; i++)
+    {
+      if (*(const u32 *)(src + (i << 1)) != *(u32 *)(p + (i << 2)))
+      {
+        rows |= (1 << i);
+      }
+    }
+
+    if (rows)
+    {
+      xee::mem::Memcpy(p, src, 32);
+    }
+#endif
+
+    /* Update pattern cache */
+    if (rows)
+    {
+      gpgx::ppu::vdp::MarkPatternDirty(bg_dirty_rows, bg_dirty_summary, index >> 5, rows);
+      MARK_RASTER_CHANGE(RASTER_VRAM);
+    }
+
+    src += 16;
+    index += 32;
+  }
+
+  /* Remaining words */
+  while (index < end)
+  {
+    u16 *p = (u16 *)&vram[index];
+
+    /* Only write unique data to VRAM */
+    if (*src != *p)
+    {
+      *p = *src;
+      MARK_BG_DIRTY(index);
+      MARK_RASTER_CHANGE(RASTER_VRAM);
+    }
+
+    src++;
+    index += 2;
+  }
+
+  /* Update internal SAT */
+  vdp_dma_sat_update(start, end);
+
+  /* Last written words remain in FIFO */
+  i = (length < 4) ? length : 4;
+  src -= i;
+  fifo_idx = (fifo_idx + length - i) & 3;
+  for (; i > 0; i--)
+  {
+    fifo[fifo_idx] = *src++;
+    fifo_idx = (fifo_idx + 1) & 3;
+  }
+
+  /* Update address register */
+  addr = end;
+}
+
+/* Write a single byte to VRAM (DMA Fill & Copy) */
+static void vdp_dma_vram_w_byte(unsigned int index, u8 data)
+{
+  /* Intercept writes to Sprite Attribute Table */
+  if ((index & sat_base_mask) == satb)
+  {
+    /* Update internal SAT */
+    WRITE_BYTE(sat, (index & sat_addr_mask) ^ 1, data);
+    sat_dirty = 1;
+  }
+
+  /* Write byte to adjacent VRAM address */
+  WRITE_BYTE(vram, index ^ 1, data);
+
+  /* Update pattern cache */
+  MARK_BG_DIRTY(index);
+  MARK_RASTER_CHANGE(RASTER_VRAM);
+}
+
+/* Mark all pattern rows of a VRAM range as modified */
+static void vdp_dma_vram_dirty(unsigned int start, unsigned int end)
+{
+  /* First and last modified rows (one bit per row) */
+  unsigned int row = start >> 2;
+  unsigned int last = (end - 1) >> 2;
+
+  MARK_RASTER_CHANGE(RASTER_VRAM);
+
+  while (row <= last)
+  {
+    /* Rows within the same 64-bit word */
+    unsigned int shift = row & 0x3F;
+    unsigned int count = 64 - shift;
+    if (count > (last - row + 1))
+    {
+      count = last - row + 1;
+    }
+
+    bg_dirty_rows[row >> 6] |= ((count < 64) ? (((u64)1 << count) - 1) : ~(u64)0) << shift;
+    bg_dirty_summary[row >> 12] |= (u64)1 << ((row >> 6) & 0x3F);
+
+    row += count;
+  }
+}
+
+/* Copy an even-aligned VRAM range to internal SAT if it overlaps the Sprite Attribute Table */
+static void vdp_dma_sat_update(unsigned int start, unsigned int end)
+{
+  unsigned int sat_start = satb;
+  unsigned int sat_end = satb + sat_addr_mask + 1;
+
+  if (start > sat_start)
+  {
+    sat_start = start;
+  }
+
+  if (end < sat_end)
+  {
+    sat_end = end;
+  }
+
+  if (sat_start < sat_end)
+  {
+    xee::mem::Memcpy(&sat[sat_start & sat_addr_mask], &vram[sat_start], sat_end - sat_start);
+    sat_dirty = 1;
+  }
+}
+
 /*--------------------------------------------------------------------------*/
 /* DMA operations (Mega Drive VDP only)                                     */
 /*--------------------------------------------------------------------------*/
@@ -3022,8 +3238,35 @@ static void vdp_dma_68k_ext(unsigned int length)
   /* 68k bus source address */
   u32 source = (reg[23] << 17) | (dma_src << 1);
 
+  /* Bulk transfer to VRAM */
+  int bulk = vdp_dma_bulk() && ((code & 0x0F) == 0x01) && (reg[15] == 2) && !(addr & 1);
+
   do
   {
+    /* Memory-mapped source area */
+    if (bulk && !m68k.memory_map[source>>16].read16)
+    {
+      /* Words until end of source area, end of VRAM or end of DMA */
+      unsigned int count = (0x10000 - (source & 0xFFFF)) >> 1;
+      if (count > ((0x10000 - addr) >> 1))
+      {
+        count = (0x10000 - addr) >> 1;
+      }
+      if (count > length)
+      {
+        count = length;
+      }
+
+      /* Write data words to VRAM */
+      vdp_dma_vram_w((u16 *)(m68k.memory_map[source>>16].base + (source & 0xFFFF)), count);
+
+      /* Increment source address (128k DMA window) */
+      source = (reg[23] << 17) | ((source + (count << 1)) & 0x1FFFF);
+
+      length -= count;
+      continue;
+    }
+
     /* Read data word from 68k bus */
     if (m68k.memory_map[source>>16].read16)
     {
@@ -3042,8 +3285,10 @@ static void vdp_dma_68k_ext(unsigned int length)
 
     /* Write data word to VRAM, CRAM or VSRAM */
     vdp_bus_w(data);
+
+    length--;
   }
-  while (--length);
+  while (length);
 
   /* Update DMA source address */
   dma_src = (source >> 1) & 0xffff;
@@ -3057,6 +3302,37 @@ static void vdp_dma_68k_ram(unsigned int length)
   /* 68k bus source address */
   u32 source = (reg[23] << 17) | (dma_src << 1);
 
+  /* Bulk transfer to VRAM */
+  if (vdp_dma_bulk() && ((code & 0x0F) == 0x01) && (reg[15] == 2) && !(addr & 1))
+  {
+    do
+    {
+      /* Words until end of Work-RAM, end of VRAM or end of DMA */
+      unsigned int count = (0x10000 - (source & 0xFFFF)) >> 1;
+      if (count > ((0x10000 - addr) >> 1))
+      {
+        count = (0x10000 - addr) >> 1;
+      }
+      if (count > length)
+      {
+        count = length;
+      }
+
+      /* Write data words to VRAM */
+      vdp_dma_vram_w((u16 *)(work_ram + (source & 0xFFFF)), count);
+
+      /* Increment source address (128k DMA window) */
+      source = (reg[23] << 17) | ((source + (count << 1)) & 0x1FFFF);
+
+      length -= count;
+    }
+    while (length);
+
+    /* Update DMA source address */
+    dma_src = (source >> 1) & 0xffff;
+    return;
+  }
+
   do
   {
     /* access Work-RAM by default  */
@@ -3131,12 +3407,84 @@ static void vdp_dma_copy(unsigned int length)
   /* CD4 should be set (CD0-CD3 ignored) otherwise VDP locks (hard reset needed) */
   if (code & 0x10)
   {
-    int name;
     u8 data;
     
     /* VRAM source address */
     u16 source = dma_src;
 
+    /* Bulk copy (address register incremented by 1) */
+    if (vdp_dma_bulk() && (reg[15] == 1))
+    {
+      do
+      {
+        /* Bytes until end of VRAM (source or destination) or end of DMA */
+        unsigned int count = 0x10000 - addr;
+        if (count > (0x10000u - source))
+        {
+          count = 0x10000 - source;
+        }
+        if (count > length)
+        {
+          count = length;
+        }
+
+        /* Same byte alignment and no forward overlap (repeated source data) */
+        if (!((source ^ addr) & 1) && ((addr <= source) || (addr >= (source + count))))
+        {
+          unsigned int start = addr;
+          unsigned int end = addr + count;
+
+          /* Odd first byte */
+          if (start & 1)
+          {
+            vdp_dma_vram_w_byte(start, READ_BYTE(vram, source ^ 1));
+            source++;
+            start++;
+          }
+
+          /* Odd last byte (copied last) */
+          if ((end & 1) && (end > start))
+          {
+            end--;
+          }
+
+          /* Copy whole words */
+          if (end > start)
+          {
+            xee::mem::Memmove(&vram[start], &vram[source], end - start);
+            vdp_dma_vram_dirty(start, end);
+            vdp_dma_sat_update(start, end);
+            source += end - start;
+          }
+
+          if (end < (addr + count))
+          {
+            vdp_dma_vram_w_byte(end, READ_BYTE(vram, source ^ 1));
+            source++;
+          }
+        }
+        else
+        {
+          unsigned int i;
+
+          for (i = 0; i < count; i++)
+          {
+            vdp_dma_vram_w_byte((addr + i) & 0xFFFF, READ_BYTE(vram, source ^ 1));
+            source++;
+          }
+        }
+
+        /* Increment VRAM destination address */
+        addr += count;
+        length -= count;
+      }
+      while (length);
+
+      /* Update DMA source address */
+      dma_src = source;
+      return;
+    }
+
     do
     {
       /* Read byte from adjacent VRAM source address */
@@ -3147,6 +3495,7 @@ static void vdp_dma_copy(unsigned int length)
       {
         /* Update internal SAT */
         WRITE_BYTE(sat, (addr & sat_addr_mask) ^ 1, data);
+        sat_dirty = 1;
       }
 
       /* Write byte to adjacent VRAM destination address */
@@ -3154,6 +3503,7 @@ static void vdp_dma_copy(unsigned int length)
 
       /* Update pattern cache */
       MARK_BG_DIRTY(addr);
+      MARK_RASTER_CHANGE(RASTER_VRAM);
 
       /* Increment VRAM source address */
       source++;
@@ -3176,11 +3526,52 @@ static void vdp_dma_fill(unsigned int length)
   {
     case 0x01:  /* VRAM */
     {
-      int name;
-
       /* Get source data from last written FIFO entry */
       u8 data = fifo[(fifo_idx+3)&3] >> 8;
 
+      /* Bulk fill (address register incremented by 1) */
+      if (vdp_dma_bulk() && (reg[15] == 1))
+      {
+        do
+        {
+          /* Bytes until end of VRAM or end of DMA */
+          unsigned int count = 0x10000 - addr;
+          if (count > length)
+          {
+            count = length;
+          }
+
+          unsigned int start = addr;
+          unsigned int end = addr + count;
+
+          /* Odd first byte */
+          if (start & 1)
+          {
+            vdp_dma_vram_w_byte(start++, data);
+          }
+
+          /* Odd last byte */
+          if ((end & 1) && (end > start))
+          {
+            vdp_dma_vram_w_byte(--end, data);
+          }
+
+          /* Fill whole words */
+          if (end > start)
+          {
+            xee::mem::Memset(&vram[start], data, end - start);
+            vdp_dma_vram_dirty(start, end);
+            vdp_dma_sat_update(start, end);
+          }
+
+          /* Increment VRAM address */
+          addr += count;
+          length -= count;
+        }
+        while (length);
+        break;
+      }
+
       do
       {
         /* Intercept writes to Sprite Attribute Table */
@@ -3188,6 +3579,7 @@ static void vdp_dma_fill(unsigned int length)
         {
           /* Update internal SAT */
           WRITE_BYTE(sat, (addr & sat_addr_mask) ^ 1, data);
+          sat_dirty = 1;
         }
 
         /* Write byte to adjacent VRAM address */
@@ -3195,6 +3587,7 @@ static void vdp_dma_fill(unsigned int length)
 
         /* Update pattern cache */
         MARK_BG_DIRTY (addr);
+        MARK_RASTER_CHANGE(RASTER_VRAM);
 
         /* Increment VRAM address */
         addr += reg[15];
@@ -3251,6 +3644,8 @@ static void vdp_dma_fill(unsigned int length)
       /* Get source data from next available FIFO entry */
       u16 data = fifo[fifo_idx];
 
+      MARK_RASTER_CHANGE(RASTER_VSRAM);
+
       do
       {
         /* Write VSRAM data */
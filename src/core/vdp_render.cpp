@@ -60,7 +60,9 @@
 #include "core/vdp/object_info_t.h"
 #include "core/vdp/pixel.h"
 
+#include "gpgx/ppu/vdp/bg_pattern_dirty.h"
 #include "gpgx/ppu/vdp/inv_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/lut.h"
 #include "gpgx/ppu/vdp/m0_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m1_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m1x_bg_layer_renderer.h"
@@ -76,11 +78,15 @@
 #include "gpgx/ppu/vdp/m5_bg_column_drawer.h"
 #include "gpgx/ppu/vdp/m5_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_bg_pattern_cache_updater.h"
+#include "gpgx/ppu/vdp/m5_deferred_line_renderer.h"
+#include "gpgx/ppu/vdp/m5_frame_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_im2_bg_column_drawer.h"
 #include "gpgx/ppu/vdp/m5_im2_bg_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_im2_sprite_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_im2_ste_sprite_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_im2_vs_bg_layer_renderer.h"
+#include "gpgx/ppu/vdp/m5_line_renderer.h"
+#include "gpgx/ppu/vdp/m5_pattern_cache.h"
 #include "gpgx/ppu/vdp/m5_satb_parser.h"
 #include "gpgx/ppu/vdp/m5_sprite_layer_renderer.h"
 #include "gpgx/ppu/vdp/m5_sprite_tile_drawer.h"
@@ -95,8 +101,8 @@
 #endif
 
 /* Pixel priority look-up tables information */
-#define LUT_MAX     (6)
-#define LUT_SIZE    (0x10000)
+#define LUT_MAX     (gpgx::ppu::vdp::kLayerPriorityLutCount)
+#define LUT_SIZE    (gpgx::ppu::vdp::kLayerPriorityLutSize)
 
 /// Clipping:
 /// - clip[0] = Plane A clipping,
@@ -117,7 +123,7 @@ static const u32 atex_table[] =
 };
 
 /* Cached and flipped patterns */
-static u8 ALIGNED_(4) bg_pattern_cache[0x80000];
+static u8 ALIGNED_(4) bg_pattern_cache[gpgx::ppu::vdp::kPatternCacheSize];
 
 /* Sprite pattern name offset look-up table (Mode 5) */
 static u8 name_lut[0x400];
@@ -151,6 +157,24 @@ static u8 object_count[2];
 /* Sprite Collision Info */
 u16 spr_col;
 
+/* 1 = Mode 5 line renderer is used */
+static u8 render_m5;
+
+/* 1 = Lines are recorded for the deferred line renderer (Mode 5) */
+static u8 render_deferred;
+
+/* 1 = Background layers of the current frame are rendered by frame (Mode 5) */
+static u8 render_frame;
+
+/* Hash of the output pixel data look-up table (see remap_line) */
+static u64 palette_hash;
+
+/* Number of color updates when palette_hash was computed */
+static u32 palette_version;
+
+/* 1 = palette_hash is up to date with palette_version */
+static u8 palette_hash_valid;
+
 static gpgx::ppu::vdp::M5BackgroundColumnDrawer* g_bg_column_drawer_m5 = nullptr;
 static gpgx::ppu::vdp::M5Im2BackgroundColumnDrawer* g_bg_column_drawer_m5_im2 = nullptr;
 
@@ -181,6 +205,11 @@ gpgx::ppu::vdp::M5SteSpriteLayerRenderer* g_sprite_layer_renderer_m5_ste = nullp
 gpgx::ppu::vdp::M5Im2SpriteLayerRenderer* g_sprite_layer_renderer_m5_im2 = nullptr;
 gpgx::ppu::vdp::M5Im2SteSpriteLayerRenderer* g_sprite_layer_renderer_m5_im2_ste = nullptr;
 
+gpgx::ppu::vdp::M5LineRenderer* g_line_renderer_m5 = nullptr;
+gpgx::ppu::vdp::M5DeferredLineRenderer* g_deferred_line_renderer_m5 = nullptr;
+gpgx::ppu::vdp::M5FrameBackgroundLayerRenderer* g_frame_bg_layer_renderer_m5 = nullptr;
+gpgx::ppu::vdp::LineChangeTracker* g_line_change_tracker = nullptr;
+
 gpgx::ppu::vdp::ISpriteAttributeTableParser* g_satb_parser = nullptr;
 gpgx::ppu::vdp::TmsSpriteAttributeTableParser* g_satb_parser_tms = nullptr;
 gpgx::ppu::vdp::M4SpriteAttributeTableParser* g_satb_parser_m4 = nullptr;
@@ -561,6 +590,105 @@ static void sprite_layer_rendering_init()
   }
 }
 
+/// Initialize line rendering.
+static void line_rendering_init()
+{
+  // Initialize line renderer in mode 5.
+  if (!g_line_renderer_m5) {
+    g_line_renderer_m5 = new gpgx::ppu::vdp::M5LineRenderer(
+      g_bg_layer_renderer_m5,
+      g_bg_layer_renderer_m5_vs,
+      g_bg_layer_renderer_m5_im2,
+      g_bg_layer_renderer_m5_im2_vs,
+
+      g_sprite_layer_renderer_m5,
+      g_sprite_layer_renderer_m5_ste,
+      g_sprite_layer_renderer_m5_im2,
+      g_sprite_layer_renderer_m5_im2_ste
+    );
+  }
+
+  // Initialize renderer of background layer in mode 5 by frame.
+  if (!g_frame_bg_layer_renderer_m5) {
+    g_frame_bg_layer_renderer_m5 = new gpgx::ppu::vdp::M5FrameBackgroundLayerRenderer(
+      reg,
+      vram,
+      vsram,
+
+      &playfield_shift,
+      &playfield_col_mask,
+      &playfield_row_mask,
+
+      &hscb,
+      &hscroll_mask,
+
+      &ntab,
+      &ntbb,
+      &ntwb,
+
+      linebuf[0],
+
+      lut[0],
+      lut[2],
+
+      &clip[0],
+      &clip[1],
+
+      &viewport,
+      g_bg_column_drawer_m5
+    );
+  }
+
+  // Initialize tracker of changed framebuffer lines.
+  if (!g_line_change_tracker) {
+    g_line_change_tracker = new gpgx::ppu::vdp::LineChangeTracker();
+  }
+
+  // Initialize deferred line renderer in mode 5 (optional).
+  if (!g_deferred_line_renderer_m5 && core_config.render_threads) {
+    g_deferred_line_renderer_m5 = new gpgx::ppu::vdp::M5DeferredLineRenderer(
+      reg,
+      vram,
+      vsram,
+      pixel,
+
+      &ntab,
+      &ntbb,
+      &ntwb,
+      &hscb,
+
+      &playfield_shift,
+      &playfield_col_mask,
+      &playfield_row_mask,
+      &hscroll_mask,
+
+      &odd_frame,
+      &im2_flag,
+      &max_sprite_pixels,
+      &lines_per_frame,
+
+      clip,
+      &viewport,
+
+      obj_info,
+      object_count,
+      &status,
+      &spr_ovr,
+
+      bg_dirty_rows,
+      bg_dirty_summary,
+
+      lut,
+      name_lut,
+      atex_table,
+      g_line_change_tracker,
+      &framebuffer
+    );
+
+    g_deferred_line_renderer_m5->Start(core_config.render_threads);
+  }
+}
+
 /// Initialize sprite attribute table parsing.
 static void sprite_attribute_table_parsing_init()
 {
@@ -598,6 +726,7 @@ static void sprite_attribute_table_parsing_init()
       obj_info,
       object_count,
       sat,
+      &sat_dirty,
       &satb,
       &im2_flag,
       &max_sprite_pixels,
@@ -613,8 +742,8 @@ static void background_pattern_cache_updating_init()
   if (!g_bg_pattern_cache_updater_m4) {
     g_bg_pattern_cache_updater_m4 = new gpgx::ppu::vdp::M4BackgroundPatternCacheUpdater(
       bg_pattern_cache,
-      bg_name_list,
-      bg_name_dirty,
+      bg_dirty_rows,
+      bg_dirty_summary,
       vram,
       bp_lut
     );
@@ -624,52 +753,13 @@ static void background_pattern_cache_updating_init()
   if (!g_bg_pattern_cache_updater_m5) {
     g_bg_pattern_cache_updater_m5 = new gpgx::ppu::vdp::M5BackgroundPatternCacheUpdater(
       bg_pattern_cache,
-      bg_name_list,
-      bg_name_dirty,
+      bg_dirty_rows,
+      bg_dirty_summary,
       vram
     );
   }
 }
 
-/*--------------------------------------------------------------------------*/
-/* Sprite pattern name offset look-up table function (Mode 5)               */
-/*--------------------------------------------------------------------------*/
-
-static void make_name_lut(void)
-{
-  int vcol, vrow;
-  int width, height;
-  int flipx, flipy;
-  int i;
-
-  for (i = 0; i < 0x400; i += 1)
-  {
-    /* Sprite settings */
-    vcol = i & 3;
-    vrow = (i >> 2) & 3;
-    height = (i >> 4) & 3;
-    width  = (i >> 6) & 3;
-    flipx  = (i >> 8) & 1;
-    flipy  = (i >> 9) & 1;
-
-    if ((vrow > height) || vcol > width)
-    {
-      /* Invalid settings (unused) */
-      name_lut[i] = -1;
-    }
-    else
-    {
-      /* Adjust column & row index if sprite is flipped */
-      if(flipx) vcol = (width - vcol);
-      if(flipy) vrow = (height - vrow);
-
-      /* Pattern offset (pattern order is up->down->left->right) */
-      name_lut[i] = vrow + (vcol * (height + 1));
-    }
-  }
-}
-
-
 /*--------------------------------------------------------------------------*/
 /* Bitplane to packed pixel look-up table function (Mode 4)                 */
 /*--------------------------------------------------------------------------*/
@@ -714,263 +804,6 @@ static void make_bp_lut(void)
 }
 
 
-/*--------------------------------------------------------------------------*/
-/* Layers priority pixel look-up tables functions                           */
-/*--------------------------------------------------------------------------*/
-
-/* Input (bx):  d5-d0=color, d6=priority, d7=unused */
-/* Input (ax):  d5-d0=color, d6=priority, d7=unused */
-/* Output:    d5-d0=color, d6=priority, d7=zero */
-static u32 make_lut_bg(u32 bx, u32 ax)
-{
-  int bf = (bx & 0x7F);
-  int bp = (bx & 0x40);
-  int b  = (bx & 0x0F);
-
-  int af = (ax & 0x7F);
-  int ap = (ax & 0x40);
-  int a  = (ax & 0x0F);
-
-  int c = (ap ? (a ? af : bf) : (bp ? (b ? bf : af) : (a ? af : bf)));
-
-  /* Strip palette & priority bits from transparent pixels */
-  if((c & 0x0F) == 0x00) c &= 0x80;
-
-  return (c);
-}
-
-/* Input (bx):  d5-d0=color, d6=priority, d7=unused */
-/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
-/* Output:    d5-d0=color, d6=priority, d7=intensity select (0=half/1=normal) */
-static u32 make_lut_bg_ste(u32 bx, u32 ax)
-{
-  int bf = (bx & 0x7F);
-  int bp = (bx & 0x40);
-  int b  = (bx & 0x0F);
-
-  int af = (ax & 0x7F);
-  int ap = (ax & 0x40);
-  int a  = (ax & 0x0F);
-
-  int c = (ap ? (a ? af : bf) : (bp ? (b ? bf : af) : (a ? af : bf)));
-
-  /* Half intensity when both pixels are low priority */
-  c |= ((ap | bp) << 1);
-
-  /* Strip palette & priority bits from transparent pixels */
-  if((c & 0x0F) == 0x00) c &= 0x80;
-
-  return (c);
-}
-
-/* Input (bx):  d5-d0=color, d6=priority/1, d7=sprite pixel marker */
-/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
-/* Output:    d5-d0=color, d6=priority, d7=sprite pixel marker */
-static u32 make_lut_obj(u32 bx, u32 sx)
-{
-  int c;
-
-  int bf = (bx & 0x7F);
-  int bs = (bx & 0x80);
-  int sf = (sx & 0x7F);
-
-  if((sx & 0x0F) == 0) return bx;
-
-  c = (bs ? bf : sf);
-
-  /* Strip palette bits from transparent pixels */
-  if((c & 0x0F) == 0x00) c &= 0xC0;
-
-  return (c | 0x80);
-}
-
-
-/* Input (bx):  d5-d0=color, d6=priority, d7=opaque sprite pixel marker */
-/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
-/* Output:    d5-d0=color, d6=zero/priority, d7=opaque sprite pixel marker */
-static u32 make_lut_bgobj(u32 bx, u32 sx)
-{
-  int c;
-
-  int bf = (bx & 0x3F);
-  int bs = (bx & 0x80);
-  int bp = (bx & 0x40);
-  int b  = (bx & 0x0F);
-
-  int sf = (sx & 0x3F);
-  int sp = (sx & 0x40);
-  int s  = (sx & 0x0F);
-
-  if(s == 0) return bx;
-
-  /* Previous sprite has higher priority */
-  if(bs) return bx;
-
-  c = (sp ? sf : (bp ? (b ? bf : sf) : sf));
-
-  /* Strip palette & priority bits from transparent pixels */
-  if((c & 0x0F) == 0x00) c &= 0x80;
-
-  return (c | 0x80);
-}
-
-/* Input (bx):  d5-d0=color, d6=priority, d7=intensity (half/normal) */
-/* Input (sx):  d5-d0=color, d6=priority, d7=sprite marker */
-/* Output:    d5-d0=color, d6=intensity (half/normal), d7=(double/invalid) */
-static u32 make_lut_bgobj_ste(u32 bx, u32 sx)
-{
-  int c;
-
-  int bf = (bx & 0x3F);
-  int bp = (bx & 0x40);
-  int b  = (bx & 0x0F);
-  int bi = (bx & 0x80) >> 1;
-
-  int sf = (sx & 0x3F);
-  int sp = (sx & 0x40);
-  int s  = (sx & 0x0F);
-  int si = sp | bi;
-
-  if(sp)
-  {
-    if(s)
-    {
-      if((sf & 0x3E) == 0x3E)
-      {
-        if(sf & 1)
-        {
-          c = (bf | 0x00);
-        }
-        else
-        {
-          c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
-        }
-      }
-      else
-      {
-        if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
-        {
-          c = (sf | 0x40);
-        }
-        else
-        {
-          c = (sf | si);
-        }
-      }
-    }
-    else
-    {
-      c = (bf | bi);
-    }
-  }
-  else
-  {
-    if(bp)
-    {
-      if(b)
-      {
-        c = (bf | bi);
-      }
-      else
-      {
-        if(s)
-        {
-          if((sf & 0x3E) == 0x3E)
-          {
-            if(sf & 1)
-            {
-              c = (bf | 0x00);
-            }
-            else
-            {
-              c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
-            }
-          }
-          else
-          {
-            if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
-            {
-              c = (sf | 0x40);
-            }
-            else
-            {
-              c = (sf | si);
-            }
-          }
-        }
-        else
-        {
-          c = (bf | bi);
-        }
-      }
-    }
-    else
-    {
-      if(s)
-      {
-        if((sf & 0x3E) == 0x3E)
-        {
-          if(sf & 1)
-          {
-            c = (bf | 0x00);
-          }
-          else
-          {
-            c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
-          }
-        }
-        else
-        {
-          if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
-          {
-            c = (sf | 0x40);
-          }
-          else
-          {
-            c = (sf | si);
-          }
-        }
-      }
-      else
-      {
-        c = (bf | bi);
-      }
-    }
-  }
-
-  if((c & 0x0f) == 0x00) c &= 0xC0;
-
-  return (c);
-}
-
-/* Input (bx):  d3-d0=color, d4=palette, d5=priority, d6=zero, d7=sprite pixel marker */
-/* Input (sx):  d3-d0=color, d7-d4=zero */
-/* Output:      d3-d0=color, d4=palette, d5=zero/priority, d6=zero, d7=sprite pixel marker */
-static u32 make_lut_bgobj_m4(u32 bx, u32 sx)
-{
-  int c;
-
-  int bf = (bx & 0x3F);
-  int bs = (bx & 0x80);
-  int bp = (bx & 0x20);
-  int b  = (bx & 0x0F);
-
-  int s  = (sx & 0x0F);
-  int sf = (s | 0x10); /* force palette bit */
-
-  /* Transparent sprite pixel */
-  if(s == 0) return bx;
-
-  /* Previous sprite has higher priority */
-  if(bs) return bx;
-
-  /* note: priority bit is always 0 for Modes 0,1,2,3 */
-  c = (bp ? (b ? bf : sf) : sf);
-
-  return (c | 0x80);
-}
-
-
 /*--------------------------------------------------------------------------*/
 /* Pixel color lookup tables initialization                                 */
 /*--------------------------------------------------------------------------*/
@@ -1055,30 +888,14 @@ void window_clip(unsigned int data, unsigned int sw)
 
 void render_init(void)
 {
-  int bx, ax;
-
   /* Initialize layers priority pixel look-up tables */
-  u16 index;
-  for (bx = 0; bx < 0x100; bx++)
-  {
-    for (ax = 0; ax < 0x100; ax++)
-    {
-      index = (bx << 8) | (ax);
-
-      lut[0][index] = make_lut_bg(bx, ax);
-      lut[1][index] = make_lut_bgobj(bx, ax);
-      lut[2][index] = make_lut_bg_ste(bx, ax);
-      lut[3][index] = make_lut_obj(bx, ax);
-      lut[4][index] = make_lut_bgobj_ste(bx, ax);
-      lut[5][index] = make_lut_bgobj_m4(bx,ax);
-    }
-  }
+  gpgx::ppu::vdp::MakeLayerPriorityLuts(lut);
 
   /* Initialize pixel color look-up tables */
   palette_init();
 
   /* Make sprite pattern name index look-up table (Mode 5) */
-  make_name_lut();
+  gpgx::ppu::vdp::MakeSpriteNameLut(name_lut);
 
   /* Make bitplane to pixel look-up table (Mode 4) */
   make_bp_lut();
@@ -1094,10 +911,19 @@ void render_init(void)
 
   // Initialize background layer rendering.
   background_layer_rendering_init();
+
+  // Initialize line rendering.
+  line_rendering_init();
 }
 
 void render_reset(void)
 {
+  /* Wait for deferred lines & clear worker threads state */
+  if (g_deferred_line_renderer_m5)
+  {
+    g_deferred_line_renderer_m5->Reset();
+  }
+
   /* Clear display bitmap */
   xee::mem::Memset(framebuffer.data, 0, framebuffer.pitch * framebuffer.height);
 
@@ -1106,12 +932,79 @@ void render_reset(void)
 
   /* Clear color palettes */
   xee::mem::Memset(pixel, 0, sizeof(pixel));
+  palette_hash_valid = 0;
+
+  /* All lines are changed in the next frame */
+  g_line_change_tracker->Invalidate();
 
   /* Clear pattern cache */
   xee::mem::Memset ((char *) bg_pattern_cache, 0, sizeof (bg_pattern_cache));
 
   /* Reset Sprite infos */
   spr_ovr = spr_col = object_count[0] = object_count[1] = 0;
+
+  /* Frame rendering restarts with the next frame */
+  render_frame = 0;
+}
+
+void render_update_mode(void)
+{
+  /* Mode 5 rendering (see vdp_reg_w) */
+  render_m5 = (g_satb_parser == g_satb_parser_m5);
+
+  /* Frame rendering restarts with the next frame */
+  render_frame = 0;
+
+  if (render_m5)
+  {
+    /* Select the line renderer specialized for the current IM2, VS & STE modes */
+    g_line_renderer_m5->SetMode(im2_flag != 0, (reg[11] & 0x04) != 0, (reg[12] & 0x08) != 0);
+  }
+
+  /* Deferred rendering (Mode 5 only) */
+  if (g_deferred_line_renderer_m5 && (render_deferred != render_m5))
+  {
+    if (render_m5)
+    {
+      /* Worker threads state is resent with the next line */
+      g_deferred_line_renderer_m5->Invalidate();
+    }
+    else
+    {
+      /* Pending lines must be rendered before lines are rendered again by this thread */
+      /* (the pattern cache is invalidated by the mode change, see vdp_reg_w) */
+      g_deferred_line_renderer_m5->Flush();
+    }
+
+    render_deferred = render_m5;
+  }
+}
+
+void render_flush(void)
+{
+  /* Wait for deferred lines */
+  if (g_deferred_line_renderer_m5)
+  {
+    g_deferred_line_renderer_m5->Flush();
+  }
+}
+
+void render_end_frame(void)
+{
+  /* Publish the lines changed since the previous displayed frame */
+  g_line_change_tracker->EndFrame();
+}
+
+void render_shutdown(void)
+{
+  /* Stop worker threads */
+  if (g_deferred_line_renderer_m5)
+  {
+    g_deferred_line_renderer_m5->Stop();
+    delete g_deferred_line_renderer_m5;
+    g_deferred_line_renderer_m5 = nullptr;
+    render_deferred = 0;
+  }
 }
 
 
@@ -1121,21 +1014,68 @@ void render_reset(void)
 
 void render_line(int line)
 {
+  /* Frame rendering (Mode 5) */
+  if (line == 0)
+  {
+    /* Background layers are rendered by frame if they were not modified during the previous frame active display (raster effects) */
+    render_frame = render_m5 && !render_deferred && (reg[1] & 0x40) && !raster_changes && g_frame_bg_layer_renderer_m5->CanRenderFrame(im2_flag);
+    raster_changes = 0;
+  }
+  else if (raster_changes)
+  {
+    /* Background layers modified during active display: remaining lines are rendered by line */
+    render_frame = 0;
+  }
+
+  /* Deferred rendering (Mode 5) */
+  if (render_deferred)
+  {
+    /* Record line state for the worker threads */
+    g_deferred_line_renderer_m5->PushRenderLine(line);
+
+    /* Parse sprites for next line */
+    if ((reg[1] & 0x40) && (line < (viewport.h - 1)))
+    {
+      g_satb_parser->ParseSpriteAttributeTable(line);
+    }
+
+    return;
+  }
+
   /* Check display status */
   if (reg[1] & 0x40)
   {
     /* Update pattern cache */
-    if (bg_list_index)
+    if (gpgx::ppu::vdp::IsAnyPatternDirty(bg_dirty_summary))
     {
-      g_bg_pattern_cache_updater->UpdateBackgroundPatternCache(bg_list_index);
-      bg_list_index = 0;
+      g_bg_pattern_cache_updater->UpdateBackgroundPatternCache();
     }
 
-    /* Render BG layer(s) */
-    g_bg_layer_renderer->RenderBackground(line);
+    if (render_frame)
+    {
+      /* Render BG layers of all lines (Mode 5) */
+      if (line == 0)
+      {
+        g_frame_bg_layer_renderer_m5->RenderFrame();
+      }
+
+      /* Merge BG layers & render sprite layer (Mode 5) */
+      g_frame_bg_layer_renderer_m5->RenderBackground(line);
+      g_sprite_layer_renderer->RenderSprites(line & 1);
+    }
+    else if (render_m5)
+    {
+      /* Render BG & sprite layers (Mode 5) */
+      g_line_renderer_m5->RenderLayers(line);
+    }
+    else
+    {
+      /* Render BG layer(s) */
+      g_bg_layer_renderer->RenderBackground(line);
 
-    /* Render sprite layer */
-    g_sprite_layer_renderer->RenderSprites(line & 1);
+      /* Render sprite layer */
+      g_sprite_layer_renderer->RenderSprites(line & 1);
+    }
 
     /* Left-most column blanking */
     if (reg[0] & 0x20)
@@ -1182,12 +1122,26 @@ void render_line(int line)
 
 void blank_line(int line, int offset, int width)
 {
+  /* Deferred rendering (Mode 5) */
+  if (render_deferred)
+  {
+    g_deferred_line_renderer_m5->PushBlankLine(line, offset, width);
+    return;
+  }
+
   xee::mem::Memset(&linebuf[0][0x20 + offset], 0x40, width);
   remap_line(line);
 }
 
 void remap_line(int line)
 {
+  /* Deferred rendering (Mode 5) */
+  if (render_deferred)
+  {
+    g_deferred_line_renderer_m5->PushRemapLine(line);
+    return;
+  }
+
   /* Line width */
   int width = viewport.w + 2*viewport.x;
 
@@ -1200,6 +1154,18 @@ void remap_line(int line)
   /* Take care of Game Gear reduced screen when overscan is disabled */
   if (line < 0) return;
 
+  /* Update the palette hash after color updates */
+  u32 version = g_color_palette_updater_mx->GetVersion() + g_color_palette_updater_m5->GetVersion();
+  if (!palette_hash_valid || (version != palette_version))
+  {
+    palette_hash = gpgx::ppu::vdp::LineChangeTracker::Hash(pixel, sizeof(pixel), 0);
+    palette_version = version;
+    palette_hash_valid = 1;
+  }
+
+  /* Track changed lines */
+  g_line_change_tracker->UpdateLine(line, src, width, palette_hash);
+
   /* Convert VDP pixel data to output pixel format */
   PIXEL_OUT_T *dst = ((PIXEL_OUT_T *)&framebuffer.data[(line * framebuffer.pitch)]);
 
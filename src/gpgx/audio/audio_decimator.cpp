@@ -0,0 +1,74 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/audio/audio_decimator.h"
+
+namespace gpgx::audio {
+
+//==============================================================================
+// AudioDecimator
+
+//------------------------------------------------------------------------------
+
+AudioDecimator::AudioDecimator() :
+  m_factor(1),
+  m_count(0)
+{
+  m_sum[0] = m_sum[1] = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void AudioDecimator::SetFactor(s32 factor)
+{
+  if (factor < 1) {
+    factor = 1;
+  } else if (factor > kMaxFactor) {
+    factor = kMaxFactor;
+  }
+
+  m_factor = factor;
+  m_count = 0;
+  m_sum[0] = m_sum[1] = 0;
+}
+
+//------------------------------------------------------------------------------
+
+s32 AudioDecimator::GetFactor() const
+{
+  return m_factor;
+}
+
+//------------------------------------------------------------------------------
+
+s32 AudioDecimator::Process(s16* samples, s32 count)
+{
+  if (m_factor == 1) {
+    return count;
+  }
+
+  const s16* src = samples;
+  s16* dst = samples;
+
+  // The output never overtakes the input (one output sample per m_factor
+  // input samples).
+  for (s32 i = 0; i < count; i++, src += 2) {
+    m_sum[0] += src[0];
+    m_sum[1] += src[1];
+
+    if (++m_count == m_factor) {
+      *dst++ = (s16)(m_sum[0] / m_factor);
+      *dst++ = (s16)(m_sum[1] / m_factor);
+
+      m_count = 0;
+      m_sum[0] = m_sum[1] = 0;
+    }
+  }
+
+  return (s32)((dst - samples) >> 1);
+}
+
+} // namespace gpgx::audio
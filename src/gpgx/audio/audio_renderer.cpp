@@ -55,6 +55,8 @@
 #include "core/cd_hw/pcm.h"
 
 #include "gpgx/g_psg.h"
+#include "gpgx/g_recorder.h"
+#include "gpgx/g_register_log.h"
 #include "gpgx/g_fm_synthesizer.h"
 #include "gpgx/audio/effect/equalizer_3band.h"
 #include "gpgx/audio/effect/null_fm_synthesizer.h"
@@ -76,6 +78,7 @@ AudioRenderer::AudioRenderer()
   m_fm_type = kFmTypeNone;
 
   xee::mem::Memset(m_fm_buffer, 0, sizeof(m_fm_buffer));
+  xee::mem::Memset(m_internal_buffer, 0, sizeof(m_internal_buffer));
 
   llp = 0;
   rrp = 0;
@@ -194,6 +197,14 @@ s32 AudioRenderer::Update(s16* output_buffer)
 {
   u32 cycles = mcycles_vdp;
 
+  // Samples are generated at internal rate when using polyphase resampler.
+  s16* buffer = snd.resampler ? m_internal_buffer : output_buffer;
+
+  // Record end of frame to the register log (if any).
+  if (gpgx::g_register_log) {
+    gpgx::g_register_log->LogEndFrame(cycles);
+  }
+
   // Run PSG chip until end of frame.
   gpgx::g_psg->psg_end_frame(cycles);
 
@@ -220,7 +231,7 @@ s32 AudioRenderer::Update(s16* output_buffer)
 #endif
 
     // resample & mix FM/PSG, PCM & CD-DA streams to output buffer.
-    snd.blips[0]->blip_mix_samples(snd.blips[1], snd.blips[2], output_buffer, size);
+    snd.blips[0]->blip_mix_samples(snd.blips[1], snd.blips[2], buffer, size);
   } else {
 #ifdef ALIGN_SND
     // return an aligned number of samples if required.
@@ -228,13 +239,13 @@ s32 AudioRenderer::Update(s16* output_buffer)
 #endif
 
     // resample FM/PSG mixed stream to output buffer.
-    snd.blips[0]->blip_read_samples(output_buffer, size);
+    snd.blips[0]->blip_read_samples(buffer, size);
   }
 
   // Audio filtering.
   if (core_config.filter) {
     int samples = size;
-    s16* out = output_buffer;
+    s16* out = buffer;
     s32 l, r;
 
     // Use low-pass filtering ?
@@ -288,14 +299,25 @@ s32 AudioRenderer::Update(s16* output_buffer)
   // Mono output mixing.
   if (core_config.mono) {
     s16 out;
+    s16* ptr = buffer;
     int samples = size;
     do {
-      out = (output_buffer[0] + output_buffer[1]) / 2;
-      *output_buffer++ = out;
-      *output_buffer++ = out;
+      out = (ptr[0] + ptr[1]) / 2;
+      *ptr++ = out;
+      *ptr++ = out;
     } while (--samples);
   }
 
+  // Convert internal rate to output rate.
+  if (snd.resampler) {
+    size = snd.resampler->Process(buffer, size, output_buffer);
+  }
+
+  // Send output samples to the recorder (if any).
+  if (gpgx::g_recorder) {
+    gpgx::g_recorder->PushAudioSamples(output_buffer, size);
+  }
+
 #ifdef LOGSOUND
   error("%d samples returned\n\n", size);
 #endif
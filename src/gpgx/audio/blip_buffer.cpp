@@ -344,42 +344,76 @@ void BlipBuffer::blip_add_delta(unsigned int time, int delta_l, int delta_r)
 
 //------------------------------------------------------------------------------
 
-void BlipBuffer::blip_add_delta_fast(unsigned int time, int delta_l, int delta_r)
+inline void BlipBuffer::add_delta_fast(u64 time, int delta_l, int delta_r)
 {
-  if (delta_l | delta_r) {
-    unsigned fixed = (unsigned)((time * m_factor + m_offset) >> kPreShift);
-    int interp = fixed >> (kFracBits - kDeltaBits) & (kDeltaUnit - 1);
-    int pos = fixed >> kFracBits;
+  unsigned fixed = (unsigned)(time >> kPreShift);
+  int interp = fixed >> (kFracBits - kDeltaBits) & (kDeltaUnit - 1);
+  int pos = fixed >> kFracBits;
 
 #ifdef STEREO_INVERT
-    s32* out_l = m_buffer[1] + pos;
-    s32* out_r = m_buffer[0] + pos;
+  s32* out_l = m_buffer[1] + pos;
+  s32* out_r = m_buffer[0] + pos;
 #else
-    s32* out_l = m_buffer[0] + pos;
-    s32* out_r = m_buffer[1] + pos;
+  s32* out_l = m_buffer[0] + pos;
+  s32* out_r = m_buffer[1] + pos;
 #endif
 
-    int delta = delta_l * interp;
+  int delta = delta_l * interp;
 
 #ifdef BLIP_ASSERT
-    // Fails if buffer size was exceeded.
-    assert(pos <= m_size + kEndFrameExtra);
+  // Fails if buffer size was exceeded.
+  assert(pos <= m_size + kEndFrameExtra);
 #endif
 
-    if (delta_l == delta_r) {
-      delta_l = delta_l * kDeltaUnit - delta;
-      out_l[7] += delta_l;
-      out_l[8] += delta;
-      out_r[7] += delta_l;
-      out_r[8] += delta;
-    } else {
-      out_l[7] += delta_l * kDeltaUnit - delta;
-      out_l[8] += delta;
-      delta = delta_r * interp;
-      out_r[7] += delta_r * kDeltaUnit - delta;
-      out_r[8] += delta;
+  if (delta_l == delta_r) {
+    delta_l = delta_l * kDeltaUnit - delta;
+    out_l[7] += delta_l;
+    out_l[8] += delta;
+    out_r[7] += delta_l;
+    out_r[8] += delta;
+  } else {
+    out_l[7] += delta_l * kDeltaUnit - delta;
+    out_l[8] += delta;
+    delta = delta_r * interp;
+    out_r[7] += delta_r * kDeltaUnit - delta;
+    out_r[8] += delta;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void BlipBuffer::blip_add_delta_fast(unsigned int time, int delta_l, int delta_r)
+{
+  if (delta_l | delta_r) {
+    add_delta_fast(time * m_factor + m_offset, delta_l, delta_r);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+// [Hardware MCD]
+void BlipBuffer::blip_add_samples_fast(unsigned int clock_time, const s32* in_l, const s32* in_r, int count, int prev[2])
+{
+  u64 time = clock_time * m_factor + m_offset;
+  int prev_l = prev[0];
+  int prev_r = prev[1];
+
+  for (int i = 0; i < count; i++) {
+    int delta_l = in_l[i] - prev_l;
+    int delta_r = in_r[i] - prev_r;
+
+    if (delta_l | delta_r) {
+      add_delta_fast(time, delta_l, delta_r);
+
+      prev_l = in_l[i];
+      prev_r = in_r[i];
     }
+
+    time += m_factor;
   }
+
+  prev[0] = prev_l;
+  prev[1] = prev_r;
 }
 
 //------------------------------------------------------------------------------
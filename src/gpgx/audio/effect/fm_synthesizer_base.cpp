@@ -45,6 +45,8 @@
 #include "core/snd.h"
 #include "core/state.h"
 
+#include "gpgx/g_register_log.h"
+
 namespace gpgx::audio::effect {
 
 //==============================================================================
@@ -64,6 +66,14 @@ FmSynthesizerBase::FmSynthesizerBase()
 
   m_fm_buffer = nullptr;
   m_fm_ptr = nullptr;
+
+  m_blip = nullptr;
+
+  m_log_chip = gpgx::capture::RegisterLogChip::kOpn2;
+  xee::mem::Memset(m_log_latch, 0, sizeof(m_log_latch));
+  xee::mem::Memset(m_log_written, 0, sizeof(m_log_written));
+  m_log_port = 0;
+  m_log_keys_written = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -75,6 +85,13 @@ void FmSynthesizerBase::SetClockRatio(int clock_ratio)
 
 //------------------------------------------------------------------------------
 
+void FmSynthesizerBase::SetBlipBuffer(gpgx::audio::BlipBuffer* blip)
+{
+  m_blip = blip;
+}
+
+//------------------------------------------------------------------------------
+
 void FmSynthesizerBase::Reset(int* buffer)
 {
   // Synchronize FM chip with CPU and reset FM chip.
@@ -114,6 +131,9 @@ void FmSynthesizerBase::EndFrame(unsigned int cycles)
   // FM buffer start pointer.
   int* ptr = m_fm_buffer;
 
+  // Output blip buffer.
+  gpgx::audio::BlipBuffer* blip = m_blip ? m_blip : snd.blips[0];
+
   int l = 0;
   int r = 0;
 
@@ -124,7 +144,7 @@ void FmSynthesizerBase::EndFrame(unsigned int cycles)
       // left & right channels.
       l = ((*ptr++ * preamp) / 100);
       r = ((*ptr++ * preamp) / 100);
-      snd.blips[0]->blip_add_delta(time, l - prev_l, r - prev_r);
+      blip->blip_add_delta(time, l - prev_l, r - prev_r);
       prev_l = l;
       prev_r = r;
 
@@ -137,7 +157,7 @@ void FmSynthesizerBase::EndFrame(unsigned int cycles)
       // left & right channels.
       l = ((*ptr++ * preamp) / 100);
       r = ((*ptr++ * preamp) / 100);
-      snd.blips[0]->blip_add_delta_fast(time, l - prev_l, r - prev_r);
+      blip->blip_add_delta_fast(time, l - prev_l, r - prev_r);
       prev_l = l;
       prev_r = r;
 
@@ -189,6 +209,96 @@ int FmSynthesizerBase::LoadContext(unsigned char* state)
 
 //------------------------------------------------------------------------------
 
+void FmSynthesizerBase::LogState(unsigned int cycles)
+{
+  gpgx::capture::RegisterLogWriter* log = gpgx::g_register_log;
+
+  if (!log) {
+    return;
+  }
+
+  if (m_log_chip == gpgx::capture::RegisterLogChip::kOpn2) {
+    // Channels settings, then key on/off.
+    for (u32 port = 0; port < 2; port++) {
+      for (u32 reg = 0; reg < 256; reg++) {
+        if (m_log_written[port][reg] && ((port != 0) || (reg != 0x28))) {
+          log->LogFmWrite(m_log_chip, cycles, port << 1, reg);
+          log->LogFmWrite(m_log_chip, cycles, (port << 1) | 1, m_log_regs[port][reg]);
+        }
+      }
+    }
+
+    for (u32 channel = 0; channel < 8; channel++) {
+      if (m_log_keys_written & (1 << channel)) {
+        log->LogFmWrite(m_log_chip, cycles, 0, 0x28);
+        log->LogFmWrite(m_log_chip, cycles, 1, m_log_keys[channel]);
+      }
+    }
+  } else {
+    // Instruments and channels settings, then rhythm ($0E) and key on/off
+    // ($20-$28).
+    for (u32 pass = 0; pass < 2; pass++) {
+      for (u32 reg = 0; reg < 64; reg++) {
+        u32 key = ((reg == 0x0E) || ((reg >= 0x20) && (reg <= 0x28))) ? 1 : 0;
+
+        if (m_log_written[0][reg] && (key == pass)) {
+          log->LogFmWrite(m_log_chip, cycles, 0, reg);
+          log->LogFmWrite(m_log_chip, cycles, 1, m_log_regs[0][reg]);
+        }
+      }
+    }
+  }
+
+  // Restore the latched register address.
+  log->LogFmWrite(m_log_chip, cycles, m_log_port << 1, m_log_latch[m_log_port]);
+}
+
+//------------------------------------------------------------------------------
+
+void FmSynthesizerBase::LogWrite(gpgx::capture::RegisterLogChip chip, unsigned int cycles, unsigned int address, unsigned int data)
+{
+  if (gpgx::g_register_log) {
+    gpgx::g_register_log->LogFmWrite(chip, cycles, address, data);
+  }
+
+  u32 port = (chip == gpgx::capture::RegisterLogChip::kOpn2) ? ((address >> 1) & 1) : 0;
+
+  m_log_chip = chip;
+
+  if (!(address & 1)) {
+    m_log_latch[port] = (u8)data;
+    m_log_port = (u8)port;
+    return;
+  }
+
+  u8 reg = m_log_latch[port];
+
+  if ((chip == gpgx::capture::RegisterLogChip::kOpn2) && (port == 0) && (reg == 0x28)) {
+    // Key on/off of the channel selected by bits 0-2.
+    m_log_keys[data & 7] = (u8)data;
+    m_log_keys_written |= (1 << (data & 7));
+  }
+
+  m_log_regs[port][reg] = (u8)data;
+  m_log_written[port][reg] = 1;
+}
+
+//------------------------------------------------------------------------------
+
+void FmSynthesizerBase::LogReset(unsigned int cycles)
+{
+  if (gpgx::g_register_log) {
+    gpgx::g_register_log->LogFmReset(cycles);
+  }
+
+  xee::mem::Memset(m_log_latch, 0, sizeof(m_log_latch));
+  xee::mem::Memset(m_log_written, 0, sizeof(m_log_written));
+  m_log_port = 0;
+  m_log_keys_written = 0;
+}
+
+//------------------------------------------------------------------------------
+
 // Run FM chip until required M-cycles.
 void FmSynthesizerBase::Update(int cycles)
 {
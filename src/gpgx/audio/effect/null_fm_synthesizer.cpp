@@ -98,5 +98,12 @@ int NullFmSynthesizer::LoadContext(unsigned char*)
   return 0;
 }
 
+//------------------------------------------------------------------------------
+
+void NullFmSynthesizer::LogState(unsigned int)
+{
+  // Nothing to do.
+}
+
 } // namespace gpgx::audio::effect
 
@@ -0,0 +1,292 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/audio/polyphase_resampler.h"
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#define RESAMPLER_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+#include "xee/fnd/data_type.h"
+#include "xee/mem/memory.h"
+
+namespace gpgx::audio {
+
+//==============================================================================
+// PolyphaseResampler
+
+//------------------------------------------------------------------------------
+
+// Zeroth order modified Bessel function of the first kind (used by the Kaiser
+// window).
+static f64 BesselI0(f64 x)
+{
+  f64 sum = 1.0;
+  f64 term = 1.0;
+  f64 half_x = x / 2.0;
+
+  for (s32 k = 1; k < 32; k++) {
+    term *= (half_x / k) * (half_x / k);
+    sum += term;
+
+    if (term < (sum * 1e-12)) {
+      break;
+    }
+  }
+
+  return sum;
+}
+
+//------------------------------------------------------------------------------
+
+PolyphaseResampler::PolyphaseResampler()
+{
+  m_input_rate = 1.0;
+  m_output_rate = 1.0;
+  m_adjustment = 1.0;
+  m_filter_ratio = 0.0;
+
+  m_pos = 0;
+  m_step = kFracUnit;
+  m_count = 0;
+
+  xee::mem::Memset(m_coeffs, 0, sizeof(m_coeffs));
+
+  Clear();
+}
+
+//------------------------------------------------------------------------------
+
+void PolyphaseResampler::SetRates(f64 input_rate, f64 output_rate)
+{
+  m_input_rate = input_rate;
+  m_output_rate = output_rate;
+  m_adjustment = 1.0;
+
+  // Only rebuild the filter when the ratio has changed.
+  f64 ratio = output_rate / input_rate;
+
+  if (ratio != m_filter_ratio) {
+    m_filter_ratio = ratio;
+    BuildFilter();
+  }
+
+  UpdateStep();
+}
+
+//------------------------------------------------------------------------------
+
+void PolyphaseResampler::SetRateAdjustment(f64 adjustment)
+{
+  m_adjustment = adjustment;
+
+  UpdateStep();
+}
+
+//------------------------------------------------------------------------------
+
+void PolyphaseResampler::Clear()
+{
+  xee::mem::Memset(m_history, 0, sizeof(m_history));
+
+  // Half of the filter is primed with silence so that the first input
+  // sample is output with the lowest latency.
+  m_count = kTapCount / 2;
+  m_pos = 0;
+}
+
+//------------------------------------------------------------------------------
+
+s32 PolyphaseResampler::GetMaxOutputSamples(s32 input_count) const
+{
+  return (s32)((((u64)input_count + kTapCount) << kFracBits) / m_step) + 1;
+}
+
+//------------------------------------------------------------------------------
+
+s32 PolyphaseResampler::Process(const s16* input, s32 input_count, s16* output)
+{
+  s32 total = 0;
+
+  while (input_count > 0) {
+    s32 count = (input_count > kMaxBlockSize) ? kMaxBlockSize : input_count;
+
+    // Append input samples to the history buffers.
+    f32* l = &m_history[0][m_count];
+    f32* r = &m_history[1][m_count];
+
+    for (s32 i = 0; i < count; i++) {
+      l[i] = (f32)input[0];
+      r[i] = (f32)input[1];
+      input += 2;
+    }
+
+    m_count += count;
+    input_count -= count;
+
+    total += ProcessBuffer(&output[total * 2]);
+  }
+
+  return total;
+}
+
+//------------------------------------------------------------------------------
+
+void PolyphaseResampler::BuildFilter()
+{
+  // Cutoff frequency (relative to the input Nyquist frequency), lowered when
+  // downsampling to remove frequencies the output rate cannot represent.
+  f64 cutoff = (m_filter_ratio < 1.0) ? (m_filter_ratio * kPassband) : kPassband;
+
+  f64 half_width = kTapCount / 2;
+  f64 i0_beta = BesselI0(kKaiserBeta);
+
+  for (s32 phase = 0; phase <= kPhaseCount; phase++) {
+    f32* coeffs = &m_coeffs[phase * kTapCount];
+    f64 sum = 0.0;
+    f64 values[kTapCount];
+
+    for (s32 tap = 0; tap < kTapCount; tap++) {
+      // Distance (in input samples) between the tap and the output sample.
+      f64 x = (tap - (half_width - 1.0)) - ((f64)phase / kPhaseCount);
+
+      // Windowed sinc.
+      f64 sinc = 1.0;
+
+      if (x != 0.0) {
+        f64 a = 3.14159265358979323846 * cutoff * x;
+        sinc = ::sin(a) / a;
+      }
+
+      f64 u = x / half_width;
+      f64 window = 0.0;
+
+      if ((u > -1.0) && (u < 1.0)) {
+        window = BesselI0(kKaiserBeta * ::sqrt(1.0 - (u * u))) / i0_beta;
+      }
+
+      values[tap] = cutoff * sinc * window;
+      sum += values[tap];
+    }
+
+    // Normalize each phase to unity gain.
+    for (s32 tap = 0; tap < kTapCount; tap++) {
+      coeffs[tap] = (f32)(values[tap] / sum);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+s32 PolyphaseResampler::ProcessBuffer(s16* output)
+{
+  static constexpr s32 kInterpBits = kFracBits - kPhaseBits;
+  static constexpr f32 kInterpScale = 1.0f / (f32)((u64)1 << kInterpBits);
+
+  s32 produced = 0;
+
+  for (;;) {
+    u64 index = m_pos >> kFracBits;
+
+    if ((index + kTapCount) > (u64)m_count) {
+      break;
+    }
+
+    u32 frac = (u32)m_pos;
+    s32 phase = frac >> kInterpBits;
+    f32 interp = (f32)(frac & (((u32)1 << kInterpBits) - 1)) * kInterpScale;
+
+    const f32* c0 = &m_coeffs[phase * kTapCount];
+    const f32* c1 = c0 + kTapCount;
+    const f32* l = &m_history[0][index];
+    const f32* r = &m_history[1][index];
+
+    f32 sum[4];
+
+#ifdef RESAMPLER_USE_SSE
+    __m128 l0 = _mm_setzero_ps();
+    __m128 l1 = _mm_setzero_ps();
+    __m128 r0 = _mm_setzero_ps();
+    __m128 r1 = _mm_setzero_ps();
+
+    for (s32 tap = 0; tap < kTapCount; tap += 4) {
+      __m128 vc0 = _mm_load_ps(&c0[tap]);
+      __m128 vc1 = _mm_load_ps(&c1[tap]);
+      __m128 vl = _mm_loadu_ps(&l[tap]);
+      __m128 vr = _mm_loadu_ps(&r[tap]);
+
+      l0 = _mm_add_ps(l0, _mm_mul_ps(vl, vc0));
+      l1 = _mm_add_ps(l1, _mm_mul_ps(vl, vc1));
+      r0 = _mm_add_ps(r0, _mm_mul_ps(vr, vc0));
+      r1 = _mm_add_ps(r1, _mm_mul_ps(vr, vc1));
+    }
+
+    // Horizontal sums of the four accumulators.
+    _MM_TRANSPOSE4_PS(l0, l1, r0, r1);
+    _mm_storeu_ps(sum, _mm_add_ps(_mm_add_ps(l0, l1), _mm_add_ps(r0, r1)));
+#else
+    sum[0] = sum[1] = sum[2] = sum[3] = 0.0f;
+
+    for (s32 tap = 0; tap < kTapCount; tap++) {
+      sum[0] += l[tap] * c0[tap];
+      sum[1] += l[tap] * c1[tap];
+      sum[2] += r[tap] * c0[tap];
+      sum[3] += r[tap] * c1[tap];
+    }
+#endif
+
+    // Interpolate between both phases.
+    f32 out[2];
+    out[0] = sum[0] + ((sum[1] - sum[0]) * interp);
+    out[1] = sum[2] + ((sum[3] - sum[2]) * interp);
+
+    for (s32 ch = 0; ch < 2; ch++) {
+      s32 s = (s32)::lrintf(out[ch]);
+
+      // clipping (16-bit samples).
+      if (s > 32767) s = 32767;
+      else if (s < -32768) s = -32768;
+
+      *output++ = (s16)s;
+    }
+
+    produced++;
+
+    m_pos += m_step;
+  }
+
+  // Discard the samples that are no longer needed.
+  u64 consumed = m_pos >> kFracBits;
+  s32 shift = (consumed > (u64)m_count) ? m_count : (s32)consumed;
+
+  if (shift) {
+    m_count -= shift;
+    xee::mem::Memmove(&m_history[0][0], &m_history[0][shift], m_count * sizeof(f32));
+    xee::mem::Memmove(&m_history[1][0], &m_history[1][shift], m_count * sizeof(f32));
+    m_pos -= (u64)shift << kFracBits;
+  }
+
+  return produced;
+}
+
+//------------------------------------------------------------------------------
+
+void PolyphaseResampler::UpdateStep()
+{
+  f64 step = (m_input_rate / (m_output_rate * m_adjustment)) * (f64)kFracUnit;
+
+  m_step = (u64)step;
+
+  // The step must never be null.
+  if (!m_step) {
+    m_step = 1;
+  }
+}
+
+} // namespace gpgx::audio
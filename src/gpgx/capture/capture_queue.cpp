@@ -0,0 +1,73 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/capture/capture_queue.h"
+
+#include "gpgx/capture/capture_packet.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+// CaptureQueue
+
+//------------------------------------------------------------------------------
+
+CaptureQueue::CaptureQueue()
+  : m_head(0)
+  , m_tail(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+CapturePacket* CaptureQueue::Acquire()
+{
+  u32 head = m_head.load(std::memory_order_relaxed);
+
+  // Full ?
+  if ((head - m_tail.load(std::memory_order_acquire)) >= kCapacity) {
+    return nullptr;
+  }
+
+  return &m_packets[head & kMask];
+}
+
+//------------------------------------------------------------------------------
+
+void CaptureQueue::Commit()
+{
+  m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+
+CapturePacket* CaptureQueue::Peek()
+{
+  u32 tail = m_tail.load(std::memory_order_relaxed);
+
+  // Empty ?
+  if (tail == m_head.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+
+  return &m_packets[tail & kMask];
+}
+
+//------------------------------------------------------------------------------
+
+void CaptureQueue::Release()
+{
+  m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+
+bool CaptureQueue::IsEmpty() const
+{
+  return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+}
+
+} // namespace gpgx::capture
@@ -0,0 +1,205 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/capture/frame_delta_codec.h"
+
+#include "xee/fnd/data_type.h"
+#include "xee/mem/memory.h"
+
+#include "core/vdp/pixel.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+// FrameDeltaCodec
+
+//------------------------------------------------------------------------------
+
+static void PutU16(std::vector<u8>& output, u32 value)
+{
+  output.push_back((u8)(value & 0xff));
+  output.push_back((u8)((value >> 8) & 0xff));
+}
+
+//------------------------------------------------------------------------------
+
+static u32 GetU16(const u8* data)
+{
+  return data[0] | (data[1] << 8);
+}
+
+//------------------------------------------------------------------------------
+
+FrameDeltaCodec::FrameDeltaCodec()
+{
+  Reset();
+}
+
+//------------------------------------------------------------------------------
+
+void FrameDeltaCodec::Reset()
+{
+  m_frame.clear();
+  m_width = 0;
+  m_height = 0;
+  m_frame_count = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void FrameDeltaCodec::Encode(const PIXEL_OUT_T* pixels, s32 width, s32 height, std::vector<u8>& output, const u8* lines)
+{
+  u8 flags = 0;
+
+  // Key frame ?
+  if ((width != m_width) || (height != m_height) || (m_frame_count >= kKeyFrameInterval)) {
+    m_width = width;
+    m_height = height;
+    m_frame.assign((size_t)width * height, 0);
+    m_frame_count = 0;
+    flags = kFlagKeyFrame;
+
+    // All lines differ from the black frame.
+    lines = nullptr;
+  }
+
+  m_frame_count++;
+
+  // Frame header (payload size is patched once known).
+  size_t start = output.size();
+  output.resize(start + kFrameHeaderSize);
+  output[start + 4] = (u8)(width & 0xff);
+  output[start + 5] = (u8)(width >> 8);
+  output[start + 6] = (u8)(height & 0xff);
+  output[start + 7] = (u8)(height >> 8);
+  output[start + 8] = flags;
+
+  PIXEL_OUT_T* ref = m_frame.data();
+  s32 total = width * height;
+  s32 pos = 0;
+
+  while (pos < total) {
+    // Unchanged pixels (compared up to the end of each line).
+    s32 skip = 0;
+    while ((pos < total) && (skip < 0xffff)) {
+      s32 y = pos / width;
+      s32 count = ((y + 1) * width) - pos;
+
+      if (count > (0xffff - skip)) {
+        count = 0xffff - skip;
+      }
+
+      if (lines && !lines[y]) {
+        // Unchanged line.
+        pos += count;
+        skip += count;
+        continue;
+      }
+
+      s32 i = 0;
+      while ((i < count) && (pixels[pos + i] == ref[pos + i])) {
+        i++;
+      }
+
+      pos += i;
+      skip += i;
+
+      if (i < count) {
+        break;
+      }
+    }
+
+    // Changed pixels (a single unchanged pixel does not end the run, it 
+    // costs less than a new token).
+    s32 first = pos;
+    s32 copy = 0;
+    while ((pos < total) && (copy < 0xffff)) {
+      if (pixels[pos] == ref[pos]) {
+        if (((pos + 1) >= total) || (pixels[pos + 1] == ref[pos + 1])) {
+          break;
+        }
+      }
+
+      pos++;
+      copy++;
+    }
+
+    PutU16(output, skip);
+    PutU16(output, copy);
+
+    if (copy) {
+      // Update the reference frame.
+      xee::mem::Memcpy(&ref[first], &pixels[first], copy * sizeof(PIXEL_OUT_T));
+
+      size_t offset = output.size();
+      output.resize(offset + (copy * sizeof(PIXEL_OUT_T)));
+      xee::mem::Memcpy(&output[offset], &pixels[first], copy * sizeof(PIXEL_OUT_T));
+    }
+  }
+
+  // Payload size.
+  u32 size = (u32)(output.size() - start - kFrameHeaderSize);
+  output[start + 0] = (u8)(size & 0xff);
+  output[start + 1] = (u8)((size >> 8) & 0xff);
+  output[start + 2] = (u8)((size >> 16) & 0xff);
+  output[start + 3] = (u8)((size >> 24) & 0xff);
+}
+
+//------------------------------------------------------------------------------
+
+bool FrameDeltaCodec::Decode(const u8* data, s32 size)
+{
+  if (size < kFrameHeaderSize) {
+    return false;
+  }
+
+  s32 payload = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+  s32 width = GetU16(&data[4]);
+  s32 height = GetU16(&data[6]);
+  u8 flags = data[8];
+
+  if ((payload + kFrameHeaderSize) > size) {
+    return false;
+  }
+
+  if (flags & kFlagKeyFrame) {
+    m_width = width;
+    m_height = height;
+    m_frame.assign((size_t)width * height, 0);
+  } else if ((width != m_width) || (height != m_height)) {
+    return false;
+  }
+
+  const u8* ptr = &data[kFrameHeaderSize];
+  const u8* end = ptr + payload;
+  PIXEL_OUT_T* ref = m_frame.data();
+  s32 total = width * height;
+  s32 pos = 0;
+
+  while (ptr < end) {
+    if ((end - ptr) < 4) {
+      return false;
+    }
+
+    s32 skip = GetU16(&ptr[0]);
+    s32 copy = GetU16(&ptr[2]);
+    ptr += 4;
+
+    pos += skip;
+
+    if (((pos + copy) > total) || ((end - ptr) < (s32)(copy * sizeof(PIXEL_OUT_T)))) {
+      return false;
+    }
+
+    xee::mem::Memcpy(&ref[pos], ptr, copy * sizeof(PIXEL_OUT_T));
+    ptr += copy * sizeof(PIXEL_OUT_T);
+    pos += copy;
+  }
+
+  return true;
+}
+
+} // namespace gpgx::capture
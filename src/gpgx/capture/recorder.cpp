@@ -0,0 +1,442 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/capture/recorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "xee/fnd/data_type.h"
+#include "xee/mem/memory.h"
+
+#include "core/vdp/pixel.h"
+
+#include "gpgx/capture/capture_packet.h"
+#include "gpgx/capture/capture_queue.h"
+#include "gpgx/capture/frame_delta_codec.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+// Recorder
+
+//------------------------------------------------------------------------------
+
+// Convert an output pixel to 8-bit RGB components.
+static inline void PixelToRgb(PIXEL_OUT_T pixel, u8* rgb)
+{
+#if defined(USE_8BPP_RENDERING)
+  // 3:3:2 RGB.
+  rgb[0] = (u8)((((pixel >> 5) & 0x07) * 255) / 7);
+  rgb[1] = (u8)((((pixel >> 2) & 0x07) * 255) / 7);
+  rgb[2] = (u8)((pixel & 0x03) * 85);
+#elif defined(USE_15BPP_RENDERING)
+  // 5:5:5 RGB.
+  u32 r = (pixel >> 10) & 0x1f;
+  u32 g = (pixel >> 5) & 0x1f;
+  u32 b = pixel & 0x1f;
+#if defined(USE_ABGR)
+  u32 t = r;
+  r = b;
+  b = t;
+#endif
+  rgb[0] = (u8)((r << 3) | (r >> 2));
+  rgb[1] = (u8)((g << 3) | (g >> 2));
+  rgb[2] = (u8)((b << 3) | (b >> 2));
+#elif defined(USE_16BPP_RENDERING)
+  // 5:6:5 RGB.
+  u32 r = (pixel >> 11) & 0x1f;
+  u32 g = (pixel >> 5) & 0x3f;
+  u32 b = pixel & 0x1f;
+  rgb[0] = (u8)((r << 3) | (r >> 2));
+  rgb[1] = (u8)((g << 2) | (g >> 4));
+  rgb[2] = (u8)((b << 3) | (b >> 2));
+#elif defined(USE_32BPP_RENDERING)
+  // 8:8:8 RGB.
+  rgb[0] = (u8)((pixel >> 16) & 0xff);
+  rgb[1] = (u8)((pixel >> 8) & 0xff);
+  rgb[2] = (u8)(pixel & 0xff);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+// Write a 16-bit value (little-endian).
+static void WriteU16(FILE* file, u32 value)
+{
+  u8 data[2] = { (u8)(value & 0xff), (u8)((value >> 8) & 0xff) };
+  fwrite(data, 1, 2, file);
+}
+
+//------------------------------------------------------------------------------
+
+// Write a 32-bit value (little-endian).
+static void WriteU32(FILE* file, u32 value)
+{
+  u8 data[4] = { (u8)(value & 0xff), (u8)((value >> 8) & 0xff), (u8)((value >> 16) & 0xff), (u8)((value >> 24) & 0xff) };
+  fwrite(data, 1, 4, file);
+}
+
+//------------------------------------------------------------------------------
+
+Recorder::Recorder()
+  : m_stop(false)
+  , m_stalls(0)
+{
+  m_recording = false;
+  m_video_format = VideoFormat::kNone;
+  m_video_file = nullptr;
+  m_audio_file = nullptr;
+  m_sample_rate = 0;
+  m_frame_rate = 0.0;
+  m_audio_size = 0;
+  m_video_width = 0;
+  m_video_height = 0;
+}
+
+//------------------------------------------------------------------------------
+
+Recorder::~Recorder()
+{
+  Stop();
+}
+
+//------------------------------------------------------------------------------
+
+bool Recorder::Start(const char* path, VideoFormat video_format, bool audio, s32 sample_rate, f64 frame_rate)
+{
+  if (m_recording) {
+    return false;
+  }
+
+  char filename[1024];
+
+  m_video_format = video_format;
+  m_sample_rate = sample_rate;
+  m_frame_rate = frame_rate;
+  m_audio_size = 0;
+  m_video_width = 0;
+  m_video_height = 0;
+  m_codec.Reset();
+  m_stalls.store(0, std::memory_order_relaxed);
+
+  // Video file.
+  if (video_format != VideoFormat::kNone) {
+    const char* extension = (video_format == VideoFormat::kRaw) ? "rgb" : ((video_format == VideoFormat::kY4m) ? "y4m" : "vfd");
+    snprintf(filename, sizeof(filename), "%s.%s", path, extension);
+
+    m_video_file = fopen(filename, "wb");
+
+    if (!m_video_file) {
+      return false;
+    }
+
+    if (video_format == VideoFormat::kDelta) {
+      // File header: magic, bytes per pixel, frame rate (in mHz).
+      fwrite("VFD1", 1, 4, m_video_file);
+      WriteU16(m_video_file, sizeof(PIXEL_OUT_T));
+      WriteU16(m_video_file, 0);
+      WriteU32(m_video_file, (u32)(frame_rate * 1000.0 + 0.5));
+    }
+  }
+
+  // Audio file.
+  if (audio) {
+    snprintf(filename, sizeof(filename), "%s.wav", path);
+
+    m_audio_file = fopen(filename, "wb");
+
+    if (!m_audio_file) {
+      if (m_video_file) {
+        fclose(m_video_file);
+        m_video_file = nullptr;
+      }
+
+      return false;
+    }
+
+    WriteWavHeader();
+  }
+
+  // Start the writer thread.
+  m_stop.store(false, std::memory_order_release);
+  m_thread = std::thread(&Recorder::Run, this);
+  m_recording = true;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+void Recorder::Stop()
+{
+  if (!m_recording) {
+    return;
+  }
+
+  m_recording = false;
+
+  // Wait for the writer thread to flush pending packets.
+  m_stop.store(true, std::memory_order_release);
+  m_thread.join();
+
+  if (m_audio_file) {
+    // Update data sizes.
+    WriteWavHeader();
+    fclose(m_audio_file);
+    m_audio_file = nullptr;
+  }
+
+  if (m_video_file) {
+    fclose(m_video_file);
+    m_video_file = nullptr;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Recorder::PushVideoFrame(const u8* data, s32 width, s32 height, s32 pitch, const u8* lines)
+{
+  if (!m_recording || !m_video_file || (width <= 0) || (height <= 0)) {
+    return;
+  }
+
+  CapturePacket* packet = AcquirePacket();
+
+  s32 line_size = width * sizeof(PIXEL_OUT_T);
+
+  packet->type = CapturePacketType::kVideo;
+  packet->width = width;
+  packet->height = height;
+  packet->count = 0;
+  packet->data.resize((size_t)line_size * height);
+
+  // Changed lines (the delta codec only compares these lines).
+  if (lines) {
+    packet->lines.assign(lines, lines + height);
+  } else {
+    packet->lines.clear();
+  }
+
+  // Pack lines.
+  u8* dst = packet->data.data();
+
+  for (s32 y = 0; y < height; y++) {
+    xee::mem::Memcpy(dst, data, line_size);
+    dst += line_size;
+    data += pitch;
+  }
+
+  m_queue.Commit();
+}
+
+//------------------------------------------------------------------------------
+
+void Recorder::PushAudioSamples(const s16* samples, s32 count)
+{
+  if (!m_recording || !m_audio_file || (count <= 0)) {
+    return;
+  }
+
+  CapturePacket* packet = AcquirePacket();
+
+  packet->type = CapturePacketType::kAudio;
+  packet->width = 0;
+  packet->height = 0;
+  packet->count = count;
+  packet->data.resize((size_t)count * 2 * sizeof(s16));
+  packet->lines.clear();
+
+  xee::mem::Memcpy(packet->data.data(), samples, count * 2 * sizeof(s16));
+
+  m_queue.Commit();
+}
+
+//------------------------------------------------------------------------------
+
+CapturePacket* Recorder::AcquirePacket()
+{
+  CapturePacket* packet = m_queue.Acquire();
+
+  // Queue is full: the writer thread is late, wait instead of dropping data.
+  while (!packet) {
+    m_stalls.fetch_add(1, std::memory_order_relaxed);
+    std::this_thread::yield();
+    packet = m_queue.Acquire();
+  }
+
+  return packet;
+}
+
+//------------------------------------------------------------------------------
+
+void Recorder::Run()
+{
+  for (;;) {
+    // Stop request must be read before checking the queue, so that packets 
+    // committed before the request are always written.
+    bool stop = m_stop.load(std::memory_order_acquire);
+
+    CapturePacket* packet = m_queue.Peek();
+
+    if (!packet) {
+      if (stop) {
+        break;
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    if (packet->type == CapturePacketType::kVideo) {
+      WriteVideoFrame(*packet);
+    } else {
+      WriteAudioBlock(*packet);
+    }
+
+    m_queue.Release();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Recorder::WriteVideoFrame(const CapturePacket& packet)
+{
+  switch (m_video_format) {
+    case VideoFormat::kRaw:
+    {
+      ConvertFrame(packet);
+      fwrite(m_rgb.data(), 1, m_rgb.size(), m_video_file);
+
+      break;
+    }
+    case VideoFormat::kY4m:
+    {
+      ConvertFrame(packet);
+
+      s32 count = m_video_width * m_video_height;
+
+      m_yuv.resize((size_t)count * 3);
+
+      u8* y = &m_yuv[0];
+      u8* u = &m_yuv[count];
+      u8* v = &m_yuv[count * 2];
+      const u8* rgb = m_rgb.data();
+
+      // BT.601 (studio range) conversion.
+      for (s32 i = 0; i < count; i++) {
+        s32 r = rgb[0];
+        s32 g = rgb[1];
+        s32 b = rgb[2];
+        rgb += 3;
+
+        y[i] = (u8)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        u[i] = (u8)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        v[i] = (u8)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+      }
+
+      fwrite("FRAME\n", 1, 6, m_video_file);
+      fwrite(m_yuv.data(), 1, m_yuv.size(), m_video_file);
+
+      break;
+    }
+    case VideoFormat::kDelta:
+    {
+      m_encoded.clear();
+      m_codec.Encode((const PIXEL_OUT_T*)packet.data.data(), packet.width, packet.height, m_encoded,
+        packet.lines.empty() ? nullptr : packet.lines.data());
+      fwrite(m_encoded.data(), 1, m_encoded.size(), m_video_file);
+
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Recorder::WriteAudioBlock(const CapturePacket& packet)
+{
+  // Samples are written in little-endian order.
+  const s16* samples = (const s16*)packet.data.data();
+
+#ifdef LSB_FIRST
+  fwrite(samples, sizeof(s16), packet.count * 2, m_audio_file);
+#else
+  for (s32 i = 0; i < (packet.count * 2); i++) {
+    WriteU16(m_audio_file, (u16)samples[i]);
+  }
+#endif
+
+  m_audio_size += packet.count * 2 * sizeof(s16);
+}
+
+//------------------------------------------------------------------------------
+
+void Recorder::WriteWavHeader()
+{
+  fseek(m_audio_file, 0, SEEK_SET);
+
+  // RIFF chunk.
+  fwrite("RIFF", 1, 4, m_audio_file);
+  WriteU32(m_audio_file, 36 + m_audio_size);
+  fwrite("WAVE", 1, 4, m_audio_file);
+
+  // Format chunk (16-bit stereo PCM).
+  fwrite("fmt ", 1, 4, m_audio_file);
+  WriteU32(m_audio_file, 16);
+  WriteU16(m_audio_file, 1);
+  WriteU16(m_audio_file, 2);
+  WriteU32(m_audio_file, m_sample_rate);
+  WriteU32(m_audio_file, m_sample_rate * 2 * sizeof(s16));
+  WriteU16(m_audio_file, 2 * sizeof(s16));
+  WriteU16(m_audio_file, 16);
+
+  // Data chunk.
+  fwrite("data", 1, 4, m_audio_file);
+  WriteU32(m_audio_file, m_audio_size);
+
+  fseek(m_audio_file, 0, SEEK_END);
+}
+
+//------------------------------------------------------------------------------
+
+void Recorder::ConvertFrame(const CapturePacket& packet)
+{
+  // The size of the stream is the size of the first frame.
+  if (!m_video_width) {
+    m_video_width = packet.width;
+    m_video_height = packet.height;
+
+    if (m_video_format == VideoFormat::kY4m) {
+      fprintf(m_video_file, "YUV4MPEG2 W%d H%d F%u:1000 Ip A1:1 C444\n", m_video_width, m_video_height, (u32)(m_frame_rate * 1000.0 + 0.5));
+    }
+  }
+
+  m_rgb.assign((size_t)m_video_width * m_video_height * 3, 0);
+
+  s32 width = (packet.width < m_video_width) ? packet.width : m_video_width;
+  s32 height = (packet.height < m_video_height) ? packet.height : m_video_height;
+
+  const PIXEL_OUT_T* src = (const PIXEL_OUT_T*)packet.data.data();
+
+  for (s32 y = 0; y < height; y++) {
+    u8* dst = &m_rgb[(size_t)y * m_video_width * 3];
+
+    for (s32 x = 0; x < width; x++) {
+      PixelToRgb(src[x], dst);
+      dst += 3;
+    }
+
+    src += packet.width;
+  }
+}
+
+} // namespace gpgx::capture
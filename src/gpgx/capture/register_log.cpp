@@ -0,0 +1,159 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/capture/register_log.h"
+
+#include <cstdio>
+
+#include "xee/fnd/data_type.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+// RegisterLogWriter
+
+//------------------------------------------------------------------------------
+
+RegisterLogWriter::RegisterLogWriter()
+{
+  m_file = nullptr;
+  m_last_cycles = 0;
+}
+
+//------------------------------------------------------------------------------
+
+RegisterLogWriter::~RegisterLogWriter()
+{
+  Close();
+}
+
+//------------------------------------------------------------------------------
+
+bool RegisterLogWriter::Open(const char* path, u32 clock, u8 psg_type)
+{
+  Close();
+
+  m_file = fopen(path, "wb");
+
+  if (!m_file) {
+    return false;
+  }
+
+  u8 header[kHeaderSize] = {
+    (u8)(kMagic & 0xff), (u8)((kMagic >> 8) & 0xff), (u8)((kMagic >> 16) & 0xff), (u8)((kMagic >> 24) & 0xff),
+    (u8)(clock & 0xff), (u8)((clock >> 8) & 0xff), (u8)((clock >> 16) & 0xff), (u8)((clock >> 24) & 0xff),
+    psg_type, 0, 0, 0, 0, 0, 0, 0
+  };
+
+  fwrite(header, 1, kHeaderSize, m_file);
+
+  m_buffer.clear();
+  m_buffer.reserve(kFlushSize + 64);
+  m_last_cycles = 0;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogWriter::Close()
+{
+  if (!m_file) {
+    return;
+  }
+
+  fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+  fclose(m_file);
+
+  m_file = nullptr;
+  m_buffer.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogWriter::LogFmWrite(RegisterLogChip chip, u32 cycles, u32 address, u32 data)
+{
+  if (chip == RegisterLogChip::kOpn2) {
+    LogEvent((u8)RegisterLogEvent::kOpn2Write | (address & 3), cycles, data);
+  } else {
+    LogEvent((u8)RegisterLogEvent::kOpllWrite | (address & 1), cycles, data);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogWriter::LogFmReset(u32 cycles)
+{
+  LogEvent((u8)RegisterLogEvent::kFmReset, cycles, 0);
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogWriter::LogPsgWrite(u32 cycles, u32 data)
+{
+  LogEvent((u8)RegisterLogEvent::kPsgWrite, cycles, data);
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogWriter::LogPsgConfig(u32 cycles, u32 preamp, u32 panning)
+{
+  LogEvent((u8)RegisterLogEvent::kPsgPreamp, cycles, (preamp > 0xff) ? 0xff : preamp);
+  LogEvent((u8)RegisterLogEvent::kPsgConfig, cycles, panning);
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogWriter::LogEndFrame(u32 cycles)
+{
+  if (!m_file) {
+    return;
+  }
+
+  m_buffer.push_back((u8)RegisterLogEvent::kEndFrame);
+  WriteVarint(cycles);
+
+  m_last_cycles = 0;
+
+  // Events are written to the file once per frame at most.
+  if (m_buffer.size() >= kFlushSize) {
+    fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    m_buffer.clear();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogWriter::LogEvent(u8 opcode, u32 cycles, u32 data)
+{
+  if (!m_file) {
+    return;
+  }
+
+  // Timestamps of CPUs are not strictly increasing (68K and Z80 run one after 
+  // the other), so the difference is signed.
+  s32 delta = (s32)(cycles - m_last_cycles);
+  m_last_cycles = cycles;
+
+  m_buffer.push_back(opcode);
+  WriteVarint(((u32)delta << 1) ^ (u32)(delta >> 31));
+  m_buffer.push_back((u8)data);
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogWriter::WriteVarint(u32 value)
+{
+  // 7 bits per byte, least significant first, bit 7 set when more follow.
+  while (value >= 0x80) {
+    m_buffer.push_back((u8)(value | 0x80));
+    value >>= 7;
+  }
+
+  m_buffer.push_back((u8)value);
+}
+
+} // namespace gpgx::capture
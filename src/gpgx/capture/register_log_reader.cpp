@@ -0,0 +1,152 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/capture/register_log_reader.h"
+
+#include <cstdio>
+
+#include "xee/fnd/data_type.h"
+
+#include "gpgx/capture/register_log.h"
+
+namespace gpgx::capture {
+
+//==============================================================================
+// RegisterLogReader
+
+//------------------------------------------------------------------------------
+
+RegisterLogReader::RegisterLogReader()
+{
+  m_pos = 0;
+  m_clock = 0;
+  m_psg_type = 0;
+  m_last_cycles = 0;
+}
+
+//------------------------------------------------------------------------------
+
+bool RegisterLogReader::Open(const char* path)
+{
+  FILE* file = fopen(path, "rb");
+
+  if (!file) {
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  if (size < RegisterLogWriter::kHeaderSize) {
+    fclose(file);
+    return false;
+  }
+
+  m_data.resize(size);
+  size_t read = fread(m_data.data(), 1, size, file);
+  fclose(file);
+
+  if (read != (size_t)size) {
+    return false;
+  }
+
+  u32 magic = m_data[0] | (m_data[1] << 8) | (m_data[2] << 16) | ((u32)m_data[3] << 24);
+
+  if (magic != RegisterLogWriter::kMagic) {
+    return false;
+  }
+
+  m_clock = m_data[4] | (m_data[5] << 8) | (m_data[6] << 16) | ((u32)m_data[7] << 24);
+  m_psg_type = m_data[8];
+
+  Rewind();
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+void RegisterLogReader::Rewind()
+{
+  m_pos = RegisterLogWriter::kHeaderSize;
+  m_last_cycles = 0;
+}
+
+//------------------------------------------------------------------------------
+
+bool RegisterLogReader::Next(RegisterLogEntry& entry)
+{
+  if (m_pos >= m_data.size()) {
+    return false;
+  }
+
+  u8 opcode = m_data[m_pos++];
+  u32 value = 0;
+
+  if (!ReadVarint(value)) {
+    return false;
+  }
+
+  if (opcode == (u8)RegisterLogEvent::kEndFrame) {
+    entry.event = RegisterLogEvent::kEndFrame;
+    entry.cycles = value;
+    entry.address = 0;
+    entry.data = 0;
+
+    m_last_cycles = 0;
+
+    return true;
+  }
+
+  if (m_pos >= m_data.size()) {
+    return false;
+  }
+
+  // Decode the (zigzag encoded) timestamp difference.
+  s32 delta = (s32)(value >> 1) ^ -(s32)(value & 1);
+  m_last_cycles += delta;
+
+  entry.cycles = m_last_cycles;
+  entry.data = m_data[m_pos++];
+
+  if ((opcode & 0xfc) == (u8)RegisterLogEvent::kOpn2Write) {
+    entry.event = RegisterLogEvent::kOpn2Write;
+    entry.address = opcode & 3;
+  } else if ((opcode & 0xfe) == (u8)RegisterLogEvent::kOpllWrite) {
+    entry.event = RegisterLogEvent::kOpllWrite;
+    entry.address = opcode & 1;
+  } else {
+    entry.event = (RegisterLogEvent)opcode;
+    entry.address = 0;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool RegisterLogReader::ReadVarint(u32& value)
+{
+  value = 0;
+
+  for (s32 shift = 0; shift < 35; shift += 7) {
+    if (m_pos >= m_data.size()) {
+      return false;
+    }
+
+    u8 byte = m_data[m_pos++];
+    value |= (u32)(byte & 0x7f) << shift;
+
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace gpgx::capture
@@ -0,0 +1,109 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/cd_stream.h"
+
+#include <cstdio>
+
+#include "gpgx/cd/compressed_cd_stream.h"
+#include "gpgx/cd/file_cd_stream.h"
+#include "gpgx/cd/mapped_cd_stream.h"
+#include "gpgx/cd/read_ahead_cd_stream.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+// ICdStream
+
+//------------------------------------------------------------------------------
+
+size_t ICdStream::ReadAt(s64 offset, void* dst, size_t size)
+{
+  if (Seek(offset, SEEK_SET)) {
+    return 0;
+  }
+
+  return Read(dst, 1, size);
+}
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+static ICdStream* OpenFile(const char* path, CdStreamType type)
+{
+  switch (type) {
+    case CdStreamType::kMapped:
+    {
+      MappedCdStream* stream = new MappedCdStream();
+
+      if (stream->Open(path)) {
+        return stream;
+      }
+
+      delete stream;
+      break;
+    }
+
+    case CdStreamType::kReadAhead:
+    {
+      ReadAheadCdStream* stream = new ReadAheadCdStream();
+
+      if (stream->Open(path)) {
+        return stream;
+      }
+
+      delete stream;
+      break;
+    }
+
+    default:
+    {
+      break;
+    }
+  }
+
+  FileCdStream* stream = new FileCdStream();
+
+  if (stream->Open(path)) {
+    return stream;
+  }
+
+  delete stream;
+
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+ICdStream* OpenCdStream(const char* path, CdStreamType type)
+{
+  ICdStream* source = OpenFile(path, type);
+
+  if (!source || !CompressedCdStream::IsCompressed(source)) {
+    return source;
+  }
+
+  // Compressed disc image.
+  CompressedCdStream* stream = new CompressedCdStream();
+
+  if (stream->Open(source)) {
+    return stream;
+  }
+
+  delete stream;
+
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+void CloseCdStream(ICdStream* stream)
+{
+  delete stream;
+}
+
+} // namespace gpgx::cd
@@ -0,0 +1,236 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/cdda_decoder.h"
+
+#include "xee/mem/memory.h" // For Memcpy().
+
+namespace gpgx::cd {
+
+//==============================================================================
+// CddaDecoder
+
+//------------------------------------------------------------------------------
+
+CddaDecoder::CddaDecoder() :
+  m_read_index(0),
+  m_fill(0),
+  m_source(nullptr),
+  m_offset(0),
+  m_generation(0),
+  m_end(false),
+  m_failed(false),
+  m_stop(false)
+{
+  m_buffer.resize(kBufferSize);
+}
+
+//------------------------------------------------------------------------------
+
+CddaDecoder::~CddaDecoder()
+{
+  Close();
+}
+
+//------------------------------------------------------------------------------
+
+void CddaDecoder::Open()
+{
+  if (m_worker.joinable()) {
+    return;
+  }
+
+  m_stop = false;
+  m_worker = std::thread(&CddaDecoder::Run, this);
+}
+
+//------------------------------------------------------------------------------
+
+void CddaDecoder::Close()
+{
+  if (m_worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+
+    m_worker_cv.notify_all();
+    m_worker.join();
+  }
+
+  CloseWorkerStreams();
+
+  m_read_index = 0;
+  m_fill = 0;
+  m_source = nullptr;
+  m_offset = 0;
+  m_generation++;
+  m_end = false;
+  m_failed = false;
+}
+
+//------------------------------------------------------------------------------
+
+void CddaDecoder::Seek(ICdStream* stream, s64 offset)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Forward seek within the buffered data (e.g. next track in the same file).
+    if ((stream == m_source) && (offset >= m_offset) && (offset <= (m_offset + m_fill))) {
+      s32 skipped = (s32)(offset - m_offset);
+
+      m_read_index = (m_read_index + skipped) % kBufferSize;
+      m_fill -= skipped;
+      m_offset = offset;
+    } else {
+      m_read_index = 0;
+      m_fill = 0;
+      m_source = stream;
+      m_offset = offset;
+      m_generation++;
+      m_end = false;
+      m_failed = false;
+    }
+  }
+
+  m_worker_cv.notify_one();
+}
+
+//------------------------------------------------------------------------------
+
+s64 CddaDecoder::Tell()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_offset;
+}
+
+//------------------------------------------------------------------------------
+
+size_t CddaDecoder::Read(void* dst, size_t size)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  if (!m_source || (m_offset < 0)) {
+    return 0;
+  }
+
+  // Wait for the worker (after a seek or if the worker is late).
+  while (m_worker.joinable() && !m_failed && !m_end && ((size_t)m_fill < size)) {
+    m_worker_cv.notify_one();
+    m_reader_cv.wait(lock);
+  }
+
+  if (!m_worker.joinable() || m_failed) {
+    // Synchronous read.
+    size_t read = m_source->ReadAt(m_offset, dst, size);
+
+    m_offset += read;
+
+    return read;
+  }
+
+  size_t read = ((size_t)m_fill < size) ? (size_t)m_fill : size;
+  size_t first = (size_t)(kBufferSize - m_read_index);
+
+  if (first > read) {
+    first = read;
+  }
+
+  xee::mem::Memcpy(dst, &m_buffer[m_read_index], first);
+  xee::mem::Memcpy((u8*)dst + first, &m_buffer[0], read - first);
+
+  m_read_index = (s32)((m_read_index + read) % kBufferSize);
+  m_fill -= (s32)read;
+  m_offset += read;
+
+  lock.unlock();
+  m_worker_cv.notify_one();
+
+  return read;
+}
+
+//------------------------------------------------------------------------------
+
+ICdStream* CddaDecoder::GetWorkerStream(ICdStream* source)
+{
+  for (const WorkerStream& worker_stream : m_streams) {
+    if (worker_stream.source == source) {
+      return worker_stream.stream;
+    }
+  }
+
+  m_streams.push_back({ source, source->Clone() });
+
+  return m_streams.back().stream;
+}
+
+//------------------------------------------------------------------------------
+
+void CddaDecoder::CloseWorkerStreams()
+{
+  for (const WorkerStream& worker_stream : m_streams) {
+    CloseCdStream(worker_stream.stream);
+  }
+
+  m_streams.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void CddaDecoder::Run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  for (;;) {
+    if (m_stop) {
+      break;
+    }
+
+    if (!m_source || m_failed || m_end || (m_fill == kBufferSize) || (m_offset < 0)) {
+      m_worker_cv.wait(lock);
+      continue;
+    }
+
+    // The free part of the buffer is not accessed by the emulation thread.
+    u32 generation = m_generation;
+    ICdStream* source = m_source;
+    s64 offset = m_offset + m_fill;
+    s32 write_index = (m_read_index + m_fill) % kBufferSize;
+    s32 size = kBufferSize - m_fill;
+
+    if (size > (kBufferSize - write_index)) {
+      size = kBufferSize - write_index;
+    }
+
+    if (size > kChunkSize) {
+      size = kChunkSize;
+    }
+
+    lock.unlock();
+
+    // The streams of the worker are only accessed by the worker.
+    ICdStream* stream = GetWorkerStream(source);
+    size_t read = stream ? stream->ReadAt(offset, &m_buffer[write_index], size) : 0;
+
+    lock.lock();
+
+    // Discarded if a seek occurred meanwhile.
+    if (generation == m_generation) {
+      if (!stream) {
+        m_failed = true;
+      } else {
+        m_fill += (s32)read;
+        m_end = (read < (size_t)size);
+      }
+
+      m_reader_cv.notify_all();
+    }
+  }
+}
+
+} // namespace gpgx::cd
@@ -0,0 +1,294 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/compressed_cd_stream.h"
+
+#include <cstdio>
+
+#include "xee/mem/memory.h" // For Memcpy().
+
+#include "gpgx/cd/hunk_codec.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+static u32 ReadU32(const u8* src)
+{
+  return src[0] | (src[1] << 8) | (src[2] << 16) | ((u32)src[3] << 24);
+}
+
+//------------------------------------------------------------------------------
+
+static u64 ReadU64(const u8* src)
+{
+  return ReadU32(src) | ((u64)ReadU32(src + 4) << 32);
+}
+
+//==============================================================================
+// CompressedCdStream
+
+//------------------------------------------------------------------------------
+
+CompressedCdStream::CompressedCdStream() :
+  m_source(nullptr),
+  m_hunk_size(0),
+  m_hunk_count(0),
+  m_size(0),
+  m_position(0),
+  m_stamp(0)
+{
+  for (CachedHunk& hunk : m_cache) {
+    hunk.index = -1;
+    hunk.stamp = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+CompressedCdStream::~CompressedCdStream()
+{
+  CloseCdStream(m_source);
+}
+
+//------------------------------------------------------------------------------
+
+bool CompressedCdStream::IsCompressed(ICdStream* source)
+{
+  u8 magic[4];
+
+  bool compressed = (source->ReadAt(0, magic, 4) == 4) && (ReadU32(magic) == kMagic);
+
+  source->Seek(0, SEEK_SET);
+
+  return compressed;
+}
+
+//------------------------------------------------------------------------------
+
+bool CompressedCdStream::Open(ICdStream* source)
+{
+  CloseCdStream(m_source);
+  m_source = source;
+
+  u8 header[kHeaderSize];
+
+  if (m_source->ReadAt(0, header, kHeaderSize) != kHeaderSize) {
+    return false;
+  }
+
+  u16 version = header[4] | (header[5] << 8);
+
+  m_hunk_size = ReadU32(&header[8]);
+  m_hunk_count = ReadU32(&header[12]);
+  m_size = (s64)ReadU64(&header[16]);
+  m_position = 0;
+
+  if ((ReadU32(header) != kMagic) || (version != kVersion) ||
+    !m_hunk_size || (m_hunk_size > kMaxHunkSize) || (m_size < 0) ||
+    (m_hunk_count != (u64)((m_size + m_hunk_size - 1) / m_hunk_size))) {
+    return false;
+  }
+
+  // Hunk index.
+  std::vector<u8> index((size_t)m_hunk_count * kIndexEntrySize);
+
+  if (m_source->Read(index.data(), 1, index.size()) != index.size()) {
+    return false;
+  }
+
+  m_offsets.resize(m_hunk_count);
+  m_sizes.resize(m_hunk_count);
+
+  for (u32 i = 0; i < m_hunk_count; i++) {
+    m_offsets[i] = ReadU64(&index[i * kIndexEntrySize]);
+    m_sizes[i] = ReadU32(&index[(i * kIndexEntrySize) + 8]);
+
+    if (m_sizes[i] > (u32)HunkCodec::GetMaxCompressedSize(m_hunk_size)) {
+      return false;
+    }
+  }
+
+  m_buffer.resize(HunkCodec::GetMaxCompressedSize(m_hunk_size));
+
+  for (CachedHunk& hunk : m_cache) {
+    hunk.index = -1;
+    hunk.data.resize(m_hunk_size);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+size_t CompressedCdStream::Read(void* dst, size_t size, size_t count)
+{
+  if (!size || (m_position >= m_size)) {
+    return 0;
+  }
+
+  size_t available = (size_t)(m_size - m_position);
+  size_t bytes = size * count;
+
+  if (bytes > available) {
+    bytes = available;
+  }
+
+  u8* out = (u8*)dst;
+  size_t copied = 0;
+
+  while (copied < bytes) {
+    u32 index = (u32)(m_position / m_hunk_size);
+    u32 offset = (u32)(m_position % m_hunk_size);
+    const u8* hunk = GetHunk(index);
+
+    if (!hunk) {
+      break;
+    }
+
+    size_t length = m_hunk_size - offset;
+
+    if (length > (bytes - copied)) {
+      length = bytes - copied;
+    }
+
+    xee::mem::Memcpy(out + copied, hunk + offset, length);
+
+    m_position += length;
+    copied += length;
+  }
+
+  return copied / size;
+}
+
+//------------------------------------------------------------------------------
+
+s32 CompressedCdStream::Seek(s64 offset, s32 origin)
+{
+  switch (origin) {
+    case SEEK_CUR: offset += m_position; break;
+    case SEEK_END: offset += m_size; break;
+    default: break;
+  }
+
+  if (offset < 0) {
+    return -1;
+  }
+
+  m_position = offset;
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+
+s64 CompressedCdStream::Tell()
+{
+  return m_position;
+}
+
+//------------------------------------------------------------------------------
+
+char* CompressedCdStream::Gets(char* dst, s32 size)
+{
+  if ((size <= 0) || (m_position >= m_size)) {
+    return nullptr;
+  }
+
+  s32 i = 0;
+  char c = 0;
+
+  while ((i < (size - 1)) && Read(&c, 1, 1)) {
+    dst[i++] = c;
+
+    if (c == '\n') {
+      break;
+    }
+  }
+
+  dst[i] = 0;
+
+  return dst;
+}
+
+//------------------------------------------------------------------------------
+
+ICdStream* CompressedCdStream::Clone()
+{
+  ICdStream* source = m_source->Clone();
+
+  if (!source) {
+    return nullptr;
+  }
+
+  CompressedCdStream* stream = new CompressedCdStream();
+
+  if (stream->Open(source)) {
+    return stream;
+  }
+
+  delete stream;
+
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+const u8* CompressedCdStream::GetHunk(u32 index)
+{
+  if (index >= m_hunk_count) {
+    return nullptr;
+  }
+
+  m_stamp++;
+
+  // Cached hunk ?
+  CachedHunk* victim = &m_cache[0];
+
+  for (CachedHunk& hunk : m_cache) {
+    if (hunk.index == index) {
+      hunk.stamp = m_stamp;
+      return hunk.data.data();
+    }
+
+    if ((hunk.index < 0) || ((victim->index >= 0) && (hunk.stamp < victim->stamp))) {
+      victim = &hunk;
+    }
+  }
+
+  // Read and decompress the least recently used hunk.
+  u32 length = m_hunk_size;
+
+  if (index == (m_hunk_count - 1)) {
+    // Last hunk.
+    length = (u32)(m_size - ((s64)index * m_hunk_size));
+  }
+
+  u32 stored = m_sizes[index];
+
+  victim->index = -1;
+
+  if (stored == length) {
+    // Not compressed.
+    if (m_source->ReadAt((s64)m_offsets[index], victim->data.data(), length) != length) {
+      return nullptr;
+    }
+  } else {
+    if ((m_source->ReadAt((s64)m_offsets[index], m_buffer.data(), stored) != stored) ||
+      !HunkCodec::Decompress(m_buffer.data(), stored, victim->data.data(), length)) {
+      return nullptr;
+    }
+  }
+
+  victim->index = index;
+  victim->stamp = m_stamp;
+
+  return victim->data.data();
+}
+
+} // namespace gpgx::cd
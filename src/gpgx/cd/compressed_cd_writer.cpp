@@ -0,0 +1,158 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/compressed_cd_writer.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "gpgx/cd/compressed_cd_stream.h"
+#include "gpgx/cd/hunk_codec.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+static void WriteU32(u8* dst, u32 data)
+{
+  dst[0] = (u8)(data & 0xFF);
+  dst[1] = (u8)((data >> 8) & 0xFF);
+  dst[2] = (u8)((data >> 16) & 0xFF);
+  dst[3] = (u8)(data >> 24);
+}
+
+//------------------------------------------------------------------------------
+
+static void WriteU64(u8* dst, u64 data)
+{
+  WriteU32(dst, (u32)data);
+  WriteU32(dst + 4, (u32)(data >> 32));
+}
+
+//==============================================================================
+// CompressedCdWriter
+
+//------------------------------------------------------------------------------
+
+CompressedCdWriter::CompressedCdWriter() :
+  m_hunk_size(CompressedCdStream::kHunkSize),
+  m_input_size(0),
+  m_output_size(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void CompressedCdWriter::SetHunkSize(u32 hunk_size)
+{
+  if (!hunk_size) {
+    hunk_size = CompressedCdStream::kHunkSize;
+  } else if (hunk_size > CompressedCdStream::kMaxHunkSize) {
+    hunk_size = CompressedCdStream::kMaxHunkSize;
+  }
+
+  m_hunk_size = hunk_size;
+}
+
+//------------------------------------------------------------------------------
+
+bool CompressedCdWriter::Write(const char* src_path, const char* dst_path)
+{
+  m_input_size = 0;
+  m_output_size = 0;
+
+  FILE* src = fopen(src_path, "rb");
+
+  if (!src) {
+    return false;
+  }
+
+  FILE* dst = fopen(dst_path, "wb");
+
+  if (!dst) {
+    fclose(src);
+    return false;
+  }
+
+  fseek(src, 0, SEEK_END);
+  s64 size = ftell(src);
+  fseek(src, 0, SEEK_SET);
+
+  u32 hunk_count = (u32)((size + m_hunk_size - 1) / m_hunk_size);
+
+  // Header.
+  u8 header[CompressedCdStream::kHeaderSize] = { 0 };
+
+  WriteU32(&header[0], CompressedCdStream::kMagic);
+  header[4] = (u8)(CompressedCdStream::kVersion & 0xFF);
+  header[5] = (u8)(CompressedCdStream::kVersion >> 8);
+  WriteU32(&header[8], m_hunk_size);
+  WriteU32(&header[12], hunk_count);
+  WriteU64(&header[16], (u64)size);
+
+  // Index (written once the hunks are stored).
+  std::vector<u8> index((size_t)hunk_count * CompressedCdStream::kIndexEntrySize, 0);
+
+  bool ok = (fwrite(header, 1, sizeof(header), dst) == sizeof(header)) &&
+    (fwrite(index.data(), 1, index.size(), dst) == index.size());
+
+  // Hunks.
+  std::vector<u8> hunk(m_hunk_size);
+  std::vector<u8> compressed(HunkCodec::GetMaxCompressedSize(m_hunk_size));
+  u64 offset = CompressedCdStream::kHeaderSize + index.size();
+
+  for (u32 i = 0; ok && (i < hunk_count); i++) {
+    u32 length = m_hunk_size;
+
+    if (i == (hunk_count - 1)) {
+      length = (u32)(size - ((s64)i * m_hunk_size));
+    }
+
+    if (fread(hunk.data(), 1, length, src) != length) {
+      ok = false;
+      break;
+    }
+
+    // Stored without compression unless it is smaller.
+    const u8* data = hunk.data();
+    u32 stored = (u32)HunkCodec::Compress(hunk.data(), length, compressed.data());
+
+    if (stored >= length) {
+      stored = length;
+    } else {
+      data = compressed.data();
+    }
+
+    ok = (fwrite(data, 1, stored, dst) == stored);
+
+    WriteU64(&index[i * CompressedCdStream::kIndexEntrySize], offset);
+    WriteU32(&index[(i * CompressedCdStream::kIndexEntrySize) + 8], stored);
+
+    offset += stored;
+  }
+
+  if (ok) {
+    ok = !fseek(dst, CompressedCdStream::kHeaderSize, SEEK_SET) &&
+      (fwrite(index.data(), 1, index.size(), dst) == index.size());
+  }
+
+  fclose(src);
+
+  if (fclose(dst)) {
+    ok = false;
+  }
+
+  if (ok) {
+    m_input_size = size;
+    m_output_size = (s64)offset;
+  }
+
+  return ok;
+}
+
+} // namespace gpgx::cd
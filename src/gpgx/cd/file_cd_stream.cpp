@@ -0,0 +1,83 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/file_cd_stream.h"
+
+namespace gpgx::cd {
+
+//==============================================================================
+// FileCdStream
+
+//------------------------------------------------------------------------------
+
+FileCdStream::FileCdStream() :
+  m_file(nullptr)
+{
+}
+
+//------------------------------------------------------------------------------
+
+FileCdStream::~FileCdStream()
+{
+  if (m_file) {
+    fclose(m_file);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+bool FileCdStream::Open(const char* path)
+{
+  m_file = fopen(path, "rb");
+  m_path = path;
+
+  return m_file != nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+size_t FileCdStream::Read(void* dst, size_t size, size_t count)
+{
+  return fread(dst, size, count, m_file);
+}
+
+//------------------------------------------------------------------------------
+
+s32 FileCdStream::Seek(s64 offset, s32 origin)
+{
+  return fseek(m_file, (long)offset, origin);
+}
+
+//------------------------------------------------------------------------------
+
+s64 FileCdStream::Tell()
+{
+  return ftell(m_file);
+}
+
+//------------------------------------------------------------------------------
+
+char* FileCdStream::Gets(char* dst, s32 size)
+{
+  return fgets(dst, size, m_file);
+}
+
+//------------------------------------------------------------------------------
+
+ICdStream* FileCdStream::Clone()
+{
+  FileCdStream* stream = new FileCdStream();
+
+  if (stream->Open(m_path.c_str())) {
+    return stream;
+  }
+
+  delete stream;
+
+  return nullptr;
+}
+
+} // namespace gpgx::cd
@@ -0,0 +1,197 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/hunk_codec.h"
+
+#include "xee/mem/memory.h" // For Memcpy().
+
+namespace gpgx::cd {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Number of bits of the hash table index.
+static constexpr s32 kHashBits = 12;
+
+//------------------------------------------------------------------------------
+
+static u32 Read32(const u8* src)
+{
+  return src[0] | (src[1] << 8) | (src[2] << 16) | ((u32)src[3] << 24);
+}
+
+//------------------------------------------------------------------------------
+
+static u8* WriteLength(u8* dst, s32 length)
+{
+  while (length >= 255) {
+    *dst++ = 255;
+    length -= 255;
+  }
+
+  *dst++ = (u8)length;
+
+  return dst;
+}
+
+//==============================================================================
+// HunkCodec
+
+//------------------------------------------------------------------------------
+
+s32 HunkCodec::Compress(const u8* src, s32 size, u8* dst)
+{
+  s32 table[1 << kHashBits];
+
+  for (s32& position : table) {
+    position = -1;
+  }
+
+  u8* out = dst;
+  s32 ip = 0;
+  s32 anchor = 0;
+
+  while ((ip + kMinMatch) <= size) {
+    u32 sequence = Read32(&src[ip]);
+    u32 hash = (sequence * 2654435761u) >> (32 - kHashBits);
+    s32 ref = table[hash];
+
+    table[hash] = ip;
+
+    if ((ref < 0) || ((ip - ref) > kMaxOffset) || (Read32(&src[ref]) != sequence)) {
+      ip++;
+      continue;
+    }
+
+    // Match length.
+    s32 length = kMinMatch;
+
+    while (((ip + length) < size) && (src[ref + length] == src[ip + length])) {
+      length++;
+    }
+
+    // Sequence.
+    s32 literals = ip - anchor;
+    s32 extra = length - kMinMatch;
+
+    *out++ = (u8)(((literals < 15 ? literals : 15) << 4) | (extra < 15 ? extra : 15));
+
+    if (literals >= 15) {
+      out = WriteLength(out, literals - 15);
+    }
+
+    xee::mem::Memcpy(out, &src[anchor], literals);
+    out += literals;
+
+    *out++ = (u8)((ip - ref) & 0xFF);
+    *out++ = (u8)((ip - ref) >> 8);
+
+    if (extra >= 15) {
+      out = WriteLength(out, extra - 15);
+    }
+
+    ip += length;
+    anchor = ip;
+  }
+
+  // Last literals.
+  s32 literals = size - anchor;
+
+  *out++ = (u8)((literals < 15 ? literals : 15) << 4);
+
+  if (literals >= 15) {
+    out = WriteLength(out, literals - 15);
+  }
+
+  xee::mem::Memcpy(out, &src[anchor], literals);
+  out += literals;
+
+  return (s32)(out - dst);
+}
+
+//------------------------------------------------------------------------------
+
+bool HunkCodec::Decompress(const u8* src, s32 size, u8* dst, s32 dst_size)
+{
+  s32 ip = 0;
+  s32 op = 0;
+
+  while (ip < size) {
+    u8 token = src[ip++];
+
+    // Literals.
+    s32 literals = token >> 4;
+
+    if (literals == 15) {
+      u8 data;
+
+      do {
+        if (ip >= size) {
+          return false;
+        }
+
+        data = src[ip++];
+        literals += data;
+      } while (data == 255);
+    }
+
+    if ((literals > (size - ip)) || (literals > (dst_size - op))) {
+      return false;
+    }
+
+    xee::mem::Memcpy(&dst[op], &src[ip], literals);
+    ip += literals;
+    op += literals;
+
+    // Last sequence.
+    if (ip == size) {
+      break;
+    }
+
+    // Match.
+    if ((ip + 2) > size) {
+      return false;
+    }
+
+    s32 offset = src[ip] | (src[ip + 1] << 8);
+    ip += 2;
+
+    s32 length = token & 0x0F;
+
+    if (length == 15) {
+      u8 data;
+
+      do {
+        if (ip >= size) {
+          return false;
+        }
+
+        data = src[ip++];
+        length += data;
+      } while (data == 255);
+    }
+
+    length += kMinMatch;
+
+    if (!offset || (offset > op) || (length > (dst_size - op))) {
+      return false;
+    }
+
+    // Overlapping copy (repeated pattern when offset < length).
+    const u8* ref = &dst[op - offset];
+
+    for (s32 i = 0; i < length; i++) {
+      dst[op + i] = ref[i];
+    }
+
+    op += length;
+  }
+
+  return op == dst_size;
+}
+
+} // namespace gpgx::cd
@@ -0,0 +1,261 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/mapped_cd_stream.h"
+
+#include <cstdint>
+#include <cstdio>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // #if defined(_WIN32)
+
+#include "xee/mem/memory.h" // For Memcpy().
+
+namespace gpgx::cd {
+
+//==============================================================================
+// MappedCdStream
+
+//------------------------------------------------------------------------------
+
+MappedCdStream::MappedCdStream() :
+  m_data(nullptr),
+  m_size(0),
+  m_position(0)
+#if defined(_WIN32)
+  ,
+  m_file(INVALID_HANDLE_VALUE),
+  m_mapping(nullptr)
+#endif // #if defined(_WIN32)
+{
+}
+
+//------------------------------------------------------------------------------
+
+MappedCdStream::~MappedCdStream()
+{
+  Close();
+}
+
+//------------------------------------------------------------------------------
+
+bool MappedCdStream::Open(const char* path)
+{
+  Close();
+
+#if defined(_WIN32)
+  m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if (m_file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER size;
+
+  if (!GetFileSizeEx(m_file, &size) || !size.QuadPart || ((u64)size.QuadPart > (u64)SIZE_MAX)) {
+    Close();
+    return false;
+  }
+
+  m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if (!m_mapping) {
+    Close();
+    return false;
+  }
+
+  m_data = (const u8*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+
+  if (!m_data) {
+    Close();
+    return false;
+  }
+
+  m_size = size.QuadPart;
+#else
+  int fd = open(path, O_RDONLY);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+
+  if ((fstat(fd, &st) < 0) || (st.st_size <= 0) || ((u64)st.st_size > (u64)SIZE_MAX)) {
+    close(fd);
+    return false;
+  }
+
+  void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping is kept after the file descriptor is closed.
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  m_data = (const u8*)data;
+  m_size = st.st_size;
+#endif // #if defined(_WIN32)
+
+  m_position = 0;
+  m_path = path;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+void MappedCdStream::Close()
+{
+#if defined(_WIN32)
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+  }
+
+  if (m_mapping) {
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+  }
+
+  if (m_file != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_file);
+    m_file = INVALID_HANDLE_VALUE;
+  }
+#else
+  if (m_data) {
+    munmap((void*)m_data, (size_t)m_size);
+  }
+#endif // #if defined(_WIN32)
+
+  m_data = nullptr;
+  m_size = 0;
+  m_position = 0;
+}
+
+//------------------------------------------------------------------------------
+
+size_t MappedCdStream::Read(void* dst, size_t size, size_t count)
+{
+  if (!size || (m_position >= m_size)) {
+    return 0;
+  }
+
+  // Complete items only (the position is moved after the bytes read, as
+  // fread() does with a partial item).
+  size_t available = (size_t)(m_size - m_position);
+  size_t bytes = size * count;
+
+  if (bytes > available) {
+    bytes = available;
+  }
+
+  xee::mem::Memcpy(dst, &m_data[m_position], bytes);
+  m_position += bytes;
+
+  return bytes / size;
+}
+
+//------------------------------------------------------------------------------
+
+s32 MappedCdStream::Seek(s64 offset, s32 origin)
+{
+  switch (origin) {
+    case SEEK_CUR: offset += m_position; break;
+    case SEEK_END: offset += m_size; break;
+    default: break;
+  }
+
+  if (offset < 0) {
+    return -1;
+  }
+
+  m_position = offset;
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+
+s64 MappedCdStream::Tell()
+{
+  return m_position;
+}
+
+//------------------------------------------------------------------------------
+
+char* MappedCdStream::Gets(char* dst, s32 size)
+{
+  if ((size <= 0) || (m_position >= m_size)) {
+    return nullptr;
+  }
+
+  s32 i = 0;
+
+  while ((i < (size - 1)) && (m_position < m_size)) {
+    char c = (char)m_data[m_position++];
+    dst[i++] = c;
+
+    if (c == '\n') {
+      break;
+    }
+  }
+
+  dst[i] = 0;
+
+  return dst;
+}
+
+//------------------------------------------------------------------------------
+
+size_t MappedCdStream::ReadAt(s64 offset, void* dst, size_t size)
+{
+  if (offset < 0) {
+    return 0;
+  }
+
+  m_position = offset;
+
+  if (offset >= m_size) {
+    return 0;
+  }
+
+  size_t available = (size_t)(m_size - offset);
+
+  if (size > available) {
+    size = available;
+  }
+
+  xee::mem::Memcpy(dst, &m_data[offset], size);
+  m_position = offset + size;
+
+  return size;
+}
+
+//------------------------------------------------------------------------------
+
+ICdStream* MappedCdStream::Clone()
+{
+  MappedCdStream* stream = new MappedCdStream();
+
+  if (stream->Open(m_path.c_str())) {
+    return stream;
+  }
+
+  delete stream;
+
+  return nullptr;
+}
+
+} // namespace gpgx::cd
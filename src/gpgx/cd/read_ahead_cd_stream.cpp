@@ -0,0 +1,328 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/read_ahead_cd_stream.h"
+
+#include "xee/mem/memory.h" // For Memcpy().
+
+namespace gpgx::cd {
+
+//==============================================================================
+// ReadAheadCdStream
+
+//------------------------------------------------------------------------------
+
+ReadAheadCdStream::ReadAheadCdStream() :
+  m_file(nullptr),
+  m_worker_file(nullptr),
+  m_size(0),
+  m_position(0),
+  m_stop(false)
+{
+  for (Block& block : m_blocks) {
+    block.offset = 0;
+    block.size = 0;
+    block.state = BlockState::kEmpty;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+ReadAheadCdStream::~ReadAheadCdStream()
+{
+  Close();
+}
+
+//------------------------------------------------------------------------------
+
+bool ReadAheadCdStream::Open(const char* path)
+{
+  Close();
+
+  m_file = fopen(path, "rb");
+  m_worker_file = fopen(path, "rb");
+
+  if (!m_file || !m_worker_file) {
+    Close();
+    return false;
+  }
+
+  fseek(m_file, 0, SEEK_END);
+  m_size = ftell(m_file);
+  fseek(m_file, 0, SEEK_SET);
+  m_position = 0;
+  m_path = path;
+
+  for (Block& block : m_blocks) {
+    block.data.resize(kBlockSize);
+  }
+
+  m_stop = false;
+  m_worker = std::thread(&ReadAheadCdStream::Run, this);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+void ReadAheadCdStream::Close()
+{
+  if (m_worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+
+    m_cv.notify_all();
+    m_worker.join();
+  }
+
+  if (m_file) {
+    fclose(m_file);
+    m_file = nullptr;
+  }
+
+  if (m_worker_file) {
+    fclose(m_worker_file);
+    m_worker_file = nullptr;
+  }
+
+  for (Block& block : m_blocks) {
+    block.state = BlockState::kEmpty;
+  }
+
+  m_size = 0;
+  m_position = 0;
+}
+
+//------------------------------------------------------------------------------
+
+size_t ReadAheadCdStream::Read(void* dst, size_t size, size_t count)
+{
+  if (!size || (m_position >= m_size)) {
+    return 0;
+  }
+
+  size_t available = (size_t)(m_size - m_position);
+  size_t bytes = size * count;
+
+  if (bytes > available) {
+    bytes = available;
+  }
+
+  size_t copied = CopyFromBlocks((u8*)dst, bytes);
+
+  if (copied < bytes) {
+    // Not loaded yet: synchronous read.
+    fseek(m_file, (long)m_position, SEEK_SET);
+
+    size_t read = fread((u8*)dst + copied, 1, bytes - copied, m_file);
+
+    m_position += read;
+    copied += read;
+  }
+
+  RequestBlocks();
+
+  return copied / size;
+}
+
+//------------------------------------------------------------------------------
+
+s32 ReadAheadCdStream::Seek(s64 offset, s32 origin)
+{
+  switch (origin) {
+    case SEEK_CUR: offset += m_position; break;
+    case SEEK_END: offset += m_size; break;
+    default: break;
+  }
+
+  if (offset < 0) {
+    return -1;
+  }
+
+  m_position = offset;
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+
+s64 ReadAheadCdStream::Tell()
+{
+  return m_position;
+}
+
+//------------------------------------------------------------------------------
+
+char* ReadAheadCdStream::Gets(char* dst, s32 size)
+{
+  if ((size <= 0) || (m_position >= m_size)) {
+    return nullptr;
+  }
+
+  s32 i = 0;
+  char c = 0;
+
+  while ((i < (size - 1)) && Read(&c, 1, 1)) {
+    dst[i++] = c;
+
+    if (c == '\n') {
+      break;
+    }
+  }
+
+  dst[i] = 0;
+
+  return dst;
+}
+
+//------------------------------------------------------------------------------
+
+ICdStream* ReadAheadCdStream::Clone()
+{
+  ReadAheadCdStream* stream = new ReadAheadCdStream();
+
+  if (stream->Open(m_path.c_str())) {
+    return stream;
+  }
+
+  delete stream;
+
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+size_t ReadAheadCdStream::CopyFromBlocks(u8* dst, size_t size)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  size_t copied = 0;
+
+  while (copied < size) {
+    const Block* found = nullptr;
+
+    for (const Block& block : m_blocks) {
+      if ((block.state == BlockState::kReady) &&
+        (m_position >= block.offset) && (m_position < (block.offset + block.size))) {
+        found = &block;
+        break;
+      }
+    }
+
+    if (!found) {
+      break;
+    }
+
+    size_t offset = (size_t)(m_position - found->offset);
+    size_t length = found->size - offset;
+
+    if (length > (size - copied)) {
+      length = size - copied;
+    }
+
+    xee::mem::Memcpy(dst + copied, &found->data[offset], length);
+
+    m_position += length;
+    copied += length;
+  }
+
+  return copied;
+}
+
+//------------------------------------------------------------------------------
+
+void ReadAheadCdStream::RequestBlocks()
+{
+  s64 first = (m_position / kBlockSize) * kBlockSize;
+  s64 end = first + ((s64)kBlockCount * kBlockSize);
+  bool requested = false;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (s64 offset = first; (offset < end) && (offset < m_size); offset += kBlockSize) {
+      Block* victim = nullptr;
+      bool present = false;
+
+      for (Block& block : m_blocks) {
+        if (block.state == BlockState::kEmpty) {
+          if (!victim) {
+            victim = &block;
+          }
+        } else if (block.offset == offset) {
+          present = true;
+          break;
+        } else if ((block.state != BlockState::kLoading) &&
+          ((block.offset < first) || (block.offset >= end))) {
+          // Out of the read-ahead window.
+          if (!victim) {
+            victim = &block;
+          }
+        }
+      }
+
+      if (!present && victim) {
+        victim->offset = offset;
+        victim->size = 0;
+        victim->state = BlockState::kQueued;
+        requested = true;
+      }
+    }
+  }
+
+  if (requested) {
+    m_cv.notify_one();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void ReadAheadCdStream::Run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  for (;;) {
+    Block* next = nullptr;
+
+    // Nearest requested block first.
+    for (Block& block : m_blocks) {
+      if ((block.state == BlockState::kQueued) && (!next || (block.offset < next->offset))) {
+        next = &block;
+      }
+    }
+
+    if (!next) {
+      if (m_stop) {
+        break;
+      }
+
+      m_cv.wait(lock);
+      continue;
+    }
+
+    if (m_stop) {
+      break;
+    }
+
+    // The block is not modified by the emulation thread while it is loaded.
+    next->state = BlockState::kLoading;
+    s64 offset = next->offset;
+
+    lock.unlock();
+
+    fseek(m_worker_file, (long)offset, SEEK_SET);
+    size_t read = fread(next->data.data(), 1, kBlockSize, m_worker_file);
+
+    lock.lock();
+
+    next->size = (s32)read;
+    next->state = read ? BlockState::kReady : BlockState::kEmpty;
+  }
+}
+
+} // namespace gpgx::cd
@@ -0,0 +1,131 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/cd/sector_cache.h"
+
+#include "xee/mem/memory.h" // For Memcpy() and Memset().
+
+namespace gpgx::cd {
+
+//==============================================================================
+// SectorCache
+
+//------------------------------------------------------------------------------
+
+SectorCache::SectorCache(s32 sector_size, u32 capacity) :
+  m_sector_size(sector_size),
+  m_capacity(capacity),
+  m_count(0),
+  m_first(kNone),
+  m_last(kNone)
+{
+  m_data.resize((size_t)capacity * sector_size);
+  m_entries.resize(capacity);
+  m_index.reserve(capacity);
+
+  ResetStats();
+}
+
+//------------------------------------------------------------------------------
+
+void SectorCache::Read(ICdStream* stream, s32 lba, u8* dst)
+{
+  auto it = m_index.find(lba);
+
+  if (it != m_index.end()) {
+    u32 index = it->second;
+
+    Unlink(index);
+    PushFront(index);
+
+    xee::mem::Memcpy(dst, &m_data[(size_t)index * m_sector_size], m_sector_size);
+    m_stats.hits++;
+
+    return;
+  }
+
+  m_stats.misses++;
+
+  size_t read = stream->ReadAt((s64)lba * m_sector_size, dst, m_sector_size);
+
+  m_stats.bytes_read += read;
+
+  if (read < (size_t)m_sector_size) {
+    // Not cached (after the end of the file).
+    xee::mem::Memset(dst + read, 0, m_sector_size - read);
+    return;
+  }
+
+  if (!m_capacity) {
+    return;
+  }
+
+  u32 index;
+
+  if (m_count < m_capacity) {
+    index = m_count++;
+  } else {
+    // Replace the least recently used sector.
+    index = m_last;
+
+    Unlink(index);
+    m_index.erase(m_entries[index].lba);
+  }
+
+  m_entries[index].lba = lba;
+  PushFront(index);
+  m_index[lba] = index;
+
+  xee::mem::Memcpy(&m_data[(size_t)index * m_sector_size], dst, m_sector_size);
+}
+
+//------------------------------------------------------------------------------
+
+void SectorCache::ResetStats()
+{
+  m_stats.hits = 0;
+  m_stats.misses = 0;
+  m_stats.bytes_read = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void SectorCache::Unlink(u32 index)
+{
+  Entry& entry = m_entries[index];
+
+  if (entry.prev != kNone) {
+    m_entries[entry.prev].next = entry.next;
+  } else {
+    m_first = entry.next;
+  }
+
+  if (entry.next != kNone) {
+    m_entries[entry.next].prev = entry.prev;
+  } else {
+    m_last = entry.prev;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void SectorCache::PushFront(u32 index)
+{
+  Entry& entry = m_entries[index];
+
+  entry.prev = kNone;
+  entry.next = m_first;
+
+  if (m_first != kNone) {
+    m_entries[m_first].prev = index;
+  } else {
+    m_last = index;
+  }
+
+  m_first = index;
+}
+
+} // namespace gpgx::cd
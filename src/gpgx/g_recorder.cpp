@@ -0,0 +1,19 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/g_recorder.h"
+
+#include "gpgx/capture/recorder.h"
+
+namespace gpgx {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+gpgx::capture::Recorder* g_recorder = nullptr;
+
+} // namespace gpgx
@@ -0,0 +1,19 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/g_register_log.h"
+
+#include "gpgx/capture/register_log.h"
+
+namespace gpgx {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+gpgx::capture::RegisterLogWriter* g_register_log = nullptr;
+
+} // namespace gpgx
@@ -48,6 +48,7 @@
 #include "core/snd.h"
 #include "core/state.h"
 
+#include "gpgx/g_register_log.h"
 #include "gpgx/ic/sn76489/sn76489_type.h"
 
 namespace gpgx::ic::sn76489 {
@@ -97,6 +98,13 @@ Sn76489::Sn76489()
   xee::mem::Memset(&m_chanDelta[0], 0, sizeof(m_chanDelta));
   xee::mem::Memset(&m_chanOut[0], 0, sizeof(m_chanOut));
   xee::mem::Memset(&m_chanAmp[0], 0, sizeof(m_chanAmp));
+  m_preamp = 100;
+  m_panning = 0xff;
+  m_tickOrigin = 0;
+  xee::mem::Memset(&m_sampleLevel[0], 0, sizeof(m_sampleLevel));
+  xee::mem::Memset(&m_sampleLast[0], 0, sizeof(m_sampleLast));
+  xee::mem::Memset(&m_sampleDelta[0], 0, sizeof(m_sampleDelta));
+  m_blip = nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -142,6 +150,14 @@ void Sn76489::psg_reset()
 
   // reset internal M-cycles clock counter.
   m_clocks = 0;
+
+  // reset sample buffer.
+  m_tickOrigin = 0;
+  m_sampleLevel[0] = 0;
+  m_sampleLevel[1] = 0;
+  m_sampleLast[0] = 0;
+  m_sampleLast[1] = 0;
+  xee::mem::Memset(&m_sampleDelta[0], 0, sizeof(m_sampleDelta));
 }
 
 //------------------------------------------------------------------------------
@@ -212,12 +228,11 @@ int Sn76489::psg_context_load(u8* state)
     }
   }
 
+  // realign sample buffer on internal clock ticks.
+  m_tickOrigin = m_clocks % kMCyclesRatio;
+
   // update mixed channels output.
-  if (core_config.hq_psg) {
-    snd.blips[0]->blip_add_delta(m_clocks, delta[0], delta[1]);
-  } else {
-    snd.blips[0]->blip_add_delta_fast(m_clocks, delta[0], delta[1]);
-  }
+  psg_add_delta(m_clocks, delta[0], delta[1]);
 
   return bufferptr;
 }
@@ -226,6 +241,10 @@ int Sn76489::psg_context_load(u8* state)
 
 void Sn76489::psg_write(unsigned int clocks, unsigned int data)
 {
+  if (gpgx::g_register_log) {
+    gpgx::g_register_log->LogPsgWrite(clocks, data);
+  }
+
   // PSG chip synchronization.
   if (clocks > m_clocks) {
     // run PSG chip until current timestamp.
@@ -364,6 +383,13 @@ void Sn76489::psg_write(unsigned int clocks, unsigned int data)
 
 void Sn76489::psg_config(unsigned int clocks, unsigned int preamp, unsigned int panning)
 {
+  if (gpgx::g_register_log) {
+    gpgx::g_register_log->LogPsgConfig(clocks, preamp, panning);
+  }
+
+  m_preamp = preamp;
+  m_panning = panning;
+
   // PSG chip synchronization.
   if (clocks > m_clocks) {
     // run PSG chip until current timestamp.
@@ -409,6 +435,43 @@ void Sn76489::psg_config(unsigned int clocks, unsigned int preamp, unsigned int
 
 //------------------------------------------------------------------------------
 
+void Sn76489::psg_log_state(unsigned int clocks)
+{
+  gpgx::capture::RegisterLogWriter* log = gpgx::g_register_log;
+
+  if (!log) {
+    return;
+  }
+
+  log->LogPsgConfig(clocks, m_preamp, m_panning);
+
+  // the latched register is written last, so that its index is restored.
+  for (int i = 1; i <= 8; i++) {
+    int index = (m_latch + i) & 0x07;
+    int data = m_regs[index];
+
+    if ((index < 6) && !(index & 1)) {
+      // tone channels frequency (10-bit register LSB, then MSB).
+      log->LogPsgWrite(clocks, 0x80 | (index << 4) | (data & 0x0f));
+      log->LogPsgWrite(clocks, (data >> 4) & 0x3f);
+    } else if (index == 6) {
+      // noise control.
+      log->LogPsgWrite(clocks, 0x80 | (index << 4) | (data & 0x07));
+    } else {
+      // channel attenuation (register holds the 16-bit volume value).
+      int attenuation = 15;
+
+      while ((attenuation > 0) && (chanVolume[attenuation] != data)) {
+        attenuation--;
+      }
+
+      log->LogPsgWrite(clocks, 0x80 | (index << 4) | attenuation);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
 void Sn76489::psg_end_frame(unsigned int clocks)
 {
   if (clocks > m_clocks) {
@@ -419,9 +482,18 @@ void Sn76489::psg_end_frame(unsigned int clocks)
     m_clocks += ((clocks - m_clocks + kMCyclesRatio - 1) / kMCyclesRatio) * kMCyclesRatio;
   }
 
+  // render sample buffer until end of frame (fast path only).
+  if (!core_config.hq_psg) {
+    psg_flush_samples(clocks);
+  }
+
   // adjust internal M-cycles clock counter for next frame.
   m_clocks -= clocks;
 
+  // adjust timestamp of first internal clock tick for next frame.
+  m_tickOrigin += ((clocks - m_tickOrigin + kMCyclesRatio - 1) / kMCyclesRatio) * kMCyclesRatio;
+  m_tickOrigin -= clocks;
+
   // adjust channels time counters for next frame.
   for (int i = 0; i < 4; ++i) {
     m_freqCounter[i] -= clocks;
@@ -432,101 +504,229 @@ void Sn76489::psg_end_frame(unsigned int clocks)
 
 void Sn76489::psg_update(unsigned int clocks)
 {
-  int timestamp = 0;
-  int polarity = 0;
+  int count[4];
+  int timestamp[4];
+
+  // Transitions of each channel generator are evenly spaced, so the number of
+  // transitions occurring until current clock timestamp and the timestamp of
+  // next transition are computed for all channels at once.
+  for (int i = 0; i < 4; i++) {
+    unsigned int next = m_freqCounter[i];
+    count[i] = (next < clocks) ? ((clocks - next + m_freqInc[i] - 1) / m_freqInc[i]) : 0;
+    timestamp[i] = m_freqCounter[i] + (count[i] * m_freqInc[i]);
+  }
 
+  // apply any pending channel volume variations.
   for (int i = 0; i < 4; i++) {
-    // apply any pending channel volume variations.
     if (m_chanDelta[i][0] | m_chanDelta[i][1]) {
       // update channel output.
-      if (core_config.hq_psg) {
-        snd.blips[0]->blip_add_delta(m_clocks, m_chanDelta[i][0], m_chanDelta[i][1]);
-      } else {
-        snd.blips[0]->blip_add_delta_fast(m_clocks, m_chanDelta[i][0], m_chanDelta[i][1]);
-      }
+      psg_add_delta(m_clocks, m_chanDelta[i][0], m_chanDelta[i][1]);
 
       // clear pending channel volume variations.
       m_chanDelta[i][0] = 0;
       m_chanDelta[i][1] = 0;
     }
+  }
 
-    // timestamp of next transition.
-    timestamp = m_freqCounter[i];
+  // Tone channels.
+  for (int i = 0; i < 3; i++) {
+    int n = count[i];
 
-    // current channel generator polarity.
-    polarity = m_polarity[i];
+    if (!n) {
+      continue;
+    }
 
-    // Tone channels.
-    if (i < 3) {
-      // process all transitions occurring until current clock timestamp.
-      while (timestamp < clocks) {
-        // invert tone generator polarity.
-        polarity = -polarity;
-
-        // update channel output.
-        if (core_config.hq_psg) {
-          snd.blips[0]->blip_add_delta(timestamp, polarity * m_chanOut[i][0], polarity * m_chanOut[i][1]);
-        } else {
-          snd.blips[0]->blip_add_delta_fast(timestamp, polarity * m_chanOut[i][0], polarity * m_chanOut[i][1]);
+    // current channel generator polarity and output.
+    int polarity = m_polarity[i];
+    int out_l = polarity * m_chanOut[i][0];
+    int out_r = polarity * m_chanOut[i][1];
+
+    if (core_config.hq_psg) {
+      gpgx::audio::BlipBuffer* blip = psg_blip_buffer();
+
+      // timestamp of first transition.
+      int time = m_freqCounter[i];
+
+      // process all transitions occurring until current clock timestamp 
+      // (tone generator polarity is inverted on each transition).
+      do {
+        out_l = -out_l;
+        out_r = -out_r;
+        blip->blip_add_delta(time, out_l, out_r);
+        time += m_freqInc[i];
+      } while (--n);
+    } else {
+      // internal clock tick of first transition and ticks between transitions.
+      int tick = (m_freqCounter[i] - m_tickOrigin) / kMCyclesRatio;
+      int step = m_freqInc[i] / kMCyclesRatio;
+
+      // process all transitions occurring until current clock timestamp 
+      // (tone generator polarity is inverted on each transition).
+      do {
+        out_l = -out_l;
+        out_r = -out_r;
+
+        if ((unsigned int)tick < kSampleBufferSize) {
+          m_sampleDelta[0][tick] += out_l;
+          m_sampleDelta[1][tick] += out_r;
         }
 
-        // timestamp of next transition.
-        timestamp += m_freqInc[i];
-      }
+        tick += step;
+      } while (--n);
     }
 
-    // Noise channel.
-    else {
-      // current noise shift register value.
-      int shiftValue = m_noiseShiftValue;
-
-      // process all transitions occurring until current clock timestamp.
-      while (timestamp < clocks) {
-        // invert noise generator polarity.
-        polarity = -polarity;
-
-        // noise register is shifted on positive edge only.
-        if (polarity > 0) {
-          // current shift register output.
-          int shiftOutput = shiftValue & 0x01;
-
-          // White noise (-----1xx).
-          if (m_regs[6] & 0x04) {
-            // shift and apply XOR feedback network.
-            shiftValue = (shiftValue >> 1) | (noiseFeedback[shiftValue & m_noiseBitMask] << m_noiseShiftWidth);
-          }
-
-          // Periodic noise (-----0xx).
-          else {
-            // shift and feedback current output.
-            shiftValue = (shiftValue >> 1) | (shiftOutput << m_noiseShiftWidth);
-          }
-
-          // shift register output variation.
-          shiftOutput = (shiftValue & 0x1) - shiftOutput;
-
-          // update noise channel output.
-          if (core_config.hq_psg) {
-            snd.blips[0]->blip_add_delta(timestamp, shiftOutput * m_chanOut[3][0], shiftOutput * m_chanOut[3][1]);
-          } else {
-            snd.blips[0]->blip_add_delta_fast(timestamp, shiftOutput * m_chanOut[3][0], shiftOutput * m_chanOut[3][1]);
-          }
+    // channel generator polarity after all transitions.
+    m_polarity[i] = (count[i] & 1) ? -polarity : polarity;
+
+    // save timestamp of next transition.
+    m_freqCounter[i] = timestamp[i];
+  }
+
+  // Noise channel.
+  if (count[3]) {
+    // timestamp of first transition.
+    int time = m_freqCounter[3];
+
+    // current noise generator polarity.
+    int polarity = m_polarity[3];
+
+    // current noise shift register value.
+    int shiftValue = m_noiseShiftValue;
+
+    // process all transitions occurring until current clock timestamp.
+    for (int n = count[3]; n > 0; n--) {
+      // invert noise generator polarity.
+      polarity = -polarity;
+
+      // noise register is shifted on positive edge only.
+      if (polarity > 0) {
+        // current shift register output.
+        int shiftOutput = shiftValue & 0x01;
+
+        // White noise (-----1xx).
+        if (m_regs[6] & 0x04) {
+          // shift and apply XOR feedback network.
+          shiftValue = (shiftValue >> 1) | (noiseFeedback[shiftValue & m_noiseBitMask] << m_noiseShiftWidth);
         }
 
-        // timestamp of next transition.
-        timestamp += m_freqInc[3];
+        // Periodic noise (-----0xx).
+        else {
+          // shift and feedback current output.
+          shiftValue = (shiftValue >> 1) | (shiftOutput << m_noiseShiftWidth);
+        }
+
+        // shift register output variation.
+        shiftOutput = (shiftValue & 0x1) - shiftOutput;
+
+        // update noise channel output.
+        if (shiftOutput) {
+          psg_add_delta(time, shiftOutput * m_chanOut[3][0], shiftOutput * m_chanOut[3][1]);
+        }
       }
 
-      // save shift register value.
-      m_noiseShiftValue = shiftValue;
+      // timestamp of next transition.
+      time += m_freqInc[3];
     }
 
+    // save shift register value.
+    m_noiseShiftValue = shiftValue;
+
+    // save noise generator polarity.
+    m_polarity[3] = polarity;
+
     // save timestamp of next transition.
-    m_freqCounter[i] = timestamp;
+    m_freqCounter[3] = timestamp[3];
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Sn76489::psg_add_delta(int timestamp, int delta_l, int delta_r)
+{
+  if (core_config.hq_psg) {
+    // high-quality Band-Limited synthesis.
+    psg_blip_buffer()->blip_add_delta(timestamp, delta_l, delta_r);
+  } else {
+    // internal clock tick of the variation.
+    unsigned int tick = (timestamp - m_tickOrigin) / kMCyclesRatio;
+
+    if (tick < kSampleBufferSize) {
+      m_sampleDelta[0][tick] += delta_l;
+      m_sampleDelta[1][tick] += delta_r;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Sn76489::psg_flush_samples(unsigned int clocks)
+{
+  // number of internal clock ticks until end of frame.
+  int ticks = (clocks - m_tickOrigin + kMCyclesRatio - 1) / kMCyclesRatio;
 
-    // save channel generator polarity.
-    m_polarity[i] = polarity;
+  if (ticks > kSampleBufferSize) {
+    ticks = kSampleBufferSize;
   }
+
+  // restore mixed channels output and last rendered sample.
+  int level_l = m_sampleLevel[0];
+  int level_r = m_sampleLevel[1];
+  int last_l = m_sampleLast[0];
+  int last_r = m_sampleLast[1];
+
+  // frame initial timestamp.
+  int time = m_tickOrigin;
+
+  gpgx::audio::BlipBuffer* blip = psg_blip_buffer();
+
+  for (int tick = 0; tick < ticks; tick += kSampleTicks) {
+    int n = ticks - tick;
+
+    if (n > kSampleTicks) {
+      n = kSampleTicks;
+    }
+
+    // average mixed channels output over internal clock ticks.
+    int sum_l = 0;
+    int sum_r = 0;
+
+    for (int i = 0; i < n; i++) {
+      level_l += m_sampleDelta[0][tick + i];
+      level_r += m_sampleDelta[1][tick + i];
+      sum_l += level_l;
+      sum_r += level_r;
+    }
+
+    sum_l /= n;
+    sum_r /= n;
+
+    // faster Linear Interpolation (only when the sample has changed).
+    blip->blip_add_delta_fast(time, sum_l - last_l, sum_r - last_r);
+
+    last_l = sum_l;
+    last_r = sum_r;
+
+    time += kSampleTicks * kMCyclesRatio;
+  }
+
+  // clear rendered variations.
+  if (ticks > 0) {
+    xee::mem::Memset(&m_sampleDelta[0][0], 0, ticks * sizeof(int));
+    xee::mem::Memset(&m_sampleDelta[1][0], 0, ticks * sizeof(int));
+  }
+
+  // save mixed channels output and last rendered sample for next frame.
+  m_sampleLevel[0] = level_l;
+  m_sampleLevel[1] = level_r;
+  m_sampleLast[0] = last_l;
+  m_sampleLast[1] = last_r;
+}
+
+//------------------------------------------------------------------------------
+
+gpgx::audio::BlipBuffer* Sn76489::psg_blip_buffer() const
+{
+  return m_blip ? m_blip : snd.blips[0];
 }
 
 } // namespace gpgx::ic::sn76489
@@ -1706,6 +1706,8 @@ void Ym2413::ClearContext()
 // Synchronize FM chip with CPU and reset FM chip.
 void Ym2413::SyncAndReset(unsigned int cycles)
 {
+  LogReset(cycles);
+
   // synchronize FM chip with CPU.
   Update(cycles);
 
@@ -1717,6 +1719,8 @@ void Ym2413::SyncAndReset(unsigned int cycles)
 
 void Ym2413::Write(unsigned int cycles, unsigned int address, unsigned int data)
 {
+  LogWrite(gpgx::capture::RegisterLogChip::kOpll, cycles, address, data);
+
   // detect DATA port write.
   if (address & 1) {
     // synchronize FM chip with CPU.
@@ -2057,6 +2057,8 @@ void Ym2612::YM2612Config(int type)
 // Synchronize FM chip with CPU and reset FM chip.
 void Ym2612::SyncAndReset(unsigned int cycles)
 {
+  LogReset(cycles);
+
   // synchronize FM chip with CPU.
   Update(cycles);
 
@@ -2070,6 +2072,8 @@ void Ym2612::SyncAndReset(unsigned int cycles)
 
 void Ym2612::Write(unsigned int cycles, unsigned int address, unsigned int data)
 {
+  LogWrite(gpgx::capture::RegisterLogChip::kOpn2, cycles, address, data);
+
   // detect DATA port write.
   if (address & 1) {
     // synchronize FM chip with CPU.
@@ -1359,6 +1359,8 @@ void Ym3438::Init()
 // Synchronize FM chip with CPU and reset FM chip.
 void Ym3438::SyncAndReset(unsigned int cycles)
 {
+  LogReset(cycles);
+
   // synchronize FM chip with CPU.
   Update(cycles);
 
@@ -1370,6 +1372,8 @@ void Ym3438::SyncAndReset(unsigned int cycles)
 
 void Ym3438::Write(unsigned int cycles, unsigned int address, unsigned int data)
 {
+  LogWrite(gpgx::capture::RegisterLogChip::kOpn2, cycles, address, data);
+
   // synchronize FM chip with CPU.
   Update(cycles);
 
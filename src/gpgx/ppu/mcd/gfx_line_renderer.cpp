@@ -0,0 +1,407 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/ppu/mcd/gfx_line_renderer.h"
+
+#include "core/macros.h" // For READ_BYTE() and WRITE_BYTE().
+
+namespace gpgx::ppu::mcd {
+
+//==============================================================================
+// GfxLineRenderer
+
+//------------------------------------------------------------------------------
+
+GfxLineRenderer::GfxLineRenderer(u8* word_ram, const u8* lut_cell, const u8* lut_pixel,
+  const u8 (*lut_prio)[0x100][0x100]) :
+  m_word_ram(word_ram),
+  m_lut_cell(lut_cell),
+  m_lut_pixel(lut_pixel),
+  m_lut_prio(lut_prio),
+  m_op(),
+  m_trace(nullptr),
+  m_lines(0),
+  m_width(0),
+  m_area_start(0),
+  m_area_size(0),
+  m_generation(0),
+  m_pending(0),
+  m_stop(false)
+{
+}
+
+//------------------------------------------------------------------------------
+
+GfxLineRenderer::~GfxLineRenderer()
+{
+  Stop();
+}
+
+//------------------------------------------------------------------------------
+
+void GfxLineRenderer::Start(s32 thread_count)
+{
+  if (IsRunning() || (thread_count < 1)) {
+    return;
+  }
+
+  m_stop = false;
+  m_generation = 0;
+
+  // The emulation thread is counted with the workers.
+  for (s32 i = 0; i < thread_count; i++) {
+    m_workers.emplace_back(&GfxLineRenderer::Run, this, i, thread_count + 1);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void GfxLineRenderer::Stop()
+{
+  if (!IsRunning()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_work_cv.notify_all();
+
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+
+  m_workers.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void GfxLineRenderer::Render(const GfxOperation& op, const u16* trace, u32 buffer_start, s32 lines, s32 width)
+{
+  if (width <= 0) {
+    return;
+  }
+
+  s32 max_lines = kMaxBatchDots / width;
+
+  if (max_lines < 1) {
+    max_lines = 1;
+  }
+
+  while (lines > 0) {
+    s32 count = (lines < max_lines) ? lines : max_lines;
+
+    RenderBatch(op, trace, buffer_start, count, width);
+
+    // 4 trace vectors per line, 8 pixels per line.
+    trace += count * 4;
+    buffer_start += count * 8;
+    lines -= count;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void GfxLineRenderer::RenderBatch(const GfxOperation& op, const u16* trace, u32 buffer_start, s32 lines, s32 width)
+{
+  m_op = op;
+  m_trace = trace;
+  m_lines = lines;
+  m_width = width;
+
+  // Every line has the same layout (shifted by 8 pixels): the written area
+  // starts with the first line and ends with the last dot of the last line,
+  // which skips (buffer offset - 1) pixels at each cell boundary.
+  u32 last = buffer_start + ((u32)(lines - 1) * 8);
+
+  last += (u32)(width - 1) + ((((last & 7) + (u32)width - 1) >> 3) * ((u32)op.buffer_offset - 1));
+
+  // Whole words (bytes are swapped by READ_BYTE() and WRITE_BYTE()).
+  m_area_start = (buffer_start >> 1) & ~1U;
+  m_area_size = ((last >> 1) | 1U) - m_area_start;
+
+  // Trace vectors inside the written area.
+  u32 trace_start = (u32)((const u8*)trace - m_word_ram);
+  u32 trace_end = trace_start + ((u32)lines * 8) - 1;
+  bool conflict = (trace_start <= (m_area_start + m_area_size)) && (trace_end >= m_area_start);
+
+  if (!conflict) {
+    size_t dots = (size_t)lines * (size_t)width;
+
+    if (m_pixels.size() < dots) {
+      m_pixels.resize(dots);
+    }
+
+    m_conflicts.assign(lines, 0);
+
+    if (IsRunning() && (lines > 1) && (dots >= (size_t)kMinParallelDots)) {
+      s32 step = (s32)m_workers.size() + 1;
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_generation++;
+        m_pending = (s32)m_workers.size();
+      }
+
+      m_work_cv.notify_all();
+
+      // The emulation thread fetches its share of the lines too.
+      FetchLines(0, step);
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_done_cv.wait(lock, [&] { return m_pending == 0; });
+    } else {
+      FetchLines(0, 1);
+    }
+
+    for (s32 line = 0; line < lines; line++) {
+      if (m_conflicts[line]) {
+        conflict = true;
+        break;
+      }
+    }
+  }
+
+  if (conflict) {
+    // Nothing has been written yet.
+    for (s32 line = 0; line < lines; line++) {
+      RenderLine(trace + (line * 4), buffer_start + ((u32)line * 8));
+    }
+
+    return;
+  }
+
+  for (s32 line = 0; line < lines; line++) {
+    WriteLine(&m_pixels[(size_t)line * width], buffer_start + ((u32)line * 8));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void GfxLineRenderer::FetchLines(s32 first, s32 step)
+{
+  for (s32 line = first; line < m_lines; line += step) {
+    m_conflicts[line] = FetchLine(m_trace + (line * 4), &m_pixels[(size_t)line * m_width]) ? 1 : 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+bool GfxLineRenderer::FetchLine(const u16* trace, u8* pixels)
+{
+  // Locals (the pixels written below could alias the members).
+  const u8* word_ram = m_word_ram;
+  const u8* lut_cell = m_lut_cell;
+  const u8* lut_pixel = m_lut_pixel;
+  const u16* map = m_op.map;
+  u32 stamp_shift = m_op.stamp_shift;
+  u32 map_shift = m_op.map_shift;
+  s32 width = m_width;
+
+  // bits [1:0] of 32x32 pixels stamp index are masked (see Chuck Rock II - Son
+  // of Chuck).
+  u32 stamp_mask = m_op.stamp_size ? 0x7fc : 0x7ff;
+  u32 stamp_size = (u32)m_op.stamp_size << 3;
+
+  u32 position_mask = m_op.repeat ? m_op.dot_mask : 0xffffff;
+  u32 outside_mask = ~m_op.dot_mask;
+
+  u32 map_start = (u32)((const u8*)map - word_ram);
+  u32 area_start = m_area_start;
+  u32 area_size = m_area_size;
+  bool conflict = false;
+
+  // Start position (13.3 format converted to 13.11) and offset (5.11 format).
+  u32 x = (u32)trace[0] << 8;
+  u32 y = (u32)trace[1] << 8;
+  u32 x_offset = (u32)(s32)(s16)trace[2];
+  u32 y_offset = (u32)(s32)(s16)trace[3];
+
+  u32 xpos[kBlockSize];
+  u32 ypos[kBlockSize];
+
+  for (s32 dot = 0; dot < width; dot += kBlockSize) {
+    s32 count = width - dot;
+
+    if (count > kBlockSize) {
+      count = kBlockSize;
+    }
+
+    // The masks keep the low bits only: masking the position of each dot is
+    // the same as masking the position after each increment.
+    for (s32 i = 0; i < kBlockSize; i++) {
+      xpos[i] = (x + ((u32)i * x_offset)) & position_mask;
+      ypos[i] = (y + ((u32)i * y_offset)) & position_mask;
+    }
+
+    for (s32 i = 0; i < count; i++) {
+      u8 pixel = 0x00;
+
+      if (!((xpos[i] | ypos[i]) & outside_mask)) {
+        u32 map_index = (xpos[i] >> stamp_shift) | ((ypos[i] >> stamp_shift) << map_shift);
+        u32 stamp_data = map[map_index];
+        u32 stamp_index = (stamp_data & stamp_mask) << 8;
+
+        conflict |= ((map_start + (map_index << 1)) - area_start) <= area_size;
+
+        if (stamp_index) {
+          stamp_data = (stamp_data >> 13) & 7;
+
+          stamp_index |= lut_cell[stamp_data | stamp_size | ((ypos[i] >> 8) & 0xc0) | ((xpos[i] >> 10) & 0x30)] << 6;
+          stamp_index |= lut_pixel[stamp_data | ((xpos[i] >> 8) & 0x38) | ((ypos[i] >> 5) & 0x1c0)];
+
+          conflict |= ((stamp_index >> 1) - area_start) <= area_size;
+
+          // Left pixel (bits 7-4) if even, right pixel (bits 3-0) if odd.
+          pixel = (READ_BYTE(word_ram, stamp_index >> 1) >> ((~stamp_index & 1) << 2)) & 0x0f;
+        }
+      }
+
+      pixels[dot + i] = pixel;
+    }
+
+    x += (u32)kBlockSize * x_offset;
+    y += (u32)kBlockSize * y_offset;
+  }
+
+  return conflict;
+}
+
+//------------------------------------------------------------------------------
+
+void GfxLineRenderer::WriteLine(const u8* pixels, u32 buffer_index)
+{
+  // Invalid mode: the image buffer is not modified.
+  if (m_op.priority_mode == 3) {
+    return;
+  }
+
+  // Normal mode: the pixels are written as they are.
+  const u8 (*lut_prio)[0x100] = m_op.priority_mode ? m_lut_prio[m_op.priority_mode] : nullptr;
+
+  u8* word_ram = m_word_ram;
+  u32 buffer_offset = m_op.buffer_offset;
+  s32 width = m_width;
+  s32 dot = 0;
+
+  while (dot < width) {
+    u32 address = buffer_index >> 1;
+    u8 pixel_out;
+
+    if (!(buffer_index & 1) && ((dot + 1) < width)) {
+      // Both pixels of the byte (the priority tables are applied per pixel).
+      pixel_out = (pixels[dot] << 4) | pixels[dot + 1];
+      buffer_index++;
+      dot += 2;
+    } else if (buffer_index & 1) {
+      pixel_out = pixels[dot] | (READ_BYTE(word_ram, address) & 0xf0);
+      dot++;
+    } else {
+      pixel_out = (pixels[dot] << 4) | (READ_BYTE(word_ram, address) & 0x0f);
+      dot++;
+    }
+
+    if (lut_prio) {
+      pixel_out = lut_prio[READ_BYTE(word_ram, address)][pixel_out];
+    }
+
+    WRITE_BYTE(word_ram, address, pixel_out);
+
+    // Next pixel or next cell (one column minus 7 pixels).
+    buffer_index += ((buffer_index & 7) != 7) ? 1 : buffer_offset;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void GfxLineRenderer::RenderLine(const u16* trace, u32 buffer_index)
+{
+  const GfxOperation& op = m_op;
+  const u8 (*lut_prio)[0x100] = m_lut_prio[op.priority_mode];
+
+  u32 stamp_mask = op.stamp_size ? 0x7fc : 0x7ff;
+  u32 stamp_size = (u32)op.stamp_size << 3;
+  u32 position_mask = op.repeat ? op.dot_mask : 0xffffff;
+
+  // The trace vectors are read before the first dot is written.
+  u32 xpos = (u32)trace[0] << 8;
+  u32 ypos = (u32)trace[1] << 8;
+  u32 x_offset = (u32)(s32)(s16)trace[2];
+  u32 y_offset = (u32)(s32)(s16)trace[3];
+
+  for (s32 dot = 0; dot < m_width; dot++) {
+    u8 pixel_out = 0x00;
+
+    xpos &= position_mask;
+    ypos &= position_mask;
+
+    if (!((xpos | ypos) & ~op.dot_mask)) {
+      u16 stamp_data = op.map[(xpos >> op.stamp_shift) | ((ypos >> op.stamp_shift) << op.map_shift)];
+      u32 stamp_index = (stamp_data & stamp_mask) << 8;
+
+      if (stamp_index) {
+        stamp_data = (stamp_data >> 13) & 7;
+
+        stamp_index |= m_lut_cell[stamp_data | stamp_size | ((ypos >> 8) & 0xc0) | ((xpos >> 10) & 0x30)] << 6;
+        stamp_index |= m_lut_pixel[stamp_data | ((xpos >> 8) & 0x38) | ((ypos >> 5) & 0x1c0)];
+
+        pixel_out = READ_BYTE(m_word_ram, stamp_index >> 1);
+        pixel_out = (stamp_index & 1) ? (pixel_out & 0x0f) : (pixel_out >> 4);
+      }
+    }
+
+    u8 pixel_in = READ_BYTE(m_word_ram, buffer_index >> 1);
+
+    if (buffer_index & 1) {
+      pixel_out |= (pixel_in & 0xf0);
+    } else {
+      pixel_out = (pixel_out << 4) | (pixel_in & 0x0f);
+    }
+
+    WRITE_BYTE(m_word_ram, buffer_index >> 1, lut_prio[pixel_in][pixel_out]);
+
+    buffer_index += ((buffer_index & 7) != 7) ? 1 : m_op.buffer_offset;
+
+    xpos += x_offset;
+    ypos += y_offset;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void GfxLineRenderer::Run(s32 index, s32 step)
+{
+  u32 generation = 0;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      m_work_cv.wait(lock, [&] { return m_stop || (generation != m_generation); });
+
+      if (m_stop) {
+        return;
+      }
+
+      generation = m_generation;
+    }
+
+    // Line 0 modulo step is fetched by the emulation thread.
+    FetchLines(index + 1, step);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      if (--m_pending == 0) {
+        m_done_cv.notify_one();
+      }
+    }
+  }
+}
+
+} // namespace gpgx::ppu::mcd
@@ -0,0 +1,124 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/ppu/vdp/line_change_tracker.h"
+
+#include "xee/mem/memory.h" // For Memcpy() and Memset().
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+// LineChangeTracker
+
+//------------------------------------------------------------------------------
+
+LineChangeTracker::LineChangeTracker() :
+  m_frame_changed_count(0)
+{
+  xee::mem::Memset(m_frame_changed, 0, sizeof(m_frame_changed));
+
+  Invalidate();
+}
+
+//------------------------------------------------------------------------------
+
+u64 LineChangeTracker::Hash(const void* data, s32 size, u64 seed)
+{
+  const u8* src = (const u8*)data;
+  u64 hash = seed ^ ((u64)size * 0x9E3779B97F4A7C15ull);
+  u64 word = 0;
+
+  // 8 bytes at a time.
+  for (; size >= 8; size -= 8, src += 8) {
+    xee::mem::Memcpy(&word, src, 8);
+    hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 32;
+  }
+
+  // Remaining bytes.
+  if (size > 0) {
+    word = 0;
+    xee::mem::Memcpy(&word, src, size);
+    hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 32;
+  }
+
+  // Final mix.
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ull;
+  hash ^= hash >> 33;
+
+  return hash;
+}
+
+//------------------------------------------------------------------------------
+
+void LineChangeTracker::Invalidate()
+{
+  xee::mem::Memset(m_hash, 0, sizeof(m_hash));
+  xee::mem::Memset(m_changed, 1, sizeof(m_changed));
+}
+
+//------------------------------------------------------------------------------
+
+void LineChangeTracker::UpdateLine(s32 line, const u8* src, s32 width, u64 palette_hash)
+{
+  if ((line < 0) || (line >= kMaxLines)) {
+    return;
+  }
+
+  u64 hash = Hash(src, width, palette_hash);
+
+  if (hash != m_hash[line]) {
+    m_hash[line] = hash;
+    m_changed[line] = 1;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void LineChangeTracker::EndFrame()
+{
+  s32 count = 0;
+
+  for (s32 line = 0; line < kMaxLines; line++) {
+    count += m_changed[line];
+  }
+
+  xee::mem::Memcpy(m_frame_changed, m_changed, sizeof(m_frame_changed));
+  xee::mem::Memset(m_changed, 0, sizeof(m_changed));
+
+  m_frame_changed_count = count;
+}
+
+//------------------------------------------------------------------------------
+
+s32 LineChangeTracker::FindChangedLines(s32 first, s32 end, s32* count) const
+{
+  if (first < 0) {
+    first = 0;
+  }
+
+  if (end > kMaxLines) {
+    end = kMaxLines;
+  }
+
+  while ((first < end) && !m_frame_changed[first]) {
+    first++;
+  }
+
+  s32 last = first;
+
+  while ((last < end) && m_frame_changed[last]) {
+    last++;
+  }
+
+  *count = last - first;
+
+  return (first < end) ? first : end;
+}
+
+} // namespace gpgx::ppu::vdp
@@ -40,6 +40,8 @@
 
 #include "gpgx/ppu/vdp/m4_bg_pattern_cache_updater.h"
 
+#include "gpgx/ppu/vdp/bg_pattern_dirty.h"
+
 namespace gpgx::ppu::vdp {
 
 //==============================================================================
@@ -48,70 +50,99 @@ namespace gpgx::ppu::vdp {
 //------------------------------------------------------------------------------
 M4BackgroundPatternCacheUpdater::M4BackgroundPatternCacheUpdater(
   u8* pattern_cache, 
-  u16* name_list, 
-  u8* name_dirty, 
+  u64* dirty_rows, 
+  u64* dirty_summary, 
   u8* ram, 
   u32* bp_lut) :
   m_pattern_cache(pattern_cache),
-  m_name_list(name_list),
-  m_name_dirty(name_dirty),
+  m_dirty_rows(dirty_rows),
+  m_dirty_summary(dirty_summary),
   m_ram(ram),
-  m_bp_lut(bp_lut)
+  m_bp_lut(bp_lut),
+  m_updated_pattern_count(0),
+  m_updated_row_count(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void M4BackgroundPatternCacheUpdater::UpdateBackgroundPatternCache()
 {
+  TakeDirtyPatterns(m_dirty_rows, m_dirty_summary, [this](u16 name, u8 dirty) {
+    UpdatePattern(name, dirty);
+  });
 }
 
 //------------------------------------------------------------------------------
 
-void M4BackgroundPatternCacheUpdater::UpdateBackgroundPatternCache(s32 index)
+u32 M4BackgroundPatternCacheUpdater::GetUpdatedPatternCount() const
+{
+  return m_updated_pattern_count;
+}
+
+//------------------------------------------------------------------------------
+
+u32 M4BackgroundPatternCacheUpdater::GetUpdatedRowCount() const
+{
+  return m_updated_row_count;
+}
+
+//------------------------------------------------------------------------------
+
+void M4BackgroundPatternCacheUpdater::ResetUpdateCounters()
+{
+  m_updated_pattern_count = 0;
+  m_updated_row_count = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void M4BackgroundPatternCacheUpdater::UpdatePattern(u16 name, u8 dirty)
 {
   u8 x = 0;
   u8 y = 0;
   u8 c = 0;
-  u8* dst = nullptr;
-  u16 name = 0;
   u16 bp01 = 0;
   u16 bp23 = 0;
   u32 bp = 0;
 
-  for (s32 i = 0; i < index; i++) {
-    // Get modified pattern name index.
-    name = m_name_list[i];
-    
-    // Pattern cache base address.
-    dst = &m_pattern_cache[name << 6];
-
-    // Check modified lines.
-    for (y = 0; y < 8; y++) {
-      if (m_name_dirty[name] & (1 << y)) {
-        // Byteplane data.
-        bp01 = *(u16*)&m_ram[(name << 5) | (y << 2) | (0)];
-        bp23 = *(u16*)&m_ram[(name << 5) | (y << 2) | (2)];
-
-        // Convert to pixel line data (4 bytes = 8 pixels).
-        // (msb) p7p6 p5p4 p3p2 p1p0 (lsb)
-        bp = (m_bp_lut[bp01] >> 2) | (m_bp_lut[bp23]);
-
-        // Update cached line (8 pixels = 8 bytes).
-        for (x = 0; x < 8; x++) {
-          // Extract pixel data.
-          c = bp & 0x0F;
-
-          // Pattern cache data (one pattern = 8 bytes).
-          // byte0 <-> p0 p1 p2 p3 p4 p5 p6 p7 <-> byte7 (hflip = 0)
-          // byte0 <-> p7 p6 p5 p4 p3 p2 p1 p0 <-> byte7 (hflip = 1)
-          dst[0x00000 | (y << 3) | (x)] = (c);            // vflip=0 & hflip=0
-          dst[0x08000 | (y << 3) | (x ^ 7)] = (c);        // vflip=0 & hflip=1
-          dst[0x10000 | ((y ^ 7) << 3) | (x)] = (c);      // vflip=1 & hflip=0
-          dst[0x18000 | ((y ^ 7) << 3) | (x ^ 7)] = (c);  // vflip=1 & hflip=1
-
-          // Next pixel.
-          bp = bp >> 4;
-        }
-      }
+  // Pattern cache base address.
+  u8* dst = &m_pattern_cache[name << 6];
+
+  m_updated_pattern_count++;
+  m_updated_row_count += CountSetBits(dirty);
+
+  // Modified lines (lowest first).
+  u32 rows = dirty;
+
+  while (rows) {
+    y = (u8)FindLowestSetBit(rows);
+    rows &= rows - 1;
+
+    // Byteplane data.
+    bp01 = *(u16*)&m_ram[(name << 5) | (y << 2) | (0)];
+    bp23 = *(u16*)&m_ram[(name << 5) | (y << 2) | (2)];
+
+    // Convert to pixel line data (4 bytes = 8 pixels).
+    // (msb) p7p6 p5p4 p3p2 p1p0 (lsb)
+    bp = (m_bp_lut[bp01] >> 2) | (m_bp_lut[bp23]);
+
+    // Update cached line (8 pixels = 8 bytes).
+    for (x = 0; x < 8; x++) {
+      // Extract pixel data.
+      c = bp & 0x0F;
+
+      // Pattern cache data (one pattern = 8 bytes).
+      // byte0 <-> p0 p1 p2 p3 p4 p5 p6 p7 <-> byte7 (hflip = 0)
+      // byte0 <-> p7 p6 p5 p4 p3 p2 p1 p0 <-> byte7 (hflip = 1)
+      dst[0x00000 | (y << 3) | (x)] = (c);            // vflip=0 & hflip=0
+      dst[0x08000 | (y << 3) | (x ^ 7)] = (c);        // vflip=0 & hflip=1
+      dst[0x10000 | ((y ^ 7) << 3) | (x)] = (c);      // vflip=1 & hflip=0
+      dst[0x18000 | ((y ^ 7) << 3) | (x ^ 7)] = (c);  // vflip=1 & hflip=1
+
+      // Next pixel.
+      bp = bp >> 4;
     }
-    
-    // Clear modified pattern flag.
-    m_name_dirty[name] = 0;
   }
 }
 
@@ -55,44 +55,5 @@ M5BackgroundColumnDrawer::M5BackgroundColumnDrawer(
 {
 }
 
-//------------------------------------------------------------------------------
-
-void M5BackgroundColumnDrawer::DrawColumn(u32** dest, u32 attr, u32 line)
-{
-#ifdef LSB_FIRST
-  DrawLSBTile(dest, attr, line);
-  DrawMSBTile(dest, attr, line);
-#else
-  DrawMSBTile(dest, attr, line);
-  DrawLSBTile(dest, attr, line);
-#endif // #ifdef LSB_FIRST
-}
-
-//------------------------------------------------------------------------------
-
-void M5BackgroundColumnDrawer::DrawLSBTile(u32** dest, u32 attr, u32 line)
-{
-  u32 atex = m_atex_table[(attr >> 13) & 7];
-  u32* src = (u32*)&m_pattern_cache[(attr & 0x00001FFF) << 6 | line];
-
-  **dest = (src[0] | atex);
-  (*dest)++;
-  **dest = (src[1] | atex);
-  (*dest)++;
-}
-
-//------------------------------------------------------------------------------
-
-void M5BackgroundColumnDrawer::DrawMSBTile(u32** dest, u32 attr, u32 line)
-{
-  u32 atex = m_atex_table[(attr >> 29) & 7];
-  u32* src = (u32*)&m_pattern_cache[(attr & 0x1FFF0000) >> 10 | line];
-
-  **dest = (src[0] | atex);
-  (*dest)++;
-  **dest = (src[1] | atex);
-  (*dest)++;
-}
-
 } // namespace gpgx::ppu::vdp
 
@@ -42,6 +42,8 @@
 
 #include "core/macros.h" // For LSB_FIRST.
 
+#include "gpgx/ppu/vdp/bg_pattern_dirty.h"
+
 namespace gpgx::ppu::vdp {
 
 //==============================================================================
@@ -50,71 +52,107 @@ namespace gpgx::ppu::vdp {
 //------------------------------------------------------------------------------
 M5BackgroundPatternCacheUpdater::M5BackgroundPatternCacheUpdater(
   u8* pattern_cache, 
-  u16* name_list, 
-  u8* name_dirty, 
+  u64* dirty_rows, 
+  u64* dirty_summary, 
   u8* ram) :
   m_pattern_cache(pattern_cache),
-  m_name_list(name_list),
-  m_name_dirty(name_dirty),
-  m_ram(ram)
+  m_dirty_rows(dirty_rows),
+  m_dirty_summary(dirty_summary),
+  m_ram(ram),
+  m_updated_pattern_count(0),
+  m_updated_row_count(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void M5BackgroundPatternCacheUpdater::UpdateBackgroundPatternCache()
 {
+  TakeDirtyPatterns(m_dirty_rows, m_dirty_summary, [this](u16 name, u8 dirty) {
+    UpdatePattern(name, dirty);
+  });
 }
 
 //------------------------------------------------------------------------------
 
-void M5BackgroundPatternCacheUpdater::UpdateBackgroundPatternCache(s32 index)
+u32 M5BackgroundPatternCacheUpdater::GetUpdatedPatternCount() const
+{
+  return m_updated_pattern_count;
+}
+
+//------------------------------------------------------------------------------
+
+u32 M5BackgroundPatternCacheUpdater::GetUpdatedRowCount() const
+{
+  return m_updated_row_count;
+}
+
+//------------------------------------------------------------------------------
+
+void M5BackgroundPatternCacheUpdater::ResetUpdateCounters()
+{
+  m_updated_pattern_count = 0;
+  m_updated_row_count = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void M5BackgroundPatternCacheUpdater::UpdatePattern(u16 name, u8 dirty)
 {
   u8 x = 0;
   u8 y = 0;
   u8 c = 0;
-  u8* dst = nullptr;
-  u16 name = 0;
   u32 bp = 0;
 
-  for (s32 i = 0; i < index; i++) {
-    // Get modified pattern name index.
-    name = m_name_list[i];
-    
-    // Pattern cache base address.
-    dst = &m_pattern_cache[name << 6];
-
-    // Check modified lines.
-    for (y = 0; y < 8; y++) {
-      if (m_name_dirty[name] & (1 << y)) {
-        // Byteplane data (one pattern = 4 bytes).
-        // LIT_ENDIAN: byte0 (lsb) p2p3 p0p1 p6p7 p4p5 (msb) byte3
-        // BIG_ENDIAN: byte0 (msb) p0p1 p2p3 p4p5 p6p7 (lsb) byte3
-        bp = *(u32*)&m_ram[(name << 5) | (y << 2)];
-
-        // Update cached line (8 pixels = 8 bytes).
-        for (x = 0; x < 8; x++) {
-          // Extract pixel data.
-          c = bp & 0x0F;
-
-          // Pattern cache data (one pattern = 8 bytes).
-          // byte0 <-> p0 p1 p2 p3 p4 p5 p6 p7 <-> byte7 (hflip = 0)
-          // byte0 <-> p7 p6 p5 p4 p3 p2 p1 p0 <-> byte7 (hflip = 1)
+  // Pattern cache base address.
+  u8* dst = &m_pattern_cache[name << 6];
+
+  m_updated_pattern_count++;
+  m_updated_row_count += CountSetBits(dirty);
+
+  // Modified lines (lowest first).
+  u32 rows = dirty;
+
+  while (rows) {
+    y = (u8)FindLowestSetBit(rows);
+    rows &= rows - 1;
+
+    // Byteplane data (one pattern = 4 bytes).
+    // LIT_ENDIAN: byte0 (lsb) p2p3 p0p1 p6p7 p4p5 (msb) byte3
+    // BIG_ENDIAN: byte0 (msb) p0p1 p2p3 p4p5 p6p7 (lsb) byte3
+    bp = *(u32*)&m_ram[(name << 5) | (y << 2)];
+
+    // Update cached line (8 pixels = 8 bytes).
+    for (x = 0; x < 8; x++) {
+      // Extract pixel data.
+      c = bp & 0x0F;
+
+      // Pattern cache data (one pattern = 8 bytes).
+      // byte0 <-> p0 p1 p2 p3 p4 p5 p6 p7 <-> byte7 (hflip = 0)
+      // byte0 <-> p7 p6 p5 p4 p3 p2 p1 p0 <-> byte7 (hflip = 1)
+#ifdef USE_COMPACT_PATTERN_CACHE
+      // Unflipped pattern only (see m5_pattern_cache.h).
 #ifdef LSB_FIRST
-          // Byteplane data = (msb) p4p5 p6p7 p0p1 p2p3 (lsb)
-          dst[0x00000 | (y << 3) | (x ^ 3)] = (c);        // vflip=0, hflip=0
-          dst[0x20000 | (y << 3) | (x ^ 4)] = (c);        // vflip=0, hflip=1
-          dst[0x40000 | ((y ^ 7) << 3) | (x ^ 3)] = (c);  // vflip=1, hflip=0
-          dst[0x60000 | ((y ^ 7) << 3) | (x ^ 4)] = (c);  // vflip=1, hflip=1
+      dst[(y << 3) | (x ^ 3)] = (c);
+#else
+      dst[(y << 3) | (x ^ 7)] = (c);
+#endif
+#elif defined(LSB_FIRST)
+      // Byteplane data = (msb) p4p5 p6p7 p0p1 p2p3 (lsb)
+      dst[0x00000 | (y << 3) | (x ^ 3)] = (c);        // vflip=0, hflip=0
+      dst[0x20000 | (y << 3) | (x ^ 4)] = (c);        // vflip=0, hflip=1
+      dst[0x40000 | ((y ^ 7) << 3) | (x ^ 3)] = (c);  // vflip=1, hflip=0
+      dst[0x60000 | ((y ^ 7) << 3) | (x ^ 4)] = (c);  // vflip=1, hflip=1
 #else
-          // Byteplane data = (msb) p0p1 p2p3 p4p5 p6p7 (lsb)
-          dst[0x00000 | (y << 3) | (x ^ 7)] = (c);        // vflip=0, hflip=0
-          dst[0x20000 | (y << 3) | (x)] = (c);            // vflip=0, hflip=1
-          dst[0x40000 | ((y ^ 7) << 3) | (x ^ 7)] = (c);  // vflip=1, hflip=0
-          dst[0x60000 | ((y ^ 7) << 3) | (x)] = (c);      // vflip=1, hflip=1
+      // Byteplane data = (msb) p0p1 p2p3 p4p5 p6p7 (lsb)
+      dst[0x00000 | (y << 3) | (x ^ 7)] = (c);        // vflip=0, hflip=0
+      dst[0x20000 | (y << 3) | (x)] = (c);            // vflip=0, hflip=1
+      dst[0x40000 | ((y ^ 7) << 3) | (x ^ 7)] = (c);  // vflip=1, hflip=0
+      dst[0x60000 | ((y ^ 7) << 3) | (x)] = (c);      // vflip=1, hflip=1
 #endif
-          // Next pixel.
-          bp = bp >> 4;
-        }
-      }
+      // Next pixel.
+      bp = bp >> 4;
     }
-    
-    // Clear modified pattern flag.
-    m_name_dirty[name] = 0;
   }
 }
 
@@ -51,7 +51,8 @@ namespace gpgx::ppu::vdp {
 
 M5ColorPaletteUpdater::M5ColorPaletteUpdater(u8* reg, PIXEL_OUT_T* pixel) : 
   m_reg(reg),
-  m_pixel(pixel)
+  m_pixel(pixel),
+  m_version(0)
 {
   xee::mem::Memset(&m_pixel_lut, 0, sizeof(m_pixel_lut));
 }
@@ -92,6 +93,8 @@ void M5ColorPaletteUpdater::Initialize()
 
 void M5ColorPaletteUpdater::UpdateColor(s32 index, u32 data)
 {
+  m_version++;
+
   // Palette Mode.
   if (!(m_reg[0] & 0x04)) {
     // Color value is limited to 00X00X00X.
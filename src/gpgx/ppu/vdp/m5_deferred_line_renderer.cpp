@@ -0,0 +1,537 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/ppu/vdp/m5_deferred_line_renderer.h"
+
+#include "xee/mem/memory.h" // For Memcmp(), Memcpy() and Memset().
+
+#include "gpgx/ppu/vdp/bg_pattern_dirty.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+// M5DeferredLineRenderer
+
+//------------------------------------------------------------------------------
+
+M5DeferredLineRenderer::M5DeferredLineRenderer(
+  u8* reg,
+  u8* vram,
+  u8* vsram,
+  PIXEL_OUT_T* pixel,
+
+  u16* ntab,
+  u16* ntbb,
+  u16* ntwb,
+  u16* hscb,
+
+  u8* playfield_shift,
+  u8* playfield_col_mask,
+  u16* playfield_row_mask,
+  u8* hscroll_mask,
+
+  u8* odd_frame,
+  u8* im2_flag,
+  u16* max_sprite_pixels,
+  u16* lines_per_frame,
+
+  clip_t* clip,
+  viewport_t* viewport,
+
+  object_info_t(&obj_info)[2][20],
+  u8* object_count,
+  u16* status,
+  u8* spr_ovr,
+
+  u64* dirty_rows,
+  u64* dirty_summary,
+
+  u8 (*lut)[kLayerPriorityLutSize],
+  u8* name_lut,
+  const u32* atex_table,
+  LineChangeTracker* line_changes,
+  framebuffer_t* framebuffer) :
+  m_reg(reg),
+  m_vram(vram),
+  m_vsram(vsram),
+  m_pixel(pixel),
+
+  m_ntab(ntab),
+  m_ntbb(ntbb),
+  m_ntwb(ntwb),
+  m_hscb(hscb),
+
+  m_playfield_shift(playfield_shift),
+  m_playfield_col_mask(playfield_col_mask),
+  m_playfield_row_mask(playfield_row_mask),
+  m_hscroll_mask(hscroll_mask),
+
+  m_odd_frame(odd_frame),
+  m_im2_flag(im2_flag),
+  m_max_sprite_pixels(max_sprite_pixels),
+  m_lines_per_frame(lines_per_frame),
+
+  m_clip(clip),
+  m_viewport(viewport),
+
+  m_obj_info(obj_info),
+  m_object_count(object_count),
+  m_status(status),
+  m_spr_ovr(spr_ovr),
+
+  m_dirty_rows(dirty_rows),
+  m_dirty_summary(dirty_summary),
+
+  m_lut(lut),
+  m_name_lut(name_lut),
+  m_atex_table(atex_table),
+  m_line_changes(line_changes),
+  m_framebuffer(framebuffer),
+
+  m_records(kMaxRecords),
+  m_vram_blocks(kMaxVramBlocks),
+  m_states(kMaxStates),
+  m_vsrams(kMaxVsrams * 0x80),
+  m_palettes(kMaxPalettes * 0x100),
+
+  m_vram_block_count(0),
+  m_state_count(0),
+  m_vsram_count(0),
+  m_palette_count(0),
+  m_invalidated(true),
+
+  m_record_count(0),
+  m_generation(0),
+  m_stop(false)
+{
+}
+
+//------------------------------------------------------------------------------
+
+M5DeferredLineRenderer::~M5DeferredLineRenderer()
+{
+  Stop();
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::Start(s32 thread_count)
+{
+  if (IsRunning() || (thread_count < 1)) {
+    return;
+  }
+
+  m_stop = false;
+  m_record_count = 0;
+  m_vram_block_count = 0;
+  m_state_count = 0;
+  m_vsram_count = 0;
+  m_palette_count = 0;
+  m_invalidated = true;
+
+  // The number of workers must be known before the first one starts.
+  for (s32 i = 0; i < thread_count; i++) {
+    Worker* worker = new Worker();
+
+    worker->context = new M5LineRenderContext(m_lut, m_name_lut, m_atex_table, m_line_changes, m_framebuffer);
+    worker->index = i;
+    worker->done = 0;
+
+    m_workers.push_back(worker);
+  }
+
+  for (Worker* worker : m_workers) {
+    worker->thread = std::thread(&M5DeferredLineRenderer::Run, this, worker);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::Stop()
+{
+  if (!IsRunning()) {
+    return;
+  }
+
+  Flush();
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_work_cv.notify_all();
+
+  for (Worker* worker : m_workers) {
+    worker->thread.join();
+
+    delete worker->context;
+    delete worker;
+  }
+
+  m_workers.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::PushRenderLine(s32 line)
+{
+  M5LineRecord* record = AcquireRecord(line, M5LineCommand::kRender);
+
+  // Sprite masking state at the start of the line.
+  record->spr_ovr = *m_spr_ovr;
+
+  if (m_reg[1] & 0x40) {
+    // Sprites of the line (parsed during the previous line).
+    s32 list = line & 1;
+
+    record->object_count = m_object_count[list];
+    xee::mem::Memcpy(record->obj_info, m_obj_info[list], record->object_count * sizeof(object_info_t));
+
+    // Sprite masking state for the next line.
+    *m_spr_ovr = GetNextSpriteMasking(list);
+  }
+
+  Commit();
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::PushBlankLine(s32 line, s32 offset, s32 width)
+{
+  M5LineRecord* record = AcquireRecord(line, M5LineCommand::kBlank);
+
+  record->blank_offset = (s16)offset;
+  record->blank_width = (s16)width;
+
+  Commit();
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::PushRemapLine(s32 line)
+{
+  AcquireRecord(line, M5LineCommand::kRemap);
+  Commit();
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::Flush()
+{
+  if (!IsRunning()) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  m_done_cv.wait(lock, [this] {
+    for (Worker* worker : m_workers) {
+      if (worker->done != m_record_count) {
+        return false;
+      }
+    }
+
+    return true;
+  });
+
+  // Sprite collision.
+  for (Worker* worker : m_workers) {
+    *m_status |= worker->context->TakeStatus();
+  }
+
+  // Rewind the log (workers detect the new generation on their next wakeup).
+  m_record_count = 0;
+  m_generation++;
+
+  for (Worker* worker : m_workers) {
+    worker->done = 0;
+  }
+
+  m_vram_block_count = 0;
+  m_state_count = 0;
+  m_vsram_count = 0;
+  m_palette_count = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::Reset()
+{
+  if (!IsRunning()) {
+    return;
+  }
+
+  Flush();
+
+  {
+    // Workers are idle until the next record is committed.
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (Worker* worker : m_workers) {
+      worker->context->Reset();
+    }
+  }
+
+  Invalidate();
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::Invalidate()
+{
+  m_invalidated = true;
+}
+
+//------------------------------------------------------------------------------
+
+M5LineRecord* M5DeferredLineRenderer::AcquireRecord(s32 line, M5LineCommand command)
+{
+  // The log must be able to hold the record and all its snapshots.
+  if ((m_record_count >= kMaxRecords) ||
+    ((m_vram_block_count + CountDirtyPatterns(m_dirty_rows, m_dirty_summary)) > kMaxVramBlocks) ||
+    (m_state_count >= kMaxStates) ||
+    (m_vsram_count >= kMaxVsrams) ||
+    (m_palette_count >= kMaxPalettes)) {
+    Flush();
+  }
+
+  // Only read by the workers once committed.
+  M5LineRecord* record = &m_records[m_record_count];
+
+  record->line = line;
+  record->command = command;
+  record->spr_ovr = 0;
+  record->object_count = 0;
+  record->blank_offset = 0;
+  record->blank_width = 0;
+
+  CaptureVramBlocks(record);
+  CaptureState(record);
+  CaptureVsram(record);
+  CapturePalette(record);
+
+  m_invalidated = false;
+
+  return record;
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::Commit()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_record_count++;
+  }
+
+  m_work_cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::CaptureVramBlocks(M5LineRecord* record)
+{
+  record->vram_index = m_vram_block_count;
+
+  // Move the modified patterns to the log (the pattern cache of the VDP is
+  // not used while rendering is deferred).
+  TakeDirtyPatterns(m_dirty_rows, m_dirty_summary, [this](u16 name, u8 dirty) {
+    M5VramBlock& block = m_vram_blocks[m_vram_block_count++];
+
+    block.name = name;
+    block.dirty = dirty;
+    xee::mem::Memcpy(block.data, &m_vram[name << 5], sizeof(block.data));
+  });
+
+  record->vram_count = m_vram_block_count - record->vram_index;
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::CaptureState(M5LineRecord* record)
+{
+  M5LineRenderState state;
+
+  xee::mem::Memset(&state, 0, sizeof(state));
+  xee::mem::Memcpy(state.reg, m_reg, sizeof(state.reg));
+
+  state.ntab = *m_ntab;
+  state.ntbb = *m_ntbb;
+  state.ntwb = *m_ntwb;
+  state.hscb = *m_hscb;
+
+  state.playfield_row_mask = *m_playfield_row_mask;
+  state.playfield_shift = *m_playfield_shift;
+  state.playfield_col_mask = *m_playfield_col_mask;
+  state.hscroll_mask = *m_hscroll_mask;
+
+  state.odd_frame = *m_odd_frame;
+  state.im2_flag = *m_im2_flag;
+  state.max_sprite_pixels = *m_max_sprite_pixels;
+  state.lines_per_frame = *m_lines_per_frame;
+
+  state.clip[0] = m_clip[0];
+  state.clip[1] = m_clip[1];
+
+  state.viewport.x = m_viewport->x;
+  state.viewport.y = m_viewport->y;
+  state.viewport.w = m_viewport->w;
+  state.viewport.h = m_viewport->h;
+
+  if (m_invalidated || !m_state_count ||
+    xee::mem::Memcmp(&state, &m_states[m_state_count - 1], sizeof(state))) {
+    m_states[m_state_count++] = state;
+  }
+
+  record->state_index = (u16)(m_state_count - 1);
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::CaptureVsram(M5LineRecord* record)
+{
+  if (m_invalidated || !m_vsram_count ||
+    xee::mem::Memcmp(m_vsram, &m_vsrams[(m_vsram_count - 1) * 0x80], 0x80)) {
+    xee::mem::Memcpy(&m_vsrams[m_vsram_count++ * 0x80], m_vsram, 0x80);
+  }
+
+  record->vsram_index = (u16)(m_vsram_count - 1);
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::CapturePalette(M5LineRecord* record)
+{
+  const u32 size = 0x100 * sizeof(PIXEL_OUT_T);
+
+  if (m_invalidated || !m_palette_count ||
+    xee::mem::Memcmp(m_pixel, &m_palettes[(m_palette_count - 1) * 0x100], size)) {
+    xee::mem::Memcpy(&m_palettes[m_palette_count++ * 0x100], m_pixel, size);
+  }
+
+  record->palette_index = (u16)(m_palette_count - 1);
+}
+
+//------------------------------------------------------------------------------
+
+u8 M5DeferredLineRenderer::GetNextSpriteMasking(s32 list) const
+{
+  const object_info_t* object_info = m_obj_info[list];
+  s32 count = m_object_count[list];
+  s32 max_pixels = *m_max_sprite_pixels;
+  s32 pixelcount = 0;
+
+  while (count--) {
+    // Update pixel count (off-screen sprites are included).
+    pixelcount += 8 + ((object_info->size & 0x0C) << 1);
+
+    // Sprite masking is effective on next line if max pixel width is reached.
+    if (pixelcount >= max_pixels) {
+      return (pixelcount >= m_viewport->w) ? 1 : 0;
+    }
+
+    object_info++;
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+
+void M5DeferredLineRenderer::Run(Worker* worker)
+{
+  M5LineRenderContext* context = worker->context;
+  u32 worker_count = (u32)m_workers.size();
+
+  u32 generation = ~0U;
+  u32 index = 0;
+  u32 count = 0;
+
+  // Snapshots applied to the context (indices are reused when the log is rewound).
+  s32 state_index = -1;
+  s32 vsram_index = -1;
+  s32 palette_index = -1;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      m_work_cv.wait(lock, [&] {
+        return m_stop || (generation != m_generation) || (m_record_count > index);
+      });
+
+      if (generation != m_generation) {
+        generation = m_generation;
+        index = 0;
+        state_index = -1;
+        vsram_index = -1;
+        palette_index = -1;
+      }
+
+      if (m_stop) {
+        return;
+      }
+
+      count = m_record_count;
+    }
+
+    for (; index < count; index++) {
+      const M5LineRecord& record = m_records[index];
+
+      // Every worker replays the whole log to keep its state up to date.
+      if (record.vram_count) {
+        context->ApplyVramBlocks(&m_vram_blocks[record.vram_index], record.vram_count);
+      }
+
+      if (record.state_index != state_index) {
+        state_index = record.state_index;
+        context->ApplyState(m_states[state_index]);
+      }
+
+      if (record.vsram_index != vsram_index) {
+        vsram_index = record.vsram_index;
+        context->ApplyVsram(&m_vsrams[vsram_index * 0x80]);
+      }
+
+      if (record.palette_index != palette_index) {
+        palette_index = record.palette_index;
+        context->ApplyPalette(&m_palettes[palette_index * 0x100]);
+      }
+
+      // Only the lines assigned to the worker are rendered.
+      if (((u32)record.line % worker_count) != (u32)worker->index) {
+        continue;
+      }
+
+      switch (record.command) {
+        case M5LineCommand::kRender:
+          context->RenderLine(record);
+          break;
+
+        case M5LineCommand::kBlank:
+          context->BlankLine(record.line, record.blank_offset, record.blank_width);
+          break;
+
+        case M5LineCommand::kRemap:
+          context->RemapLine(record.line);
+          break;
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      if (generation == m_generation) {
+        worker->done = index;
+      }
+    }
+
+    m_done_cv.notify_all();
+  }
+}
+
+} // namespace gpgx::ppu::vdp
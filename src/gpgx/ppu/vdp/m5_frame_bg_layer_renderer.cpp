@@ -0,0 +1,293 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/ppu/vdp/m5_frame_bg_layer_renderer.h"
+
+#include "gpgx/ppu/vdp/m5_layer_merge.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+/// Shift of the plane A and B values in the 32-bit scroll words.
+#ifdef LSB_FIRST
+static constexpr u32 kPlaneAShift = 0;
+static constexpr u32 kPlaneBShift = 16;
+#else
+static constexpr u32 kPlaneAShift = 16;
+static constexpr u32 kPlaneBShift = 0;
+#endif // #ifdef LSB_FIRST
+
+//==============================================================================
+// M5FrameBackgroundLayerRenderer
+
+//------------------------------------------------------------------------------
+
+M5FrameBackgroundLayerRenderer::M5FrameBackgroundLayerRenderer(
+  u8* reg,
+  u8* vram,
+  u8* vsram,
+
+  u8* playfield_shift,
+  u8* playfield_col_mask,
+  u16* playfield_row_mask,
+
+  u16* hscb,
+  u8* hscroll_mask,
+
+  u16* ntab,
+  u16* ntbb,
+  u16* ntwb,
+
+  u8* b_line_buffer,
+
+  u8* bg_lut,
+  u8* bg_ste_lut,
+
+  clip_t* a_clip,
+  clip_t* w_clip,
+
+  viewport_t* viewport,
+  M5BackgroundColumnDrawer* bg_column_drawer) :
+  m_reg(reg),
+  m_vram(vram),
+  m_vsram(vsram),
+
+  m_playfield_shift(playfield_shift),
+  m_playfield_col_mask(playfield_col_mask),
+  m_playfield_row_mask(playfield_row_mask),
+
+  m_hscb(hscb),
+  m_hscroll_mask(hscroll_mask),
+
+  m_ntab(ntab),
+  m_ntbb(ntbb),
+  m_ntwb(ntwb),
+
+  m_b_line_buffer(b_line_buffer),
+
+  m_bg_lut(bg_lut),
+  m_bg_ste_lut(bg_ste_lut),
+
+  m_a_clip(a_clip),
+  m_w_clip(w_clip),
+
+  m_viewport(viewport),
+  m_bg_column_drawer(bg_column_drawer)
+{
+}
+
+//------------------------------------------------------------------------------
+
+bool M5FrameBackgroundLayerRenderer::CanRenderFrame(u8 im2_flag) const
+{
+  return !im2_flag && !(m_reg[11] & 0x04) && (m_viewport->h <= kMaxLineCount);
+}
+
+//------------------------------------------------------------------------------
+
+void M5FrameBackgroundLayerRenderer::RenderFrame()
+{
+  s32 line_count = m_viewport->h;
+
+  // Plane B.
+  DrawPlane(m_b_layer, *m_ntbb, kPlaneBShift, 0, m_viewport->w >> 4, 0, line_count);
+
+  // Window & Plane A: the window takes up the entire lines above or below
+  // line a (depending on the down flag), the other lines are shared.
+  s32 a = (m_reg[18] & 0x1F) << 3;
+  s32 w = (m_reg[18] >> 7) & 1;
+
+  if (a > line_count) {
+    a = line_count;
+  }
+
+  if (a) {
+    DrawPlaneAndWindow(0, a, w == 0);
+  }
+
+  if (a < line_count) {
+    DrawPlaneAndWindow(a, line_count, w == 1);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void M5FrameBackgroundLayerRenderer::RenderBackground(s32 line)
+{
+  // Merge background layers.
+  Merge(
+    &m_a_layer[line][0x20],
+    &m_b_layer[line][0x20],
+    &m_b_line_buffer[0x20],
+    m_viewport->w
+  );
+}
+
+//------------------------------------------------------------------------------
+
+void M5FrameBackgroundLayerRenderer::DrawPlaneAndWindow(s32 first_line, s32 last_line, bool full_window)
+{
+  s32 a = 0;
+  s32 w = 1;
+
+  // Window width (entire line).
+  s32 start = 0;
+  s32 end = m_viewport->w >> 4;
+
+  if (!full_window) {
+    // Window and Plane A share the line.
+    a = m_a_clip->enable;
+    w = m_w_clip->enable;
+  }
+
+  // Plane A.
+  if (a) {
+    DrawPlane(m_a_layer, *m_ntab, kPlaneAShift, m_a_clip->left, m_a_clip->right, first_line, last_line);
+
+    // Window width.
+    start = m_w_clip->left;
+    end = m_w_clip->right;
+  }
+
+  // Window.
+  if (w) {
+    DrawWindow(start, end, first_line, last_line);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+u32 M5FrameBackgroundLayerRenderer::GetXScroll(s32 line, u32 plane_shift) const
+{
+  u32 xscroll = *(u32*)&m_vram[*m_hscb + ((line & *m_hscroll_mask) << 2)];
+
+  return (xscroll >> plane_shift) & 0xFFFF;
+}
+
+//------------------------------------------------------------------------------
+
+void M5FrameBackgroundLayerRenderer::DrawPlane(u8 (*layer)[0x200], u16 nt_base, u32 plane_shift, s32 start, s32 end, s32 first_line, s32 last_line)
+{
+  u32 yscroll = *(u32*)&m_vsram[0] >> plane_shift;
+  u32 pf_col_mask = *m_playfield_col_mask;
+  u32 pf_row_mask = *m_playfield_row_mask;
+  u32 pf_shift = *m_playfield_shift;
+
+  s32 line = first_line;
+
+  while (line < last_line) {
+    u32 xscroll = GetXScroll(line, plane_shift);
+    u32 v_line = (line + yscroll) & pf_row_mask;
+
+    // Lines of the same pattern row (the playfield height is a multiple of 8
+    // lines) with the same horizontal scroll value.
+    s32 count = 8 - (v_line & 7);
+
+    if (count > (last_line - line)) {
+      count = last_line - line;
+    }
+
+    s32 line_count = 1;
+
+    while ((line_count < count) && (GetXScroll(line + line_count, plane_shift) == xscroll)) {
+      line_count++;
+    }
+
+    // Plane scroll.
+    u32 shift = xscroll & 0x0F;
+    u32 index = pf_col_mask + start + 1 - ((xscroll >> 4) & pf_col_mask);
+
+    // Plane name table.
+    u32* nt = (u32*)&m_vram[nt_base + (((v_line >> 3) << pf_shift) & 0x1FC0)];
+
+    // Pattern row index (first line).
+    v_line = (v_line & 7) << 3;
+
+    s32 offset = 0x20 + (start << 4);
+    u32 atbuf = 0;
+    u32* dst = nullptr;
+
+    if (shift) {
+      // Window bug.
+      if (start) {
+        atbuf = nt[index & pf_col_mask];
+      } else {
+        atbuf = nt[(index - 1) & pf_col_mask];
+      }
+
+      for (s32 i = 0; i < line_count; i++) {
+        dst = (u32*)&layer[line + i][offset - 0x10 + shift];
+        m_bg_column_drawer->DrawColumn(&dst, atbuf, v_line + (i << 3));
+      }
+
+      offset += shift;
+    }
+
+    for (s32 column = start; column < end; column++, index++, offset += 0x10) {
+      atbuf = nt[index & pf_col_mask];
+
+      for (s32 i = 0; i < line_count; i++) {
+        dst = (u32*)&layer[line + i][offset];
+        m_bg_column_drawer->DrawColumn(&dst, atbuf, v_line + (i << 3));
+      }
+    }
+
+    line += line_count;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void M5FrameBackgroundLayerRenderer::DrawWindow(s32 start, s32 end, s32 first_line, s32 last_line)
+{
+  s32 line = first_line;
+
+  while (line < last_line) {
+    // Lines of the same pattern row.
+    s32 line_count = 8 - (line & 7);
+
+    if (line_count > (last_line - line)) {
+      line_count = last_line - line;
+    }
+
+    // Window name table.
+    u32* nt = (u32*)&m_vram[*m_ntwb | ((line >> 3) << (6 + (m_reg[12] & 1)))];
+
+    // Pattern row index (first line).
+    u32 v_line = (line & 7) << 3;
+
+    s32 offset = 0x20 + (start << 4);
+    u32 atbuf = 0;
+    u32* dst = nullptr;
+
+    for (s32 column = start; column < end; column++, offset += 0x10) {
+      atbuf = nt[column];
+
+      for (s32 i = 0; i < line_count; i++) {
+        dst = (u32*)&m_a_layer[line + i][offset];
+        m_bg_column_drawer->DrawColumn(&dst, atbuf, v_line + (i << 3));
+      }
+    }
+
+    line += line_count;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void M5FrameBackgroundLayerRenderer::Merge(u8* srca, u8* srcb, u8* dst, s32 width)
+{
+  if (m_reg[12] & 0x08) {
+    MergeSteBackgroundLayers(srca, srcb, dst, m_bg_ste_lut, width);
+  } else {
+    MergeBackgroundLayers(srca, srcb, dst, m_bg_lut, width);
+  }
+}
+
+} // namespace gpgx::ppu::vdp
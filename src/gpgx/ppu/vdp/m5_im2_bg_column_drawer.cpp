@@ -55,44 +55,5 @@ M5Im2BackgroundColumnDrawer::M5Im2BackgroundColumnDrawer(
 {
 }
 
-//------------------------------------------------------------------------------
-
-void M5Im2BackgroundColumnDrawer::DrawColumn(u32** dest, u32 attr, u32 line)
-{
-#ifdef LSB_FIRST
-  DrawLSBTile(dest, attr, line);
-  DrawMSBTile(dest, attr, line);
-#else
-  DrawMSBTile(dest, attr, line);
-  DrawLSBTile(dest, attr, line);
-#endif // #ifdef LSB_FIRST
-}
-
-//------------------------------------------------------------------------------
-
-void M5Im2BackgroundColumnDrawer::DrawLSBTile(u32** dest, u32 attr, u32 line)
-{
-  u32 atex = m_atex_table[(attr >> 13) & 7];;
-  u32* src = (u32*)&m_pattern_cache[((attr & 0x000003FF) << 7 | (attr & 0x00001800) << 6 | line) ^ ((attr & 0x00001000) >> 6)];
-
-  **dest = (src[0] | atex);
-  (*dest)++;
-  **dest = (src[1] | atex);
-  (*dest)++;
-}
-
-//------------------------------------------------------------------------------
-
-void M5Im2BackgroundColumnDrawer::DrawMSBTile(u32** dest, u32 attr, u32 line)
-{
-  u32 atex = m_atex_table[(attr >> 29) & 7];
-  u32* src = (u32*)&m_pattern_cache[((attr & 0x03FF0000) >> 9 | (attr & 0x18000000) >> 10 | line) ^ ((attr & 0x10000000) >> 22)];
-
-  **dest = (src[0] | atex);
-  (*dest)++;
-  **dest = (src[1] | atex);
-  (*dest)++;
-}
-
 } // namespace gpgx::ppu::vdp
 
@@ -40,6 +40,8 @@
 
 #include "gpgx/ppu/vdp/m5_im2_bg_layer_renderer.h"
 
+#include "gpgx/ppu/vdp/m5_layer_merge.h"
+
 namespace gpgx::ppu::vdp {
 
 //==============================================================================
@@ -247,18 +249,19 @@ void M5Im2BackgroundLayerRenderer::RenderBackground(s32 line)
     &m_a_line_buffer[0x20], 
     &m_b_line_buffer[0x20], 
     &m_b_line_buffer[0x20], 
-    (m_reg[12] & 0x08) ? m_bg_ste_lut : m_bg_lut,
     m_viewport->w
   );
 }
 
 //------------------------------------------------------------------------------
 
-void M5Im2BackgroundLayerRenderer::Merge(u8* srca, u8* srcb, u8* dst, u8* table, s32 width)
+void M5Im2BackgroundLayerRenderer::Merge(u8* srca, u8* srcb, u8* dst, s32 width)
 {
-  do {
-    *dst++ = table[(*srcb++ << 8) | (*srca++)];
-  } while (--width);
+  if (m_reg[12] & 0x08) {
+    MergeSteBackgroundLayers(srca, srcb, dst, m_bg_ste_lut, width);
+  } else {
+    MergeBackgroundLayers(srca, srcb, dst, m_bg_lut, width);
+  }
 }
 
 } // namespace gpgx::ppu::vdp
@@ -0,0 +1,440 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/ppu/vdp/m5_line_render_context.h"
+
+#include "xee/mem/memory.h" // For Memcpy() and Memset().
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+// M5LineRenderContext
+
+//------------------------------------------------------------------------------
+
+M5LineRenderContext::M5LineRenderContext(
+  u8 (*lut)[kLayerPriorityLutSize],
+  u8* name_lut,
+  const u32* atex_table,
+  LineChangeTracker* line_changes,
+  framebuffer_t* framebuffer) :
+  m_line_changes(line_changes),
+  m_framebuffer(framebuffer)
+{
+  Reset();
+
+  xee::mem::Memset(m_reg, 0, sizeof(m_reg));
+  xee::mem::Memset(m_pixel, 0, sizeof(m_pixel));
+  m_palette_hash = LineChangeTracker::Hash(m_pixel, sizeof(m_pixel), 0);
+  xee::mem::Memset(m_obj_info, 0, sizeof(m_obj_info));
+  xee::mem::Memset(m_clip, 0, sizeof(m_clip));
+  xee::mem::Memset(&m_viewport, 0, sizeof(m_viewport));
+
+  m_ntab = 0;
+  m_ntbb = 0;
+  m_ntwb = 0;
+  m_hscb = 0;
+
+  m_playfield_shift = 6;
+  m_playfield_col_mask = 0x0F;
+  m_playfield_row_mask = 0x0FF;
+  m_hscroll_mask = 0x00;
+
+  m_odd_frame = 0;
+  m_im2_flag = 0;
+  m_max_sprite_pixels = 256;
+  m_lines_per_frame = 262;
+
+  m_bg_column_drawer = new M5BackgroundColumnDrawer(atex_table, m_pattern_cache);
+  m_bg_column_drawer_im2 = new M5Im2BackgroundColumnDrawer(atex_table, m_pattern_cache);
+
+  m_bg_layer_renderer = new M5BackgroundLayerRenderer(
+    m_reg,
+    m_vram,
+    m_vsram,
+
+    &m_playfield_shift,
+    &m_playfield_col_mask,
+    &m_playfield_row_mask,
+
+    &m_hscb,
+    &m_hscroll_mask,
+
+    &m_ntab,
+    &m_ntbb,
+    &m_ntwb,
+
+    m_line_buffer[1],
+    m_line_buffer[0],
+
+    lut[0],
+    lut[2],
+
+    &m_clip[0],
+    &m_clip[1],
+
+    &m_viewport,
+    m_bg_column_drawer
+  );
+
+  m_bg_layer_renderer_vs = new M5VsBackgroundLayerRenderer(
+    m_reg,
+    m_vram,
+    m_vsram,
+
+    &m_playfield_shift,
+    &m_playfield_col_mask,
+    &m_playfield_row_mask,
+
+    &m_hscb,
+    &m_hscroll_mask,
+
+    &m_ntab,
+    &m_ntbb,
+    &m_ntwb,
+
+    m_line_buffer[1],
+    m_line_buffer[0],
+
+    lut[0],
+    lut[2],
+
+    &m_clip[0],
+    &m_clip[1],
+
+    &m_viewport,
+    m_bg_column_drawer
+  );
+
+  m_bg_layer_renderer_im2 = new M5Im2BackgroundLayerRenderer(
+    m_reg,
+    m_vram,
+    m_vsram,
+
+    &m_odd_frame,
+
+    &m_playfield_shift,
+    &m_playfield_col_mask,
+    &m_playfield_row_mask,
+
+    &m_hscb,
+    &m_hscroll_mask,
+
+    &m_ntab,
+    &m_ntbb,
+    &m_ntwb,
+
+    m_line_buffer[1],
+    m_line_buffer[0],
+
+    lut[0],
+    lut[2],
+
+    &m_clip[0],
+    &m_clip[1],
+
+    &m_viewport,
+    m_bg_column_drawer_im2
+  );
+
+  m_bg_layer_renderer_im2_vs = new M5Im2VsBackgroundLayerRenderer(
+    m_reg,
+    m_vram,
+    m_vsram,
+
+    &m_odd_frame,
+
+    &m_playfield_shift,
+    &m_playfield_col_mask,
+    &m_playfield_row_mask,
+
+    &m_hscb,
+    &m_hscroll_mask,
+
+    &m_ntab,
+    &m_ntbb,
+    &m_ntwb,
+
+    m_line_buffer[1],
+    m_line_buffer[0],
+
+    lut[0],
+    lut[2],
+
+    &m_clip[0],
+    &m_clip[1],
+
+    &m_viewport,
+    m_bg_column_drawer_im2
+  );
+
+  m_sprite_layer_renderer = new M5SpriteLayerRenderer(
+    m_obj_info,
+    m_object_count,
+    &m_status,
+    &m_spr_ovr,
+    m_pattern_cache,
+    m_line_buffer[0],
+    lut[1],
+    name_lut,
+    &m_max_sprite_pixels,
+    &m_viewport
+  );
+
+  m_sprite_layer_renderer_ste = new M5SteSpriteLayerRenderer(
+    m_obj_info,
+    m_object_count,
+    &m_status,
+    &m_spr_ovr,
+    m_pattern_cache,
+    m_line_buffer[1],
+    lut[3],
+    m_line_buffer[0],
+    lut[4],
+    name_lut,
+    &m_max_sprite_pixels,
+    &m_viewport
+  );
+
+  m_sprite_layer_renderer_im2 = new M5Im2SpriteLayerRenderer(
+    m_obj_info,
+    m_object_count,
+    &m_status,
+    &m_odd_frame,
+    &m_spr_ovr,
+    m_pattern_cache,
+    m_line_buffer[0],
+    lut[1],
+    name_lut,
+    &m_max_sprite_pixels,
+    &m_viewport
+  );
+
+  m_sprite_layer_renderer_im2_ste = new M5Im2SteSpriteLayerRenderer(
+    m_obj_info,
+    m_object_count,
+    &m_status,
+    &m_odd_frame,
+    &m_spr_ovr,
+    m_pattern_cache,
+    m_line_buffer[1],
+    lut[3],
+    m_line_buffer[0],
+    lut[4],
+    name_lut,
+    &m_max_sprite_pixels,
+    &m_viewport
+  );
+
+  m_bg_pattern_cache_updater = new M5BackgroundPatternCacheUpdater(
+    m_pattern_cache,
+    m_dirty_rows,
+    m_dirty_summary,
+    m_vram
+  );
+
+  m_line_renderer = new M5LineRenderer(
+    m_bg_layer_renderer,
+    m_bg_layer_renderer_vs,
+    m_bg_layer_renderer_im2,
+    m_bg_layer_renderer_im2_vs,
+
+    m_sprite_layer_renderer,
+    m_sprite_layer_renderer_ste,
+    m_sprite_layer_renderer_im2,
+    m_sprite_layer_renderer_im2_ste
+  );
+}
+
+//------------------------------------------------------------------------------
+
+M5LineRenderContext::~M5LineRenderContext()
+{
+  delete m_line_renderer;
+  delete m_bg_pattern_cache_updater;
+
+  delete m_sprite_layer_renderer_im2_ste;
+  delete m_sprite_layer_renderer_im2;
+  delete m_sprite_layer_renderer_ste;
+  delete m_sprite_layer_renderer;
+
+  delete m_bg_layer_renderer_im2_vs;
+  delete m_bg_layer_renderer_im2;
+  delete m_bg_layer_renderer_vs;
+  delete m_bg_layer_renderer;
+
+  delete m_bg_column_drawer_im2;
+  delete m_bg_column_drawer;
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderContext::Reset()
+{
+  xee::mem::Memset(m_vram, 0, sizeof(m_vram));
+  xee::mem::Memset(m_vsram, 0, sizeof(m_vsram));
+  xee::mem::Memset(m_pattern_cache, 0, sizeof(m_pattern_cache));
+  xee::mem::Memset(m_line_buffer, 0, sizeof(m_line_buffer));
+
+  ClearPatternsDirty(m_dirty_rows, m_dirty_summary);
+
+  m_status = 0;
+  m_spr_ovr = 0;
+  m_object_count[0] = m_object_count[1] = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderContext::ApplyVramBlocks(const M5VramBlock* blocks, u32 count)
+{
+  for (u32 i = 0; i < count; i++) {
+    const M5VramBlock& block = blocks[i];
+
+    xee::mem::Memcpy(&m_vram[block.name << 5], block.data, 32);
+
+    // Mark pattern rows as modified (same as MARK_BG_DIRTY).
+    MarkPatternDirty(m_dirty_rows, m_dirty_summary, block.name, block.dirty);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderContext::ApplyState(const M5LineRenderState& state)
+{
+  xee::mem::Memcpy(m_reg, state.reg, sizeof(m_reg));
+
+  m_ntab = state.ntab;
+  m_ntbb = state.ntbb;
+  m_ntwb = state.ntwb;
+  m_hscb = state.hscb;
+
+  m_playfield_shift = state.playfield_shift;
+  m_playfield_col_mask = state.playfield_col_mask;
+  m_playfield_row_mask = state.playfield_row_mask;
+  m_hscroll_mask = state.hscroll_mask;
+
+  m_odd_frame = state.odd_frame;
+  m_im2_flag = state.im2_flag;
+  m_max_sprite_pixels = state.max_sprite_pixels;
+  m_lines_per_frame = state.lines_per_frame;
+
+  m_clip[0] = state.clip[0];
+  m_clip[1] = state.clip[1];
+
+  m_viewport.x = state.viewport.x;
+  m_viewport.y = state.viewport.y;
+  m_viewport.w = state.viewport.w;
+  m_viewport.h = state.viewport.h;
+
+  // Same selection as render_update_mode().
+  m_line_renderer->SetMode(m_im2_flag != 0, (m_reg[11] & 0x04) != 0, (m_reg[12] & 0x08) != 0);
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderContext::ApplyVsram(const u8* vsram)
+{
+  xee::mem::Memcpy(m_vsram, vsram, sizeof(m_vsram));
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderContext::ApplyPalette(const PIXEL_OUT_T* palette)
+{
+  xee::mem::Memcpy(m_pixel, palette, sizeof(m_pixel));
+  m_palette_hash = LineChangeTracker::Hash(m_pixel, sizeof(m_pixel), 0);
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderContext::RenderLine(const M5LineRecord& record)
+{
+  s32 line = record.line;
+
+  // Check display status.
+  if (m_reg[1] & 0x40) {
+    // Update pattern cache.
+    if (IsAnyPatternDirty(m_dirty_summary)) {
+      m_bg_pattern_cache_updater->UpdateBackgroundPatternCache();
+    }
+
+    // Sprites of the line (parsed by the emulation thread).
+    m_spr_ovr = record.spr_ovr;
+    m_object_count[line & 1] = record.object_count;
+    xee::mem::Memcpy(m_obj_info[line & 1], record.obj_info, record.object_count * sizeof(object_info_t));
+
+    // Render BG & sprite layers.
+    m_line_renderer->RenderLayers(line);
+
+    // Left-most column blanking (the VDP is always a Mega Drive VDP in mode 5).
+    if (m_reg[0] & 0x20) {
+      xee::mem::Memset(&m_line_buffer[0][0x20], 0x40, 8);
+    }
+
+    // Horizontal borders.
+    if (m_viewport.x > 0) {
+      xee::mem::Memset(&m_line_buffer[0][0x20 - m_viewport.x], 0x40, m_viewport.x);
+      xee::mem::Memset(&m_line_buffer[0][0x20 + m_viewport.w], 0x40, m_viewport.x);
+    }
+  } else {
+    // Blanked line.
+    xee::mem::Memset(&m_line_buffer[0][0x20 - m_viewport.x], 0x40, m_viewport.w + 2*m_viewport.x);
+  }
+
+  // Pixel color remapping.
+  RemapLine(line);
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderContext::BlankLine(s32 line, s32 offset, s32 width)
+{
+  xee::mem::Memset(&m_line_buffer[0][0x20 + offset], 0x40, width);
+  RemapLine(line);
+}
+
+//------------------------------------------------------------------------------
+
+u16 M5LineRenderContext::TakeStatus()
+{
+  u16 status = m_status;
+  m_status = 0;
+
+  return status;
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderContext::RemapLine(s32 line)
+{
+  // Line width.
+  s32 width = m_viewport.w + 2*m_viewport.x;
+
+  // Pixel line buffer.
+  u8* src = &m_line_buffer[0][0x20 - m_viewport.x];
+
+  // Adjust line offset in framebuffer.
+  line = (line + m_viewport.y) % m_lines_per_frame;
+
+  // Take care of Game Gear reduced screen when overscan is disabled.
+  if (line < 0) {
+    return;
+  }
+
+  // Track changed lines.
+  if (m_line_changes) {
+    m_line_changes->UpdateLine(line, src, width, m_palette_hash);
+  }
+
+  // Convert VDP pixel data to output pixel format.
+  PIXEL_OUT_T* dst = (PIXEL_OUT_T*)&m_framebuffer->data[line * m_framebuffer->pitch];
+
+  do {
+    *dst++ = m_pixel[*src++];
+  } while (--width);
+}
+
+} // namespace gpgx::ppu::vdp
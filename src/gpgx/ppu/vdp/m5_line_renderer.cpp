@@ -0,0 +1,94 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/ppu/vdp/m5_line_renderer.h"
+
+namespace gpgx::ppu::vdp {
+
+//==============================================================================
+// M5LineRenderer
+
+//------------------------------------------------------------------------------
+
+const M5LineRenderer::RenderLayersFunction M5LineRenderer::kRenderLayersFunctions[8] =
+{
+  &M5LineRenderer::RenderLayersT<false, false, false>,
+  &M5LineRenderer::RenderLayersT<false, false, true>,
+  &M5LineRenderer::RenderLayersT<false, true, false>,
+  &M5LineRenderer::RenderLayersT<false, true, true>,
+  &M5LineRenderer::RenderLayersT<true, false, false>,
+  &M5LineRenderer::RenderLayersT<true, false, true>,
+  &M5LineRenderer::RenderLayersT<true, true, false>,
+  &M5LineRenderer::RenderLayersT<true, true, true>
+};
+
+//------------------------------------------------------------------------------
+
+M5LineRenderer::M5LineRenderer(
+  M5BackgroundLayerRenderer* bg_layer_renderer,
+  M5VsBackgroundLayerRenderer* bg_layer_renderer_vs,
+  M5Im2BackgroundLayerRenderer* bg_layer_renderer_im2,
+  M5Im2VsBackgroundLayerRenderer* bg_layer_renderer_im2_vs,
+
+  M5SpriteLayerRenderer* sprite_layer_renderer,
+  M5SteSpriteLayerRenderer* sprite_layer_renderer_ste,
+  M5Im2SpriteLayerRenderer* sprite_layer_renderer_im2,
+  M5Im2SteSpriteLayerRenderer* sprite_layer_renderer_im2_ste) :
+  m_bg_layer_renderer(bg_layer_renderer),
+  m_bg_layer_renderer_vs(bg_layer_renderer_vs),
+  m_bg_layer_renderer_im2(bg_layer_renderer_im2),
+  m_bg_layer_renderer_im2_vs(bg_layer_renderer_im2_vs),
+
+  m_sprite_layer_renderer(sprite_layer_renderer),
+  m_sprite_layer_renderer_ste(sprite_layer_renderer_ste),
+  m_sprite_layer_renderer_im2(sprite_layer_renderer_im2),
+  m_sprite_layer_renderer_im2_ste(sprite_layer_renderer_im2_ste),
+
+  m_render_layers(kRenderLayersFunctions[0])
+{
+}
+
+//------------------------------------------------------------------------------
+
+void M5LineRenderer::SetMode(bool im2, bool vscroll, bool ste)
+{
+  m_render_layers = kRenderLayersFunctions[(im2 << 2) | (vscroll << 1) | ste];
+}
+
+//------------------------------------------------------------------------------
+
+template <bool kIm2, bool kVScroll, bool kSte>
+void M5LineRenderer::RenderLayersT(s32 line)
+{
+  // The layer renderers are final classes: the calls below are direct calls.
+  if constexpr (kIm2) {
+    if constexpr (kVScroll) {
+      m_bg_layer_renderer_im2_vs->RenderBackground(line);
+    } else {
+      m_bg_layer_renderer_im2->RenderBackground(line);
+    }
+
+    if constexpr (kSte) {
+      m_sprite_layer_renderer_im2_ste->RenderSprites(line & 1);
+    } else {
+      m_sprite_layer_renderer_im2->RenderSprites(line & 1);
+    }
+  } else {
+    if constexpr (kVScroll) {
+      m_bg_layer_renderer_vs->RenderBackground(line);
+    } else {
+      m_bg_layer_renderer->RenderBackground(line);
+    }
+
+    if constexpr (kSte) {
+      m_sprite_layer_renderer_ste->RenderSprites(line & 1);
+    } else {
+      m_sprite_layer_renderer->RenderSprites(line & 1);
+    }
+  }
+}
+
+} // namespace gpgx::ppu::vdp
@@ -40,6 +40,8 @@
 
 #include "gpgx/ppu/vdp/m5_satb_parser.h"
 
+#include "xee/mem/memory.h" // For Memset().
+
 #include "core/vdp/object_info_t.h"
 
 namespace gpgx::ppu::vdp {
@@ -55,6 +57,7 @@ M5SpriteAttributeTableParser::M5SpriteAttributeTableParser(
   object_info_t(&obj_info)[2][20],
   u8* object_count,
   u8* sat,
+  u8* sat_dirty,
   u16* satb,
   u8* im2_flag,
   u16* max_sprite_pixels,
@@ -64,11 +67,17 @@ M5SpriteAttributeTableParser::M5SpriteAttributeTableParser(
   m_obj_info(obj_info),
   m_object_count(object_count),
   m_sat(sat),
+  m_sat_dirty(sat_dirty),
   m_satb(satb),
   m_im2_flag(im2_flag),
   m_max_sprite_pixels(max_sprite_pixels),
-  m_status(status)
+  m_status(status),
+  m_index_width(0),
+  m_index_max_sprite_pixels(0),
+  m_index_im2_flag(0)
 {
+  // The sprite index is built on first use.
+  *m_sat_dirty = 1;
 }
 
 //------------------------------------------------------------------------------
@@ -81,6 +90,63 @@ s32 M5SpriteAttributeTableParser::GetMaxSpritesPerLine() const
 //------------------------------------------------------------------------------
 
 void M5SpriteAttributeTableParser::ParseSpriteAttributeTable(s32 line)
+{
+  // Rebuild the sprite index if needed.
+  if (*m_sat_dirty || (m_index_width != m_viewport->w) || 
+    (m_index_max_sprite_pixels != *m_max_sprite_pixels) || (m_index_im2_flag != *m_im2_flag)) {
+    UpdateSpriteIndex();
+  }
+
+  // Sprite counter.
+  int count = 0;
+
+  // max. number of rendered sprites (16 or 20 sprites per line by default).
+  int max = GetMaxSpritesPerLine();
+
+  // Pointer to sprite attribute table.
+  u16* p = (u16*)&m_vram[*m_satb];
+
+  // Sprite list for next line.
+  object_info_t* object_info = m_obj_info[(line + 1) & 1];
+
+  // Adjust line offset.
+  line += 0x81;
+
+  if ((line >= 0) && (line < kIndexLineCount)) {
+    count = m_line_sprite_count[line];
+
+    // Sprite overflow.
+    if (count > max) {
+      *m_status |= 0x40;
+
+      count = max;
+    }
+
+    u8* sprites = m_line_sprites[line];
+
+    for (int i = 0; i < count; i++) {
+      // Sprite entry.
+      int index = sprites[i];
+      int link = index << 2;
+
+      // Update sprite list (only name, attribute & xpos are parsed from VRAM).
+      object_info->attr = p[link + 2];
+      object_info->xpos = p[link + 3] & 0x1ff;
+      object_info->ypos = line - m_sprite_ypos[index];
+      object_info->size = m_sprite_size[index];
+
+      // Next sprite entry.
+      object_info++;
+    }
+  }
+
+  // Update sprite count for next line (line value already incremented).
+  m_object_count[line & 1] = count;
+}
+
+//------------------------------------------------------------------------------
+
+void M5SpriteAttributeTableParser::UpdateSpriteIndex()
 {
   // Y position.
   int ypos;
@@ -94,62 +160,37 @@ void M5SpriteAttributeTableParser::ParseSpriteAttributeTable(s32 line)
   // Sprite link data.
   int link = 0;
 
-  // Sprite counter.
-  int count = 0;
+  // max. number of indexed sprites per line (one more than rendered to detect sprite overflow).
+  int max = GetMaxSpritesPerLine() + 1;
 
-  // max. number of rendered sprites (16 or 20 sprites per line by default).
-  int max = GetMaxSpritesPerLine();
+  if (max > kIndexSpriteCount) {
+    max = kIndexSpriteCount;
+  }
 
   // max. number of parsed sprites (64 or 80 sprites per line by default).
   int total = *m_max_sprite_pixels >> 2;
 
-  // Pointer to sprite attribute table.
-  u16* p = (u16*)&m_vram[*m_satb];
-
   // Pointer to internal RAM.
   u16* q = (u16*)&m_sat[0];
 
-  // Sprite list for next line.
-  object_info_t* object_info = m_obj_info[(line + 1) & 1];
-
-  // Adjust line offset.
-  line += 0x81;
+  xee::mem::Memset(m_line_sprite_count, 0, sizeof(m_line_sprite_count));
 
+  // Walk the linked sprite list (same as the original per-line parsing).
   do {
-    // Read Y position from internal SAT cache.
+    // Read Y position & sprite size from internal SAT cache.
     ypos = (q[link] >> *m_im2_flag) & 0x1FF;
+    size = q[link + 1] >> 8;
 
-    // Check if sprite Y position has been reached.
-    if (line >= ypos) {
-      // Read sprite size from internal SAT cache.
-      size = q[link + 1] >> 8;
-
-      // Sprite height.
-      height = 8 + ((size & 3) << 3);
-
-      // Y range.
-      ypos = line - ypos;
+    // Sprite height.
+    height = 8 + ((size & 3) << 3);
 
-      // Check if sprite is visible on current line.
-      if (ypos < height) {
-        // Sprite overflow.
-        if (count == max) {
-          *m_status |= 0x40;
+    m_sprite_ypos[link >> 2] = ypos;
+    m_sprite_size[link >> 2] = size & 0x0f;
 
-          break;
-        }
-
-        // Update sprite list (only name, attribute & xpos are parsed from VRAM).
-        object_info->attr = p[link + 2];
-        object_info->xpos = p[link + 3] & 0x1ff;
-        object_info->ypos = ypos;
-        object_info->size = size & 0x0f;
-
-        // Increment Sprite count.
-        ++count;
-
-        // Next sprite entry.
-        object_info++;
+    // Add sprite to the lines it covers (in link order).
+    for (int y = ypos; y < (ypos + height); y++) {
+      if (m_line_sprite_count[y] < max) {
+        m_line_sprites[y][m_line_sprite_count[y]++] = link >> 2;
       }
     }
 
@@ -162,8 +203,11 @@ void M5SpriteAttributeTableParser::ParseSpriteAttributeTable(s32 line)
     }
   } while (--total);
 
-  // Update sprite count for next line (line value already incremented).
-  m_object_count[line & 1] = count;
+  m_index_width = m_viewport->w;
+  m_index_max_sprite_pixels = *m_max_sprite_pixels;
+  m_index_im2_flag = *m_im2_flag;
+
+  *m_sat_dirty = 0;
 }
 
 } // namespace gpgx::ppu::vdp
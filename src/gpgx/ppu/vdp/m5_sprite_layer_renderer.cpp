@@ -42,6 +42,7 @@
 
 #include "core/vdp/object_info_t.h"
 
+#include "gpgx/ppu/vdp/m5_pattern_cache.h"
 #include "gpgx/ppu/vdp/m5_sprite_tile_drawer.h"
 
 namespace gpgx::ppu::vdp {
@@ -85,7 +86,6 @@ void M5SpriteLayerRenderer::RenderSprites(s32 line)
   s32 masked = 0;
   s32 max_pixels = *m_max_sprite_pixels;
 
-  u8* src = nullptr;
   u8* s = nullptr;
   u8* lb = nullptr;
   u32 temp = 0;
@@ -158,12 +158,27 @@ void M5SpriteLayerRenderer::RenderSprites(s32 line)
       // Pattern row index.
       v_line = (v_line & 7) << 3;
 
+#ifdef USE_COMPACT_PATTERN_CACHE
+      // Flipped pattern row.
+      u32 hflip = GetFlipMask(attr, 11);
+      u32 row[2];
+
+      v_line ^= (GetFlipMask(attr, 12) & 0x38);
+
+      // Draw sprite patterns.
+      for (column = 0; column < width; column++, lb += 8) {
+        temp = (name + s[column]) & 0x07FF;
+        ReadPatternRow(&m_pattern_cache[(temp << 6) | (v_line)], hflip, row);
+        m_sprite_tile_drawer->DrawSpriteTile(8, atex, (u8*)row, lb);
+      }
+#else
       // Draw sprite patterns.
       for (column = 0; column < width; column++, lb += 8) {
         temp = attr | ((name + s[column]) & 0x07FF);
-        src = &m_pattern_cache[(temp << 6) | (v_line)];
+        u8* src = &m_pattern_cache[(temp << 6) | (v_line)];
         m_sprite_tile_drawer->DrawSpriteTile(8, atex, src, lb);
       }
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
     }
 
     // Sprite limit.
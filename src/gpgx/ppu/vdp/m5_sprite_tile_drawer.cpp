@@ -40,6 +40,8 @@
 
 #include "gpgx/ppu/vdp/m5_sprite_tile_drawer.h"
 
+#include "gpgx/ppu/vdp/m5_layer_merge.h"
+
 namespace gpgx::ppu::vdp {
 
 //==============================================================================
@@ -57,17 +59,8 @@ M5SpriteTileDrawer::M5SpriteTileDrawer(u16* status, u8* lut) :
 
 void M5SpriteTileDrawer::DrawSpriteTile(s32 width, s32 attr, u8* src, u8* line_buffer)
 {
-  u32 temp = 0;
-
-  for (s32 i = 0; i < width; i++) {
-    temp = *src++;
-
-    if (temp & 0x0f) {
-      temp |= (line_buffer[i] << 8);
-      line_buffer[i] = m_lut[temp | attr];
-
-      *m_status |= ((temp & 0x8000) >> 10);
-    }
+  for (s32 i = 0; i < width; i += 8) {
+    *m_status |= DrawSpritePixels(&src[i], attr, &line_buffer[i], m_lut);
   }
 }
 
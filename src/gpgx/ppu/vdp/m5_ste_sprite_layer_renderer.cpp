@@ -44,6 +44,9 @@
 
 #include "core/vdp/object_info_t.h"
 
+#include "gpgx/ppu/vdp/m5_layer_merge.h"
+#include "gpgx/ppu/vdp/m5_pattern_cache.h"
+
 namespace gpgx::ppu::vdp {
 
 //==============================================================================
@@ -75,7 +78,7 @@ M5SteSpriteLayerRenderer::M5SteSpriteLayerRenderer(
   m_max_sprite_pixels(max_sprite_pixels),
   m_viewport(viewport)
 {
-  m_sprite_tile_drawer = new gpgx::ppu::vdp::M5SpriteTileDrawer(status, spr_lut);
+  m_sprite_tile_drawer = new gpgx::ppu::vdp::M5SteSpriteTileDrawer(status, spr_lut);
 }
 
 //------------------------------------------------------------------------------
@@ -89,7 +92,6 @@ void M5SteSpriteLayerRenderer::RenderSprites(s32 line)
   s32 masked = 0;
   s32 max_pixels = *m_max_sprite_pixels;
 
-  u8* src = nullptr;
   u8* s = nullptr;
   u8* lb = nullptr;
   u32 temp = 0;
@@ -165,12 +167,27 @@ void M5SteSpriteLayerRenderer::RenderSprites(s32 line)
       // Pattern row index.
       v_line = (v_line & 7) << 3;
 
+#ifdef USE_COMPACT_PATTERN_CACHE
+      // Flipped pattern row.
+      u32 hflip = GetFlipMask(attr, 11);
+      u32 row[2];
+
+      v_line ^= (GetFlipMask(attr, 12) & 0x38);
+
+      // Draw sprite patterns.
+      for (column = 0; column < width; column++, lb += 8) {
+        temp = (name + s[column]) & 0x07FF;
+        ReadPatternRow(&m_pattern_cache[(temp << 6) | (v_line)], hflip, row);
+        m_sprite_tile_drawer->DrawSpriteTile(8, atex, (u8*)row, lb);
+      }
+#else
       // Draw sprite patterns.
       for (column = 0; column < width; column++, lb += 8) {
         temp = attr | ((name + s[column]) & 0x07FF);
-        src = &m_pattern_cache[(temp << 6) | (v_line)];
+        u8* src = &m_pattern_cache[(temp << 6) | (v_line)];
         m_sprite_tile_drawer->DrawSpriteTile(8, atex, src, lb);
       }
+#endif // #ifdef USE_COMPACT_PATTERN_CACHE
     }
 
     // Sprite limit.
@@ -179,7 +196,7 @@ void M5SteSpriteLayerRenderer::RenderSprites(s32 line)
       *m_spr_ovr = (pixelcount >= m_viewport->w);
 
       // Merge background & sprite layers.
-      Merge(&m_spr_line_buffer[0x20], &m_bg_line_buffer[0x20], &m_bg_line_buffer[0x20], m_bg_spr_lut, m_viewport->w);
+      Merge(&m_spr_line_buffer[0x20], &m_bg_line_buffer[0x20], &m_bg_line_buffer[0x20], m_viewport->w);
 
       // Stop sprite rendering.
       return;
@@ -193,16 +210,14 @@ void M5SteSpriteLayerRenderer::RenderSprites(s32 line)
   *m_spr_ovr = 0;
 
   // Merge background & sprite layers.
-  Merge(&m_spr_line_buffer[0x20], &m_bg_line_buffer[0x20], &m_bg_line_buffer[0x20], m_bg_spr_lut, m_viewport->w);
+  Merge(&m_spr_line_buffer[0x20], &m_bg_line_buffer[0x20], &m_bg_line_buffer[0x20], m_viewport->w);
 }
 
 //------------------------------------------------------------------------------
 
-void M5SteSpriteLayerRenderer::Merge(u8* srca, u8* srcb, u8* dst, u8* table, s32 width)
+void M5SteSpriteLayerRenderer::Merge(u8* srca, u8* srcb, u8* dst, s32 width)
 {
-  do {
-    *dst++ = table[(*srcb++ << 8) | (*srca++)];
-  } while (--width);
+  MergeSteSpriteLayer(srca, srcb, dst, m_bg_spr_lut, width);
 }
 
 } // namespace gpgx::ppu::vdp
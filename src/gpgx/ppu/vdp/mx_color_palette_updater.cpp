@@ -57,6 +57,7 @@ MXColorPaletteUpdater::MXColorPaletteUpdater(
   u8* system_hw) :
   m_reg(reg),
   m_pixel(pixel),
+  m_version(0),
   m_system_hw(system_hw)
 {
   xee::mem::Memset(&m_pixel_lut, 0, sizeof(m_pixel_lut));
@@ -97,6 +98,8 @@ void MXColorPaletteUpdater::Initialize()
 
 void MXColorPaletteUpdater::UpdateColor(s32 index, u32 data)
 {
+  m_version++;
+
   switch (*m_system_hw) {
     case SYSTEM_GG:
     {
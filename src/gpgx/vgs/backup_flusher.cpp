@@ -0,0 +1,193 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/vgs/backup_flusher.h"
+
+#include <cstdio>
+
+#include "xee/mem/memory.h" // For Memcmp() and Memcpy().
+
+namespace gpgx::vgs {
+
+//==============================================================================
+// BackupFlusher
+
+//------------------------------------------------------------------------------
+
+BackupFlusher::BackupFlusher() :
+  m_stop(false)
+{
+}
+
+//------------------------------------------------------------------------------
+
+BackupFlusher::~BackupFlusher()
+{
+  Stop();
+
+  for (File* file : m_files) {
+    delete file;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void BackupFlusher::Start()
+{
+  if (IsRunning()) {
+    return;
+  }
+
+  m_stop = false;
+  m_worker = std::thread(&BackupFlusher::Run, this);
+}
+
+//------------------------------------------------------------------------------
+
+void BackupFlusher::Stop()
+{
+  if (!IsRunning()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_cv.notify_one();
+  m_worker.join();
+}
+
+//------------------------------------------------------------------------------
+
+void BackupFlusher::SetSaved(const char* path, const u8* data, u32 size)
+{
+  File* file = GetFile(path);
+
+  file->data.assign(data, data + size);
+}
+
+//------------------------------------------------------------------------------
+
+void BackupFlusher::Save(const char* path, const u8* data, u32 size)
+{
+  File* file = GetFile(path);
+
+  if ((file->data.size() == size) && !xee::mem::Memcmp(file->data.data(), data, size)) {
+    return;
+  }
+
+  file->data.assign(data, data + size);
+
+  if (!IsRunning()) {
+    WriteFile(file->path, data, size);
+    return;
+  }
+
+  {
+    // A snapshot not written yet is replaced.
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    file->pending.resize(size);
+    xee::mem::Memcpy(file->pending.data(), data, size);
+    file->queued = true;
+  }
+
+  m_cv.notify_one();
+}
+
+//------------------------------------------------------------------------------
+
+bool BackupFlusher::WriteFile(const std::string& path, const u8* data, u32 size)
+{
+  std::string temp_path = path + ".tmp";
+  FILE* fp = fopen(temp_path.c_str(), "wb");
+
+  if (!fp) {
+    return false;
+  }
+
+  bool ok = (fwrite(data, 1, size, fp) == size);
+
+  if (fclose(fp)) {
+    ok = false;
+  }
+
+  // Some systems do not replace an existing file.
+  if (ok && std::rename(temp_path.c_str(), path.c_str())) {
+    std::remove(path.c_str());
+    ok = !std::rename(temp_path.c_str(), path.c_str());
+  }
+
+  if (!ok) {
+    std::remove(temp_path.c_str());
+  }
+
+  return ok;
+}
+
+//------------------------------------------------------------------------------
+
+BackupFlusher::File* BackupFlusher::GetFile(const char* path)
+{
+  for (File* file : m_files) {
+    if (file->path == path) {
+      return file;
+    }
+  }
+
+  // Files are only added by the emulation thread, the worker only accesses
+  // the snapshots of the files (under lock).
+  File* file = new File();
+
+  file->path = path;
+  file->queued = false;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_files.push_back(file);
+
+  return file;
+}
+
+//------------------------------------------------------------------------------
+
+void BackupFlusher::Run()
+{
+  std::vector<u8> data;
+  std::string path;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      File* next = nullptr;
+
+      m_cv.wait(lock, [&] {
+        for (File* file : m_files) {
+          if (file->queued) {
+            next = file;
+            return true;
+          }
+        }
+
+        return m_stop;
+      });
+
+      // The pending snapshots are written before stopping.
+      if (!next) {
+        return;
+      }
+
+      data.swap(next->pending);
+      path = next->path;
+      next->queued = false;
+    }
+
+    WriteFile(path, data.data(), (u32)data.size());
+  }
+}
+
+} // namespace gpgx::vgs
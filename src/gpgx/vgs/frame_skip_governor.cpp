@@ -0,0 +1,109 @@
+/**
+ * This file is part of the Video Game Systems (VIGAS) project.
+ *
+ * Copyright 2024 Christophe Maymard <christophe.maymard@hotmail.com>
+ */
+
+#include "gpgx/vgs/frame_skip_governor.h"
+
+namespace gpgx::vgs {
+
+//==============================================================================
+// FrameSkipGovernor
+
+//------------------------------------------------------------------------------
+
+FrameSkipGovernor::FrameSkipGovernor() :
+  m_enabled(false),
+
+  m_start_time(0),
+  m_frame_index(0),
+  m_frame_period(16667),
+
+  m_skipped(0),
+
+  m_frame_count(0),
+  m_skipped_frame_count(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void FrameSkipGovernor::SetEnabled(bool enabled)
+{
+  m_enabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+
+bool FrameSkipGovernor::IsEnabled() const
+{
+  return m_enabled;
+}
+
+//------------------------------------------------------------------------------
+
+void FrameSkipGovernor::Reset(u64 time, u32 frame_period)
+{
+  m_start_time = time;
+  m_frame_index = 0;
+  m_frame_period = frame_period ? frame_period : 1;
+  m_skipped = 0;
+}
+
+//------------------------------------------------------------------------------
+
+bool FrameSkipGovernor::BeginFrame(u64 time)
+{
+  // Host time at which the frame is due.
+  u64 due_time = m_start_time + (m_frame_index * m_frame_period);
+
+  m_frame_count++;
+
+  if (time < (due_time + m_frame_period)) {
+    // On time (the host is throttled by the frontend when early).
+    m_frame_index++;
+    m_skipped = 0;
+    return false;
+  }
+
+  if ((time - due_time) > ((u64)kMaxLateFrames * m_frame_period)) {
+    // Too late to catch up: restart from the current frame.
+    m_start_time = time;
+    m_frame_index = 1;
+    m_skipped = 0;
+    return false;
+  }
+
+  m_frame_index++;
+
+  if (!m_enabled || (m_skipped >= kMaxSkippedFrames)) {
+    m_skipped = 0;
+    return false;
+  }
+
+  m_skipped++;
+  m_skipped_frame_count++;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+u32 FrameSkipGovernor::TakeFrameCount()
+{
+  u32 count = m_frame_count;
+  m_frame_count = 0;
+  return count;
+}
+
+//------------------------------------------------------------------------------
+
+u32 FrameSkipGovernor::TakeSkippedFrameCount()
+{
+  u32 count = m_skipped_frame_count;
+  m_skipped_frame_count = 0;
+  return count;
+}
+
+} // namespace gpgx::vgs